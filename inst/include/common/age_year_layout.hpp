@@ -0,0 +1,177 @@
+/**
+ * @file age_year_layout.hpp
+ * @brief Maps the distinct values of a parameter that is structured by age
+ * and year, e.g., natural mortality, to the full year by age matrix.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_AGE_YEAR_LAYOUT_HPP
+#define FIMS_COMMON_AGE_YEAR_LAYOUT_HPP
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+namespace fims {
+
+/**
+ * @brief How the values of an age by year parameter vary.
+ */
+enum AgeYearStructure {
+  AgeYearConstant, /**< one value for every age and year */
+  AgeYearAge,      /**< one value per age, the same in every year */
+  AgeYearYear,     /**< one value per year, the same at every age */
+  AgeYearBlock,    /**< one value per age in each block of years */
+  AgeYearFull      /**< one value per year and age */
+};
+
+/**
+ * @brief The layout of a parameter that is stored as its distinct values and
+ * read as a full matrix, indexed year * nages + age.
+ *
+ * @details Most assessments estimate one natural mortality, or one per age,
+ * but the population loops read it by year and age. Storing the distinct
+ * values keeps the parameter vector short, and transforms such as exp() are
+ * computed once per distinct value; Broadcast() then copies the results into
+ * the full matrix, which adds no operations to an AD tape. The layout only
+ * holds indices, so the double and AD instances of a model can use the same
+ * one.
+ */
+struct AgeYearLayout {
+  AgeYearStructure structure = AgeYearFull; /**< how the values vary */
+  std::vector<size_t> year_block; /**< the block of each year, for
+                                     AgeYearBlock; blocks are numbered from
+                                     zero */
+  size_t nyears = 0; /**< the number of years of the full matrix */
+  size_t nages = 0;  /**< the number of ages of the full matrix */
+  size_t nblocks = 0; /**< the number of blocks of years */
+  bool readable = true; /**< false if the structure or the blocks given to
+                           the layout could not be read, e.g., an unknown
+                           name or a negative block */
+
+  /**
+   * @brief Sets the dimensions of the full matrix and counts the blocks.
+   */
+  void Resize(size_t nyears, size_t nages) {
+    this->nyears = nyears;
+    this->nages = nages;
+    this->nblocks = 0;
+    for (size_t y = 0; y < this->year_block.size(); y++) {
+      if (this->year_block[y] + 1 > this->nblocks) {
+        this->nblocks = this->year_block[y] + 1;
+      }
+    }
+  }
+
+  /**
+   * @brief True if the layout was read and the blocks, if used, cover each
+   * year.
+   */
+  bool IsValid() const {
+    return this->readable && (this->structure != AgeYearBlock ||
+                              this->year_block.size() == this->nyears);
+  }
+
+  /**
+   * @brief The number of distinct values.
+   */
+  size_t Size() const {
+    switch (this->structure) {
+      case AgeYearConstant:
+        return 1;
+      case AgeYearAge:
+        return this->nages;
+      case AgeYearYear:
+        return this->nyears;
+      case AgeYearBlock:
+        return this->nblocks * this->nages;
+      default:
+        return this->nyears * this->nages;
+    }
+  }
+
+  /**
+   * @brief The index of the distinct value at a year and age. No bounds
+   * checking is performed.
+   */
+  inline size_t Index(size_t year, size_t age) const {
+    switch (this->structure) {
+      case AgeYearConstant:
+        return 0;
+      case AgeYearAge:
+        return age;
+      case AgeYearYear:
+        return year;
+      case AgeYearBlock:
+        return this->year_block[year] * this->nages + age;
+      default:
+        return year * this->nages + age;
+    }
+  }
+
+  /**
+   * @brief The first year a distinct value is used in, e.g., the first year
+   * a change to the parameter affects.
+   */
+  size_t FirstYear(size_t i) const {
+    switch (this->structure) {
+      case AgeYearYear:
+        return i;
+      case AgeYearBlock:
+        for (size_t y = 0; y < this->year_block.size(); y++) {
+          if (this->year_block[y] == i / this->nages) {
+            return y;
+          }
+        }
+        return 0;
+      case AgeYearFull:
+        return i / this->nages;
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * @brief Copies the distinct values into the full matrix.
+   *
+   * @param distinct The Size() distinct values.
+   * @param full The nyears * nages values, indexed year * nages + age.
+   */
+  template <class Distinct, class Full>
+  void Broadcast(const Distinct &distinct, Full &full) const {
+    for (size_t year = 0; year < this->nyears; year++) {
+      for (size_t age = 0; age < this->nages; age++) {
+        full[year * this->nages + age] = distinct[this->Index(year, age)];
+      }
+    }
+  }
+
+  /**
+   * @brief Reads a structure from its name: "constant", "age", "year",
+   * "block", or "full".
+   *
+   * @return False if the name is not one of these.
+   */
+  static bool Parse(const std::string &name, AgeYearStructure &structure) {
+    if (name == "constant") {
+      structure = AgeYearConstant;
+    } else if (name == "age") {
+      structure = AgeYearAge;
+    } else if (name == "year") {
+      structure = AgeYearYear;
+    } else if (name == "block") {
+      structure = AgeYearBlock;
+    } else if (name == "full") {
+      structure = AgeYearFull;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_AGE_YEAR_LAYOUT_HPP */
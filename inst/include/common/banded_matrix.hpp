@@ -0,0 +1,130 @@
+/**
+ * @file banded_matrix.hpp
+ * @brief A row-major matrix that stores only a band of columns in each row,
+ * used for age-length keys where each age spans a few length bins.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_BANDED_MATRIX_HPP
+#define FIMS_COMMON_BANDED_MATRIX_HPP
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "fims_kernels.hpp"
+#include "fims_vector.hpp"
+
+namespace fims {
+
+/**
+ * @brief A row-major matrix that stores, for each row, the values from its
+ * first to its last nonzero column. Everything outside the band is zero.
+ *
+ * @details The band is found once from a dense matrix, after which Update()
+ * copies the values in the band from the dense matrix again. Elements that
+ * are estimated stay in the band even if they start at zero, so the band does
+ * not depend on parameter values and the AD tape is valid for all of them.
+ */
+template <class Type>
+class BandedMatrix {
+ public:
+  size_t nrows = 0; /**< number of rows */
+  size_t ncols = 0; /**< number of columns */
+  std::vector<std::pair<size_t, size_t>>
+      band;                   /**< [first, last) stored column of each row */
+  std::vector<size_t> offset; /**< position of each row in values */
+  fims::Vector<Type> values;  /**< the stored values, row by row */
+
+  BandedMatrix() {}
+
+  /**
+   * @brief Finds the band of a dense matrix.
+   *
+   * @param dense The matrix, of size nrows * ncols.
+   * @param nrows The number of rows.
+   * @param ncols The number of columns.
+   * @param keep Elements of dense that are stored even if they are zero.
+   */
+  BandedMatrix(const fims::Vector<Type> &dense, size_t nrows, size_t ncols,
+               const std::set<const Type *> &keep = std::set<const Type *>())
+      : nrows(nrows), ncols(ncols), band(nrows), offset(nrows) {
+    size_t nvalues = 0;
+    for (size_t k = 0; k < nrows; k++) {
+      size_t first = 0;
+      while (first < ncols && !this->Stored(dense, keep, k * ncols + first)) {
+        first++;
+      }
+      size_t last = ncols;
+      while (last > first && !this->Stored(dense, keep, k * ncols + last - 1)) {
+        last--;
+      }
+      this->band[k] = std::make_pair(first, last);
+      this->offset[k] = nvalues;
+      nvalues += last - first;
+    }
+    this->values.resize(nvalues);
+    this->Update(dense);
+  }
+
+  /**
+   * @brief True if the matrix has the given dimensions, i.e., it was set up
+   * for a dense matrix of that shape.
+   */
+  bool HasShape(size_t nrows, size_t ncols) const {
+    return this->nrows == nrows && this->ncols == ncols &&
+           this->band.size() == nrows;
+  }
+
+  /**
+   * @brief Copies the values in the band from a dense matrix with the same
+   * shape.
+   *
+   * @param dense The matrix, of size nrows * ncols.
+   */
+  void Update(const fims::Vector<Type> &dense) {
+    for (size_t k = 0; k < this->nrows; k++) {
+      for (size_t j = this->band[k].first; j < this->band[k].second; j++) {
+        this->values[this->offset[k] + j - this->band[k].first] =
+            dense[k * this->ncols + j];
+      }
+    }
+  }
+
+  /**
+   * @brief The fraction of the elements that are stored.
+   */
+  double Density() const {
+    size_t n = this->nrows * this->ncols;
+    return n == 0 ? 0.0
+                  : static_cast<double>(this->values.size()) /
+                        static_cast<double>(n);
+  }
+
+  /**
+   * @brief Adds the product of a dense row-major matrix and this matrix to a
+   * third, C += A B, see fims_math::add_product().
+   *
+   * @param a The left matrix, of size n * nrows.
+   * @param c The result, of size n * ncols, which is added to.
+   * @param n The number of rows of A and C.
+   */
+  void MultiplyAdd(const Type *a, Type *c, size_t n) const {
+    fims_math::add_product(a, this->values.data(), c, n, this->nrows,
+                           this->ncols, this->band, this->offset);
+  }
+
+ private:
+  /**
+   * @brief True if an element of the dense matrix belongs in the band.
+   */
+  static bool Stored(const fims::Vector<Type> &dense,
+                     const std::set<const Type *> &keep, size_t i) {
+    return dense[i] != static_cast<Type>(0.0) || keep.count(&dense[i]) > 0;
+  }
+};
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_BANDED_MATRIX_HPP */
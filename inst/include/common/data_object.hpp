@@ -8,21 +8,138 @@
 #ifndef FIMS_COMMON_DATA_OBJECT_HPP
 #define FIMS_COMMON_DATA_OBJECT_HPP
 
+#include <array>
 #include <exception>
+#include <stdexcept>
 #include <vector>
 
 #include "model_object.hpp"
 #include "fims_vector.hpp"
+#include "shared_data.hpp"
 
 namespace fims_data_object {
 
 /**
- * Container to hold user supplied data.
+ * Access policy that checks every index and throws std::overflow_error if it
+ * is out of bounds.
+ */
+struct CheckedAccess {
+  /**
+   * Throws if pos is not less than size.
+   * @param pos the index
+   * @param size the number of values
+   */
+  static inline void Check(size_t pos, size_t size) {
+    if (pos >= size) {
+      throw std::overflow_error("DataObject error: index out of bounds");
+    }
+  }
+};
+
+/**
+ * Access policy that does not check indices, for loops whose bounds were
+ * validated when the model was created.
+ */
+struct UncheckedAccess {
+  /**
+   * Does nothing.
+   */
+  static inline void Check(size_t, size_t) {}
+};
+
+/**
+ * The access policy of DataObject::operator() and DataView: checked in debug
+ * builds, i.e., with FIMS_DEBUG defined, and unchecked otherwise. at() is
+ * always checked.
+ */
+#ifdef FIMS_DEBUG
+typedef CheckedAccess DefaultAccess;
+#else
+typedef UncheckedAccess DefaultAccess;
+#endif
+
+/**
+ * A lightweight row-major view of the values of a data object with Rank
+ * dimensions, in the manner of std::mdspan. The view points into the buffer
+ * of the data object, so it is made where it is used, e.g., once per
+ * evaluation, and not kept across changes to the data.
+ */
+template <typename Type, size_t Rank, class Access = DefaultAccess>
+class DataView {
+  const double *data_m = nullptr;  /**< the first value */
+  std::array<size_t, Rank> extents; /**< the size of each dimension */
+
+ public:
+  /**
+   * Constructs a view of values with the given dimensions.
+   * @param data the first value
+   * @param extents the size of each dimension
+   */
+  DataView(const double *data, const std::array<size_t, Rank> &extents)
+      : data_m(data), extents(extents) {}
+
+  /**
+   * @return the size of dimension r
+   */
+  inline size_t extent(size_t r) const { return this->extents[r]; }
+
+  /**
+   * @return the number of values
+   */
+  inline size_t size() const {
+    size_t n = 1;
+    for (size_t r = 0; r < Rank; r++) {
+      n *= this->extents[r];
+    }
+    return n;
+  }
+
+  /**
+   * Retrieve an element, one index per dimension.
+   * @return the value at the position
+   */
+  template <typename... Index>
+  inline const Type operator()(Index... index) const {
+    static_assert(sizeof...(Index) == Rank,
+                  "DataView: one index is needed per dimension");
+    const size_t idx[Rank] = {static_cast<size_t>(index)...};
+    size_t pos = 0;
+    for (size_t r = 0; r < Rank; r++) {
+      Access::Check(idx[r], this->extents[r]);
+      pos = pos * this->extents[r] + idx[r];
+    }
+    return static_cast<Type>(this->data_m[pos]);
+  }
+
+  /**
+   * The contiguous values whose first index is i, e.g., the age composition
+   * of one year.
+   * @param i the first index
+   * @return the values of row i
+   */
+  inline fims::Span<const double> row(size_t i) const {
+    Access::Check(i, this->extents[0]);
+    size_t n = this->extents[0] == 0 ? 0 : this->size() / this->extents[0];
+    return fims::Span<const double>(this->data_m + i * n, n);
+  }
+
+  /**
+   * @return all of the values
+   */
+  inline fims::Span<const double> span() const {
+    return fims::Span<const double>(this->data_m, this->size());
+  }
+};
+
+/**
+ * Container to hold user supplied data. The values are stored once as
+ * doubles and shared by the data objects with the same id in every
+ * Information instance, see fims::SharedData.
  */
 template <typename Type>
 struct DataObject : public fims_model_object::FIMSObject<Type> {
   static uint32_t id_g;                    /**< id of the Data Object >*/
-  fims::Vector<Type> data;                 /**< vector of the data >*/
+  fims::SharedDataView<Type> data;         /**< vector of the data >*/
   size_t dimensions;                       /**< dimension of the Data object >*/
   size_t imax;                             /**<1st dimension of data object >*/
   size_t jmax;                             /**< 2nd dimension of data object>*/
@@ -70,15 +187,18 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param i dimension of 1d data set
    * @return the value of the vector at position i
    */
-  inline Type operator()(size_t i) { return data[i]; }
+  inline const Type operator()(size_t i) const {
+    DefaultAccess::Check(i, this->data.size());
+    return data[i];
+  }
 
   /**
    * Retrieve element from 1d data set.
    * Throws an exception if index is out of bounds.
    * @param i dimension of 1d data set
-   * @return the reference to the value of the vector at position i
+   * @return the value of the vector at position i
    */
-  inline Type& at(size_t i) {
+  inline const Type at(size_t i) const {
     if (i >= this->data.size()) {
       throw std::overflow_error("DataObject error:i index out of bounds");
     }
@@ -91,7 +211,8 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param j 2nd dimension of 2d data set
    * @return the value of the matrix at position i, j
    */
-  inline const Type operator()(size_t i, size_t j) {
+  inline const Type operator()(size_t i, size_t j) const {
+    DefaultAccess::Check(i * jmax + j, this->data.size());
     return data[i * jmax + j];
   }
 
@@ -100,9 +221,9 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * Throws an exception if index is out of bounds.
    * @param i 1st dimension of 2d data set
    * @param j 2nd dimension of 2d data set
-   * @return the reference to the value of the matrix at position i, j
+   * @return the value of the matrix at position i, j
    */
-  inline Type& at(size_t i, size_t j) {
+  inline const Type at(size_t i, size_t j) const {
     if ((i * jmax + j) >= this->data.size()) {
       throw std::overflow_error("DataObject error: index out of bounds");
     }
@@ -116,7 +237,8 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param k 3rd dimension of 3d data set
    * @return the value of the array at position i, j, k
    */
-  inline const Type operator()(size_t i, size_t j, size_t k) {
+  inline const Type operator()(size_t i, size_t j, size_t k) const {
+    DefaultAccess::Check(i * jmax * kmax + j * kmax + k, this->data.size());
     return data[i * jmax * kmax + j * kmax + k];
   }
 
@@ -126,9 +248,9 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param i 1st dimension of 3d data set
    * @param j 2nd dimension of 3d data set
    * @param k 3rd dimension of 3d data set
-   * @return the reference to the value of the array at position i, j, k
+   * @return the value of the array at position i, j, k
    */
-  inline Type& at(size_t i, size_t j, size_t k) {
+  inline const Type at(size_t i, size_t j, size_t k) const {
     if ((i * jmax * kmax + j * kmax + k) >= this->data.size()) {
       throw std::overflow_error("DataObject error: index out of bounds");
     }
@@ -143,7 +265,9 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param l 4th dimension of 4d data set
    * @return the value of the array at position i, j, k, l
    */
-  inline const Type operator()(size_t i, size_t j, size_t k, size_t l) {
+  inline const Type operator()(size_t i, size_t j, size_t k, size_t l) const {
+    DefaultAccess::Check(i * jmax * kmax * lmax + j * kmax * lmax + k * lmax + l,
+                         this->data.size());
     return data[i * jmax * kmax * lmax + j * kmax * lmax + k * lmax + l];
   }
 
@@ -154,9 +278,9 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
    * @param j 2nd dimension of 4d data set
    * @param k 3rd dimension of 4d data set
    * @param l 4th dimension of 4d data set
-   * @return the reference to the value of the array at position i, j, k, l
+   * @return the value of the array at position i, j, k, l
    */
-  inline Type& at(size_t i, size_t j, size_t k, size_t l) {
+  inline const Type at(size_t i, size_t j, size_t k, size_t l) const {
     if ((i * jmax * kmax * lmax + j * kmax * lmax + k * lmax + l) >=
         this->data.size()) {
       throw std::overflow_error("DataObject error: index out of bounds");
@@ -164,6 +288,48 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
     return data[i * jmax * kmax * lmax + j * kmax * lmax + k * lmax + l];
   }
 
+  /**
+   * Replace an element of a 1d data set, e.g., with simulated data. Only
+   * this data object sees the new value.
+   * Throws an exception if index is out of bounds.
+   * @param i dimension of 1d data set
+   * @param value the new value
+   */
+  inline void set(size_t i, const Type& value) {
+    if (i >= this->data.size()) {
+      throw std::overflow_error("DataObject error:i index out of bounds");
+    }
+    data.Set(i, value);
+  }
+
+  /**
+   * Replace an element of a 2d data set. Only this data object sees the new
+   * value.
+   * Throws an exception if index is out of bounds.
+   * @param i 1st dimension of 2d data set
+   * @param j 2nd dimension of 2d data set
+   * @param value the new value
+   */
+  inline void set(size_t i, size_t j, const Type& value) {
+    if ((i * jmax + j) >= this->data.size()) {
+      throw std::overflow_error("DataObject error: index out of bounds");
+    }
+    data.Set(i * jmax + j, value);
+  }
+
+  /**
+   * Checks that the number of values matches the dimensions. Called once when
+   * the model is created so the evaluation loops can read without checks.
+   * @return true if the data has imax * jmax * ... values
+   */
+  bool IsValid() const {
+    size_t n = imax;
+    if (dimensions > 1) n *= jmax;
+    if (dimensions > 2) n *= kmax;
+    if (dimensions > 3) n *= lmax;
+    return n == this->data.size();
+  }
+
   /**
    * @brief Get the dimensions object
    *
@@ -203,6 +369,32 @@ struct DataObject : public fims_model_object::FIMSObject<Type> {
 template <typename Type>
 uint32_t DataObject<Type>::id_g = 0;
 
+/**
+ * Makes a view of a data object with Rank dimensions. A data object with
+ * fewer dimensions is viewed with its values in the last ones, e.g., a 1d
+ * data set as a single row.
+ * @param d the data object
+ * @return the view
+ */
+template <size_t Rank, class Access = DefaultAccess, typename Type>
+DataView<Type, Rank, Access> view(const DataObject<Type> &d) {
+  static_assert(Rank >= 1 && Rank <= 4, "DataView: rank must be 1 to 4");
+  const size_t dims[4] = {d.imax, d.dimensions > 1 ? d.jmax : 1,
+                          d.dimensions > 2 ? d.kmax : 1,
+                          d.dimensions > 3 ? d.lmax : 1};
+  std::array<size_t, Rank> extents;
+  extents.fill(1);
+  size_t n = d.dimensions < Rank ? d.dimensions : Rank;
+  // leading dimensions beyond Rank are folded into the first extent
+  for (size_t r = 0; r < n; r++) {
+    extents[Rank - n + r] = dims[d.dimensions - n + r];
+  }
+  for (size_t r = 0; r + n < d.dimensions; r++) {
+    extents[Rank - n] *= dims[r];
+  }
+  return DataView<Type, Rank, Access>(d.data.GetBuffer()->data(), extents);
+}
+
 }  // namespace fims_data_object
 
 #endif
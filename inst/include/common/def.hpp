@@ -402,6 +402,34 @@ class FIMSLog {
     this->log_entries.push_back(l);
   }
 
+  /**
+   * Get the number of bytes held by the log entries, including the
+   * characters of their strings.
+   *
+   * @return the number of bytes
+   */
+  size_t get_memory_usage() const {
+    size_t bytes = this->entries.capacity() * sizeof(std::string) +
+                   this->log_entries.capacity() * sizeof(LogEntry);
+    for (size_t i = 0; i < this->entries.size(); i++) {
+      bytes += this->entries[i].capacity();
+    }
+    for (size_t i = 0; i < this->log_entries.size(); i++) {
+      const LogEntry &l = this->log_entries[i];
+      bytes += l.timestamp.capacity() + l.message.capacity() +
+               l.level.capacity() + l.user.capacity() + l.wd.capacity() +
+               l.file.capacity() + l.routine.capacity();
+    }
+    return bytes;
+  }
+
+  /**
+   * Get the number of log entries.
+   *
+   * @return the number of entries
+   */
+  size_t get_entry_count() const { return this->log_entries.size(); }
+
   /**
    * Get the log as a string object.
    *
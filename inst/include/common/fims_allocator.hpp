@@ -0,0 +1,330 @@
+/**
+ * @file fims_allocator.hpp
+ * @brief Allocators for fims::Vector, including the arena that holds the
+ * vectors of a model.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_FIMS_ALLOCATOR_HPP
+#define FIMS_COMMON_FIMS_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace fims {
+
+/**
+ * @brief An allocator whose storage starts on an Alignment-byte boundary,
+ * e.g., a cache line, so vector loops over doubles can use aligned loads.
+ *
+ * @tparam T The element type.
+ * @tparam Alignment The alignment in bytes, a power of two.
+ */
+template <class T, size_t Alignment = 64>
+struct AlignedAllocator {
+  typedef T value_type; /**< the element type */
+
+  /**
+   * @brief The allocator for another element type, used by containers that
+   * allocate nodes.
+   */
+  template <class U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other; /**< the rebound type */
+  };
+
+  AlignedAllocator() {}
+
+  /**
+   * @brief Converts from an allocator for another element type.
+   */
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  /**
+   * @brief Allocates storage for n elements.
+   */
+  T *allocate(size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  /**
+   * @brief Frees storage from allocate().
+   */
+  void deallocate(T *p, size_t n) {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+};
+
+/**
+ * @brief Aligned allocators are interchangeable.
+ */
+template <class T, class U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment> &,
+                const AlignedAllocator<U, Alignment> &) {
+  return true;
+}
+
+/**
+ * @brief Aligned allocators are interchangeable.
+ */
+template <class T, class U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment> &,
+                const AlignedAllocator<U, Alignment> &) {
+  return false;
+}
+
+/**
+ * @brief A monotonic arena of elements of type T. Allocations are taken from
+ * the end of the last chunk and are never freed individually; the chunks are
+ * freed together when the arena is destroyed.
+ *
+ * @details Every allocation is a whole number of elements, so the used part
+ * of each chunk is one array of T. That lets Fill() reset every vector in the
+ * arena in one pass, including storage left behind by vectors that grew, which
+ * is not read again.
+ */
+template <class T>
+class Arena {
+ public:
+  /** @brief The alignment of each chunk, a cache line. */
+  static constexpr size_t alignment =
+      alignof(T) > 64 ? alignof(T) : static_cast<size_t>(64);
+
+  /**
+   * @brief Constructs an empty arena.
+   *
+   * @param chunk_size The number of elements in each chunk. Larger requests
+   * get a chunk of their own size.
+   */
+  explicit Arena(size_t chunk_size = 4096) : chunk_size(chunk_size) {}
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Frees the chunks.
+   */
+  ~Arena() {
+    for (size_t i = 0; i < this->chunks.size(); i++) {
+      ::operator delete(this->chunks[i].begin, std::align_val_t(alignment));
+    }
+  }
+
+  /**
+   * @brief Takes storage for n elements from the arena.
+   */
+  T *Allocate(size_t n) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->chunks.empty() ||
+        this->chunks.back().used + n > this->chunks.back().capacity) {
+      Chunk chunk;
+      chunk.capacity = std::max(n, this->chunk_size);
+      chunk.used = 0;
+      chunk.begin = static_cast<T *>(::operator new(
+          chunk.capacity * sizeof(T), std::align_val_t(alignment)));
+      this->chunks.push_back(chunk);
+    }
+    Chunk &chunk = this->chunks.back();
+    T *p = chunk.begin + chunk.used;
+    chunk.used += n;
+    return p;
+  }
+
+  /**
+   * @brief Sets every element taken from the arena to value.
+   */
+  void Fill(const T &value) {
+    for (size_t i = 0; i < this->chunks.size(); i++) {
+      T *begin = this->chunks[i].begin;
+      T *end = begin + this->chunks[i].used;
+      for (T *p = begin; p != end; ++p) {
+        new (p) T(value);
+      }
+    }
+  }
+
+  /**
+   * @brief The number of elements taken from the arena.
+   */
+  size_t Size() const {
+    size_t n = 0;
+    for (size_t i = 0; i < this->chunks.size(); i++) {
+      n += this->chunks[i].used;
+    }
+    return n;
+  }
+
+  /**
+   * @brief The number of elements the chunks can hold.
+   */
+  size_t Capacity() const {
+    size_t n = 0;
+    for (size_t i = 0; i < this->chunks.size(); i++) {
+      n += this->chunks[i].capacity;
+    }
+    return n;
+  }
+
+  /**
+   * @brief The number of chunks.
+   */
+  size_t Chunks() const { return this->chunks.size(); }
+
+ private:
+  /** @brief A block of storage and the part of it in use. */
+  struct Chunk {
+    T *begin;        /**< the first element */
+    size_t capacity; /**< the number of elements the chunk holds */
+    size_t used;     /**< the number of elements taken */
+  };
+  std::vector<Chunk> chunks; /**< the chunks, the last one in use */
+  size_t chunk_size;         /**< the number of elements in a new chunk */
+  std::mutex mutex;          /**< guards allocation from task threads */
+};
+
+/**
+ * @brief The allocator of fims::Vector. A vector constructed while an
+ * ArenaScope is open takes its storage from that arena, and any other vector
+ * from the heap.
+ *
+ * @details The allocator holds a reference to its arena, so the arena lives
+ * as long as any vector that uses it. Copies of a vector use the arena in
+ * scope where they are made, e.g., the heap for a copy of the derived
+ * quantities taken after the model is built, while moves keep the storage.
+ * Only element types without a destructor use arenas, because Arena::Fill()
+ * constructs elements over the storage in place.
+ */
+template <class T>
+class ArenaAllocator {
+ public:
+  typedef T value_type; /**< the element type */
+  /** @brief Moves keep the storage of the moved vector. */
+  typedef std::true_type propagate_on_container_move_assignment;
+  /** @brief Swaps exchange the storage of the vectors. */
+  typedef std::true_type propagate_on_container_swap;
+  /** @brief Copies keep the arena of the vector assigned to. */
+  typedef std::false_type propagate_on_container_copy_assignment;
+
+  /**
+   * @brief The allocator for the arena in scope, if any.
+   */
+  ArenaAllocator() : arena(ArenaAllocator<T>::Current()) {}
+
+  /**
+   * @brief The allocator for an arena, or for the heap if arena is null.
+   */
+  explicit ArenaAllocator(const std::shared_ptr<Arena<T> > &arena)
+      : arena(arena) {}
+
+  /**
+   * @brief Converts from an allocator for another element type, which uses
+   * the heap.
+   */
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U> &) {}
+
+  /**
+   * @brief Allocates storage for n elements.
+   */
+  T *allocate(size_t n) {
+    if (this->arena != nullptr) {
+      return this->arena->Allocate(n);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  /**
+   * @brief Frees storage from allocate(). Storage from an arena is freed with
+   * the arena.
+   */
+  void deallocate(T *p, [[maybe_unused]] size_t n) {
+    if (this->arena == nullptr) {
+      ::operator delete(p);
+    }
+  }
+
+  /**
+   * @brief A copy of a vector uses the arena in scope.
+   */
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  /**
+   * @brief The arena, or null for the heap.
+   */
+  Arena<T> *GetArena() const { return this->arena.get(); }
+
+  /**
+   * @brief The arena that new vectors of T take their storage from, set by
+   * ArenaScope.
+   */
+  static std::shared_ptr<Arena<T> > &Current() {
+    static thread_local std::shared_ptr<Arena<T> > current;
+    return current;
+  }
+
+ private:
+  std::shared_ptr<Arena<T> > arena; /**< the arena, or null for the heap */
+};
+
+/**
+ * @brief Allocators are equal if they use the same arena.
+ */
+template <class T, class U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+  return static_cast<const void *>(lhs.GetArena()) ==
+         static_cast<const void *>(rhs.GetArena());
+}
+
+/**
+ * @brief Allocators are equal if they use the same arena.
+ */
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * @brief Sets the arena that vectors of T constructed on this thread take
+ * their storage from, until the scope closes.
+ */
+template <class T>
+class ArenaScope {
+ public:
+  /**
+   * @brief Opens the scope. A null arena, or an element type with a
+   * destructor, leaves the vectors on the heap.
+   */
+  explicit ArenaScope(const std::shared_ptr<Arena<T> > &arena)
+      : previous(ArenaAllocator<T>::Current()) {
+    if (std::is_trivially_destructible<T>::value) {
+      ArenaAllocator<T>::Current() = arena;
+    } else {
+      ArenaAllocator<T>::Current() = nullptr;
+    }
+  }
+
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+
+  /**
+   * @brief Closes the scope and restores the arena that was in scope before.
+   */
+  ~ArenaScope() { ArenaAllocator<T>::Current() = this->previous; }
+
+ private:
+  std::shared_ptr<Arena<T> > previous; /**< the arena in scope before */
+};
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_FIMS_ALLOCATOR_HPP */
@@ -0,0 +1,90 @@
+/**
+ * @file fims_checkpoint.hpp
+ * @brief Checkpointing of a block of the model calculations. With TMBad the
+ * block is recorded on its own tape and added to the model tape as one atomic
+ * operation, so the derivative tapes built from the model tape, e.g., for the
+ * Hessian, hold one operation per block instead of the whole block.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_FIMS_CHECKPOINT_HPP
+#define FIMS_COMMON_FIMS_CHECKPOINT_HPP
+
+#include <utility>
+#include <vector>
+
+#include "fims_vector.hpp"
+
+namespace fims {
+
+/**
+ * @brief Evaluates a block of calculations that writes its results to the
+ * tracked vectors. Without a tape there is nothing to checkpoint, so the block
+ * is evaluated directly.
+ *
+ * @param block The calculations, a function with no arguments.
+ * @param tracked The vectors the block may write to.
+ */
+template <class Type, class Block>
+void checkpoint(
+    Block block,
+    [[maybe_unused]] const std::vector<fims::Vector<Type> *> &tracked) {
+  block();
+}
+
+#if defined(TMB_MODEL) && defined(TMBAD_FRAMEWORK)
+/**
+ * @brief Records a block of calculations as one atomic operation on the
+ * current tape.
+ *
+ * @details The block is run once on a tape of its own. Values it reads from
+ * the current tape become references, which resolve_refs() turns into inputs
+ * of the block. Its outputs are the elements of the tracked vectors that it
+ * wrote, which are found by checking which elements are variables on the
+ * block tape. The block must take the same branches for every parameter
+ * value, which is already required of the model tape.
+ *
+ * @param block The calculations, a function with no arguments.
+ * @param tracked The vectors the block may write to.
+ */
+template <class Block>
+void checkpoint(Block block,
+                const std::vector<fims::Vector<TMBad::ad_aug> *> &tracked) {
+  typedef TMBad::ad_aug ad;
+  // (vector, element) of each output
+  std::vector<std::pair<size_t, size_t>> written;
+  TMBad::ADFun<> F(
+      [&](const std::vector<ad> &x) {
+        block();
+        TMBad::global *tape = TMBad::get_glob();
+        std::vector<ad> y;
+        for (size_t v = 0; v < tracked.size(); v++) {
+          fims::Vector<ad> &values = *tracked[v];
+          for (size_t i = 0; i < values.size(); i++) {
+            if (values[i].ontape() && values[i].glob() == tape) {
+              written.push_back(std::make_pair(v, i));
+              y.push_back(values[i]);
+            }
+          }
+        }
+        // the placeholder input keeps the range from being empty
+        y.push_back(x[0]);
+        return y;
+      },
+      std::vector<double>(1, 0.0));
+
+  std::vector<ad> x(1, ad(0.0));
+  std::vector<ad> refs = F.resolve_refs();
+  x.insert(x.end(), refs.begin(), refs.end());
+  F.optimize();
+  std::vector<ad> y = F.atomic()(x);
+  for (size_t k = 0; k < written.size(); k++) {
+    (*tracked[written[k].first])[written[k].second] = y[k];
+  }
+}
+#endif
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_FIMS_CHECKPOINT_HPP */
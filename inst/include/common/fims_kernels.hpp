@@ -0,0 +1,408 @@
+/**
+ * @file fims_kernels.hpp
+ * @brief Vector kernels for the inner loops of the population dynamics:
+ * Baranov catch, the numbers-at-age survival step, normalization of a
+ * composition, and the conversion of compositions at age to length. With
+ * TMBad the first three are recorded on the tape as one atomic operation with
+ * hand-coded derivatives instead of one node per scalar operation.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_FIMS_KERNELS_HPP
+#define FIMS_COMMON_FIMS_KERNELS_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "fims_math.hpp"
+
+namespace fims_math {
+
+/**
+ * @brief Baranov catch at age.
+ *
+ * @details \f$ C_a = \frac{F_a}{Z_a} N_a (1 - e^{-Z_a}) \f$. The input is
+ * folded as [F, Z, N], each with one value per age.
+ *
+ * @param tx The inputs, of length 3 * nages.
+ * @param ty The catch at age, of length nages.
+ */
+template <class Type, class Vector>
+void baranov_catch_forward(const Vector &tx, Vector &ty) {
+  size_t n = tx.size() / 3;
+  for (size_t a = 0; a < n; a++) {
+    const Type &F = tx[a];
+    const Type &Z = tx[n + a];
+    const Type &N = tx[2 * n + a];
+    ty[a] = F / Z * N * (static_cast<Type>(1.0) - fims_math::exp(-Z));
+  }
+}
+
+/**
+ * @brief Derivatives of baranov_catch_forward().
+ *
+ * @param tx The inputs, folded as [F, Z, N].
+ * @param py The derivatives of the objective with respect to the catch.
+ * @param px The derivatives of the objective with respect to the inputs.
+ */
+template <class Type, class Vector>
+void baranov_catch_reverse(const Vector &tx, const Vector &py, Vector &px) {
+  size_t n = tx.size() / 3;
+  for (size_t a = 0; a < n; a++) {
+    const Type &F = tx[a];
+    const Type &Z = tx[n + a];
+    const Type &N = tx[2 * n + a];
+    Type survival = fims_math::exp(-Z);
+    Type dead = static_cast<Type>(1.0) - survival;
+    px[a] = py[a] * N * dead / Z;
+    px[n + a] = py[a] * F * N * (survival / Z - dead / (Z * Z));
+    px[2 * n + a] = py[a] * F * dead / Z;
+  }
+}
+
+/**
+ * @brief Numbers at age at the start of the next year.
+ *
+ * @details The survivors of age a - 1 become age a, and the survivors of the
+ * plus group stay in the plus group. The input is folded as [N, Z], each with
+ * one value per age. Recruitment is not included, so the output starts at the
+ * second age.
+ *
+ * @param tx The inputs, of length 2 * nages.
+ * @param ty The numbers at ages 1 to nages - 1, of length nages - 1.
+ */
+template <class Type, class Vector>
+void survival_step_forward(const Vector &tx, Vector &ty) {
+  size_t n = tx.size() / 2;
+  for (size_t a = 1; a < n; a++) {
+    ty[a - 1] = tx[a - 1] * fims_math::exp(-tx[n + a - 1]);
+  }
+  ty[n - 2] = ty[n - 2] + tx[n - 1] * fims_math::exp(-tx[2 * n - 1]);
+}
+
+/**
+ * @brief Derivatives of survival_step_forward().
+ *
+ * @param tx The inputs, folded as [N, Z].
+ * @param py The derivatives of the objective with respect to the output.
+ * @param px The derivatives of the objective with respect to the inputs.
+ */
+template <class Type, class Vector>
+void survival_step_reverse(const Vector &tx, const Vector &py, Vector &px) {
+  size_t n = tx.size() / 2;
+  for (size_t a = 0; a < n; a++) {
+    // the plus group adds to the last output
+    const Type &dy = py[a < n - 1 ? a : n - 2];
+    Type survivors = tx[a] * fims_math::exp(-tx[n + a]);
+    px[a] = dy * fims_math::exp(-tx[n + a]);
+    px[n + a] = -dy * survivors;
+  }
+}
+
+/**
+ * @brief Divides a composition by its sum so it sums to one.
+ *
+ * @param tx The composition.
+ * @param ty The proportions.
+ */
+template <class Type, class Vector>
+void normalize_forward(const Vector &tx, Vector &ty) {
+  Type sum = static_cast<Type>(0.0);
+  for (size_t i = 0; i < tx.size(); i++) {
+    sum += tx[i];
+  }
+  for (size_t i = 0; i < tx.size(); i++) {
+    ty[i] = tx[i] / sum;
+  }
+}
+
+/**
+ * @brief Derivatives of normalize_forward().
+ *
+ * @details With \f$ y_i = x_i / S \f$, the derivative with respect to
+ * \f$ x_j \f$ is \f$ (\bar{y}_j - \sum_i \bar{y}_i y_i) / S \f$.
+ *
+ * @param tx The composition.
+ * @param ty The proportions.
+ * @param py The derivatives of the objective with respect to the proportions.
+ * @param px The derivatives of the objective with respect to the composition.
+ */
+template <class Type, class Vector>
+void normalize_reverse(const Vector &tx, const Vector &ty, const Vector &py,
+                       Vector &px) {
+  Type sum = static_cast<Type>(0.0);
+  Type weighted = static_cast<Type>(0.0);
+  for (size_t i = 0; i < tx.size(); i++) {
+    sum += tx[i];
+    weighted += py[i] * ty[i];
+  }
+  for (size_t i = 0; i < tx.size(); i++) {
+    px[i] = (py[i] - weighted) / sum;
+  }
+}
+
+/**
+ * @brief The range of columns with nonzero values in each row of a row-major
+ * matrix, e.g., the length bins each age can be in for an age-length key. A
+ * row of zeros gets an empty range.
+ *
+ * @param b The matrix, of size nrows * ncols.
+ * @param nrows The number of rows.
+ * @param ncols The number of columns.
+ * @return The [first, last) nonzero column of each row.
+ */
+template <class Type>
+std::vector<std::pair<size_t, size_t>> nonzero_columns(const Type *b,
+                                                       size_t nrows,
+                                                       size_t ncols) {
+  std::vector<std::pair<size_t, size_t>> band(nrows,
+                                              std::make_pair(0, 0));
+  for (size_t k = 0; k < nrows; k++) {
+    const Type *row = b + k * ncols;
+    size_t first = 0;
+    while (first < ncols && row[first] == static_cast<Type>(0.0)) {
+      first++;
+    }
+    size_t last = ncols;
+    while (last > first && row[last - 1] == static_cast<Type>(0.0)) {
+      last--;
+    }
+    band[k] = std::make_pair(first, last);
+  }
+  return band;
+}
+
+/**
+ * @brief Adds a scaled row to another row, c += a * b.
+ */
+template <class Type>
+inline void add_scaled_row(const Type &a, const Type *b, Type *c, size_t n) {
+  for (size_t j = 0; j < n; j++) {
+    c[j] += a * b[j];
+  }
+}
+
+/**
+ * @brief Adds a scaled row to another row for doubles. The rows do not
+ * overlap, so the loop is vectorized.
+ */
+inline void add_scaled_row(const double &a, const double *__restrict b,
+                           double *__restrict c, size_t n) {
+  const double scale = a;
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t j = 0; j < n; j++) {
+    c[j] += scale * b[j];
+  }
+}
+
+/**
+ * @brief Adds the product of two row-major matrices to a third, C += A B,
+ * where only a band of columns of each row of B is stored, e.g., numbers at
+ * age by year times an age-length key gives numbers at length by year.
+ *
+ * @details The inner dimension and the columns are split into tiles so a tile
+ * of B stays in cache while every row of A is multiplied with it. Only the
+ * stored columns of each row of B are visited. Each element of C still sums
+ * over the inner dimension in order, so the result is the same as the plain
+ * triple loop.
+ *
+ * @param a The left matrix, of size nrows * ninner.
+ * @param b The stored values of the right matrix.
+ * @param c The result, of size nrows * ncols, which is added to.
+ * @param nrows The number of rows of A and C.
+ * @param ninner The number of columns of A and rows of B.
+ * @param ncols The number of columns of B and C.
+ * @param band The [first, last) stored columns of each row of B.
+ * @param offset The position in b of the first stored value of each row.
+ * @param tile The size of the tiles in both dimensions.
+ */
+template <class Type>
+void add_product(const Type *a, const Type *b, Type *c, size_t nrows,
+                 size_t ninner, size_t ncols,
+                 const std::vector<std::pair<size_t, size_t>> &band,
+                 const std::vector<size_t> &offset, size_t tile = 64) {
+  for (size_t k0 = 0; k0 < ninner; k0 += tile) {
+    size_t k1 = std::min(k0 + tile, ninner);
+    for (size_t j0 = 0; j0 < ncols; j0 += tile) {
+      size_t j1 = std::min(j0 + tile, ncols);
+      for (size_t i = 0; i < nrows; i++) {
+        for (size_t k = k0; k < k1; k++) {
+          size_t first = std::max(j0, band[k].first);
+          size_t last = std::min(j1, band[k].second);
+          if (first < last) {
+            add_scaled_row(a[i * ninner + k],
+                           b + offset[k] + (first - band[k].first),
+                           c + i * ncols + first, last - first);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Adds the product of two dense row-major matrices to a third,
+ * C += A B, visiting only the nonzero band of each row of B.
+ *
+ * @param a The left matrix, of size nrows * ninner.
+ * @param b The right matrix, of size ninner * ncols.
+ * @param c The result, of size nrows * ncols, which is added to.
+ * @param nrows The number of rows of A and C.
+ * @param ninner The number of columns of A and rows of B.
+ * @param ncols The number of columns of B and C.
+ * @param band The nonzero columns of each row of B, see nonzero_columns().
+ * @param tile The size of the tiles in both dimensions.
+ */
+template <class Type>
+void add_product(const Type *a, const Type *b, Type *c, size_t nrows,
+                 size_t ninner, size_t ncols,
+                 const std::vector<std::pair<size_t, size_t>> &band,
+                 size_t tile = 64) {
+  std::vector<size_t> offset(ninner);
+  for (size_t k = 0; k < ninner; k++) {
+    offset[k] = k * ncols + band[k].first;
+  }
+  add_product(a, b, c, nrows, ninner, ncols, band, offset, tile);
+}
+
+#if defined(TMB_MODEL) && defined(TMBAD_FRAMEWORK)
+/**
+ * @brief TMB atomic versions of the kernels. Derivatives of any order are
+ * available because the reverse sweeps are written with Type and are taped
+ * when TMB differentiates them.
+ */
+namespace atomic {
+TMB_ATOMIC_VECTOR_FUNCTION(
+    // ATOMIC_NAME
+    baranov_catch,
+    // OUTPUT_DIM
+    tx.size() / 3,
+    // ATOMIC_DOUBLE
+    fims_math::baranov_catch_forward<double>(tx, ty),
+    // ATOMIC_REVERSE
+    fims_math::baranov_catch_reverse<Type>(tx, py, px))
+
+TMB_ATOMIC_VECTOR_FUNCTION(
+    // ATOMIC_NAME
+    survival_step,
+    // OUTPUT_DIM
+    tx.size() / 2 - 1,
+    // ATOMIC_DOUBLE
+    fims_math::survival_step_forward<double>(tx, ty),
+    // ATOMIC_REVERSE
+    fims_math::survival_step_reverse<Type>(tx, py, px))
+
+TMB_ATOMIC_VECTOR_FUNCTION(
+    // ATOMIC_NAME
+    normalize,
+    // OUTPUT_DIM
+    tx.size(),
+    // ATOMIC_DOUBLE
+    fims_math::normalize_forward<double>(tx, ty),
+    // ATOMIC_REVERSE
+    fims_math::normalize_reverse<Type>(tx, ty, py, px))
+}  // namespace atomic
+
+/**
+ * @brief Calls a TMB atomic function on a std::vector.
+ */
+template <class Function>
+std::vector<TMBad::ad_aug> call_atomic(
+    Function f, const std::vector<TMBad::ad_aug> &x) {
+  CppAD::vector<TMBad::ad_aug> tx(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    tx[i] = x[i];
+  }
+  CppAD::vector<TMBad::ad_aug> ty = f(tx);
+  std::vector<TMBad::ad_aug> y(ty.size());
+  for (size_t i = 0; i < y.size(); i++) {
+    y[i] = ty[i];
+  }
+  return y;
+}
+#endif
+
+/**
+ * @brief Baranov catch at age, see baranov_catch_forward().
+ *
+ * @param tx The inputs, folded as [F, Z, N].
+ * @return The catch at age.
+ */
+template <class Type>
+std::vector<Type> baranov_catch(const std::vector<Type> &tx) {
+  std::vector<Type> ty(tx.size() / 3);
+  baranov_catch_forward<Type>(tx, ty);
+  return ty;
+}
+
+/**
+ * @brief Numbers at age after one year, see survival_step_forward().
+ *
+ * @param tx The inputs, folded as [N, Z].
+ * @return The numbers at ages 1 to nages - 1.
+ */
+template <class Type>
+std::vector<Type> survival_step(const std::vector<Type> &tx) {
+  std::vector<Type> ty(tx.size() / 2 - 1);
+  survival_step_forward<Type>(tx, ty);
+  return ty;
+}
+
+/**
+ * @brief Proportions of a composition, see normalize_forward().
+ *
+ * @param tx The composition.
+ * @return The proportions.
+ */
+template <class Type>
+std::vector<Type> normalize(const std::vector<Type> &tx) {
+  std::vector<Type> ty(tx.size());
+  normalize_forward<Type>(tx, ty);
+  return ty;
+}
+
+#if defined(TMB_MODEL) && defined(TMBAD_FRAMEWORK)
+/**
+ * @brief Baranov catch at age as one atomic tape operation.
+ */
+inline std::vector<TMBad::ad_aug> baranov_catch(
+    const std::vector<TMBad::ad_aug> &tx) {
+  return call_atomic(
+      [](const CppAD::vector<TMBad::ad_aug> &x) {
+        return atomic::baranov_catch(x);
+      },
+      tx);
+}
+
+/**
+ * @brief The survival step as one atomic tape operation.
+ */
+inline std::vector<TMBad::ad_aug> survival_step(
+    const std::vector<TMBad::ad_aug> &tx) {
+  return call_atomic(
+      [](const CppAD::vector<TMBad::ad_aug> &x) {
+        return atomic::survival_step(x);
+      },
+      tx);
+}
+
+/**
+ * @brief Normalization of a composition as one atomic tape operation.
+ */
+inline std::vector<TMBad::ad_aug> normalize(
+    const std::vector<TMBad::ad_aug> &tx) {
+  return call_atomic(
+      [](const CppAD::vector<TMBad::ad_aug> &x) {
+        return atomic::normalize(x);
+      },
+      tx);
+}
+#endif
+
+}  // namespace fims_math
+
+#endif /* FIMS_COMMON_FIMS_KERNELS_HPP */
@@ -269,6 +269,208 @@ inline const Type double_logistic(const Type &inflection_point_asc,
                exp(Type(-1.0) * slope_desc * (x - inflection_point_desc))));
 }
 
+/**
+ * @brief The exponential function of each element of an array.
+ *
+ * @details The batched functions below evaluate one function for n values at
+ * once, so a module can fill a whole vector with one call instead of one
+ * virtual call per element. For AD types they are plain loops over the scalar
+ * functions. For double they are written as independent element-wise loops
+ * marked for SIMD, which the compiler vectorizes, with AVX2 or AVX-512 when
+ * the target allows it and a vector math library provides exp and log, and
+ * runs as scalar loops otherwise. out may be the same array as the input.
+ *
+ * @param x The values, of length n.
+ * @param out The exponentiated values, of length n.
+ * @param n The number of values.
+ */
+template <class Type>
+inline void exp(const Type *x, Type *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = fims_math::exp(x[i]);
+  }
+}
+
+/**
+ * @brief The exponential function of each element of an array of doubles.
+ *
+ * @param x The values, of length n.
+ * @param out The exponentiated values, of length n.
+ * @param n The number of values.
+ */
+inline void exp(const double *x, double *out, size_t n) {
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[i] = std::exp(x[i]);
+  }
+}
+
+/**
+ * @brief The natural log of each element of an array.
+ *
+ * @param x The values, of length n.
+ * @param out The logs, of length n.
+ * @param n The number of values.
+ */
+template <class Type>
+inline void log(const Type *x, Type *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = fims_math::log(x[i]);
+  }
+}
+
+/**
+ * @brief The natural log of each element of an array of doubles.
+ *
+ * @param x The values, of length n.
+ * @param out The logs, of length n.
+ * @param n The number of values.
+ */
+inline void log(const double *x, double *out, size_t n) {
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[i] = std::log(x[i]);
+  }
+}
+
+/**
+ * @brief The logistic function at each element of an array, see
+ * logistic(const Type &, const Type &, const Type &).
+ *
+ * @param inflection_point the inflection point of the logistic function
+ * @param slope the slope of the logistic function
+ * @param x The values the function is evaluated at, e.g., ages, of length n.
+ * @param out The function values, of length n.
+ * @param n The number of values.
+ */
+template <class Type>
+inline void logistic(const Type &inflection_point, const Type &slope,
+                     const double *x, Type *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = fims_math::logistic(inflection_point, slope, Type(x[i]));
+  }
+}
+
+/**
+ * @brief The logistic function at each element of an array of doubles.
+ *
+ * @param inflection_point the inflection point of the logistic function
+ * @param slope the slope of the logistic function
+ * @param x The values the function is evaluated at, e.g., ages, of length n.
+ * @param out The function values, of length n.
+ * @param n The number of values.
+ */
+inline void logistic(const double &inflection_point, const double &slope,
+                     const double *x, double *out, size_t n) {
+  const double ip = inflection_point;
+  const double s = slope;
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[i] = 1.0 / (1.0 + std::exp(-s * (x[i] - ip)));
+  }
+}
+
+/**
+ * @brief The inverse logit function of each element of an array, see
+ * inv_logit(const Type &, const Type &, const Type &).
+ *
+ * @param a lower bound
+ * @param b upper bound
+ * @param logit_x The parameters in real space, of length n.
+ * @param out The parameters in bounded space, of length n.
+ * @param n The number of values.
+ */
+template <class Type>
+inline void inv_logit(const Type &a, const Type &b, const Type *logit_x,
+                      Type *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = fims_math::inv_logit(a, b, logit_x[i]);
+  }
+}
+
+/**
+ * @brief The inverse logit function of each element of an array of doubles.
+ *
+ * @param a lower bound
+ * @param b upper bound
+ * @param logit_x The parameters in real space, of length n.
+ * @param out The parameters in bounded space, of length n.
+ * @param n The number of values.
+ */
+inline void inv_logit(const double &a, const double &b, const double *logit_x,
+                      double *out, size_t n) {
+  const double lower = a;
+  const double range = b - a;
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[i] = lower + range / (1.0 + std::exp(-logit_x[i]));
+  }
+}
+
+/**
+ * @brief The double logistic function at each element of an array, see
+ * double_logistic(const Type &, const Type &, const Type &, const Type &,
+ * const Type &).
+ *
+ * @param inflection_point_asc the inflection point of the ascending limb
+ * @param slope_asc the slope of the ascending limb
+ * @param inflection_point_desc the inflection point of the descending limb
+ * @param slope_desc the slope of the descending limb
+ * @param x The values the function is evaluated at, e.g., ages, of length n.
+ * @param out The function values, of length n.
+ * @param n The number of values.
+ */
+template <class Type>
+inline void double_logistic(const Type &inflection_point_asc,
+                            const Type &slope_asc,
+                            const Type &inflection_point_desc,
+                            const Type &slope_desc, const double *x, Type *out,
+                            size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = fims_math::double_logistic(inflection_point_asc, slope_asc,
+                                        inflection_point_desc, slope_desc,
+                                        Type(x[i]));
+  }
+}
+
+/**
+ * @brief The double logistic function at each element of an array of
+ * doubles.
+ *
+ * @param inflection_point_asc the inflection point of the ascending limb
+ * @param slope_asc the slope of the ascending limb
+ * @param inflection_point_desc the inflection point of the descending limb
+ * @param slope_desc the slope of the descending limb
+ * @param x The values the function is evaluated at, e.g., ages, of length n.
+ * @param out The function values, of length n.
+ * @param n The number of values.
+ */
+inline void double_logistic(const double &inflection_point_asc,
+                            const double &slope_asc,
+                            const double &inflection_point_desc,
+                            const double &slope_desc, const double *x,
+                            double *out, size_t n) {
+  const double ip_asc = inflection_point_asc;
+  const double s_asc = slope_asc;
+  const double ip_desc = inflection_point_desc;
+  const double s_desc = slope_desc;
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[i] = 1.0 / (1.0 + std::exp(-s_asc * (x[i] - ip_asc))) *
+             (1.0 - 1.0 / (1.0 + std::exp(-s_desc * (x[i] - ip_desc))));
+  }
+}
+
 /**
  *
  * Used when x could evaluate to zero, which will result in a NaN for
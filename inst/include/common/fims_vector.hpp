@@ -9,9 +9,84 @@
 #define FIMS_VECTOR_HPP
 
 #include "../interface/interface.hpp"
+#include "fims_allocator.hpp"
+#include <memory>
 #include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 namespace fims {
 
+/**
+ * @brief A view of a contiguous range of elements owned by something else,
+ * e.g., a fims::Vector or one year of a derived quantity. The view does not
+ * copy the elements and is invalidated when the owner reallocates.
+ *
+ * @tparam Type The element type, const for a read-only view.
+ */
+template <typename Type>
+class Span {
+  Type* data_m = nullptr; /*!< the first element */
+  size_t size_m = 0;      /*!< the number of elements */
+
+ public:
+  typedef Type element_type; /*!< the element type */
+  typedef typename std::remove_cv<Type>::type value_type; /*!< the value type */
+  typedef Type* iterator; /*!< iterator */
+
+  Span() {}
+
+  /**
+   * @brief A view of size elements starting at data.
+   */
+  Span(Type* data, size_t size) : data_m(data), size_m(size) {}
+
+  /**
+   * @brief Converts a view to a read-only view.
+   */
+  template <typename T, typename = typename std::enable_if<
+                            std::is_convertible<T (*)[], Type (*)[]>::value>::type>
+  Span(const Span<T>& other) : data_m(other.data()), size_m(other.size()) {}
+
+  /**
+   * @brief Returns a reference to the element at pos. No bounds checking is
+   * performed.
+   */
+  inline Type& operator[](size_t pos) const { return this->data_m[pos]; }
+
+  /**
+   * @brief Returns a pointer to the first element.
+   */
+  inline Type* data() const { return this->data_m; }
+
+  /**
+   * @brief Returns the number of elements.
+   */
+  inline size_t size() const { return this->size_m; }
+
+  /**
+   * @brief Checks whether the view is empty.
+   */
+  inline bool empty() const { return this->size_m == 0; }
+
+  /**
+   * @brief Returns an iterator to the first element.
+   */
+  inline iterator begin() const { return this->data_m; }
+
+  /**
+   * @brief Returns an iterator to the element following the last element.
+   */
+  inline iterator end() const { return this->data_m + this->size_m; }
+
+  /**
+   * @brief A view of count elements starting at offset.
+   */
+  inline Span subspan(size_t offset, size_t count) const {
+    return Span(this->data_m + offset, count);
+  }
+};
+
 /**
  * Wrapper class for std::vector types. If this file is compiled with
  * -DTMB_MODEL, conversion operators are defined for TMB vector types.
@@ -20,42 +95,53 @@ namespace fims {
  * these may not be called explicitly in FIMS, they may be required to run other
  * std library functions.
  *
+ * The vector is movable, so assigning a temporary to a derived quantity or
+ * returning one from a function does not copy the elements. The allocator can
+ * be replaced, e.g., with fims::AlignedAllocator. The default,
+ * fims::ArenaAllocator, takes the storage from the arena of the model being
+ * built, see fims::ArenaScope, and from the heap otherwise.
+ *
+ * Only fims::Vector<Type, std::allocator<Type> > moves its storage to and
+ * from std::vector<Type>. With any other allocator, including the default,
+ * the conversions copy the elements.
  */
-template <typename Type>
+template <typename Type, typename Alloc = fims::ArenaAllocator<Type> >
 class Vector {
-  std::vector<Type> vec_m;
+  std::vector<Type, Alloc> vec_m;
 
   /**
    * @brief friend comparison operator. Allows the operator to see private
    * members of fims::Vector<Type>.
    */
-  template <typename T>
-  friend bool operator==(const fims::Vector<T>& lhs,
-                         const fims::Vector<T>& rhs);
+  template <typename T, typename A>
+  friend bool operator==(const fims::Vector<T, A>& lhs,
+                         const fims::Vector<T, A>& rhs);
 
  public:
   // Member Types
 
-  typedef
-      typename std::vector<Type>::value_type value_type; /*!<Member type Type>*/
-  typedef typename std::vector<Type>::allocator_type
+  typedef typename std::vector<Type, Alloc>::value_type
+      value_type; /*!<Member type Type>*/
+  typedef typename std::vector<Type, Alloc>::allocator_type
       allocator_type; /*!<Allocator for type Type>*/
-  typedef typename std::vector<Type>::size_type size_type; /*!<Size type>*/
-  typedef typename std::vector<Type>::difference_type
+  typedef
+      typename std::vector<Type, Alloc>::size_type size_type; /*!<Size type>*/
+  typedef typename std::vector<Type, Alloc>::difference_type
       difference_type; /*!<Difference type>*/
-  typedef typename std::vector<Type>::reference
+  typedef typename std::vector<Type, Alloc>::reference
       reference; /*!<Reference type &Type>*/
-  typedef typename std::vector<Type>::const_reference
+  typedef typename std::vector<Type, Alloc>::const_reference
       const_reference; /*!<Constant reference type const &Type>*/
-  typedef typename std::vector<Type>::pointer pointer; /*!<Pointer type Type*>*/
-  typedef typename std::vector<Type>::const_pointer
+  typedef typename std::vector<Type, Alloc>::pointer
+      pointer; /*!<Pointer type Type*>*/
+  typedef typename std::vector<Type, Alloc>::const_pointer
       const_pointer; /*!<Constant pointer type const Type*>*/
-  typedef typename std::vector<Type>::iterator iterator; /*!<Iterator>*/
-  typedef typename std::vector<Type>::const_iterator
+  typedef typename std::vector<Type, Alloc>::iterator iterator; /*!<Iterator>*/
+  typedef typename std::vector<Type, Alloc>::const_iterator
       const_iterator; /*!<Constant iterator>*/
-  typedef typename std::vector<Type>::reverse_iterator
+  typedef typename std::vector<Type, Alloc>::reverse_iterator
       reverse_iterator; /*!<Reverse iterator>*/
-  typedef typename std::vector<Type>::const_reverse_iterator
+  typedef typename std::vector<Type, Alloc>::const_reverse_iterator
       const_reverse_iterator; /*!<Constant reverse iterator>*/
 
   // Constructors
@@ -65,41 +151,66 @@ class Vector {
    */
   Vector() {}
 
+  /**
+   * @brief Constructs an empty Vector that allocates with alloc.
+   */
+  explicit Vector(const Alloc& alloc) : vec_m(alloc) {}
+
   /**
    * @brief Constructs a Vector of length "size" and sets the elements with the
    * value from input "value".
    */
-  Vector(size_t size, const Type& value = Type()) {
-    this->vec_m.resize(size, value);
-  }
+  Vector(size_t size, const Type& value = Type(), const Alloc& alloc = Alloc())
+      : vec_m(size, value, alloc) {}
 
   /**
    * @brief Copy constructor.
    */
-  Vector(const Vector<Type>& other) {
-    this->vec_m.resize(other.size());
-    for (size_t i = 0; i < this->vec_m.size(); i++) {
-      this->vec_m[i] = other[i];
-    }
-  }
+  Vector(const Vector& other) = default;
+
+  /**
+   * @brief Move constructor. The elements are not copied.
+   */
+  Vector(Vector&& other) noexcept = default;
+
+  /**
+   * @brief Copy assignment.
+   */
+  Vector& operator=(const Vector& other) = default;
+
+  /**
+   * @brief Move assignment. The elements are not copied.
+   */
+  Vector& operator=(Vector&& other) noexcept = default;
 
   /**
    * @brief Initialization constructor from std::vector<Type> type.
    */
-  Vector(const std::vector<Type>& other) { this->vec_m = other; }
+  Vector(const std::vector<Type, Alloc>& other) : vec_m(other) {}
+
+  /**
+   * @brief Initialization constructor that takes over the storage of a
+   * std::vector<Type> with the same allocator.
+   */
+  Vector(std::vector<Type, Alloc>&& other) noexcept : vec_m(std::move(other)) {}
+
+  /**
+   * @brief Initialization constructor from a std::vector<Type> with another
+   * allocator. The elements are copy-constructed into this vector's storage.
+   */
+  template <typename A>
+  Vector(const std::vector<Type, A>& other)
+      : vec_m(other.begin(), other.end()) {}
 
   // TMB specific constructor
 #ifdef TMB_MODEL
 
   /**
-   * @brief Initialization constructor from tmbutils::vector<Type> type.
+   * @brief Initialization constructor from tmbutils::vector<Type> type. The
+   * elements are copy-constructed from the TMB storage.
    */
-  Vector(const tmbutils::vector<Type>& other) {
-    this->vec_m.resize(other.size());
-    for (size_t i = 0; i < this->vec_m.size(); i++) {
-      this->vec_m[i] = other[i];
-    }
-  }
+  Vector(const tmbutils::vector<Type>& other)
+      : vec_m(other.data(), other.data() + other.size()) {}
 
 #endif
 
@@ -183,6 +294,40 @@ class Vector {
    */
   inline const_pointer data() const { return this->vec_m.data(); }
 
+  /**
+   * @brief Returns a view of the elements.
+   */
+  inline Span<Type> span() { return Span<Type>(this->data(), this->size()); }
+
+  /**
+   * @brief Returns a read-only view of the elements.
+   */
+  inline Span<const Type> span() const {
+    return Span<const Type>(this->data(), this->size());
+  }
+
+  /**
+   * @brief Returns a view of count elements starting at offset, e.g., one year
+   * of a vector indexed by year and age.
+   */
+  inline Span<Type> span(size_t offset, size_t count) {
+    return Span<Type>(this->data() + offset, count);
+  }
+
+  /**
+   * @brief Returns a read-only view of count elements starting at offset.
+   */
+  inline Span<const Type> span(size_t offset, size_t count) const {
+    return Span<const Type>(this->data() + offset, count);
+  }
+
+  /**
+   * @brief Returns the allocator.
+   */
+  inline allocator_type get_allocator() const {
+    return this->vec_m.get_allocator();
+  }
+
   // iterators
 
   /**
@@ -196,6 +341,17 @@ class Vector {
    */
   inline iterator end() { return this->vec_m.end(); }
 
+  /**
+   * @brief Returns a constant iterator to the first element of the vector.
+   */
+  inline const_iterator begin() const { return this->vec_m.begin(); }
+
+  /**
+   * @brief Returns a constant iterator to the element following the last
+   * element of the vector.
+   */
+  inline const_iterator end() const { return this->vec_m.end(); }
+
   /**
    * @brief Returns a reverse iterator to the first element of the reversed
    * vector. It corresponds to the last element of the non-reversed vector.
@@ -249,7 +405,7 @@ class Vector {
    * @brief Returns the number of elements that can be held in currently
    * allocated storage.
    */
-  inline size_type capacity() { return this->vec_m.capacity(); }
+  inline size_type capacity() const { return this->vec_m.capacity(); }
 
   /**
    *  @brief Reduces memory usage by freeing unused memory.
@@ -317,7 +473,14 @@ class Vector {
   /**
    * @brief Adds an element to the end.
    */
-  inline void push_back(const Type&& value) { this->vec_m.push_back(value); }
+  inline void push_back(const Type& value) { this->vec_m.push_back(value); }
+
+  /**
+   * @brief Moves an element to the end.
+   */
+  inline void push_back(Type&& value) {
+    this->vec_m.push_back(std::move(value));
+  }
 
   /**
    * @brief Constructs an element in-place at the end.
@@ -351,32 +514,33 @@ class Vector {
   /**
    * @brief Converts fims::Vector<Type> to std::vector<Type>
    */
-  inline operator std::vector<Type>() { return this->vec_m; }
-
-#ifdef TMB_MODEL
+  inline operator std::vector<Type>() const& {
+    return std::vector<Type>(this->vec_m.begin(), this->vec_m.end());
+  }
 
   /**
-   * @brief Converts fims::Vector<Type> to tmbutils::vector<Type>const
+   * @brief Converts a temporary fims::Vector<Type> to std::vector<Type>,
+   * moving the storage if the allocator is std::allocator<Type> and copying
+   * the elements otherwise.
    */
-  operator tmbutils::vector<Type>() const {
-    tmbutils::vector<Type> ret;
-    ret.resize(this->vec_m.size());
-    for (size_t i = 0; i < this->vec_m.size(); i++) {
-      ret[i] = this->vec_m[i];
+  inline operator std::vector<Type>() && {
+    if constexpr (std::is_same<Alloc, std::allocator<Type> >::value) {
+      return std::move(this->vec_m);
+    } else {
+      return std::vector<Type>(this->vec_m.begin(), this->vec_m.end());
     }
-    return ret;
   }
 
+#ifdef TMB_MODEL
+
   /**
-   * @brief Converts fims::Vector<Type> to tmbutils::vector<Type>
+   * @brief Converts fims::Vector<Type> to tmbutils::vector<Type>, copying the
+   * elements directly from the contiguous storage.
    */
-  operator tmbutils::vector<Type>() {
-    tmbutils::vector<Type> ret;
-    ret.resize(this->vec_m.size());
-    for (size_t i = 0; i < this->vec_m.size(); i++) {
-      ret[i] = this->vec_m[i];
-    }
-    return ret;
+  operator tmbutils::vector<Type>() const {
+    typedef Eigen::Array<Type, Eigen::Dynamic, 1> array;
+    return tmbutils::vector<Type>(
+        Eigen::Map<const array>(this->vec_m.data(), this->vec_m.size()));
   }
 
 #endif
@@ -387,8 +551,8 @@ class Vector {
 /**
  * @brief Comparison operator.
  */
-template <class T>
-bool operator==(const fims::Vector<T>& lhs, const fims::Vector<T>& rhs) {
+template <class T, class A>
+bool operator==(const fims::Vector<T, A>& lhs, const fims::Vector<T, A>& rhs) {
   return lhs.vec_m == rhs.vec_m;
 }
 
@@ -401,8 +565,9 @@ bool operator==(const fims::Vector<T>& lhs, const fims::Vector<T>& rhs) {
  * @param v A vector.
  * @return std::ostream&
  */
-template <typename Type>
-std::ostream& operator<<(std::ostream& out, const fims::Vector<Type>& v) {
+template <typename Type, typename Alloc>
+std::ostream& operator<<(std::ostream& out,
+                         const fims::Vector<Type, Alloc>& v) {
   out << "[";
 
   if (v.size() == 0) {
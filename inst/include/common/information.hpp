@@ -11,6 +11,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 #include <algorithm>
 
@@ -37,6 +38,12 @@ class Information {
   size_t nyears = 0;   /**< number of years >*/
   size_t nseasons = 1; /**< number of seasons >*/
   size_t nages = 0;    /**< number of ages>*/
+  bool valid_model = true; /**< false if CreateModel() found errors; an
+                              invalid model is not evaluated >*/
+  size_t data_revision = 0; /**< incremented each time observed data are
+                               changed in place, so an incremental evaluation
+                               knows not to reuse derived quantities computed
+                               from the old values >*/
 
   static std::shared_ptr<Information<Type>>
       fims_information;           /**< singleton instance >*/
@@ -152,6 +159,14 @@ class Information {
   typedef typename std::unordered_map<uint32_t, fims::Vector<Type> *>::iterator
       variable_map_iterator; /**< iterator for variable map>*/
 
+  std::shared_ptr<fims::Arena<Type>> arena =
+      std::make_shared<fims::Arena<Type>>(); /**< holds the vectors of the
+                                                modules added while it is in
+                                                scope, see ArenaScope */
+  std::map<uint32_t, std::shared_ptr<fims::Arena<Type>>>
+      model_arenas; /**< holds the derived quantities of each model by id,
+                       which the model resets in one pass */
+
   Information() {}
 
   virtual ~Information() {}
@@ -175,9 +190,13 @@ class Information {
     this->recruitment_process_models.clear();
     this->selectivity_models.clear();
     this->models_map.clear();
+    // the arenas are released together, once the last vector in them is gone
+    this->model_arenas.clear();
+    this->arena = std::make_shared<fims::Arena<Type>>();
     this->nyears = 0;
     this->nseasons = 0;
     this->nages = 0;
+    this->valid_model = true;
 
     for (density_components_iterator it = density_components.begin();
          it != density_components.end(); ++it) {
@@ -329,6 +348,31 @@ class Information {
     }
   }
 
+  /**
+   * @brief Checks that a data object linked to a fleet holds at least the
+   * number of values the fleet reads from it. The check is done once, when the
+   * model is created, so the evaluation reads the data without bounds checks.
+   *
+   * @param &valid_model reference to true/false boolean indicating whether
+   * model is valid.
+   * @param d the data object
+   * @param expected the number of values the fleet reads
+   * @param name the kind of data, for the error message
+   * @param fleet_id the id of the fleet
+   */
+  void CheckDataSize(bool &valid_model,
+                     const std::shared_ptr<fims_data_object::DataObject<Type>> &d,
+                     size_t expected, const std::string &name,
+                     uint32_t fleet_id) {
+    if (d->data.size() < expected) {
+      valid_model = false;
+      FIMS_ERROR_LOG(name + " data " + fims::to_string(d->id) + " for fleet " +
+                     fims::to_string(fleet_id) + " has " +
+                     fims::to_string(d->data.size()) + " values but " +
+                     fims::to_string(expected) + " are expected.");
+    }
+  }
+
   /**
    * @brief Set pointers to landings data in the fleet module.
    *
@@ -344,6 +388,8 @@ class Information {
       data_iterator it = this->data_objects.find(observed_landings_id);
       if (it != this->data_objects.end()) {
         f->observed_landings_data = (*it).second;
+        this->CheckDataSize(valid_model, f->observed_landings_data, f->nyears,
+                            "Landings", f->id);
         FIMS_INFO_LOG("Landings data for fleet " + fims::to_string(f->id) +
                       " successfully set to " +
                       fims::to_string(f->observed_landings_data->at(1)));
@@ -371,6 +417,8 @@ class Information {
       data_iterator it = this->data_objects.find(observed_index_id);
       if (it != this->data_objects.end()) {
         f->observed_index_data = (*it).second;
+        this->CheckDataSize(valid_model, f->observed_index_data, f->nyears,
+                            "Index", f->id);
         FIMS_INFO_LOG("Index data for fleet " + fims::to_string(f->id) +
                       " successfully set to " +
                       fims::to_string(f->observed_index_data->at(1)));
@@ -398,6 +446,8 @@ class Information {
       data_iterator it = this->data_objects.find(observed_agecomp_id);
       if (it != this->data_objects.end()) {
         f->observed_agecomp_data = (*it).second;
+        this->CheckDataSize(valid_model, f->observed_agecomp_data,
+                            f->nyears * f->nages, "Age-composition", f->id);
         FIMS_INFO_LOG("Observed input age-composition data for fleet " +
                       fims::to_string(f->id) + " successfully set to " +
                       fims::to_string(f->observed_agecomp_data->at(1)));
@@ -425,6 +475,9 @@ class Information {
       data_iterator it = this->data_objects.find(observed_lengthcomp_id);
       if (it != this->data_objects.end()) {
         f->observed_lengthcomp_data = (*it).second;
+        this->CheckDataSize(valid_model, f->observed_lengthcomp_data,
+                            f->nyears * f->nlengths, "Length-composition",
+                            f->id);
         FIMS_INFO_LOG("Observed input length-composition data for fleet " +
                       fims::to_string(f->id) + " successfully set to " +
                       fims::to_string(f->observed_lengthcomp_data->at(1)));
@@ -615,6 +668,14 @@ class Information {
         FIMS_INFO_LOG("Growth model " + fims::to_string(growth_uint) +
                       " successfully set to population " +
                       fims::to_string(p->id));
+        if (!p->growth->IsValid(p->nyears, p->nages)) {
+          valid_model = false;
+          FIMS_ERROR_LOG("Growth model " + fims::to_string(growth_uint) +
+                         " does not have a weight for each of the " +
+                         fims::to_string(p->nyears) + " years and " +
+                         fims::to_string(p->nages) + " ages of population " +
+                         fims::to_string(p->id));
+        }
       } else {
         valid_model = false;
         FIMS_ERROR_LOG("Expected growth function not defined for population " +
@@ -664,6 +725,39 @@ class Information {
     }
   }
 
+  /**
+   * @brief Check that the layout of the natural mortality of a population was
+   * read and that it has one value for each distinct value of the layout.
+   *
+   * @param &valid_model reference to true/false boolean indicating whether
+   * model is valid.
+   * @param p shared pointer to population module
+   */
+  void SetNaturalMortality(bool &valid_model,
+                           std::shared_ptr<fims_popdy::Population<Type>> p) {
+    p->M_layout.Resize(p->nyears, p->nages);
+    if (!p->M_layout.readable) {
+      valid_model = false;
+      FIMS_ERROR_LOG("Natural mortality of population " +
+                     fims::to_string(p->id) +
+                     " has an unknown M_structure or a negative year block.");
+    } else if (!p->M_layout.IsValid()) {
+      valid_model = false;
+      FIMS_ERROR_LOG("Natural mortality of population " +
+                     fims::to_string(p->id) + " has " +
+                     fims::to_string(p->M_layout.year_block.size()) +
+                     " year blocks but " + fims::to_string(p->nyears) +
+                     " years.");
+    } else if (p->log_M.size() != p->M_layout.Size()) {
+      valid_model = false;
+      FIMS_ERROR_LOG("Natural mortality of population " +
+                     fims::to_string(p->id) + " has " +
+                     fims::to_string(p->log_M.size()) + " values but " +
+                     fims::to_string(p->M_layout.Size()) +
+                     " are expected for its structure.");
+    }
+  }
+
   /**
    * @brief Loop over all fleets and set pointers to fleet objects
    *
@@ -709,6 +803,12 @@ class Information {
 
           if (it != this->data_objects.end()) {
             d->observed_values = (*it).second;
+            if (!d->observed_values->IsValid()) {
+              valid_model = false;
+              FIMS_ERROR_LOG("Observed data " +
+                             fims::to_string(observed_data_id) +
+                             " does not match its dimensions.");
+            }
             FIMS_INFO_LOG("Observed data " + fims::to_string(observed_data_id) +
                           " successfully set to density component " +
                           fims::to_string(d->id));
@@ -797,6 +897,74 @@ class Information {
       SetGrowth(valid_model, p);
 
       SetMaturity(valid_model, p);
+
+      SetNaturalMortality(valid_model, p);
+    }
+  }
+
+  /**
+   * @brief Check that each fleet with hybrid F and linked landings data has
+   * landings in every year. Also called by UpdateDataObject(), since the
+   * landings can change after CreateModel().
+   *
+   * @param &valid_model reference to true/false boolean indicating whether
+   * the landings are valid.
+   */
+  void CheckHybridFLandings(bool &valid_model) {
+    for (fleet_iterator it = this->fleets.begin(); it != this->fleets.end();
+         ++it) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> f = (*it).second;
+      if (!f->hybrid_F || f->observed_landings_data == nullptr) {
+        continue;
+      }
+      for (size_t y = 0; y < f->nyears; y++) {
+        if (fims::value_of(f->observed_landings_data->at(y)) ==
+            fims::value_of(f->observed_landings_data->na_value)) {
+          valid_model = false;
+          FIMS_ERROR_LOG("Fleet " + fims::to_string(f->id) +
+                         " has hybrid F but its landings are missing in "
+                         "year " +
+                         fims::to_string(y) +
+                         "; hybrid F needs landings in every year.");
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Check that each fleet with hybrid F has landings data in every
+   * year and belongs to one population, since its F is solved from the
+   * landings and the numbers at age of that population. Its log_Fmort is not
+   * estimated, so a year with missing landings would have no F to use.
+   *
+   * @param &valid_model reference to true/false boolean indicating whether
+   * model is valid.
+   */
+  void CheckHybridF(bool &valid_model) {
+    CheckHybridFLandings(valid_model);
+    for (fleet_iterator it = this->fleets.begin(); it != this->fleets.end();
+         ++it) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> f = (*it).second;
+      if (!f->hybrid_F) {
+        continue;
+      }
+      if (f->observed_landings_data == nullptr) {
+        valid_model = false;
+        FIMS_ERROR_LOG("Fleet " + fims::to_string(f->id) +
+                       " has hybrid F but no landings data.");
+      }
+      size_t npopulations = 0;
+      for (population_iterator pt = this->populations.begin();
+           pt != this->populations.end(); ++pt) {
+        npopulations += (*pt).second->fleet_ids.count(f->id);
+      }
+      if (npopulations != 1) {
+        valid_model = false;
+        FIMS_ERROR_LOG("Fleet " + fims::to_string(f->id) +
+                       " has hybrid F but is in " +
+                       fims::to_string(npopulations) +
+                       " populations; hybrid F needs exactly one.");
+      }
     }
   }
 
@@ -825,10 +993,65 @@ class Information {
                          fims::to_string(model->GetId()));
         }
       }
+      // the derived quantities are laid out one after another in the
+      // model's arena
+      std::shared_ptr<fims::Arena<Type>> model_arena =
+          std::make_shared<fims::Arena<Type>>();
+      this->model_arenas[model->GetId()] = model_arena;
+      model->arena = model_arena;
+      fims::ArenaScope<Type> scope(model_arena);
       model->Initialize();
     }
   }
 
+  /**
+   * @brief Loop over all fleets and find the band of length bins each age can
+   * be in from the nonzero elements of the age-length key. Estimated elements
+   * stay in the band even if they start at zero.
+   */
+  void SetupLengthKeys() {
+    std::set<const Type *> estimated(this->fixed_effects_parameters.begin(),
+                                     this->fixed_effects_parameters.end());
+    estimated.insert(this->random_effects_parameters.begin(),
+                     this->random_effects_parameters.end());
+    for (fleet_iterator it = this->fleets.begin(); it != this->fleets.end();
+         ++it) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> &f = (*it).second;
+      if (f->nlengths > 0 && f->age_to_length_conversion.size() ==
+                                 static_cast<size_t>(f->nages * f->nlengths)) {
+        f->SetupLengthKey(estimated);
+        FIMS_INFO_LOG("Age-length key of fleet " + fims::to_string(f->id) +
+                      " stores " +
+                      fims::to_string(f->length_key.values.size()) + " of " +
+                      fims::to_string(f->nages * f->nlengths) + " elements");
+      }
+    }
+  }
+
+  /**
+   * @brief Loop over all models and tell them which derived quantities the
+   * density components are linked to through the variable map, so they can
+   * skip the derived quantities that nothing uses.
+   */
+  void SetupDemand() {
+    std::set<const fims::Vector<Type> *> used;
+    for (density_components_iterator it = this->density_components.begin();
+         it != this->density_components.end(); ++it) {
+      std::shared_ptr<fims_distributions::DensityComponentBase<Type>> d =
+          (*it).second;
+      for (size_t i = 0; i < d->key.size(); i++) {
+        variable_map_iterator vmit = this->variable_map.find(d->key[i]);
+        if (vmit != this->variable_map.end()) {
+          used.insert((*vmit).second);
+        }
+      }
+    }
+    for (model_map_iterator it = this->models_map.begin();
+         it != this->models_map.end(); ++it) {
+      (*it).second->SetDemand(used);
+    }
+  }
+
   /**
    * @brief Create the generalized stock assessment model that will evaluate the
    * objective function. Does error checking to make sure the program has
@@ -844,19 +1067,363 @@ class Information {
 
     CreateFleetObjects(valid_model);
 
+    SetupLengthKeys();
+
     SetDataObjects(valid_model);
 
     CreatePopulationObjects(valid_model);
 
+    CheckHybridF(valid_model);
+
     CreateModelingObjects(valid_model);
 
+    SetupDemand();
+
+    for (model_map_iterator it = this->models_map.begin();
+         it != this->models_map.end(); ++it) {
+      (*it).second->ResolveModules();
+    }
+
     // setup priors, random effect, and data density components
     SetupPriors();
     SetupRandomEffects();
 
+    this->valid_model = valid_model;
     return valid_model;
   }
 
+  /**
+   * @brief Replace the values of an existing data object in place.
+   *
+   * @details The data object keeps its address, so fleets and density
+   * components that were linked to it in CreateModel() see the new values
+   * without the model being rebuilt. The number of values must match the size
+   * of the data object.
+   *
+   * @param id The id of the data object.
+   * @param values The new values, folded in the same order as the data.
+   * @return True if the data object was found and updated, false otherwise.
+   */
+  bool UpdateDataObject(uint32_t id, const std::vector<double> &values) {
+    return this->UpdateDataObject(id,
+                                  std::make_shared<fims::SharedData>(values));
+  }
+
+  /**
+   * @brief Replace the values of an existing data object with a shared
+   * buffer, e.g., one buffer for the data objects of every Information
+   * instance or a file mapped with fims::SharedData::MapFile(). Only the
+   * buffer pointer of the data object changes.
+   *
+   * The update is undone if it leaves a fleet with hybrid F without landings
+   * in a year. A successful update increments data_revision, so the next
+   * incremental evaluation recomputes every derived quantity.
+   *
+   * @param id The id of the data object.
+   * @param buffer The new values, folded in the same order as the data.
+   * @return True if the data object was found and updated, false otherwise.
+   */
+  bool UpdateDataObject(uint32_t id,
+                        const std::shared_ptr<fims::SharedData> &buffer) {
+    data_iterator it = this->data_objects.find(id);
+    if (it == this->data_objects.end()) {
+      FIMS_ERROR_LOG("Data object " + fims::to_string(id) +
+                     " not found, data not updated.");
+      return false;
+    }
+    std::shared_ptr<fims_data_object::DataObject<Type>> &d = (*it).second;
+    if (buffer == nullptr || d->data.size() != buffer->size()) {
+      FIMS_ERROR_LOG("Data object " + fims::to_string(id) + " has " +
+                     fims::to_string(d->data.size()) + " values but " +
+                     fims::to_string(buffer == nullptr ? 0 : buffer->size()) +
+                     " were supplied, data not updated.");
+      return false;
+    }
+    std::shared_ptr<fims::SharedData> previous = d->data.GetBuffer();
+    d->data.SetBuffer(buffer);
+    bool valid_landings = true;
+    this->CheckHybridFLandings(valid_landings);
+    if (!valid_landings) {
+      d->data.SetBuffer(previous);
+      FIMS_ERROR_LOG("Data object " + fims::to_string(id) +
+                     " not updated, a fleet with hybrid F needs landings in "
+                     "every year.");
+      return false;
+    }
+    this->data_revision++;
+    return true;
+  }
+
+  /**
+   * @brief Replace the values of the fixed effects parameters in place.
+   *
+   * @param values The new values, in the order the parameters were registered.
+   * @return True if the parameters were updated, false if the number of values
+   * does not match the number of fixed effects parameters.
+   */
+  bool UpdateFixedEffectsParameters(const std::vector<double> &values) {
+    if (values.size() != this->fixed_effects_parameters.size()) {
+      FIMS_ERROR_LOG("Expected " +
+                     fims::to_string(this->fixed_effects_parameters.size()) +
+                     " fixed effects values but " +
+                     fims::to_string(values.size()) + " were supplied.");
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+      *this->fixed_effects_parameters[i] = static_cast<Type>(values[i]);
+    }
+    this->ClearTransformedParameters();
+    return true;
+  }
+
+  /**
+   * @brief Replace the values of the random effects parameters in place.
+   *
+   * @param values The new values, in the order the random effects were
+   * registered.
+   * @return True if the random effects were updated, false if the number of
+   * values does not match the number of random effects parameters.
+   */
+  bool UpdateRandomEffectsParameters(const std::vector<double> &values) {
+    if (values.size() != this->random_effects_parameters.size()) {
+      FIMS_ERROR_LOG("Expected " +
+                     fims::to_string(this->random_effects_parameters.size()) +
+                     " random effects values but " +
+                     fims::to_string(values.size()) + " were supplied.");
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+      *this->random_effects_parameters[i] = static_cast<Type>(values[i]);
+    }
+    this->ClearTransformedParameters();
+    return true;
+  }
+
+  /**
+   * @brief Marks the cached natural-scale parameters of the recruitment and
+   * depletion modules as out of date, so they are not read until the modules
+   * are transformed again.
+   */
+  void ClearTransformedParameters() {
+    for (recruitment_models_iterator it = this->recruitment_models.begin();
+         it != this->recruitment_models.end(); ++it) {
+      (*it).second->transformed = false;
+    }
+    for (depletion_models_iterator it = this->depletion_models.begin();
+         it != this->depletion_models.end(); ++it) {
+      (*it).second->transformed = false;
+    }
+  }
+
+  /**
+   * @brief Set the observations of the last years of every data object to NA.
+   *
+   * @details The first dimension of a data object is taken as year when its
+   * length equals nyears, e.g., index and landings data (year) and
+   * composition data (year by age or length). Data objects with other shapes
+   * are left as they are. Masked values are skipped by the likelihoods, so a
+   * retrospective peel needs no change to the model structure. Use
+   * UpdateDataObject() to restore the values.
+   *
+   * The landings of a fleet with hybrid F are not masked. Its F is solved
+   * from the landings in every year, so the landings of the removed years
+   * are treated as known, and they still add to the likelihood.
+   *
+   * @param nyears_removed The number of trailing years to mask.
+   * @return The number of values that were masked.
+   */
+  size_t MaskTrailingYears(size_t nyears_removed) {
+    std::set<const fims_data_object::DataObject<Type> *> hybrid_landings;
+    for (fleet_iterator it = this->fleets.begin(); it != this->fleets.end();
+         ++it) {
+      if ((*it).second->hybrid_F) {
+        hybrid_landings.insert((*it).second->observed_landings_data.get());
+      }
+    }
+
+    size_t masked = 0;
+    for (data_iterator it = this->data_objects.begin();
+         it != this->data_objects.end(); ++it) {
+      std::shared_ptr<fims_data_object::DataObject<Type>> &d = (*it).second;
+      if (d->imax != this->nyears || nyears_removed == 0 ||
+          hybrid_landings.count(d.get()) > 0) {
+        continue;
+      }
+      size_t row = d->data.size() / d->imax;
+      size_t first_year = nyears_removed >= this->nyears
+                              ? 0
+                              : this->nyears - nyears_removed;
+      for (size_t i = first_year * row; i < d->data.size(); i++) {
+        d->data[i] = d->na_value;
+        masked++;
+      }
+    }
+    if (masked > 0) {
+      this->data_revision++;
+    }
+    return masked;
+  }
+
+  /**
+   * @brief Adds the storage held by this instance to a memory report: the
+   * parameter lists, the data objects, each module and model by id, and the
+   * arenas. Data buffers shared with other instances are counted once.
+   *
+   * @param report The report. Its type is used to label the records.
+   */
+  void ReportMemory(fims::MemoryReport &report) const {
+    report.AddVector("information", "Information", 0, "parameters",
+                     this->parameters);
+    report.AddVector("information", "Information", 0,
+                     "fixed_effects_parameters",
+                     this->fixed_effects_parameters);
+    report.AddVector("information", "Information", 0,
+                     "random_effects_parameters",
+                     this->random_effects_parameters);
+    typename std::map<
+        uint32_t,
+        std::shared_ptr<fims_data_object::DataObject<Type>>>::const_iterator
+        d_it;
+    for (d_it = this->data_objects.begin(); d_it != this->data_objects.end();
+         ++d_it) {
+      report.AddBuffer("data", "DataObject", (*d_it).first, "data",
+                       (*d_it).second->data.GetBuffer());
+    }
+    Information<Type>::ReportModules(report, this->recruitment_models,
+                                     "Recruitment");
+    Information<Type>::ReportModules(report, this->recruitment_process_models,
+                                     "RecruitmentProcess");
+    Information<Type>::ReportModules(report, this->selectivity_models,
+                                     "Selectivity");
+    Information<Type>::ReportModules(report, this->growth_models, "Growth");
+    Information<Type>::ReportModules(report, this->maturity_models,
+                                     "Maturity");
+    Information<Type>::ReportModules(report, this->depletion_models,
+                                     "Depletion");
+    Information<Type>::ReportModules(report, this->fleets, "Fleet");
+    Information<Type>::ReportModules(report, this->populations, "Population");
+    Information<Type>::ReportModules(report, this->density_components,
+                                     "DensityComponent");
+    Information<Type>::ReportModules(report, this->models_map, "Model");
+    typename std::map<uint32_t,
+                      std::shared_ptr<fims::Arena<Type>>>::const_iterator a_it;
+    for (a_it = this->model_arenas.begin(); a_it != this->model_arenas.end();
+         ++a_it) {
+      report.AddArena("Model", (*a_it).first, (*a_it).second);
+    }
+    report.AddArena("Information", 0, this->arena);
+  }
+
+  /**
+   * @brief Compute a hash of the model structure.
+   *
+   * @details The hash covers everything that determines the shape of the
+   * computational graph: dimensions, module ids and the links between them,
+   * data object sizes, density component types and keys, and the number and
+   * names of the parameters. Observed values and parameter values are not
+   * included, so two models that differ only in their data or starting values
+   * share a hash and can reuse the same tape.
+   *
+   * @return A 64-bit FNV-1a hash of the model structure.
+   */
+  uint64_t GetStructureHash() {
+    uint64_t h = 14695981039346656037ULL;
+
+    HashValue(h, this->nyears);
+    HashValue(h, this->nages);
+    HashValue(h, this->nseasons);
+
+    for (data_iterator it = this->data_objects.begin();
+         it != this->data_objects.end(); ++it) {
+      std::shared_ptr<fims_data_object::DataObject<Type>> &d = (*it).second;
+      HashValue(h, (*it).first);
+      HashValue(h, d->dimensions);
+      HashValue(h, d->data.size());
+    }
+
+    for (fleet_iterator it = this->fleets.begin(); it != this->fleets.end();
+         ++it) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> &f = (*it).second;
+      HashValue(h, f->id);
+      HashValue(h, f->nyears);
+      HashValue(h, f->nages);
+      HashValue(h, f->nlengths);
+      HashValue(h, f->fleet_selectivity_id_m);
+      HashValue(h, f->fleet_observed_landings_data_id_m);
+      HashValue(h, f->fleet_observed_index_data_id_m);
+      HashValue(h, f->fleet_observed_agecomp_data_id_m);
+      HashValue(h, f->fleet_observed_lengthcomp_data_id_m);
+      HashString(h, f->observed_landings_units);
+      HashString(h, f->observed_index_units);
+      HashValue(h, f->log_Fmort.size());
+      HashValue(h, f->hybrid_F);
+      HashValue(h, f->log_q.size());
+    }
+
+    for (population_iterator it = this->populations.begin();
+         it != this->populations.end(); ++it) {
+      std::shared_ptr<fims_popdy::Population<Type>> &p = (*it).second;
+      HashValue(h, p->id);
+      HashValue(h, p->nyears);
+      HashValue(h, p->nages);
+      HashValue(h, p->nseasons);
+      HashValue(h, p->recruitment_id);
+      HashValue(h, p->depletion_id);
+      HashValue(h, p->growth_id);
+      HashValue(h, p->maturity_id);
+      HashValue(h, p->log_M.size());
+      HashValue(h, static_cast<int>(p->M_layout.structure));
+      HashValue(h, p->M_layout.year_block.size());
+      HashValue(h, p->log_init_naa.size());
+      for (std::set<uint32_t>::iterator fit = p->fleet_ids.begin();
+           fit != p->fleet_ids.end(); ++fit) {
+        HashValue(h, *fit);
+      }
+    }
+
+    for (density_components_iterator it = this->density_components.begin();
+         it != this->density_components.end(); ++it) {
+      std::shared_ptr<fims_distributions::DensityComponentBase<Type>> &d =
+          (*it).second;
+      HashValue(h, d->id);
+      HashString(h, d->input_type);
+      HashValue(h, d->observed_data_id_m);
+      HashValue(h, d->x.size());
+      HashValue(h, d->expected_values.size());
+      for (size_t i = 0; i < d->key.size(); i++) {
+        HashValue(h, d->key[i]);
+      }
+    }
+
+    // models_map is unordered, so visit the models by sorted id
+    std::vector<uint32_t> model_ids;
+    for (model_map_iterator it = this->models_map.begin();
+         it != this->models_map.end(); ++it) {
+      model_ids.push_back((*it).first);
+    }
+    std::sort(model_ids.begin(), model_ids.end());
+    for (size_t i = 0; i < model_ids.size(); i++) {
+      std::shared_ptr<fims_popdy::FisheryModelBase<Type>> &m =
+          this->models_map[model_ids[i]];
+      HashValue(h, model_ids[i]);
+      HashString(h, m->model_type_m);
+      for (std::set<uint32_t>::iterator pit = m->population_ids.begin();
+           pit != m->population_ids.end(); ++pit) {
+        HashValue(h, *pit);
+      }
+    }
+
+    HashValue(h, this->fixed_effects_parameters.size());
+    HashValue(h, this->random_effects_parameters.size());
+    for (size_t i = 0; i < this->parameter_names.size(); i++) {
+      HashString(h, this->parameter_names[i]);
+    }
+    for (size_t i = 0; i < this->random_effects_names.size(); i++) {
+      HashString(h, this->random_effects_names[i]);
+    }
+    return h;
+  }
+
   /**
    * @brief Get the Nages object
    *
@@ -1022,6 +1589,51 @@ class Information {
     }
     return valid_model;
   }
+
+ private:
+  /**
+   * @brief Adds each module of a map to a memory report.
+   *
+   * @param report The report.
+   * @param modules The modules by id.
+   * @param module The kind of module.
+   */
+  template <typename Map>
+  static void ReportModules(fims::MemoryReport &report, const Map &modules,
+                            const std::string &module) {
+    typename Map::const_iterator it;
+    for (it = modules.begin(); it != modules.end(); ++it) {
+      (*it).second->ReportMemory(report, module);
+    }
+  }
+
+  /**
+   * @brief Fold the bytes of a value into an FNV-1a hash.
+   *
+   * @param h The running hash.
+   * @param v The value to add to the hash.
+   */
+  template <typename T>
+  static void HashValue(uint64_t &h, const T &v) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&v);
+    for (size_t i = 0; i < sizeof(T); i++) {
+      h ^= static_cast<uint64_t>(bytes[i]);
+      h *= 1099511628211ULL;
+    }
+  }
+
+  /**
+   * @brief Fold the characters of a string into an FNV-1a hash.
+   *
+   * @param h The running hash.
+   * @param s The string to add to the hash.
+   */
+  static void HashString(uint64_t &h, const std::string &s) {
+    HashValue(h, s.size());
+    for (size_t i = 0; i < s.size(); i++) {
+      HashValue(h, s[i]);
+    }
+  }
 };
 
 template <typename Type>
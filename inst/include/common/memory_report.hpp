@@ -0,0 +1,194 @@
+/**
+ * @file memory_report.hpp
+ * @brief Accounting of the memory held by the modules, derived quantities,
+ * and data of each Information instance, see get_memory_report().
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_MEMORY_REPORT_HPP
+#define FIMS_COMMON_MEMORY_REPORT_HPP
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "fims_allocator.hpp"
+#include "fims_vector.hpp"
+#include "shared_data.hpp"
+
+namespace fims {
+
+/**
+ * @brief The bytes held by one vector, buffer, or other piece of storage.
+ */
+struct MemoryRecord {
+  std::string type;     /**< the AD type of the Information instance */
+  std::string category; /**< e.g., "module", "derived_quantity", or "data" */
+  std::string module;   /**< the kind of module, e.g., "Fleet" */
+  uint32_t id;          /**< the id of the module or data object */
+  std::string name;     /**< the name of the vector */
+  size_t bytes;         /**< the bytes held */
+  bool shared; /**< true if the storage was counted by an earlier record */
+};
+
+/**
+ * @brief A list of the storage held by a model, one record per vector.
+ *
+ * @details Modules add their vectors through FIMSObject::ReportMemory(). A
+ * vector counts its capacity, so storage reserved but not used is included.
+ * Vectors whose storage is in an arena are counted against the arena, and
+ * AddArena() then records only the part of the arena no reported vector
+ * holds, so the records add up to the memory in use. Storage seen twice, e.g.,
+ * a data buffer shared by the double and AD instances, is counted once and
+ * marked as shared after that.
+ */
+class MemoryReport {
+ public:
+  std::string type; /**< the AD type that new records are stamped with */
+  std::vector<MemoryRecord> records; /**< the records, in the order added */
+
+  /**
+   * @brief Adds a record.
+   *
+   * @param category The kind of storage.
+   * @param module The kind of module.
+   * @param id The id of the module.
+   * @param name The name of the storage.
+   * @param bytes The bytes held.
+   * @param storage The address of the storage, used to count it only once;
+   * null if it is not shared.
+   */
+  void Add(const std::string &category, const std::string &module, uint32_t id,
+           const std::string &name, size_t bytes,
+           const void *storage = nullptr) {
+    MemoryRecord record;
+    record.type = this->type;
+    record.category = category;
+    record.module = module;
+    record.id = id;
+    record.name = name;
+    record.bytes = bytes;
+    record.shared = storage != nullptr && !this->seen.insert(storage).second;
+    this->records.push_back(record);
+  }
+
+  /**
+   * @brief Adds the storage of a fims::Vector.
+   */
+  template <typename T, typename A>
+  void AddVector(const std::string &category, const std::string &module,
+                 uint32_t id, const std::string &name,
+                 const fims::Vector<T, A> &v) {
+    size_t bytes = v.capacity() * sizeof(T);
+    this->Add(category, module, id, name, bytes, v.data());
+    if (!this->records.back().shared) {
+      this->Attribute(v.get_allocator(), bytes);
+    }
+  }
+
+  /**
+   * @brief Adds the storage of a std::vector.
+   */
+  template <typename T, typename A>
+  void AddVector(const std::string &category, const std::string &module,
+                 uint32_t id, const std::string &name,
+                 const std::vector<T, A> &v) {
+    this->Add(category, module, id, name, v.capacity() * sizeof(T),
+              v.data());
+  }
+
+  /**
+   * @brief Adds each vector of a map of derived quantities by its name.
+   */
+  template <typename V>
+  void AddVectors(const std::string &category, const std::string &module,
+                  uint32_t id, const std::map<std::string, V> &vectors) {
+    typename std::map<std::string, V>::const_iterator it;
+    for (it = vectors.begin(); it != vectors.end(); ++it) {
+      this->AddVector(category, module, id, (*it).first, (*it).second);
+    }
+  }
+
+  /**
+   * @brief Adds a shared data buffer, counted only the first time it is seen.
+   */
+  void AddBuffer(const std::string &category, const std::string &module,
+                 uint32_t id, const std::string &name,
+                 const std::shared_ptr<SharedData> &buffer) {
+    if (buffer == nullptr) {
+      return;
+    }
+    this->Add(category, module, id,
+              buffer->IsMapped() ? name + " (mapped)" : name,
+              buffer->size() * sizeof(double), buffer.get());
+  }
+
+  /**
+   * @brief Adds the storage of an arena that no reported vector holds, e.g.,
+   * the parameters of modules or storage left behind when vectors grew. Call
+   * after the vectors in the arena were added.
+   */
+  template <typename T>
+  void AddArena(const std::string &module, uint32_t id,
+                const std::shared_ptr<Arena<T>> &arena) {
+    if (arena == nullptr) {
+      return;
+    }
+    size_t bytes = arena->Capacity() * sizeof(T);
+    size_t held = this->arena_bytes[arena.get()];
+    this->Add("arena", module, id, "unattributed",
+              bytes > held ? bytes - held : 0);
+  }
+
+  /**
+   * @brief The bytes of the records that are not shared.
+   */
+  size_t Total() const {
+    size_t n = 0;
+    for (size_t i = 0; i < this->records.size(); i++) {
+      n += this->records[i].shared ? 0 : this->records[i].bytes;
+    }
+    return n;
+  }
+
+  /**
+   * @brief The bytes of the records of one category that are not shared.
+   */
+  size_t Total(const std::string &category) const {
+    size_t n = 0;
+    for (size_t i = 0; i < this->records.size(); i++) {
+      if (this->records[i].category == category && !this->records[i].shared) {
+        n += this->records[i].bytes;
+      }
+    }
+    return n;
+  }
+
+ private:
+  /**
+   * @brief Counts the bytes of a vector against its arena, if it has one.
+   */
+  template <typename T>
+  void Attribute(const ArenaAllocator<T> &allocator, size_t bytes) {
+    if (allocator.GetArena() != nullptr) {
+      this->arena_bytes[allocator.GetArena()] += bytes;
+    }
+  }
+
+  /**
+   * @brief Other allocators do not use arenas.
+   */
+  template <typename A>
+  void Attribute(const A &, size_t) {}
+
+  std::set<const void *> seen; /**< the shared storage counted so far */
+  std::map<const void *, size_t>
+      arena_bytes; /**< the bytes of reported vectors by arena */
+};
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_MEMORY_REPORT_HPP */
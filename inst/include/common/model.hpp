@@ -8,9 +8,14 @@
 #ifndef FIMS_COMMON_MODEL_HPP
 #define FIMS_COMMON_MODEL_HPP
 
+#include <algorithm>
 #include <future>
 #include <memory>
+#include <set>
+#include <type_traits>
+#include <vector>
 
+#include "../utilities/fims_thread_pool.hpp"
 #include "information.hpp"
 
 namespace fims_model {
@@ -29,8 +34,32 @@ class Model {  // may need singleton
 
 #ifdef TMB_MODEL
   bool do_tmb_reporting = true;
-  ::objective_function<Type> *of;
+  ::objective_function<Type> *of = nullptr;
 #endif
+  size_t n_regions = 1; /**< number of groups the negative log-likelihood
+                           terms are summed in when TMB is not taping parallel
+                           regions; set to the number of threads to reproduce
+                           a parallel fit exactly. Regions are taped one at a
+                           time and each repeats the population dynamics, so
+                           only the likelihood work is split, see Evaluate() */
+  size_t region_block_size =
+      256; /**< data likelihoods with more rows than this are split into
+              blocks of this many rows when there is more than one region */
+  size_t n_threads = 1; /**< number of threads used to evaluate the fishery
+                           models and populations of the double model; one
+                           evaluates them on the calling thread */
+  std::shared_ptr<fims::ThreadPool>
+      thread_pool; /**< workers for the double model, created on first use */
+  bool incremental = false; /**< if true, each evaluation of the double model
+                               only recomputes the derived quantities that
+                               depend on parameters that changed since the
+                               previous evaluation */
+  std::vector<Type> last_parameters; /**< the fixed and then random effects at
+                                        the previous incremental evaluation;
+                                        clear it to make the next one
+                                        evaluate in full */
+  size_t last_data_revision = 0; /**< Information::data_revision at the
+                                    previous incremental evaluation */
 
   // constructor
 
@@ -50,8 +79,132 @@ class Model {  // may need singleton
     return Model<Type>::fims_model;
   }
 
+  /**
+   * @brief The number of regions the negative log-likelihood is split into.
+   * While TMB tapes parallel regions this is the number of regions TMB uses,
+   * otherwise it is n_regions.
+   */
+  size_t NumberOfRegions() const {
+#ifdef TMB_MODEL
+    if (this->of != nullptr && this->of->max_parallel_regions > 0) {
+      return static_cast<size_t>(this->of->max_parallel_regions);
+    }
+#endif
+    return std::max<size_t>(1, this->n_regions);
+  }
+
+  /**
+   * @brief The fixed and random effects whose values changed since the
+   * previous call. Every parameter has changed on the first call and when the
+   * number of parameters changes.
+   */
+  std::vector<Type *> ChangedParameters() {
+    std::vector<Type *> parameters =
+        this->fims_information->fixed_effects_parameters;
+    parameters.insert(
+        parameters.end(),
+        this->fims_information->random_effects_parameters.begin(),
+        this->fims_information->random_effects_parameters.end());
+    std::vector<Type *> changed;
+    bool all = this->last_parameters.size() != parameters.size();
+    this->last_parameters.resize(parameters.size());
+    for (size_t i = 0; i < parameters.size(); i++) {
+      if (all || this->last_parameters[i] != *parameters[i]) {
+        changed.push_back(parameters[i]);
+        this->last_parameters[i] = *parameters[i];
+      }
+    }
+    return changed;
+  }
+
+  /**
+   * @brief The thread pool for evaluating models and populations as separate
+   * tasks, or nullptr if they are evaluated one after another. Only the
+   * double model uses threads because an AD tape is recorded by one thread.
+   */
+  fims::ThreadPool *GetThreadPool() {
+    if (!std::is_same<Type, double>::value || this->n_threads <= 1) {
+      return nullptr;
+    }
+    if (this->thread_pool == nullptr ||
+        this->thread_pool->Size() != this->n_threads) {
+      this->thread_pool = std::make_shared<fims::ThreadPool>(this->n_threads);
+    }
+    return this->thread_pool.get();
+  }
+
+  /**
+   * @brief Checks that no population, fleet, or recruitment module is used by
+   * more than one of the models, so the models can be evaluated as separate
+   * tasks.
+   *
+   * @param models The fishery models.
+   */
+  static bool Independent(
+      const std::vector<std::shared_ptr<fims_popdy::FisheryModelBase<Type>>>
+          &models) {
+    std::set<uint32_t> population_ids;
+    std::set<uint32_t> fleet_ids;
+    std::set<const void *> recruitment;
+    for (size_t i = 0; i < models.size(); i++) {
+      for (size_t p = 0; p < models[i]->populations.size(); p++) {
+        std::shared_ptr<fims_popdy::Population<Type>> &population =
+            models[i]->populations[p];
+        if (!population_ids.insert(population->GetId()).second ||
+            !recruitment.insert(population->recruitment.get()).second) {
+          return false;
+        }
+      }
+      typename fims_popdy::FisheryModelBase<Type>::fleet_iterator f_it;
+      for (f_it = models[i]->fleets.begin(); f_it != models[i]->fleets.end();
+           ++f_it) {
+        if (!fleet_ids.insert((*f_it).first).second) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Sums the terms that belong to one region.
+   *
+   * @details Term j belongs to region j % n_regions and the terms of a region
+   * are added in order. Adding the region sums in region order gives the same
+   * result whether the regions are evaluated by one thread or by TMB on
+   * several threads, and with one region it is the plain serial sum.
+   *
+   * @param terms The negative log-likelihood terms.
+   * @param region The region.
+   * @param n_regions The number of regions.
+   */
+  static Type RegionSum(const std::vector<Type> &terms, size_t region,
+                        size_t n_regions) {
+    Type sum = static_cast<Type>(0.0);
+    for (size_t j = region; j < terms.size(); j += n_regions) {
+      sum += terms[j];
+    }
+    return sum;
+  }
+
   /**
    * @brief Evaluate. Calculates the joint negative log-likelihood function.
+   *
+   * @details The negative log-likelihood of each density component is a term
+   * of the objective function. With more than one region, data components
+   * with more than region_block_size rows contribute one term per block of
+   * rows instead, so that a large data set is spread over several regions.
+   * The terms are then summed by region with RegionSum(). TMB records one tape
+   * per parallel region and keeps only the operations its region depends on,
+   * so the gradient and Hessian are evaluated on all threads.
+   *
+   * Information and Model are shared by all threads, so the TMB objective
+   * function tapes the regions one at a time, and every region records the
+   * full population dynamics because all of its terms depend on them. Only
+   * the likelihood terms are divided between the regions. Parallel regions
+   * therefore speed up models whose likelihoods cost more than their
+   * population dynamics, e.g., large composition data sets, and they make
+   * taping slower.
    */
   const Type Evaluate() {
     // jnll = negative-log-likelihood (the objective function)
@@ -64,25 +217,93 @@ class Model {  // may need singleton
           "calling Evaluate().");
       return jnll;
     }
+    // the dimensions of an invalid model may not match, so it is not
+    // evaluated
+    if (!this->fims_information->valid_model) {
+      FIMS_ERROR_LOG(
+          "The model is not valid, see the errors from CreateModel(); it is "
+          "not evaluated.");
+      return jnll;
+    }
 
+    std::vector<std::shared_ptr<fims_popdy::FisheryModelBase<Type>>> models;
     for (m_it = this->fims_information->models_map.begin();
          m_it != this->fims_information->models_map.end(); ++m_it) {
       //(*m_it).second points to the Model module
       std::shared_ptr<fims_popdy::FisheryModelBase<Type>> m = (*m_it).second;
+#ifdef TMB_MODEL
       m->of = this->of;  // link to TMB objective function
-      m->Prepare();
-      m->Evaluate();
+#endif
+      models.push_back(m);
+    }
+
+    // Only the double model evaluates incrementally. The AD models are taped
+    // once, so every derived quantity must be on the tape.
+    // After the data change, e.g., the landings a hybrid F is solved from,
+    // or after last_parameters is cleared, nothing computed before can be
+    // reused, so the models evaluate in full.
+    if (this->incremental && std::is_same<Type, double>::value) {
+      bool reuse =
+          !this->last_parameters.empty() &&
+          this->last_data_revision == this->fims_information->data_revision;
+      std::vector<Type *> changed = this->ChangedParameters();
+      if (reuse) {
+        for (size_t i = 0; i < models.size(); i++) {
+          models[i]->SetChangedParameters(changed);
+        }
+      }
+      this->last_data_revision = this->fims_information->data_revision;
+    }
+
+    // Independent models run as tasks and evaluate their own populations
+    // serially, because a task cannot wait on tasks queued behind it.
+    // Otherwise the models run in order and each may use the pool for its
+    // populations.
+    fims::ThreadPool *pool = this->GetThreadPool();
+    if (pool != nullptr && models.size() > 1 &&
+        Model<Type>::Independent(models)) {
+      for (size_t i = 0; i < models.size(); i++) {
+        models[i]->thread_pool = nullptr;
+      }
+      pool->ParallelFor(models.size(), [&models](size_t i) {
+        models[i]->Prepare();
+        models[i]->Evaluate();
+      });
+    } else {
+      for (size_t i = 0; i < models.size(); i++) {
+        models[i]->thread_pool = pool;
+        models[i]->Prepare();
+        models[i]->Evaluate();
+      }
+    }
+
+    // The models and modules log what they found while evaluating only now,
+    // after the tasks have finished.
+    for (size_t i = 0; i < models.size(); i++) {
+      models[i]->LogEvaluateMessages();
+    }
+    typename fims_info::Information<Type>::growth_models_iterator g_it;
+    for (g_it = this->fims_information->growth_models.begin();
+         g_it != this->fims_information->growth_models.end(); ++g_it) {
+      (*g_it).second->LogPrepareMessages();
     }
 
 // Create vector for reporting out nll components
 #ifdef TMB_MODEL
     vector<Type> nll_components(
         this->fims_information->density_components.size());
+    nll_components.fill(0);
+#else
+    fims::Vector<Type> nll_components(
+        this->fims_information->density_components.size(),
+        static_cast<Type>(0.0));
 #endif
+    size_t n_regions = this->NumberOfRegions();
+    // negative log-likelihood terms in the order they are summed
+    std::vector<Type> terms;
 
     // Loop over densities and evaluate joint negative log densities for priors
     typename fims_info::Information<Type>::density_components_iterator d_it;
-    nll_components.fill(0);
     int nll_components_idx = 0;
     size_t n_priors = 0;
     FIMS_INFO_LOG("Begin evaluating prior densities.")
@@ -95,27 +316,18 @@ class Model {  // may need singleton
 #endif
       if (d->input_type == "prior") {
         nll_components[nll_components_idx] = -d->evaluate();
-        jnll += nll_components[nll_components_idx];
+        terms.push_back(nll_components[nll_components_idx]);
         n_priors += 1;
         nll_components_idx += 1;
       }
     }
     FIMS_INFO_LOG(
-        "Model: Finished evaluating prior distributions. The jnll after "
-        "evaluating " +
-        fims::to_string(n_priors) + " priors is: " + fims::to_string(jnll));
-
-    // Loop over populations and evaluate recruitment component
-
-    typename fims_info::Information<Type>::population_iterator p_it;
-
-    for (p_it = this->fims_information->populations.begin();
-         p_it != this->fims_information->populations.end(); ++p_it) {
-      //(*p_it).second points to the Population module
-      std::shared_ptr<fims_popdy::Population<Type>> p = (*p_it).second;
-    }
+        "Model: Finished evaluating prior distributions. The number of prior "
+        "terms is: " +
+        fims::to_string(n_priors));
 
     // Loop over and evaluate populations
+    typename fims_info::Information<Type>::population_iterator p_it;
     for (p_it = this->fims_information->populations.begin();
          p_it != this->fims_information->populations.end(); ++p_it) {
       //(*p_it).second points to the Population module
@@ -138,16 +350,15 @@ class Model {  // may need singleton
 #endif
       if (d->input_type == "random_effects") {
         nll_components[nll_components_idx] = -d->evaluate();
-        jnll += nll_components[nll_components_idx];
+        terms.push_back(nll_components[nll_components_idx]);
         n_random_effects += 1;
         nll_components_idx += 1;
       }
     }
     FIMS_INFO_LOG(
-        "Model: Finished evaluating random effect distributions. The jnll "
-        "after evaluating priors and " +
-        fims::to_string(n_random_effects) +
-        " random_effects is: " + fims::to_string(jnll));
+        "Model: Finished evaluating random effect distributions. The number "
+        "of random effect terms is: " +
+        fims::to_string(n_random_effects));
 
     this->fims_information->SetupData();
     // Loop over and evaluate data joint negative log-likelihoods
@@ -162,12 +373,38 @@ class Model {  // may need singleton
 #endif
       if (d->input_type == "data") {
         nll_components[nll_components_idx] = -d->evaluate();
-        jnll += nll_components[nll_components_idx];
+        size_t n_rows = d->lpdf_vec.size();
+        if (n_regions > 1 && n_rows > this->region_block_size) {
+          // one term per block of rows
+          for (size_t start = 0; start < n_rows;
+               start += this->region_block_size) {
+            size_t end = std::min(n_rows, start + this->region_block_size);
+            Type block = static_cast<Type>(0.0);
+            for (size_t i = start; i < end; i++) {
+              block -= d->lpdf_vec[i];
+            }
+            terms.push_back(block);
+          }
+        } else {
+          terms.push_back(nll_components[nll_components_idx]);
+        }
         n_data += 1;
         nll_components_idx += 1;
       }
     }
 
+    // Sum the terms by region. Each call to parallel_region() moves TMB to
+    // the next region, and only the region being taped is added.
+    for (size_t r = 0; r < n_regions; r++) {
+      Type region_sum = Model<Type>::RegionSum(terms, r, n_regions);
+#ifdef TMB_MODEL
+      if (this->of != nullptr && !this->of->parallel_region()) {
+        continue;
+      }
+#endif
+      jnll += region_sum;
+    }
+
 // report out nll components
 #ifdef TMB_MODEL
     FIMS_REPORT_F(nll_components, this->of);
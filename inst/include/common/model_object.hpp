@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "def.hpp"
+#include "memory_report.hpp"
 
 namespace fims_model_object {
 
@@ -36,6 +37,24 @@ struct FIMSObject {
    */
   uint32_t GetId() const { return id; }
 
+  /**
+   * @brief Adds the storage held by the object to a memory report. The
+   * default reports the lists of parameters; modules with vectors of their
+   * own also report those.
+   *
+   * @param report The report.
+   * @param module The kind of module, e.g., "Fleet".
+   */
+  virtual void ReportMemory(fims::MemoryReport& report,
+                            const std::string& module) const {
+    report.AddVector("module", module, this->id, "parameters",
+                     this->parameters);
+    report.AddVector("module", module, this->id, "fixed_effects_parameters",
+                     this->fixed_effects_parameters);
+    report.AddVector("module", module, this->id, "random_effects_parameters",
+                     this->random_effects_parameters);
+  }
+
   /**
    * @brief Check the dimensions of an object
    *
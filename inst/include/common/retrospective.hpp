@@ -0,0 +1,243 @@
+/**
+ * @file retrospective.hpp
+ * @brief Retrospective (peel) analysis of a fitted model.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_RETROSPECTIVE_HPP
+#define FIMS_COMMON_RETROSPECTIVE_HPP
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../utilities/fims_optimizer.hpp"
+#include "model.hpp"
+
+namespace fims_model {
+
+/**
+ * @brief Mohn's rho, the mean relative difference between the terminal value
+ * of each peel and the value for the same year in the full model.
+ *
+ * @param series The time series of a quantity, one vector per peel, where
+ * series[0] is the full model and series[k] has k years removed.
+ * @param nyears The number of model years in the full model.
+ * @return Mohn's rho, or zero if there are no peels.
+ */
+inline double MohnsRho(const std::vector<std::vector<double>> &series,
+                       size_t nyears) {
+  if (series.size() < 2) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (size_t k = 1; k < series.size(); k++) {
+    size_t year = nyears - 1 - k;
+    sum += (series[k][year] - series[0][year]) / series[0][year];
+  }
+  return sum / static_cast<double>(series.size() - 1);
+}
+
+/**
+ * @brief Results of a retrospective analysis.
+ */
+struct RetrospectiveResult {
+  std::map<std::string, std::vector<std::vector<double>>>
+      series; /**< time series of ssb, F, and recruitment for each peel */
+  std::map<std::string, double> mohns_rho; /**< Mohn's rho by quantity */
+  std::vector<std::vector<double>> par;    /**< estimates for each peel */
+  std::vector<double> objective; /**< objective function value by peel */
+  std::vector<int> convergence;  /**< 0 if the peel converged */
+};
+
+/**
+ * @brief The data of one Information instance during a retrospective
+ * analysis. The buffers are saved when it is constructed, and each peel
+ * masks a copy of them, so the saved values are never written.
+ */
+template <typename Type>
+class PeelData {
+ public:
+  /**
+   * @brief Saves the data buffers of an Information instance.
+   *
+   * @param info The Information instance.
+   */
+  explicit PeelData(std::shared_ptr<fims_info::Information<Type>> info)
+      : info(info) {
+    typename fims_info::Information<Type>::data_iterator it;
+    for (it = info->data_objects.begin(); it != info->data_objects.end();
+         ++it) {
+      this->original[(*it).first] = (*it).second->data.GetBuffer();
+    }
+  }
+
+  /**
+   * @brief Restores the saved data and masks the last years.
+   *
+   * @param nyears_removed The number of trailing years to mask. Zero restores
+   * the full data.
+   */
+  void Mask(size_t nyears_removed) {
+    std::map<uint32_t, std::shared_ptr<fims::SharedData>>::iterator it;
+    for (it = this->original.begin(); it != this->original.end(); ++it) {
+      this->info->UpdateDataObject((*it).first, (*it).second);
+    }
+    this->info->MaskTrailingYears(nyears_removed);
+  }
+
+ private:
+  std::shared_ptr<fims_info::Information<Type>>
+      info; /**< the Information instance */
+  std::map<uint32_t, std::shared_ptr<fims::SharedData>>
+      original; /**< the saved buffers by data object id */
+};
+
+/**
+ * @brief Retrospective analysis that reuses the existing model.
+ *
+ * @details Each peel sets the observations in the last years to NA with
+ * Information::MaskTrailingYears(), so the modules, links, and parameters are
+ * not rebuilt. Peel k starts the optimizer from the estimates of peel k - 1.
+ * The data and parameters are restored when the analysis finishes.
+ *
+ * The peels run one after another. The double model is a singleton that
+ * every peel writes to, so peels cannot share it across threads.
+ *
+ * Random effects would need the Laplace approximation, which is only
+ * available through TMB, so models with random effects are rejected.
+ */
+template <typename Type>
+class Retrospective {
+ public:
+  size_t npeels = 5;                  /**< number of peels */
+  fims::OptimizerControl control;     /**< optimizer settings for each peel */
+  fims::Optimizer::gradient_t
+      gradient; /**< gradient of the objective function of the current peel;
+                   if empty, central finite differences are used */
+  std::function<void(size_t)>
+      set_peel; /**< called with the number of years removed after the data
+                   are masked for a peel, and with zero once they are
+                   restored, e.g., to mask the data that a gradient reads */
+
+  /**
+   * @brief Runs the analysis. Peel 0 refits the full model.
+   *
+   * @return The results, empty if the model has random effects.
+   */
+  RetrospectiveResult Run() {
+    std::shared_ptr<fims_info::Information<Type>> info =
+        fims_info::Information<Type>::GetInstance();
+    std::shared_ptr<Model<Type>> model = Model<Type>::GetInstance();
+    RetrospectiveResult result;
+
+    if (info->random_effects_parameters.size() > 0) {
+      FIMS_ERROR_LOG(
+          "A retrospective analysis cannot be run on a model with random "
+          "effects; fit the peels with TMB instead.");
+      return result;
+    }
+
+    // save the data and parameters to restore them afterwards
+    PeelData<Type> data(info);
+    std::vector<double> start(info->fixed_effects_parameters.size());
+    for (size_t i = 0; i < start.size(); i++) {
+      start[i] = *info->fixed_effects_parameters[i];
+    }
+
+    fims::Optimizer optimizer(
+        [&](const std::vector<double> &x) {
+          info->UpdateFixedEffectsParameters(x);
+          return static_cast<double>(model->Evaluate());
+        },
+        this->gradient);
+    optimizer.control = this->control;
+    bool incremental = model->incremental;
+    model->incremental = true;
+
+    std::vector<double> par = start;
+    for (size_t k = 0; k <= this->npeels && k < info->nyears; k++) {
+      data.Mask(k);
+      // the derived quantities tracked for the previous peel were computed
+      // from other data, so each peel starts with a full evaluation
+      model->last_parameters.clear();
+      if (this->set_peel) {
+        this->set_peel(k);
+      }
+
+      fims::OptimizerResult fit = optimizer.Minimize(par);
+      par = fit.par;
+      info->UpdateFixedEffectsParameters(par);
+      model->Evaluate();
+
+      result.par.push_back(par);
+      result.objective.push_back(fit.objective);
+      result.convergence.push_back(fit.convergence);
+      this->Record(info, result);
+    }
+
+    result.mohns_rho["ssb"] = MohnsRho(result.series["ssb"], info->nyears);
+    result.mohns_rho["F"] = MohnsRho(result.series["F"], info->nyears);
+    result.mohns_rho["recruitment"] =
+        MohnsRho(result.series["recruitment"], info->nyears);
+
+    // restore the full model
+    data.Mask(0);
+    model->last_parameters.clear();
+    if (this->set_peel) {
+      this->set_peel(0);
+    }
+    info->UpdateFixedEffectsParameters(start);
+    model->Evaluate();
+    model->incremental = incremental;
+    return result;
+  }
+
+ private:
+  /**
+   * @brief Appends the spawning biomass, total fishing mortality, and
+   * recruitment by year, summed over the populations and fleets of every
+   * catch-at-age model.
+   */
+  void Record(std::shared_ptr<fims_info::Information<Type>> &info,
+              RetrospectiveResult &result) {
+    std::vector<double> ssb(info->nyears, 0.0);
+    std::vector<double> F(info->nyears, 0.0);
+    std::vector<double> recruitment(info->nyears, 0.0);
+
+    typename fims_info::Information<Type>::model_map_iterator m_it;
+    for (m_it = info->models_map.begin(); m_it != info->models_map.end();
+         ++m_it) {
+      std::shared_ptr<fims_popdy::CatchAtAge<Type>> caa =
+          std::dynamic_pointer_cast<fims_popdy::CatchAtAge<Type>>(
+              (*m_it).second);
+      if (caa == nullptr) {
+        continue;
+      }
+      for (size_t p = 0; p < caa->populations.size(); p++) {
+        std::map<std::string, fims::Vector<Type>> &dq =
+            caa->population_derived_quantities[caa->populations[p]->GetId()];
+        for (size_t y = 0; y < caa->populations[p]->nyears; y++) {
+          ssb[y] += dq["spawning_biomass"][y];
+          recruitment[y] += dq["expected_recruitment"][y];
+        }
+      }
+      typename fims_popdy::CatchAtAge<Type>::fleet_iterator f_it;
+      for (f_it = caa->fleets.begin(); f_it != caa->fleets.end(); ++f_it) {
+        std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*f_it).second;
+        for (size_t y = 0; y < fleet->nyears; y++) {
+          F[y] += fleet->Fmort[y];
+        }
+      }
+    }
+    result.series["ssb"].push_back(ssb);
+    result.series["F"].push_back(F);
+    result.series["recruitment"].push_back(recruitment);
+  }
+};
+
+}  // namespace fims_model
+
+#endif /* FIMS_COMMON_RETROSPECTIVE_HPP */
@@ -0,0 +1,275 @@
+/**
+ * @file shared_data.hpp
+ * @brief Observed data stored once as doubles and shared by the data objects
+ * of every Information<Type> instance.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_COMMON_SHARED_DATA_HPP
+#define FIMS_COMMON_SHARED_DATA_HPP
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "def.hpp"
+
+#if defined(FIMS_LINUX) || defined(FIMS_MACOS) || defined(FIMS_BSD)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FIMS_MMAP
+#endif
+
+namespace fims {
+
+/**
+ * @brief The value of a scalar as a double. Observed data are constants, so
+ * only the value of an AD scalar is stored, e.g., for simulated data.
+ */
+template <typename Type>
+inline double value_of(const Type &x) {
+#ifdef TMB_MODEL
+  return asDouble(x);
+#else
+  return static_cast<double>(x);
+#endif
+}
+
+/**
+ * @brief An immutable buffer of doubles, either owned or mapped from a file.
+ *
+ * @details The data objects of the double and AD instances of Information
+ * hold the same buffer, so each data set is stored once. Replacing the data,
+ * e.g., for replicate fits, replaces the buffer pointer.
+ */
+class SharedData {
+ public:
+  /**
+   * @brief Takes ownership of a vector of values.
+   */
+  explicit SharedData(std::vector<double> values)
+      : owned(std::move(values)) {
+    this->data_m = this->owned.data();
+    this->size_m = this->owned.size();
+  }
+
+  SharedData(const SharedData &) = delete;
+  SharedData &operator=(const SharedData &) = delete;
+
+  /**
+   * @brief Unmaps a mapped file.
+   */
+  ~SharedData() {
+#ifdef FIMS_MMAP
+    if (this->map_m != nullptr) {
+      munmap(this->map_m, this->map_size_m);
+    }
+#endif
+  }
+
+  /**
+   * @brief A buffer of size zeros.
+   */
+  static std::shared_ptr<SharedData> Zeros(size_t size) {
+    return std::make_shared<SharedData>(std::vector<double>(size, 0.0));
+  }
+
+  /**
+   * @brief Maps a binary file of native doubles into memory, so large inputs
+   * are paged in by the operating system instead of copied. Where mapping is
+   * not available the file is read into an owned buffer.
+   *
+   * @param path The path of the file.
+   * @return The buffer, or nullptr if the file cannot be read.
+   */
+  static std::shared_ptr<SharedData> MapFile(const std::string &path) {
+#ifdef FIMS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      FIMS_ERROR_LOG("Cannot open data file " + path + ".");
+      return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      FIMS_ERROR_LOG("Cannot read data file " + path + ".");
+      return nullptr;
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+    std::shared_ptr<SharedData> buffer =
+        std::make_shared<SharedData>(std::vector<double>());
+    if (bytes >= sizeof(double)) {
+      void *map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map == MAP_FAILED) {
+        close(fd);
+        FIMS_ERROR_LOG("Cannot map data file " + path + ".");
+        return nullptr;
+      }
+      buffer->map_m = map;
+      buffer->map_size_m = bytes;
+      buffer->data_m = static_cast<const double *>(map);
+      buffer->size_m = bytes / sizeof(double);
+    }
+    close(fd);
+    return buffer;
+#else
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!in.good()) {
+      FIMS_ERROR_LOG("Cannot open data file " + path + ".");
+      return nullptr;
+    }
+    std::vector<double> values(static_cast<size_t>(in.tellg()) /
+                               sizeof(double));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(values.data()),
+            values.size() * sizeof(double));
+    return std::make_shared<SharedData>(std::move(values));
+#endif
+  }
+
+  /**
+   * @brief Returns a pointer to the values.
+   */
+  inline const double *data() const { return this->data_m; }
+
+  /**
+   * @brief Returns the number of values.
+   */
+  inline size_t size() const { return this->size_m; }
+
+  /**
+   * @brief True if the values are mapped from a file.
+   */
+  inline bool IsMapped() const { return this->map_m != nullptr; }
+
+ private:
+  /**
+   * @brief A writable pointer to owned values, for SharedDataView after it
+   * has made its own copy.
+   */
+  double *owned_data() { return this->owned.data(); }
+
+  template <typename Type>
+  friend class SharedDataView;
+
+  std::vector<double> owned;       /**< the values, unless mapped */
+  const double *data_m = nullptr;  /**< the first value */
+  size_t size_m = 0;               /**< the number of values */
+  void *map_m = nullptr;           /**< the mapping, if mapped */
+  size_t map_size_m = 0;           /**< the size of the mapping in bytes */
+};
+
+/**
+ * @brief A typed view of a shared buffer, used for the values of a
+ * DataObject<Type>.
+ *
+ * @details Reads convert the double to Type. Writes, e.g., masking years or
+ * simulating data, first copy the buffer if it is shared or mapped, so they
+ * only change this view, as they did when each Information instance held its
+ * own copy.
+ */
+template <typename Type>
+class SharedDataView {
+ public:
+  /**
+   * @brief A reference to one value of the view.
+   */
+  class reference {
+   public:
+    /**
+     * @brief The value at the position.
+     */
+    reference(SharedDataView *view, size_t i) : view(view), i(i) {}
+
+    /**
+     * @brief The value as Type.
+     */
+    operator Type() const { return static_cast<Type>(view->buffer->data()[i]); }
+
+    /**
+     * @brief Replaces the value.
+     */
+    reference &operator=(const Type &value) {
+      view->Set(i, value);
+      return *this;
+    }
+
+    /**
+     * @brief Replaces the value with another value of a view.
+     */
+    reference &operator=(const reference &other) {
+      view->Set(i, static_cast<Type>(other));
+      return *this;
+    }
+
+   private:
+    SharedDataView *view; /**< the view */
+    size_t i;             /**< the position */
+  };
+
+  /**
+   * @brief An empty view.
+   */
+  SharedDataView() : buffer(SharedData::Zeros(0)) {}
+
+  /**
+   * @brief Returns the value at pos as Type. No bounds checking is performed.
+   */
+  inline const Type operator[](size_t pos) const {
+    return static_cast<Type>(this->buffer->data()[pos]);
+  }
+
+  /**
+   * @brief Returns a reference to the value at pos. No bounds checking is
+   * performed.
+   */
+  inline reference operator[](size_t pos) { return reference(this, pos); }
+
+  /**
+   * @brief Returns the number of values.
+   */
+  inline size_t size() const { return this->buffer->size(); }
+
+  /**
+   * @brief Replaces the values with size zeros in a buffer of its own.
+   */
+  void resize(size_t size) { this->buffer = SharedData::Zeros(size); }
+
+  /**
+   * @brief Returns the shared buffer.
+   */
+  inline const std::shared_ptr<SharedData> &GetBuffer() const {
+    return this->buffer;
+  }
+
+  /**
+   * @brief Views another buffer. Nothing is copied.
+   */
+  void SetBuffer(const std::shared_ptr<SharedData> &buffer) {
+    this->buffer = buffer;
+  }
+
+  /**
+   * @brief Replaces the value at pos, copying the buffer first if it is
+   * shared or mapped.
+   */
+  void Set(size_t pos, const Type &value) {
+    if (this->buffer.use_count() > 1 || this->buffer->IsMapped()) {
+      this->buffer = std::make_shared<SharedData>(std::vector<double>(
+          this->buffer->data(), this->buffer->data() + this->buffer->size()));
+    }
+    this->buffer->owned_data()[pos] = fims::value_of(value);
+  }
+
+ private:
+  std::shared_ptr<SharedData> buffer; /**< the values */
+};
+
+}  // namespace fims
+
+#endif /* FIMS_COMMON_SHARED_DATA_HPP */
@@ -45,11 +45,11 @@ struct DistributionElementObject {
   /**
    * Retrieve element from observed data set, random effect, or prior.
    * @param i index referencing vector or pointer
-   * @return the reference to the value of the vector or pointer at position i
+   * @return the value of the vector or pointer at position i
    */
-  inline Type& get_observed(size_t i) {
+  inline Type get_observed(size_t i) {
     if (this->input_type == "data") {
-      return observed_values->at(i);
+      return (*observed_values)(i);
     }
     if (this->input_type == "random_effects") {
       return (*re)[i];
@@ -64,11 +64,11 @@ struct DistributionElementObject {
    * Retrieve element from observed data set, random effect, or prior.
    * @param i index referencing row
    * @param j index referencing column
-   * @return the reference to the row and column at position i, j
+   * @return the value at the row and column at position i, j
    */
-  inline Type& get_observed(size_t i, size_t j) {
+  inline Type get_observed(size_t i, size_t j) {
     if (this->input_type == "data") {
-      return observed_values->at(i, j);
+      return (*observed_values)(i, j);
     }
     if (this->input_type == "random_effects") {
       return (*re)[i, j];
@@ -150,6 +150,22 @@ struct DensityComponentBase : public fims_model_object::FIMSObject<Type>,
   }
 
   virtual ~DensityComponentBase() {}
+
+  /**
+   * @brief Adds the expected values and likelihood contributions to a memory
+   * report. The observed values are reported with the data objects.
+   */
+  virtual void ReportMemory(fims::MemoryReport& report,
+                            const std::string& module) const {
+    fims_model_object::FIMSObject<Type>::ReportMemory(report, module);
+    report.AddVector("derived_quantity", module, this->id, "expected_values",
+                     this->expected_values);
+    report.AddVector("derived_quantity", module, this->id, "x", this->x);
+    report.AddVector("derived_quantity", module, this->id, "lpdf_vec",
+                     this->lpdf_vec);
+    report.AddVector("derived_quantity", module, this->id, "report_lpdf_vec",
+                     this->report_lpdf_vec);
+  }
   /**
    * @brief Generic probability density function. Calculates the pdf at the
    * independent variable value.
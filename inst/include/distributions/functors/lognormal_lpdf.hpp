@@ -95,9 +95,10 @@ struct LogNormalLPDF : public DensityComponentBase<Type> {
         FIMS_SIMULATE_F(this->of) {  // preprocessor definition in interface.hpp
                                      // this simulates data that is mean biased
           if (this->input_type == "data") {
-            this->observed_values->at(i) = fims_math::exp(
-                rnorm(this->get_expected(i),
-                      fims_math::exp(log_sd.get_force_scalar(i))));
+            this->observed_values->set(
+                i, fims_math::exp(
+                       rnorm(this->get_expected(i),
+                             fims_math::exp(log_sd.get_force_scalar(i)))));
           }
           if (this->input_type == "random_effects") {
             (*this->re)[i] = fims_math::exp(
@@ -90,20 +90,25 @@ struct MultinomialLPMF : public DensityComponentBase<Type> {
       bool containsNA = false; /**< skips the entire row if any values are NA */
 
 #ifdef TMB_MODEL
-      for (size_t j = 0; j < dims[1]; j++) {
-        if (this->input_type == "data") {
+      if (this->input_type == "data") {
+        // the row of observed values is contiguous; its size was validated
+        // when the model was created
+        fims::Span<const double> observed =
+            fims_data_object::view<2>(*this->observed_values).row(i);
+        double na_value = fims::value_of(this->observed_values->na_value);
+        for (size_t j = 0; j < dims[1]; j++) {
           // if data, check if there are any NA values and skip lpdf calculation
           // for entire row if there are
-          if (this->get_observed(i, j) == this->observed_values->na_value) {
+          if (observed[j] == na_value) {
             containsNA = true;
             break;
           }
-          if (!containsNA) {
-            size_t idx = (i * dims[1]) + j;
-            x_vector[j] = this->get_observed(i, j);
-            prob_vector[j] = this->get_expected(idx);
-          }
-        } else {
+          size_t idx = (i * dims[1]) + j;
+          x_vector[j] = static_cast<Type>(observed[j]);
+          prob_vector[j] = this->get_expected(idx);
+        }
+      } else {
+        for (size_t j = 0; j < dims[1]; j++) {
           // if not data (i.e. prior or process), use x vector instead of
           // observed_values
           size_t idx = (i * dims[1]) + j;
@@ -91,9 +91,9 @@ struct NormalLPDF : public DensityComponentBase<Type> {
       if (this->simulate_flag) {
         FIMS_SIMULATE_F(this->of) {
           if (this->input_type == "data") {
-            this->observed_values->at(i) =
-                rnorm(this->get_expected(i),
-                      fims_math::exp(log_sd.get_force_scalar(i)));
+            this->observed_values->set(
+                i, rnorm(this->get_expected(i),
+                         fims_math::exp(log_sd.get_force_scalar(i))));
           }
           if (this->input_type == "random_effects") {
             (*this->re)[i] = rnorm(this->get_expected(i),
@@ -8,7 +8,9 @@
 #ifndef FIMS_INTERFACE_RCPP_INTERFACE_HPP
 #define FIMS_INTERFACE_RCPP_INTERFACE_HPP
 #include "../../common/model.hpp"
+#include "../../common/retrospective.hpp"
 #include "../../utilities/fims_json.hpp"
+#include "../../utilities/fims_optimizer.hpp"
 #include "rcpp_objects/rcpp_data.hpp"
 #include "rcpp_objects/rcpp_distribution.hpp"
 #include "rcpp_objects/rcpp_fleet.hpp"
@@ -47,9 +49,28 @@ bool CreateTMBModel() {
       "Adding FIMS objects to TMB, " +
       fims::to_string(FIMSRcppInterfaceBase::fims_interface_objects.size()) +
       " objects");
-  for (size_t i = 0; i < FIMSRcppInterfaceBase::fims_interface_objects.size();
-       i++) {
-    FIMSRcppInterfaceBase::fims_interface_objects[i]->add_to_fims_tmb();
+  {
+    // the vectors of the modules are laid out in the arena of each
+    // Information instance
+#ifdef TMBAD_FRAMEWORK
+    fims::ArenaScope<TMB_FIMS_REAL_TYPE> scope0(
+        fims_info::Information<TMB_FIMS_REAL_TYPE>::GetInstance()->arena);
+    fims::ArenaScope<TMBAD_FIMS_TYPE> scope(
+        fims_info::Information<TMBAD_FIMS_TYPE>::GetInstance()->arena);
+#else
+    fims::ArenaScope<TMB_FIMS_REAL_TYPE> scope0(
+        fims_info::Information<TMB_FIMS_REAL_TYPE>::GetInstance()->arena);
+    fims::ArenaScope<TMB_FIMS_FIRST_ORDER> scope1(
+        fims_info::Information<TMB_FIMS_FIRST_ORDER>::GetInstance()->arena);
+    fims::ArenaScope<TMB_FIMS_SECOND_ORDER> scope2(
+        fims_info::Information<TMB_FIMS_SECOND_ORDER>::GetInstance()->arena);
+    fims::ArenaScope<TMB_FIMS_THIRD_ORDER> scope3(
+        fims_info::Information<TMB_FIMS_THIRD_ORDER>::GetInstance()->arena);
+#endif
+    for (size_t i = 0;
+         i < FIMSRcppInterfaceBase::fims_interface_objects.size(); i++) {
+      FIMSRcppInterfaceBase::fims_interface_objects[i]->add_to_fims_tmb();
+    }
   }
 
   // base model
@@ -93,17 +114,12 @@ bool CreateTMBModel() {
 }
 
 /**
- * Finalize a model run by populating derived quantities into the Rcpp interface
- * objects and return the output as a JSON string.
+ * @brief Evaluates the double version of the model at par and extracts the
+ * results back to the interface objects.
  *
  * @param par A vector of parameter values.
- * @param fn The objective function.
- * @param gr The gradient function.
- *
- * @return A JSON output string is returned.
  */
-std::string finalize_fims(Rcpp::NumericVector par, Rcpp::Function fn,
-                          Rcpp::Function gr) {
+void finalize_interface_objects(Rcpp::NumericVector par) {
   std::shared_ptr<fims_info::Information<double>> information =
       fims_info::Information<double>::GetInstance();
 
@@ -115,7 +131,31 @@ std::string finalize_fims(Rcpp::NumericVector par, Rcpp::Function fn,
 
   bool reporting = model->do_tmb_reporting;
   model->do_tmb_reporting = false;
+  bool incremental = model->incremental;
+  model->incremental = true;
   model->Evaluate();
+  model->incremental = incremental;
+
+  for (size_t i = 0; i < FIMSRcppInterfaceBase::fims_interface_objects.size();
+       i++) {
+    FIMSRcppInterfaceBase::fims_interface_objects[i]->finalize();
+  }
+  model->do_tmb_reporting = reporting;
+}
+
+/**
+ * Finalize a model run by populating derived quantities into the Rcpp interface
+ * objects and return the output as a JSON string.
+ *
+ * @param par A vector of parameter values.
+ * @param fn The objective function.
+ * @param gr The gradient function.
+ *
+ * @return A JSON output string is returned.
+ */
+std::string finalize_fims(Rcpp::NumericVector par, Rcpp::Function fn,
+                          Rcpp::Function gr) {
+  finalize_interface_objects(par);
 
   Rcpp::Function f = Rcpp::as<Rcpp::Function>(fn);
   Rcpp::Function g = Rcpp::as<Rcpp::Function>(gr);
@@ -128,10 +168,6 @@ std::string finalize_fims(Rcpp::NumericVector par, Rcpp::Function fn,
     }
   }
 
-  for (size_t i = 0; i < FIMSRcppInterfaceBase::fims_interface_objects.size();
-       i++) {
-    FIMSRcppInterfaceBase::fims_interface_objects[i]->finalize();
-  }
   std::string ret;
   auto now = std::chrono::system_clock::now();
   std::time_t now_time = std::chrono::system_clock::to_time_t(now);
@@ -170,10 +206,78 @@ std::string finalize_fims(Rcpp::NumericVector par, Rcpp::Function fn,
   }
 
   ret = fims::JsonParser::PrettyFormatJSON(ss.str());
-  model->do_tmb_reporting = reporting;
   return ret;
 }
 
+/**
+ * @brief Finalizes a model run like finalize_fims() but returns the
+ * estimates, derived quantities, and fits to data as column-oriented tables
+ * instead of a JSON string.
+ *
+ * @param par A vector of parameter values.
+ * @return A list with the elements estimates, derived_quantities, and fits,
+ * where each element is a named list of equal-length vectors that can be
+ * passed to tibble::as_tibble().
+ */
+Rcpp::List get_output_tables(Rcpp::NumericVector par) {
+  finalize_interface_objects(par);
+
+  OutputTables tables;
+  for (size_t i = 0; i < FIMSRcppInterfaceBase::fims_interface_objects.size();
+       i++) {
+    FIMSRcppInterfaceBase::fims_interface_objects[i]->add_to_tables(tables);
+  }
+
+  // label each fit with the type of data it is fit to
+  for (size_t i = 0; i < tables.fits.data_id.size(); i++) {
+    std::map<uint32_t, DataInterfaceBase *>::iterator it =
+        DataInterfaceBase::live_objects.find(tables.fits.data_id[i]);
+    if (it != DataInterfaceBase::live_objects.end()) {
+      tables.fits.label[i] = (*it).second->data_type();
+    }
+  }
+
+  OutputTables::Estimates &e = tables.estimates;
+  Rcpp::List estimates = Rcpp::List::create(
+      Rcpp::Named("module_name") = Rcpp::wrap(e.module_name),
+      Rcpp::Named("module_id") = Rcpp::wrap(e.module_id),
+      Rcpp::Named("module_type") = Rcpp::wrap(e.module_type),
+      Rcpp::Named("label") = Rcpp::wrap(e.label),
+      Rcpp::Named("type_id") = Rcpp::wrap(e.type_id),
+      Rcpp::Named("type") = Rcpp::wrap(e.type),
+      Rcpp::Named("parameter_id") = Rcpp::wrap(e.parameter_id),
+      Rcpp::Named("index") = Rcpp::wrap(e.index),
+      Rcpp::Named("initial") = Rcpp::wrap(e.initial),
+      Rcpp::Named("estimate") = Rcpp::wrap(e.estimate),
+      Rcpp::Named("estimation_type") = Rcpp::wrap(e.estimation_type));
+
+  OutputTables::DerivedQuantities &d = tables.derived_quantities;
+  Rcpp::List derived_quantities = Rcpp::List::create(
+      Rcpp::Named("module_name") = Rcpp::wrap(d.module_name),
+      Rcpp::Named("module_id") = Rcpp::wrap(d.module_id),
+      Rcpp::Named("module_type") = Rcpp::wrap(d.module_type),
+      Rcpp::Named("label") = Rcpp::wrap(d.label),
+      Rcpp::Named("index") = Rcpp::wrap(d.index),
+      Rcpp::Named("estimate") = Rcpp::wrap(d.estimate));
+
+  OutputTables::Fits &f = tables.fits;
+  Rcpp::List fits = Rcpp::List::create(
+      Rcpp::Named("module_name") = Rcpp::wrap(f.module_name),
+      Rcpp::Named("module_id") = Rcpp::wrap(f.module_id),
+      Rcpp::Named("label") = Rcpp::wrap(f.label),
+      Rcpp::Named("data_id") = Rcpp::wrap(f.data_id),
+      Rcpp::Named("index") = Rcpp::wrap(f.index),
+      Rcpp::Named("distribution") = Rcpp::wrap(f.distribution),
+      Rcpp::Named("init") = Rcpp::wrap(f.init),
+      Rcpp::Named("expected") = Rcpp::wrap(f.expected),
+      Rcpp::Named("log_like") = Rcpp::wrap(f.log_like));
+
+  return Rcpp::List::create(
+      Rcpp::Named("estimates") = estimates,
+      Rcpp::Named("derived_quantities") = derived_quantities,
+      Rcpp::Named("fits") = fits);
+}
+
 /**
  * @brief Gets the fixed parameters vector object.
  *
@@ -244,6 +348,451 @@ Rcpp::List get_random_names(Rcpp::List pars) {
   return pars;
 }
 
+/**
+ * @brief Replaces the observed values of a data object on an existing model.
+ *
+ * @details The values are written in place into the interface object and into
+ * the data object held by every Information instance, so a replicate can be
+ * refit without calling `clear()` and `CreateTMBModel()` again.
+ *
+ * @param id The id of the data object, i.e., the value of `get_id()`.
+ * @param values The new values, folded in the same order as the data.
+ * @return True if the data were updated.
+ */
+bool update_data(uint32_t id, Rcpp::NumericVector values) {
+  std::map<uint32_t, DataInterfaceBase *>::iterator it =
+      DataInterfaceBase::live_objects.find(id);
+  if (it == DataInterfaceBase::live_objects.end()) {
+    FIMS_ERROR_LOG("Data with id " + fims::to_string(id) + " not found.");
+    return false;
+  }
+  return (*it).second->update_data(Rcpp::as<std::vector<double>>(values));
+}
+
+/**
+ * @brief Replaces the parameter values of the Information instance of type
+ * Type.
+ *
+ * @param values The new values.
+ * @param random If true, the random effects are updated, otherwise the fixed
+ * effects are updated.
+ * @return True if the parameters were updated.
+ */
+template <typename Type>
+bool update_parameters_internal(const std::vector<double> &values,
+                                bool random) {
+  std::shared_ptr<fims_info::Information<Type>> info =
+      fims_info::Information<Type>::GetInstance();
+  if (random) {
+    return info->UpdateRandomEffectsParameters(values);
+  }
+  return info->UpdateFixedEffectsParameters(values);
+}
+
+/**
+ * @brief Replaces the parameter values of every Information instance.
+ *
+ * @param values The new values.
+ * @param random If true, the random effects are updated, otherwise the fixed
+ * effects are updated.
+ * @return True if the parameters were updated.
+ */
+bool update_parameters_all(const std::vector<double> &values, bool random) {
+  bool updated = true;
+#ifdef TMBAD_FRAMEWORK
+  updated &= update_parameters_internal<TMB_FIMS_REAL_TYPE>(values, random);
+  updated &= update_parameters_internal<TMBAD_FIMS_TYPE>(values, random);
+#else
+  updated &= update_parameters_internal<TMB_FIMS_REAL_TYPE>(values, random);
+  updated &= update_parameters_internal<TMB_FIMS_FIRST_ORDER>(values, random);
+  updated &= update_parameters_internal<TMB_FIMS_SECOND_ORDER>(values, random);
+  updated &= update_parameters_internal<TMB_FIMS_THIRD_ORDER>(values, random);
+#endif
+  return updated;
+}
+
+/**
+ * @brief Replaces the starting values of the fixed effects on an existing
+ * model.
+ *
+ * @param par A vector of fixed effects values in the order given by
+ * `get_parameter_names()`.
+ * @return True if the parameters were updated.
+ */
+bool update_fixed(Rcpp::NumericVector par) {
+  return update_parameters_all(Rcpp::as<std::vector<double>>(par), false);
+}
+
+/**
+ * @brief Replaces the starting values of the random effects on an existing
+ * model.
+ *
+ * @param re A vector of random effects values in the order given by
+ * `get_random_names()`.
+ * @return True if the random effects were updated.
+ */
+bool update_random(Rcpp::NumericVector re) {
+  return update_parameters_all(Rcpp::as<std::vector<double>>(re), true);
+}
+
+/**
+ * @brief Gets a hash of the model structure.
+ *
+ * @details Two models with the same hash have the same dimensions, modules,
+ * links, data sizes, and parameters, so a tape recorded for one can be reused
+ * for the other after swapping data with `update_data()`.
+ *
+ * @return The hash as a hexadecimal string.
+ */
+std::string get_structure_hash() {
+  std::shared_ptr<fims_info::Information<TMB_FIMS_REAL_TYPE>> info0 =
+      fims_info::Information<TMB_FIMS_REAL_TYPE>::GetInstance();
+  std::stringstream ss;
+  ss << std::hex << info0->GetStructureHash();
+  return ss.str();
+}
+
+/**
+ * @brief Adds the storage of the Information instance of type Type to a
+ * memory report.
+ *
+ * @param report The report.
+ * @param type The label of the type in the report.
+ */
+template <typename Type>
+void report_memory_internal(fims::MemoryReport &report,
+                            const std::string &type) {
+  report.type = type;
+  fims_info::Information<Type>::GetInstance()->ReportMemory(report);
+}
+
+/**
+ * @brief Gets the bytes held by each Information instance, by module id and
+ * derived quantity name, along with the data, the interface objects, and the
+ * log.
+ *
+ * @details Data buffers are shared by the Information instances, so a buffer
+ * counts its bytes in the first row it appears in and is marked as shared in
+ * the others. The sum of `bytes` over the rows that are not shared is the
+ * memory held by FIMS outside of the TMB tape.
+ *
+ * @return A data frame with one row per vector or buffer and the columns
+ * `type`, `category`, `module`, `id`, `name`, `bytes`, and `shared`.
+ */
+Rcpp::DataFrame get_memory_report() {
+  fims::MemoryReport report;
+#ifdef TMBAD_FRAMEWORK
+  report_memory_internal<TMB_FIMS_REAL_TYPE>(report, "double");
+  report_memory_internal<TMBAD_FIMS_TYPE>(report, "ad");
+#else
+  report_memory_internal<TMB_FIMS_REAL_TYPE>(report, "double");
+  report_memory_internal<TMB_FIMS_FIRST_ORDER>(report, "first_order");
+  report_memory_internal<TMB_FIMS_SECOND_ORDER>(report, "second_order");
+  report_memory_internal<TMB_FIMS_THIRD_ORDER>(report, "third_order");
+#endif
+  report.type = "";
+  std::map<uint32_t, DataInterfaceBase *>::iterator it;
+  for (it = DataInterfaceBase::live_objects.begin();
+       it != DataInterfaceBase::live_objects.end(); ++it) {
+    (*it).second->report_memory(report);
+  }
+  report.Add("interface", "FIMSRcppInterfaceBase", 0, "objects",
+             FIMSRcppInterfaceBase::fims_interface_objects.capacity() *
+                 sizeof(std::shared_ptr<FIMSRcppInterfaceBase>));
+  report.Add("log", "FIMSLog", 0,
+             fims::to_string(fims::FIMSLog::fims_log->get_entry_count()) +
+                 " entries",
+             fims::FIMSLog::fims_log->get_memory_usage());
+
+  size_t n = report.records.size();
+  Rcpp::CharacterVector type(n);
+  Rcpp::CharacterVector category(n);
+  Rcpp::CharacterVector module(n);
+  Rcpp::NumericVector id(n);
+  Rcpp::CharacterVector name(n);
+  Rcpp::NumericVector bytes(n);
+  Rcpp::LogicalVector shared(n);
+  for (size_t i = 0; i < n; i++) {
+    const fims::MemoryRecord &r = report.records[i];
+    type[i] = r.type;
+    category[i] = r.category;
+    module[i] = r.module;
+    id[i] = r.id;
+    name[i] = r.name;
+    bytes[i] = static_cast<double>(r.bytes);
+    shared[i] = r.shared;
+  }
+  return Rcpp::DataFrame::create(
+      Rcpp::Named("type") = type, Rcpp::Named("category") = category,
+      Rcpp::Named("module") = module, Rcpp::Named("id") = id,
+      Rcpp::Named("name") = name, Rcpp::Named("bytes") = bytes,
+      Rcpp::Named("shared") = shared,
+      Rcpp::Named("stringsAsFactors") = false);
+}
+
+/**
+ * @brief Reads optimizer settings from a list of controls.
+ *
+ * @param control A list with any of `eval.max`, `iter.max`, `rel.tol`,
+ * `grad.tol`, `newton.steps`, `memory`, and `fd.step`.
+ * @return The settings, with defaults for the controls not given.
+ */
+fims::OptimizerControl optimizer_control_from_list(Rcpp::List control) {
+  fims::OptimizerControl settings;
+  if (control.containsElementNamed("eval.max")) {
+    settings.max_evaluations = Rcpp::as<size_t>(control["eval.max"]);
+  }
+  if (control.containsElementNamed("iter.max")) {
+    settings.max_iterations = Rcpp::as<size_t>(control["iter.max"]);
+  }
+  if (control.containsElementNamed("rel.tol")) {
+    settings.relative_tolerance = Rcpp::as<double>(control["rel.tol"]);
+  }
+  if (control.containsElementNamed("grad.tol")) {
+    settings.gradient_tolerance = Rcpp::as<double>(control["grad.tol"]);
+  }
+  if (control.containsElementNamed("newton.steps")) {
+    settings.newton_steps = Rcpp::as<size_t>(control["newton.steps"]);
+  }
+  if (control.containsElementNamed("memory")) {
+    settings.memory = Rcpp::as<size_t>(control["memory"]);
+  }
+  if (control.containsElementNamed("fd.step")) {
+    settings.finite_difference_step =
+        Rcpp::as<double>(control["fd.step"]);
+  }
+  return settings;
+}
+
+/**
+ * @brief Minimizes the objective function of the double version of the model
+ * in C++.
+ *
+ * @details The fixed effects are estimated with a bounded L-BFGS minimizer
+ * that calls Model::Evaluate() directly, so objective function values do not
+ * cross into R. If gr is given, e.g., the gradient of a TMB object, it is
+ * used for the gradients and the Hessian of the Newton steps is found with
+ * central differences of it. gr is an R function, so every gradient is still
+ * a call into R; the gradient is not evaluated from the TMB tape in C++.
+ * Otherwise both are found with central finite differences of the objective.
+ * Random effects are held at their current values because the Laplace
+ * approximation is only available through TMB.
+ *
+ * The double model is evaluated incrementally during the fit, starting with
+ * a full evaluation.
+ *
+ * @param par The starting values of the fixed effects.
+ * @param lower The lower bounds, either empty or the same length as par.
+ * @param upper The upper bounds, either empty or the same length as par.
+ * @param control A list with any of `eval.max`, `iter.max`, `rel.tol`,
+ * `grad.tol`, `newton.steps`, `memory`, and `fd.step`.
+ * @param gr An optional R function that returns the gradient of the
+ * objective function at the fixed effects, e.g., `obj$gr` from
+ * `TMB::MakeADFun()`.
+ * @return A list in the same form as the output of `nlminb()`.
+ */
+Rcpp::List optimize_fims(Rcpp::NumericVector par, Rcpp::NumericVector lower,
+                         Rcpp::NumericVector upper, Rcpp::List control,
+                         Rcpp::Nullable<Rcpp::Function> gr = R_NilValue) {
+  std::shared_ptr<fims_info::Information<double>> information =
+      fims_info::Information<double>::GetInstance();
+  std::shared_ptr<fims_model::Model<double>> model =
+      fims_model::Model<double>::GetInstance();
+
+  if (static_cast<size_t>(par.size()) !=
+      information->fixed_effects_parameters.size()) {
+    FIMS_ERROR_LOG("optimize_fims: par has " + fims::to_string(par.size()) +
+                   " values but the model has " +
+                   fims::to_string(
+                       information->fixed_effects_parameters.size()) +
+                   " fixed effects.");
+    return Rcpp::List();
+  }
+  if (information->random_effects_parameters.size() > 0) {
+    FIMS_WARNING_LOG(
+        "optimize_fims: random effects are held at their current values.");
+  }
+
+  fims::Optimizer::gradient_t gradient;
+  if (gr.isNotNull()) {
+    Rcpp::Function gradient_function(gr);
+    gradient = [gradient_function](const std::vector<double> &x,
+                                   std::vector<double> &g) {
+      Rcpp::NumericVector value = gradient_function(Rcpp::wrap(x));
+      g.assign(value.begin(), value.end());
+    };
+  }
+  fims::Optimizer optimizer(
+      [&](const std::vector<double> &x) {
+        information->UpdateFixedEffectsParameters(x);
+        return model->Evaluate();
+      },
+      gradient);
+  optimizer.control = optimizer_control_from_list(control);
+
+  bool reporting = model->do_tmb_reporting;
+  model->do_tmb_reporting = false;
+  // finite differences change one parameter at a time, so most of each
+  // evaluation can be reused; the first evaluation is in full, since the
+  // model may have changed since it was last evaluated incrementally
+  bool incremental = model->incremental;
+  model->incremental = true;
+  model->last_parameters.clear();
+  fims::OptimizerResult result =
+      optimizer.Minimize(Rcpp::as<std::vector<double>>(par),
+                         Rcpp::as<std::vector<double>>(lower),
+                         Rcpp::as<std::vector<double>>(upper));
+  // leave the model at the estimates
+  information->UpdateFixedEffectsParameters(result.par);
+  model->incremental = incremental;
+  model->do_tmb_reporting = reporting;
+
+  Rcpp::NumericVector evaluations = Rcpp::NumericVector::create(
+      Rcpp::Named("function") =
+          static_cast<double>(result.function_evaluations),
+      Rcpp::Named("gradient") =
+          static_cast<double>(result.gradient_evaluations));
+  return Rcpp::List::create(
+      Rcpp::Named("par") = Rcpp::wrap(result.par),
+      Rcpp::Named("objective") = result.objective,
+      Rcpp::Named("convergence") = result.convergence,
+      Rcpp::Named("iterations") = static_cast<double>(result.iterations),
+      Rcpp::Named("evaluations") = evaluations,
+      Rcpp::Named("message") = result.message);
+}
+
+/**
+ * @brief Returns a function that masks the trailing years of the data of the
+ * Information instance of type Type, see fims_model::PeelData. The data are
+ * saved when this is called.
+ */
+template <typename Type>
+std::function<void(size_t)> peel_data_internal() {
+  std::shared_ptr<fims_model::PeelData<Type>> data =
+      std::make_shared<fims_model::PeelData<Type>>(
+          fims_info::Information<Type>::GetInstance());
+  return [data](size_t nyears_removed) { data->Mask(nyears_removed); };
+}
+
+/**
+ * @brief Runs a retrospective analysis on the double version of the model.
+ *
+ * @details Peels remove the last years of data by setting them to NA, refit
+ * with the C++ optimizer starting from the previous peel, and record spawning
+ * biomass, total F, and recruitment. The data and parameters are restored
+ * afterwards. Call this after the model is fit so peel 0 starts at the
+ * estimates. Models with random effects are rejected.
+ *
+ * Without gr the gradients are found with central finite differences of the
+ * objective function. TMB records the data as constants on its tape, so gr
+ * needs retape: for each peel the data of the AD Information instances are
+ * masked too and retape is called before gr is used, and once more after the
+ * data are restored. Both are R functions, so each call crosses into R.
+ *
+ * @param npeels The number of peels.
+ * @param control Optimizer settings, see `optimize_fims()`.
+ * @param gr An optional R function that returns the gradient of the
+ * objective function at the fixed effects, e.g., `obj$gr` from
+ * `TMB::MakeADFun()`.
+ * @param retape The R function that rebuilds the tape used by gr, e.g.,
+ * `obj$retape`. Required if gr is given.
+ * @return A list with Mohn's rho, a matrix for each quantity with one column
+ * per peel, and the estimates, objective function value, and convergence code
+ * of each peel. The list is empty if the analysis could not be run.
+ */
+Rcpp::List run_retrospective(size_t npeels, Rcpp::List control,
+                             Rcpp::Nullable<Rcpp::Function> gr = R_NilValue,
+                             Rcpp::Nullable<Rcpp::Function> retape =
+                                 R_NilValue) {
+  fims_model::Retrospective<double> retro;
+  retro.npeels = npeels;
+  retro.control = optimizer_control_from_list(control);
+
+  if (gr.isNotNull()) {
+    if (retape.isNull()) {
+      FIMS_ERROR_LOG(
+          "run_retrospective: gr needs retape, since the tape of gr holds "
+          "the data of the full model.");
+      return Rcpp::List();
+    }
+    Rcpp::Function gradient_function(gr);
+    Rcpp::Function retape_function(retape);
+    retro.gradient = [gradient_function](const std::vector<double> &x,
+                                         std::vector<double> &g) {
+      Rcpp::NumericVector value = gradient_function(Rcpp::wrap(x));
+      g.assign(value.begin(), value.end());
+    };
+    // the double instance is masked by Retrospective itself
+    std::vector<std::function<void(size_t)>> masks;
+#ifdef TMBAD_FRAMEWORK
+    masks.push_back(peel_data_internal<TMBAD_FIMS_TYPE>());
+#else
+    masks.push_back(peel_data_internal<TMB_FIMS_FIRST_ORDER>());
+    masks.push_back(peel_data_internal<TMB_FIMS_SECOND_ORDER>());
+    masks.push_back(peel_data_internal<TMB_FIMS_THIRD_ORDER>());
+#endif
+    retro.set_peel = [masks, retape_function](size_t nyears_removed) {
+      for (size_t i = 0; i < masks.size(); i++) {
+        masks[i](nyears_removed);
+      }
+      retape_function();
+    };
+  }
+
+  std::shared_ptr<fims_model::Model<double>> model =
+      fims_model::Model<double>::GetInstance();
+  bool reporting = model->do_tmb_reporting;
+  model->do_tmb_reporting = false;
+  fims_model::RetrospectiveResult result = retro.Run();
+  model->do_tmb_reporting = reporting;
+  if (result.objective.empty()) {
+    return Rcpp::List();
+  }
+
+  Rcpp::List out;
+  out["mohns_rho"] = Rcpp::NumericVector::create(
+      Rcpp::Named("ssb") = result.mohns_rho["ssb"],
+      Rcpp::Named("F") = result.mohns_rho["F"],
+      Rcpp::Named("recruitment") = result.mohns_rho["recruitment"]);
+  std::vector<std::string> names = {"ssb", "F", "recruitment"};
+  for (size_t q = 0; q < names.size(); q++) {
+    std::vector<std::vector<double>> &series = result.series[names[q]];
+    size_t nyears = series.empty() ? 0 : series[0].size();
+    Rcpp::NumericMatrix m(nyears, series.size());
+    for (size_t k = 0; k < series.size(); k++) {
+      for (size_t y = 0; y < nyears; y++) {
+        // years removed by a peel are not estimated
+        m(y, k) = (y + k < nyears) ? series[k][y] : NA_REAL;
+      }
+    }
+    out[names[q]] = m;
+  }
+  Rcpp::List par;
+  for (size_t k = 0; k < result.par.size(); k++) {
+    par.push_back(Rcpp::wrap(result.par[k]));
+  }
+  out["par"] = par;
+  out["objective"] = Rcpp::wrap(result.objective);
+  out["convergence"] = Rcpp::wrap(result.convergence);
+  return out;
+}
+
+/**
+ * @brief Sets the number of threads used to evaluate the double version of
+ * the model, e.g., in `optimize_fims()`, `run_retrospective()`, and
+ * `finalize()`. Fishery models that share no populations or fleets, and the
+ * populations within a catch-at-age model, are evaluated as separate tasks.
+ * The results do not depend on the number of threads.
+ *
+ * @param n The number of threads. One, the default, evaluates everything on
+ * the calling thread.
+ */
+void set_n_threads(size_t n) {
+  std::shared_ptr<fims_model::Model<double>> model =
+      fims_model::Model<double>::GetInstance();
+  model->n_threads = std::max<size_t>(1, n);
+}
+
 /**
  * @brief Clears the internal objects.
  *
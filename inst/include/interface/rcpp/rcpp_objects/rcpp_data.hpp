@@ -10,6 +10,7 @@
 #define FIMS_INTERFACE_RCPP_RCPP_OBJECTS_RCPP_DATA_HPP
 
 #include "../../../common/information.hpp"
+#include "../../../common/shared_data.hpp"
 #include "rcpp_interface_base.hpp"
 
 /**
@@ -66,10 +67,134 @@ class DataInterfaceBase : public FIMSRcppInterfaceBase {
    */
   virtual uint32_t get_id() { return this->id; }
 
+  /**
+   * @brief Gets the type of data, e.g., "Index", used to label the fits.
+   */
+  virtual std::string data_type() { return "data"; }
+
   /**
    * @brief Adds the parameters to the TMB model.
    */
   virtual bool add_to_fims_tmb() { return true; };
+
+  /**
+   * @brief Adds the buffer the data objects share to a memory report. It is
+   * marked as shared if an Information instance was reported first.
+   *
+   * @param report The report.
+   */
+  void report_memory(fims::MemoryReport& report) {
+    report.AddBuffer("interface", "DataInterface", this->id, this->data_type(),
+                     this->buffer);
+  }
+
+  /**
+   * @brief Replaces the observed values of this data object in every
+   * Information instance without rebuilding the model. If an instance
+   * rejects the values, the instances go back to the previous values, so
+   * they always agree.
+   *
+   * @param values The new values, folded in the same order as the data.
+   * @return True if every Information instance was updated.
+   */
+  virtual bool update_data(const std::vector<double>& values) {
+    bool updated = true;
+#ifdef TMB_MODEL
+    // one buffer for every Information instance
+    std::shared_ptr<fims::SharedData> buffer =
+        std::make_shared<fims::SharedData>(values);
+    updated = this->update_data_all(buffer);
+    if (updated) {
+      this->buffer = buffer;
+    } else if (this->buffer != nullptr) {
+      this->update_data_all(this->buffer);
+    }
+#endif
+    return updated;
+  }
+
+#ifdef TMB_MODEL
+  /**
+   * @brief Replaces the observed values of this data object in every
+   * Information instance.
+   *
+   * @param buffer The new values, folded in the same order as the data.
+   * @return True if every Information instance was updated.
+   */
+  bool update_data_all(const std::shared_ptr<fims::SharedData>& buffer) {
+    bool updated = true;
+#ifdef TMBAD_FRAMEWORK
+    updated &= this->update_data_internal<TMB_FIMS_REAL_TYPE>(buffer);
+    updated &= this->update_data_internal<TMBAD_FIMS_TYPE>(buffer);
+#else
+    updated &= this->update_data_internal<TMB_FIMS_REAL_TYPE>(buffer);
+    updated &= this->update_data_internal<TMB_FIMS_FIRST_ORDER>(buffer);
+    updated &= this->update_data_internal<TMB_FIMS_SECOND_ORDER>(buffer);
+    updated &= this->update_data_internal<TMB_FIMS_THIRD_ORDER>(buffer);
+#endif
+    return updated;
+  }
+#endif
+
+#ifdef TMB_MODEL
+  /**
+   * @brief Replaces the observed values of this data object in the
+   * Information instance of type Type.
+   *
+   * @param buffer The new values, folded in the same order as the data.
+   * @return True if the data object was found and updated.
+   */
+  template <typename Type>
+  bool update_data_internal(const std::shared_ptr<fims::SharedData>& buffer) {
+    std::shared_ptr<fims_info::Information<Type>> info =
+        fims_info::Information<Type>::GetInstance();
+    return info->UpdateDataObject(this->id, buffer);
+  }
+#endif
+
+ protected:
+  /**
+   * @brief The values shared by the data objects of every Information
+   * instance, set by add_to_fims_tmb().
+   */
+  std::shared_ptr<fims::SharedData> buffer;
+
+  /**
+   * @brief Copies the interface storage of the data into a buffer that the
+   * data objects of every Information instance share.
+   *
+   * @param storage The interface storage of the data.
+   */
+  void share(RealVector& storage) {
+    std::vector<double> values(storage.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = storage[i];
+    }
+    this->buffer = std::make_shared<fims::SharedData>(std::move(values));
+  }
+
+  /**
+   * @brief Copies new values into the interface storage of the data so that
+   * the output reflects the data used in the fit.
+   *
+   * @param storage The interface storage of the data.
+   * @param values The new values.
+   * @return True if the sizes match and the values were copied.
+   */
+  bool copy_to_interface(RealVector& storage,
+                         const std::vector<double>& values) {
+    if (storage.size() != values.size()) {
+      FIMS_ERROR_LOG("Data " + fims::to_string(this->id) + " has " +
+                     fims::to_string(storage.size()) + " values but " +
+                     fims::to_string(values.size()) +
+                     " were supplied, data not updated.");
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+      storage[i] = values[i];
+    }
+    return true;
+  }
 };
 // static id of the DataInterfaceBase object
 uint32_t DataInterfaceBase::id_g = 1;
@@ -126,6 +251,22 @@ class AgeCompDataInterface : public DataInterfaceBase {
    */
   virtual ~AgeCompDataInterface() {}
 
+  /**
+   * @brief Replaces the observed values without rebuilding the model. The
+   * Information instances are updated first, so the interface keeps the old
+   * values if they reject the new ones.
+   *
+   * @param values The new values, folded in the same order as the data.
+   * @return True if the interface and every Information instance were
+   * updated.
+   */
+  virtual bool update_data(const std::vector<double>& values) {
+    if (!DataInterfaceBase::update_data(values)) {
+      return false;
+    }
+    return this->copy_to_interface(this->age_comp_data, values);
+  }
+
   /**
    * @brief Gets the ID of the interface base object.
    * @return The ID.
@@ -157,6 +298,11 @@ class AgeCompDataInterface : public DataInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Gets the type of data used to label the fits.
+   */
+  virtual std::string data_type() { return "AgeComp"; }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -166,12 +312,7 @@ class AgeCompDataInterface : public DataInterfaceBase {
                                                              this->amax);
 
     age_comp_data->id = this->id;
-    for (int y = 0; y < ymax; y++) {
-      for (int a = 0; a < amax; a++) {
-        int i_age_year = y * amax + a;
-        age_comp_data->at(y, a) = this->age_comp_data[i_age_year];
-      }
-    }
+    age_comp_data->data.SetBuffer(this->buffer);
 
     std::shared_ptr<fims_info::Information<Type>> info =
         fims_info::Information<Type>::GetInstance();
@@ -186,6 +327,7 @@ class AgeCompDataInterface : public DataInterfaceBase {
    * @return A boolean of true.
    */
   virtual bool add_to_fims_tmb() {
+    this->share(this->age_comp_data);
 #ifdef TMBAD_FRAMEWORK
     this->add_to_fims_tmb_internal<TMB_FIMS_REAL_TYPE>();
     this->add_to_fims_tmb_internal<TMBAD_FIMS_TYPE>();
@@ -251,6 +393,22 @@ class LengthCompDataInterface : public DataInterfaceBase {
    */
   virtual ~LengthCompDataInterface() {}
 
+  /**
+   * @brief Replaces the observed values without rebuilding the model. The
+   * Information instances are updated first, so the interface keeps the old
+   * values if they reject the new ones.
+   *
+   * @param values The new values, folded in the same order as the data.
+   * @return True if the interface and every Information instance were
+   * updated.
+   */
+  virtual bool update_data(const std::vector<double>& values) {
+    if (!DataInterfaceBase::update_data(values)) {
+      return false;
+    }
+    return this->copy_to_interface(this->length_comp_data, values);
+  }
+
   /**
    * @brief Gets the ID of the interface base object.
    * @return The ID.
@@ -282,6 +440,11 @@ class LengthCompDataInterface : public DataInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Gets the type of data used to label the fits.
+   */
+  virtual std::string data_type() { return "LengthComp"; }
+
 #ifdef TMB_MODEL
   template <typename Type>
   bool add_to_fims_tmb_internal() {
@@ -289,12 +452,7 @@ class LengthCompDataInterface : public DataInterfaceBase {
         std::make_shared<fims_data_object::DataObject<Type>>(this->ymax,
                                                              this->lmax);
     length_comp_data->id = this->id;
-    for (int y = 0; y < ymax; y++) {
-      for (int l = 0; l < lmax; l++) {
-        int i_length_year = y * lmax + l;
-        length_comp_data->at(y, l) = this->length_comp_data[i_length_year];
-      }
-    }
+    length_comp_data->data.SetBuffer(this->buffer);
     std::shared_ptr<fims_info::Information<Type>> info =
         fims_info::Information<Type>::GetInstance();
     info->data_objects[this->id] = length_comp_data;
@@ -306,6 +464,7 @@ class LengthCompDataInterface : public DataInterfaceBase {
    * @return A boolean of true.
    */
   virtual bool add_to_fims_tmb() {
+    this->share(this->length_comp_data);
 #ifdef TMBAD_FRAMEWORK
     this->add_to_fims_tmb_internal<TMB_FIMS_REAL_TYPE>();
     this->add_to_fims_tmb_internal<TMBAD_FIMS_TYPE>();
@@ -362,6 +521,22 @@ class IndexDataInterface : public DataInterfaceBase {
    */
   virtual ~IndexDataInterface() {}
 
+  /**
+   * @brief Replaces the observed values without rebuilding the model. The
+   * Information instances are updated first, so the interface keeps the old
+   * values if they reject the new ones.
+   *
+   * @param values The new values, folded in the same order as the data.
+   * @return True if the interface and every Information instance were
+   * updated.
+   */
+  virtual bool update_data(const std::vector<double>& values) {
+    if (!DataInterfaceBase::update_data(values)) {
+      return false;
+    }
+    return this->copy_to_interface(this->index_data, values);
+  }
+
   /**
    * @brief Gets the ID of the interface base object.
    * @return The ID.
@@ -393,6 +568,11 @@ class IndexDataInterface : public DataInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Gets the type of data used to label the fits.
+   */
+  virtual std::string data_type() { return "Index"; }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -402,9 +582,7 @@ class IndexDataInterface : public DataInterfaceBase {
 
     data->id = this->id;
 
-    for (int y = 0; y < ymax; y++) {
-      data->at(y) = this->index_data[y];
-    }
+    data->data.SetBuffer(this->buffer);
 
     std::shared_ptr<fims_info::Information<Type>> info =
         fims_info::Information<Type>::GetInstance();
@@ -418,6 +596,7 @@ class IndexDataInterface : public DataInterfaceBase {
    * @return A boolean of true.
    */
   virtual bool add_to_fims_tmb() {
+    this->share(this->index_data);
 #ifdef TMBAD_FRAMEWORK
     this->add_to_fims_tmb_internal<TMB_FIMS_REAL_TYPE>();
     this->add_to_fims_tmb_internal<TMBAD_FIMS_TYPE>();
@@ -475,6 +654,22 @@ class LandingsDataInterface : public DataInterfaceBase {
    */
   virtual ~LandingsDataInterface() {}
 
+  /**
+   * @brief Replaces the observed values without rebuilding the model. The
+   * Information instances are updated first, so the interface keeps the old
+   * values if they reject the new ones.
+   *
+   * @param values The new values, folded in the same order as the data.
+   * @return True if the interface and every Information instance were
+   * updated.
+   */
+  virtual bool update_data(const std::vector<double>& values) {
+    if (!DataInterfaceBase::update_data(values)) {
+      return false;
+    }
+    return this->copy_to_interface(this->landings_data, values);
+  }
+
   /**
    * @brief Gets the ID of the interface base object.
    * @return The ID.
@@ -506,6 +701,11 @@ class LandingsDataInterface : public DataInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Gets the type of data used to label the fits.
+   */
+  virtual std::string data_type() { return "Landings"; }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -515,9 +715,7 @@ class LandingsDataInterface : public DataInterfaceBase {
 
     data->id = this->id;
 
-    for (int y = 0; y < ymax; y++) {
-      data->at(y) = this->landings_data[y];
-    }
+    data->data.SetBuffer(this->buffer);
 
     std::shared_ptr<fims_info::Information<Type>> info =
         fims_info::Information<Type>::GetInstance();
@@ -531,6 +729,7 @@ class LandingsDataInterface : public DataInterfaceBase {
    * @return A boolean of true.
    */
   virtual bool add_to_fims_tmb() {
+    this->share(this->landings_data);
 #ifdef TMBAD_FRAMEWORK
     this->add_to_fims_tmb_internal<TMB_FIMS_REAL_TYPE>();
     this->add_to_fims_tmb_internal<TMBAD_FIMS_TYPE>();
@@ -247,6 +247,18 @@ class PellaTomlinsonInterface : public DepletionInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters to the estimates table.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("depletion", this->id, "Pella--Tomlinson", "log_r",
+                          this->log_r);
+    tables.add_parameters("depletion", this->id, "Pella--Tomlinson", "log_K",
+                          this->log_K);
+    tables.add_parameters("depletion", this->id, "Pella--Tomlinson", "log_m",
+                          this->log_m);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -104,6 +104,37 @@ class DistributionsInterfaceBase : public FIMSRcppInterfaceBase {
    * each distribution can have an evaluate() function.
    */
   virtual double evaluate() = 0;
+
+  /**
+   * @brief Adds one row per observation to the fits table if the distribution
+   * is fit to data. The label is filled in from the data object afterwards.
+   *
+   * @param tables The output tables.
+   * @param distribution The type of distribution.
+   * @param x The observed values.
+   * @param expected_values The expected values.
+   * @param lpdf_vec The log-likelihood of each observation.
+   */
+  void add_fits(OutputTables &tables, const std::string &distribution,
+                ParameterVector &x, ParameterVector &expected_values,
+                RealVector &lpdf_vec) {
+    if (this->input_type_m.get() != "data") {
+      return;
+    }
+    for (size_t i = 0; i < lpdf_vec.size(); i++) {
+      tables.fits.module_name.push_back("data");
+      tables.fits.module_id.push_back(this->id_m);
+      tables.fits.label.push_back("");
+      tables.fits.data_id.push_back(this->interface_observed_data_id_m.get());
+      tables.fits.index.push_back(i + 1);
+      tables.fits.distribution.push_back(distribution);
+      tables.fits.init.push_back(i < x.size() ? x[i].final_value_m : NA_REAL);
+      tables.fits.expected.push_back(i < expected_values.size()
+                                         ? expected_values[i].final_value_m
+                                         : NA_REAL);
+      tables.fits.log_like.push_back(lpdf_vec[i]);
+    }
+  }
 };
 // static id of the DistributionsInterfaceBase object
 uint32_t DistributionsInterfaceBase::id_g = 1;
@@ -331,6 +362,14 @@ class DnormDistributionsInterface : public DistributionsInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the fits to data to the output tables.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    this->add_fits(tables, "normal", this->x, this->expected_values,
+                   this->lpdf_vec);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -622,6 +661,14 @@ class DlnormDistributionsInterface : public DistributionsInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the fits to data to the output tables.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    this->add_fits(tables, "log_normal", this->x, this->expected_values,
+                   this->lpdf_vec);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -924,6 +971,14 @@ class DmultinomDistributionsInterface : public DistributionsInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the fits to data to the output tables.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    this->add_fits(tables, "Dmultinom", this->x, this->expected_values,
+                   this->lpdf_vec);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
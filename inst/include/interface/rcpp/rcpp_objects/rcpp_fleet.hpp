@@ -130,6 +130,16 @@ class FleetInterface : public FleetInterfaceBase {
    * fleet.
    */
   ParameterVector log_Fmort;
+  /**
+   * @brief If true, the fishing mortality in each year is solved from the
+   * observed landings and log_Fmort is not estimated, so the landings must be
+   * observed in every year. The landings likelihood of the fleet is kept so
+   * its fits are reported as usual, but its expected landings equal the
+   * observed landings and the term does not inform the other parameters. Its
+   * standard deviation must be fixed, since an estimated one would shrink
+   * toward zero. The default is false.
+   */
+  SharedBoolean hybrid_F = false;
   /**
    * @brief The vector of natural log of the expected total landings for
    * the fleet.
@@ -271,6 +281,7 @@ class FleetInterface : public FleetInterfaceBase {
         age_to_length_conversion(other.age_to_length_conversion),
         observed_landings_units(other.observed_landings_units),
         observed_index_units(other.observed_index_units),
+        hybrid_F(other.hybrid_F),
         derived_landings_naa(other.derived_landings_naa),
         derived_landings_nal(other.derived_landings_nal),
         derived_landings_waa(other.derived_landings_waa),
@@ -392,7 +403,11 @@ class FleetInterface : public FleetInterfaceBase {
           std::dynamic_pointer_cast<fims_popdy::Fleet<double> >(it->second);
 
       for (size_t i = 0; i < this->log_Fmort.size(); i++) {
-        if (this->log_Fmort[i].estimation_type_m.get() == "constant") {
+        if (fleet->hybrid_F && i < fleet->Fmort.size() &&
+            fleet->Fmort[i] > 0.0) {
+          // the solved F, so the output shows the F the model used
+          this->log_Fmort[i].final_value_m = std::log(fleet->Fmort[i]);
+        } else if (this->log_Fmort[i].estimation_type_m.get() == "constant") {
           this->log_Fmort[i].final_value_m = this->log_Fmort[i].initial_value_m;
         } else {
           this->log_Fmort[i].final_value_m = fleet->log_Fmort[i];
@@ -789,6 +804,55 @@ class FleetInterface : public FleetInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters and derived quantities to the output tables.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("Fleet", this->id, "fleet", "log_Fmort",
+                          this->log_Fmort);
+    tables.add_parameters("Fleet", this->id, "fleet", "log_q", this->log_q);
+    if (this->nlengths.get() > 0) {
+      tables.add_parameters("Fleet", this->id, "fleet",
+                            "age_to_length_conversion",
+                            this->age_to_length_conversion);
+    }
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_naa",
+                                this->derived_landings_naa);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_nal",
+                                this->derived_landings_nal);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_waa",
+                                this->derived_landings_waa);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_naa",
+                                this->derived_index_naa);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_nal",
+                                this->derived_index_nal);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_waa",
+                                this->derived_index_waa);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "agecomp_expected",
+                                this->derived_agecomp_expected);
+    tables.add_derived_quantity("Fleet", this->id, "fleet",
+                                "lengthcomp_expected",
+                                this->derived_lengthcomp_expected);
+    tables.add_derived_quantity("Fleet", this->id, "fleet",
+                                "agecomp_proportion",
+                                this->derived_agecomp_proportion);
+    tables.add_derived_quantity("Fleet", this->id, "fleet",
+                                "lengthcomp_proportion",
+                                this->derived_lengthcomp_proportion);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_expected",
+                                this->derived_index_expected);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_weight",
+                                this->derived_index_w);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "index_numbers",
+                                this->derived_index_n);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_expected",
+                                this->derived_landings_expected);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_weight",
+                                this->derived_landings_w);
+    tables.add_derived_quantity("Fleet", this->id, "fleet", "landings_numbers",
+                                this->derived_landings_n);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -808,6 +872,7 @@ class FleetInterface : public FleetInterfaceBase {
     fleet->nyears = this->nyears.get();
     fleet->observed_landings_units = this->observed_landings_units;
     fleet->observed_index_units = this->observed_index_units;
+    fleet->hybrid_F = this->hybrid_F.get();
 
     fleet->fleet_observed_agecomp_data_id_m =
         interface_observed_agecomp_data_id_m.get();
@@ -844,6 +909,10 @@ class FleetInterface : public FleetInterfaceBase {
     fleet->log_Fmort.resize(this->log_Fmort.size());
     for (size_t i = 0; i < log_Fmort.size(); i++) {
       fleet->log_Fmort[i] = this->log_Fmort[i].initial_value_m;
+      // with hybrid F, F is solved from the landings, not estimated
+      if (fleet->hybrid_F) {
+        continue;
+      }
 
       if (this->log_Fmort[i].estimation_type_m.get() == "fixed_effects") {
         ss.str("");
@@ -87,6 +87,11 @@ class EWAAGrowthInterface : public GrowthInterfaceBase {
    * @brief Ages (years) for each age class.
    */
   RealVector ages;
+  /**
+   * @brief Optional weights by year and age, ordered by age within year. When
+   * empty, weights are used for every year.
+   */
+  RealVector weights_at_year;
   /**
    * @brief A map of empirical weight-at-age values. TODO: describe this
    * parameter better.
@@ -115,6 +120,7 @@ class EWAAGrowthInterface : public GrowthInterfaceBase {
       : GrowthInterfaceBase(other),
         weights(other.weights),
         ages(other.ages),
+        weights_at_year(other.weights_at_year),
         ewaa(other.ewaa),
         initialized(other.initialized) {}
 
@@ -209,6 +215,10 @@ class EWAAGrowthInterface : public GrowthInterfaceBase {
     // set relative info
     ewaa_growth->id = this->id;
     ewaa_growth->ewaa = make_map(this->ages, this->weights);  // this->ewaa;
+    ewaa_growth->weight_at_year_age.resize(this->weights_at_year.size());
+    for (size_t i = 0; i < this->weights_at_year.size(); i++) {
+      ewaa_growth->weight_at_year_age[i] = this->weights_at_year[i];
+    }
     // add to Information
     info->growth_models[ewaa_growth->id] = ewaa_growth;
 
@@ -11,6 +11,7 @@
 
 #include <RcppCommon.h>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "../../../common/def.hpp"
@@ -452,11 +453,7 @@ class RealVector {
    */
   RealVector(Rcpp::NumericVector x, size_t size) {
     this->id_m = RealVector::id_g++;
-    this->storage_m = std::make_shared<std::vector<double> >();
-    this->resize(x.size());
-    for (size_t i = 0; i < x.size(); i++) {
-      storage_m->at(i) = x[i];
-    }
+    this->storage_m = std::make_shared<std::vector<double> >(x.begin(), x.end());
   }
 
   /**
@@ -465,11 +462,7 @@ class RealVector {
    */
   RealVector(const fims::Vector<double>& v) {
     this->id_m = RealVector::id_g++;
-    this->storage_m = std::make_shared<std::vector<double> >();
-    this->storage_m->resize(v.size());
-    for (size_t i = 0; i < v.size(); i++) {
-      storage_m->at(i) = v[i];
-    }
+    this->storage_m = std::make_shared<std::vector<double> >(v.begin(), v.end());
   }
 
   /**
@@ -485,10 +478,7 @@ class RealVector {
    * @return RealVector&
    */
   RealVector& operator=(const Rcpp::NumericVector& v) {
-    this->storage_m->resize(v.size());
-    for (size_t i = 0; i < v.size(); i++) {
-      storage_m->at(i) = v[i];
-    }
+    this->storage_m->assign(v.begin(), v.end());
     return *this;
   }
 
@@ -503,10 +493,7 @@ class RealVector {
    * @param orig
    */
   void fromRVector(const Rcpp::NumericVector& orig) {
-    this->storage_m->resize(orig.size());
-    for (size_t i = 0; i < this->storage_m->size(); i++) {
-      this->storage_m->at(i) = orig[i];
-    }
+    this->storage_m->assign(orig.begin(), orig.end());
   }
 
   /**
@@ -515,12 +502,7 @@ class RealVector {
    * @return Rcpp::NumericVector
    */
   Rcpp::NumericVector toRVector() {
-    Rcpp::NumericVector ret(this->storage_m->size());
-    for (size_t i = 0; i < this->size(); i++) {
-      ret[i] = this->storage_m->at(i);
-    }
-
-    return ret;
+    return Rcpp::NumericVector(this->storage_m->begin(), this->storage_m->end());
   }
 
   /**
@@ -609,6 +591,100 @@ class RealVector {
 };
 uint32_t RealVector::id_g = 0;
 
+/**
+ * @brief Column-oriented output tables that the interface objects fill after
+ * the model is finalized.
+ *
+ * @details Every column is a plain vector with one entry per row, so the
+ * tables can be returned to R as lists of atomic vectors and wrapped into data
+ * frames without writing or parsing JSON. Rows for a vector-valued parameter,
+ * derived quantity, or likelihood are added in element order, and `index` is
+ * the one-based position of the element within its vector.
+ */
+struct OutputTables {
+  /**
+   * @brief Parameter estimates, one row per parameter element.
+   */
+  struct Estimates {
+    std::vector<std::string> module_name;     /**< module name */
+    std::vector<int> module_id;               /**< module id */
+    std::vector<std::string> module_type;     /**< module type */
+    std::vector<std::string> label;           /**< parameter name */
+    std::vector<int> type_id;                 /**< id of the ParameterVector */
+    std::vector<std::string> type;            /**< parameter type */
+    std::vector<int> parameter_id;            /**< id of the Parameter */
+    std::vector<int> index;                   /**< position in the vector */
+    std::vector<double> initial;              /**< starting value */
+    std::vector<double> estimate;             /**< final value */
+    std::vector<std::string> estimation_type; /**< estimation type */
+  } estimates; /**< parameter estimates */
+
+  /**
+   * @brief Derived quantities, one row per element.
+   */
+  struct DerivedQuantities {
+    std::vector<std::string> module_name; /**< module name */
+    std::vector<int> module_id;           /**< module id */
+    std::vector<std::string> module_type; /**< module type */
+    std::vector<std::string> label;       /**< derived quantity name */
+    std::vector<int> index;               /**< position in the vector */
+    std::vector<double> estimate;         /**< value */
+  } derived_quantities; /**< derived quantities */
+
+  /**
+   * @brief Fits to data, one row per observation.
+   */
+  struct Fits {
+    std::vector<std::string> module_name;  /**< always "data" */
+    std::vector<int> module_id;            /**< distribution id */
+    std::vector<std::string> label;        /**< type of data, e.g., "Index" */
+    std::vector<int> data_id;              /**< id of the data object */
+    std::vector<int> index;                /**< position in the data */
+    std::vector<std::string> distribution; /**< distribution type */
+    std::vector<double> init;              /**< observed value */
+    std::vector<double> expected;          /**< expected value */
+    std::vector<double> log_like;          /**< log-likelihood contribution */
+  } fits; /**< fits to data */
+
+  /**
+   * @brief Adds one row per element of a parameter vector to the estimates.
+   */
+  void add_parameters(const std::string& module_name, uint32_t module_id,
+                      const std::string& module_type, const std::string& label,
+                      ParameterVector& p) {
+    for (size_t i = 0; i < p.size(); i++) {
+      this->estimates.module_name.push_back(module_name);
+      this->estimates.module_id.push_back(module_id);
+      this->estimates.module_type.push_back(module_type);
+      this->estimates.label.push_back(label);
+      this->estimates.type_id.push_back(p.id_m);
+      this->estimates.type.push_back("vector");
+      this->estimates.parameter_id.push_back(p[i].id_m);
+      this->estimates.index.push_back(i + 1);
+      this->estimates.initial.push_back(p[i].initial_value_m);
+      this->estimates.estimate.push_back(p[i].final_value_m);
+      this->estimates.estimation_type.push_back(p[i].estimation_type_m.get());
+    }
+  }
+
+  /**
+   * @brief Adds one row per element of a derived quantity.
+   */
+  void add_derived_quantity(const std::string& module_name, uint32_t module_id,
+                            const std::string& module_type,
+                            const std::string& label,
+                            const Rcpp::NumericVector& values) {
+    for (R_xlen_t i = 0; i < values.size(); i++) {
+      this->derived_quantities.module_name.push_back(module_name);
+      this->derived_quantities.module_id.push_back(module_id);
+      this->derived_quantities.module_type.push_back(module_type);
+      this->derived_quantities.label.push_back(label);
+      this->derived_quantities.index.push_back(i + 1);
+      this->derived_quantities.estimate.push_back(values[i]);
+    }
+  }
+};
+
 /**
  *@brief Base class for all interface objects.
  */
@@ -647,6 +723,12 @@ class FIMSRcppInterfaceBase {
     return "{\"name\" : \"not yet implemented\"}";
   }
 
+  /**
+   * @brief Adds the rows for this object to the output tables. Called after
+   * finalize(). The default adds nothing.
+   */
+  virtual void add_to_tables(OutputTables& tables) {}
+
   /**
    * @brief Make a string of dimensions for the model.
    */
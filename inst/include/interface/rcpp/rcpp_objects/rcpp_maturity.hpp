@@ -209,6 +209,16 @@ class LogisticMaturityInterface : public MaturityInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters to the estimates table.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("maturity", this->id, "logistic", "inflection_point",
+                          this->inflection_point);
+    tables.add_parameters("maturity", this->id, "logistic", "slope",
+                          this->slope);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -10,6 +10,7 @@
 #include "rcpp_interface_base.hpp"
 #include <valarray>
 #include <cmath>
+#include <future>
 #include <mutex>
 
 /**
@@ -92,13 +93,48 @@ std::map<uint32_t, std::shared_ptr<FisheryModelInterfaceBase>>
 class CatchAtAgeInterface : public FisheryModelInterfaceBase {
   std::shared_ptr<std::set<uint32_t>> population_ids;
   typedef typename std::set<uint32_t>::iterator population_id_iterator;
+  /**
+   * @brief The names of the derived quantities to report with standard
+   * errors, or empty to report all of them.
+   */
+  std::shared_ptr<std::set<std::string>> report_quantities;
 
  public:
+  /**
+   * @brief If true, reference points are calculated in the model report and
+   * their standard errors are available from `TMB::sdreport()`.
+   */
+  SharedBoolean do_reference_points = false;
+  /**
+   * @brief The target spawning potential ratios for the SPR-based reference
+   * points.
+   */
+  RealVector spr_targets;
+  /**
+   * @brief If true, the catch equation, survival step, and composition
+   * normalization are recorded on the AD tape as atomic operations.
+   */
+  SharedBoolean use_atomic_kernels = true;
+  /**
+   * @brief The number of years in each checkpointed block of the population
+   * recursion, or zero to record the years directly on the AD tape.
+   */
+  SharedInt checkpoint_years = 0;
+  /**
+   * @brief If true, the modules of each population are resolved to their
+   * concrete types and evaluated without virtual calls.
+   */
+  SharedBoolean static_dispatch = true;
   /**
    * @brief The constructor.
    */
   CatchAtAgeInterface() : FisheryModelInterfaceBase() {
     this->population_ids = std::make_shared<std::set<uint32_t>>();
+    this->report_quantities = std::make_shared<std::set<std::string>>();
+    this->spr_targets.resize(3);
+    this->spr_targets[0] = 0.3;
+    this->spr_targets[1] = 0.35;
+    this->spr_targets[2] = 0.4;
     std::shared_ptr<CatchAtAgeInterface> caa =
         std::make_shared<CatchAtAgeInterface>(*this);
     FIMSRcppInterfaceBase::fims_interface_objects.push_back(caa);
@@ -112,7 +148,28 @@ class CatchAtAgeInterface : public FisheryModelInterfaceBase {
    */
   CatchAtAgeInterface(const CatchAtAgeInterface &other)
       : FisheryModelInterfaceBase(other),
-        population_ids(other.population_ids) {}
+        population_ids(other.population_ids),
+        report_quantities(other.report_quantities),
+        do_reference_points(other.do_reference_points),
+        spr_targets(other.spr_targets),
+        use_atomic_kernels(other.use_atomic_kernels),
+        checkpoint_years(other.checkpoint_years),
+        static_dispatch(other.static_dispatch) {}
+
+  /**
+   * @brief Sets the derived quantities to report with standard errors, e.g.,
+   * "spawning_biomass". Derived quantities that are neither reported nor used
+   * by a likelihood are not computed on the AD tape. An empty vector reports
+   * all of them.
+   *
+   * @param names The names of the derived quantities.
+   */
+  void SetReportQuantities(Rcpp::CharacterVector names) {
+    this->report_quantities->clear();
+    for (R_xlen_t i = 0; i < names.size(); i++) {
+      this->report_quantities->insert(Rcpp::as<std::string>(names[i]));
+    }
+  }
 
   /**
    * Method to add a population id to the set of population ids.
@@ -535,258 +592,217 @@ class CatchAtAgeInterface : public FisheryModelInterfaceBase {
     return result;
   }
 
+  /**
+   * @brief Finds the double version of this model and one of its populations.
+   *
+   * @param population_id The id of the population.
+   * @param model Output pointer to the model.
+   * @return The population, or nullptr if the model has not been created or
+   * does not contain the population. Stops with an error if the model with
+   * this id is not a catch-at-age model.
+   */
+  std::shared_ptr<fims_popdy::Population<double>> get_model_population(
+      uint32_t population_id,
+      std::shared_ptr<fims_popdy::CatchAtAge<double>> &model) {
+    std::shared_ptr<fims_info::Information<double>> info =
+        fims_info::Information<double>::GetInstance();
+    typename fims_info::Information<double>::model_map_iterator model_it =
+        info->models_map.find(this->get_id());
+    if (model_it == info->models_map.end()) {
+      FIMS_ERROR_LOG("Model " + fims::to_string(this->get_id()) +
+                     " not found, call CreateTMBModel() first.");
+      return nullptr;
+    }
+    model = std::dynamic_pointer_cast<fims_popdy::CatchAtAge<double>>(
+        (*model_it).second);
+    if (model == nullptr) {
+      Rcpp::stop("Model " + fims::to_string(this->get_id()) +
+                 " is not a catch-at-age model.");
+    }
+    for (size_t p = 0; p < model->populations.size(); p++) {
+      if (model->populations[p]->GetId() == population_id) {
+        return model->populations[p];
+      }
+    }
+    FIMS_ERROR_LOG("Population with id " + fims::to_string(population_id) +
+                   " not found in model " + fims::to_string(this->get_id()) +
+                   ".");
+    return nullptr;
+  }
+
+  /**
+   * @brief Converts reference points to a named list.
+   */
+  Rcpp::List reference_points_to_list(
+      uint32_t population_id, fims_popdy::ReferencePoints<double> rp) {
+    return Rcpp::List::create(
+        Rcpp::Named("population") = population_id,
+        Rcpp::Named("F_msy") = rp.F_msy, Rcpp::Named("msy") = rp.msy,
+        Rcpp::Named("ssb_msy") = rp.ssb_msy, Rcpp::Named("b_msy") = rp.b_msy,
+        Rcpp::Named("r_msy") = rp.r_msy, Rcpp::Named("spr_msy") = rp.spr_msy,
+        Rcpp::Named("r0") = rp.r0, Rcpp::Named("ssb0") = rp.ssb0,
+        Rcpp::Named("b0") = rp.b0, Rcpp::Named("phi0") = rp.phi0,
+        Rcpp::Named("spr_targets") = Rcpp::wrap(std::vector<double>(rp.spr_targets)),
+        Rcpp::Named("F_spr") = Rcpp::wrap(std::vector<double>(rp.F_spr)),
+        Rcpp::Named("ssb_spr") = Rcpp::wrap(std::vector<double>(rp.ssb_spr)),
+        Rcpp::Named("yield_spr") = Rcpp::wrap(std::vector<double>(rp.yield_spr)));
+  }
+
   /**
    * @brief Method to calculate reference points for a population.
+   *
+   * @details Uses the selectivity, natural mortality, maturity, weight at age,
+   * and stock-recruit modules of the population at their current values,
+   * with F allocated among fleets by the terminal-year F.
+   *
    * @param population_interface
-   * @param maxF The maximum fishing mortality to calculate reference points
-   * for.
-   * @param step The step size for the fishing mortality.
    * @return A list of reference points for the population.
    */
   Rcpp::List calculate_reference_points_population(
-      PopulationInterface *population_interface, double maxF = 1.0,
-      double step = 0.01) {
-    //         //note: this algorithm is ported from the Meta-population
-    //         assessment system project and
-    //         //needs review
+      PopulationInterface *population_interface) {
+    std::shared_ptr<fims_popdy::CatchAtAge<double>> model;
+    std::shared_ptr<fims_popdy::Population<double>> population =
+        this->get_model_population(population_interface->get_id(), model);
+    if (population == nullptr) {
+      return Rcpp::List();
+    }
+    model->spr_targets = this->spr_target_values();
+    return this->reference_points_to_list(
+        population->GetId(), model->CalculateReferencePoints(population));
+  }
 
+  /**
+   * @brief Calculates reference points of a population for several fleet
+   * allocations in parallel.
+   *
+   * @param population_id The id of the population.
+   * @param allocations A list of numeric vectors, each giving the share of F
+   * for every fleet of the population in the order the fleets were added.
+   * @return A list with one set of reference points per allocation.
+   */
+  Rcpp::List calculate_reference_points_allocations(uint32_t population_id,
+                                                    Rcpp::List allocations) {
     Rcpp::List result;
-    //         double spawning_season_offset = 0.0;
-    //         std::shared_ptr<fims_info::Information<double>> info =
-    //             fims_info::Information<double>::GetInstance();
-
-    //         typename fims_info::Information<double>::population_iterator pit;
-
-    //         pit = info->populations.find(population_interface->get_id());
-
-    //         if (pit != info->populations.end())
-    //         {
-    //             std::shared_ptr<fims_popdy::Population<double>> &pop =
-    //             (*pit).second;
-
-    //             size_t year = pop->nyears - 1;
-    //             size_t season = pop->nseasons - 1;
-    //             size_t nages = pop->ages.size();
-
-    //             std::vector<double> F;
-    //             for (double f = 0.0; f <= maxF; f += step)
-    //             {
-    //                 F.push_back(f);
-    //             }
-
-    //             std::valarray<double> spr(F.size());       // equilibrium spr
-    //             at F std::valarray<double> spr_ratio(F.size()); //
-    //             equilibrium spr at F std::vector<double> S_eq(F.size()); //
-    //             equilibrium SSB at F std::vector<double> R_eq(F.size()); //
-    //             equilibrium recruitment at F std::vector<double>
-    //             B_eq(F.size());        // equilibrium biomass at F
-    //             std::vector<double> L_eq(F.size());        // equilibrium
-    //             landings at F std::vector<double> D_eq(F.size());        //
-    //             equilibrium dead discards at F std::vector<double>
-    //             E_eq(F.size());        // equilibrium exploitation rate at F
-    //             (landings only) std::valarray<double> L_eq_knum(F.size());
-    //             std::valarray<double> SSB_eq(F.size());
-    //             double spr_F0 = 0.0;
-
-    //             std::vector<double> N0(pop->ages.size(), 1.0);
-    //             for (int iage = 1; iage < nages; iage++)
-    //             {
-    //                 N0[iage] = N0[iage - 1] * std::exp(-1.0 * pop->M[iage -
-    //                 1]);
-    //             }
-    //             N0[nages - 1] = N0[nages - 2] * std::exp(-1.0 * pop->M[nages
-    //             - 2]) / (1.0 - std::exp(-1.0 * pop->M[nages - 1]));
-
-    //             std::valarray<double> reprod(nages);
-    //             std::valarray<double> selL(nages);
-    //             std::valarray<double> selZ(nages);
-    //             std::valarray<double> selD(nages);
-    //             std::valarray<double> M_age(nages);
-    //             std::valarray<double> wgt(nages);
-
-    //             for (int a = 0; a < pop->ages.size(); a++)
-    //             {
-    //                 // dimension folded index
-    //                 size_t index = year * pop->ages.size() + a;
-
-    //                 // is this ssb_unfished?
-    //                 reprod[a] =
-    //                 pop->derived_quantities["weight_at_age"][index] *
-    //                 (pop->derived_quantities["proportion_mature_at_age"][index]
-    //                 * pop->proportion_female[0]); spr_F0 += N0[a] *
-    //                 reprod[a]; selL[a] =
-    //                 pop->derived_quantities["sum_selectivity"][index];
-    //                 selZ[a] =
-    //                 pop->derived_quantities["sum_selectivity"][index];
-    //                 M_age[a] = pop->M[a];
-    //                 wgt[a] = pop->derived_quantities["weight_at_age"][a];
-    //             }
-
-    //             std::valarray<double> L_age(nages); // #landings at age
-    //             std::valarray<double> D_age(nages); // #dead discards at age
-    //             std::valarray<double> F_age(nages); // #F at age
-    //             std::valarray<double> Z_age(nages); // #Z at age
-
-    //             // BEGIN ALGORITHM
-    //             for (int i = 0; i < F.size(); i++)
-    //             {
-
-    //                 std::valarray<double> FL_age = F[i] * selL;
-    //                 // std::valarray<REAL_T> FD_age = F[i] * selD;
-    //                 std::valarray<double> Z_age = M_age + F[i] * selZ;
-
-    //                 std::valarray<double> N_age(nages);
-    //                 std::valarray<double> N_age_spawn(nages);
-
-    //                 N_age[0] = 1.0;
-
-    //                 for (int iage = 1; iage < nages; iage++)
-    //                 {
-    //                     N_age[iage] = N_age[iage - 1] * std::exp(-1.0 *
-    //                     Z_age[iage - 1]);
-    //                 }
-
-    //                 // last age is pooled
-    //                 N_age[nages - 1] = N_age[nages - 2] * std::exp(-1.0 *
-    //                 Z_age[nages - 2]) /
-    //                                    (1.0 - std::exp(-1.0 * Z_age[nages -
-    //                                    1]));
-
-    //                 N_age_spawn = (N_age *
-    //                                std::exp((-1.0 * Z_age *
-    //                                spawning_season_offset)));
-
-    //                 N_age_spawn[nages - 1] = (N_age_spawn[nages - 2] *
-    //                 (std::exp(-1. * (Z_age[nages - 2] * (1.0 -
-    //                 spawning_season_offset) +
-    //                                                                                     Z_age[nages - 1] * spawning_season_offset)))) /
-    //                                          (1.0 - std::exp(-1. *
-    //                                          Z_age[nages - 1]));
-
-    //                 spr[i] = sum(N_age * reprod);
-    // #warning This is probably not correct
-    //                 R_eq[i] = pop->recruitment->evaluate(spr[i], spr_F0);
-    //                 // R_eq[i] = (R0 / ((5.0 * steep - 1.0) * spr[i])) *
-    //                 //           (BC * 4.0 * steep * spr[i] - spr_F0 * (1.0 -
-    //                 steep));
-    //                 // R_eq[i] =
-    //                 this->recruitment_model->CalculateEquilibriumRecruitment(
-    //                 //
-    //                 this->recruitment_model->CalculateEquilibriumSpawningBiomass(spr[i]));
-    //                 //*1000*this->sex_fraction_value;
-
-    //                 if (R_eq[i] < 0.0000001)
-    //                 {
-    //                     R_eq[i] = 0.0000001;
-    //                 }
-
-    //                 N_age *= R_eq[i];
-    //                 N_age_spawn *= R_eq[i];
-
-    //                 S_eq[i] = sum(N_age * reprod);
-    //                 B_eq[i] = sum(N_age * wgt);
-
-    //                 for (int iage = 0; iage < nages; iage++)
-    //                 {
-    //                     L_age[iage] = N_age[iage] *
-    //                                   (FL_age[iage] / Z_age[iage]) * (1. -
-    //                                   std::exp(-1.0 * Z_age[iage]));
-    //                     // D_age[iage] = N_age[iage] *
-    //                     //               (FD_age[iage] / Z_age[iage]) * (1. -
-    //                     exp(-1.0 * Z_age[iage]))
-    //                 }
-    //                 SSB_eq[i] = sum((N_age_spawn * reprod));
-    //                 L_eq[i] = sum(L_age * wgt);
-    //                 E_eq[i] = sum(L_age) / sum(N_age);
-    //                 L_eq_knum[i] = (sum(L_age) / 1000.0);
-    //             }
-
-    //             int max_index = 0;
-    //             double max = std::numeric_limits<double>::min();
-    //             spr_ratio = spr / spr_F0;
-    //             double F01_dum = min(fabs(spr_ratio - 0.001));
-    //             double F30_dum = min(fabs(spr_ratio - 0.3));
-    //             double F35_dum = min(fabs(spr_ratio - 0.35));
-    //             double F40_dum = min(fabs(spr_ratio - 0.4));
-    //             size_t F01_out;
-    //             size_t F30_out = 0;
-    //             size_t F35_out = 0;
-    //             size_t F40_out = 0;
-
-    //             for (int i = 0; i < L_eq.size(); i++)
-    //             {
-
-    //                 if (L_eq[i] >= max)
-    //                 {
-    //                     max = L_eq[i];
-    //                     max_index = i;
-    //                 }
-
-    //                 //                if (std::fabs(spr_ratio[i] - 0.001) ==
-    //                 F01_dum) {
-    //                 //                    F01_out = F[i];
-    //                 //                }
-
-    //                 if (std::fabs(spr_ratio[i] - 0.3) == F30_dum)
-    //                 {
-    //                     F30_out = i;
-    //                 }
-    //                 if (std::fabs(spr_ratio[i] - 0.35) == F35_dum)
-    //                 {
-    //                     F35_out = i;
-    //                 }
-    //                 if (std::fabs(spr_ratio[i] - 0.4) == F40_dum)
-    //                 {
-    //                     F40_out = i;
-    //                 }
-    //             }
-    //             double msy_mt_out = max; // msy in whole weight
-    //             double SSB_msy_out;
-    //             double B_msy_out;
-    //             double R_msy_out;
-    //             double msy_knum_out;
-    //             double F_msy_out;
-    //             double spr_msy_out;
-    //             int index_m = 0;
-    //             for (int i = 0; i < F.size(); i++)
-    //             {
-    //                 if (L_eq[i] == msy_mt_out)
-    //                 {
-
-    //                     SSB_msy_out = SSB_eq[i];
-    //                     B_msy_out = B_eq[i] * pop->proportion_female[0];
-    //                     R_msy_out = R_eq[i] * 1000.0 *
-    //                     pop->proportion_female[0]; msy_knum_out =
-    //                     L_eq_knum[i]; F_msy_out = F[i]; spr_msy_out = spr[i];
-    //                     index_m = i;
-    //                 }
-    //             }
-
-    //             std::cout << std::fixed;
-    //             //
-    //             std::cout << "\n\nFmax: " << maxF << "\n";
-    //             std::cout << "Step: " << step << "\n";
-    //             std::cout << "\n\nF_msy: " << F[max_index] << "\n";
-    //             std::cout << "spr_30: " << spr_ratio[F30_out] << "\n";
-    //             std::cout << "spr_35: " << spr_ratio[F35_out] << "\n";
-    //             std::cout << "spr_40: " << spr_ratio[F40_out] << "\n";
-    //             std::cout << "F30: " << F[F30_out] << "\n";
-    //             std::cout << "F35: " << F[F35_out] << "\n";
-    //             std::cout << "F40: " << F[F40_out] << "\n";
-    //             spr_msy_out = spr[max_index];
-    //             std::cout << "msy: " << F_msy_out * pop->proportion_female[0]
-    //             << "\n"; std::cout << "spr_msy: " << spr[max_index] << "\n";
-    //             std::cout << "SR_msy: " << spr_msy_out / spr_F0 << "\n";
-    //             //                        std::cout << "D_msy_out" <<
-    //             D_eq[max_index] << "\n"; std::cout << "R_msy: " <<
-    //             R_eq[max_index] << "\n"; std::cout << "SSB_msy: " <<
-    //             SSB_msy_out << "\n"; std::cout << "B_msy: " << B_msy_out <<
-    //             "\n"; std::cout << "E_msy: " << E_eq[max_index] << "\n";
-    //         }
+    std::shared_ptr<fims_popdy::CatchAtAge<double>> model;
+    std::shared_ptr<fims_popdy::Population<double>> population =
+        this->get_model_population(population_id, model);
+    if (population == nullptr) {
+      return result;
+    }
+    std::vector<double> targets = this->spr_target_values();
+
+    // the equilibrium models are set up serially, then solved concurrently
+    std::vector<fims_popdy::EquilibriumModel<double>> eq;
+    for (R_xlen_t i = 0; i < allocations.size(); i++) {
+      std::vector<double> allocation =
+          Rcpp::as<std::vector<double>>(allocations[i]);
+      if (allocation.size() != population->fleets.size()) {
+        FIMS_ERROR_LOG("Allocation " + fims::to_string(i + 1) + " has " +
+                       fims::to_string(allocation.size()) +
+                       " values but population " +
+                       fims::to_string(population_id) + " has " +
+                       fims::to_string(population->fleets.size()) +
+                       " fleets.");
+        return result;
+      }
+      eq.push_back(model->GetEquilibriumModel(population, allocation));
+    }
 
+    std::vector<std::future<fims_popdy::ReferencePoints<double>>> futures;
+    for (size_t i = 0; i < eq.size(); i++) {
+      futures.push_back(std::async(std::launch::async, [&eq, &targets, i]() {
+        return eq[i].Calculate(targets);
+      }));
+    }
+    for (size_t i = 0; i < futures.size(); i++) {
+      result.push_back(this->reference_points_to_list(population_id,
+                                                      futures[i].get()));
+    }
     return result;
   }
 
+  /**
+   * @brief Projects a population forward with stochastic recruitment.
+   *
+   * @details Uses the double version of the model at its current parameter
+   * values, so it should be called after the model is fit. Replicates run on
+   * a thread pool and only percentile summaries are returned.
+   *
+   * @param population_id The id of the population.
+   * @param settings A named list with `values` (F or landings in weight for
+   * each projection year) and optionally `type` ("F" or "catch"), `nyears`,
+   * `nreplicates`, `seed`, `nthreads`, `sigma_r`, and `probs`.
+   * @return A list with the probabilities and, for each of ssb, biomass,
+   * recruitment, landings_weight, and F, a matrix of percentiles with one row
+   * per projection year and the mean by year.
+   */
+  Rcpp::List project(uint32_t population_id, Rcpp::List settings) {
+    std::shared_ptr<fims_popdy::CatchAtAge<double>> model;
+    std::shared_ptr<fims_popdy::Population<double>> population =
+        this->get_model_population(population_id, model);
+    if (population == nullptr) {
+      return Rcpp::List();
+    }
+
+    fims_popdy::ProjectionSettings ps;
+    ps.values = Rcpp::as<std::vector<double>>(settings["values"]);
+    ps.nyears = ps.values.size();
+    if (settings.containsElementNamed("type")) {
+      ps.catch_based = Rcpp::as<std::string>(settings["type"]) == "catch";
+    }
+    if (settings.containsElementNamed("nyears")) {
+      ps.nyears = Rcpp::as<size_t>(settings["nyears"]);
+    }
+    if (settings.containsElementNamed("nreplicates")) {
+      ps.nreplicates = Rcpp::as<size_t>(settings["nreplicates"]);
+    }
+    if (settings.containsElementNamed("seed")) {
+      ps.seed = static_cast<uint64_t>(Rcpp::as<double>(settings["seed"]));
+    }
+    if (settings.containsElementNamed("nthreads")) {
+      ps.nthreads = Rcpp::as<size_t>(settings["nthreads"]);
+    }
+    if (settings.containsElementNamed("sigma_r")) {
+      ps.sigma_r = Rcpp::as<double>(settings["sigma_r"]);
+    }
+    if (settings.containsElementNamed("probs")) {
+      ps.probs = Rcpp::as<std::vector<double>>(settings["probs"]);
+    }
+
+    fims_popdy::Projection projection =
+        fims_popdy::MakeProjection(*model, population);
+    fims_popdy::ProjectionSummary summary = projection.Run(ps);
+
+    Rcpp::List result;
+    result["probs"] = Rcpp::wrap(summary.probs);
+    std::vector<std::string> names = fims_popdy::Projection::Quantities();
+    size_t nprobs = summary.probs.size();
+    for (size_t q = 0; q < names.size(); q++) {
+      Rcpp::NumericMatrix pct(summary.nyears, nprobs);
+      std::vector<double> &values = summary.percentiles[names[q]];
+      for (size_t t = 0; t < summary.nyears; t++) {
+        for (size_t k = 0; k < nprobs; k++) {
+          pct(t, k) = values[t * nprobs + k];
+        }
+      }
+      result[names[q]] = Rcpp::List::create(
+          Rcpp::Named("percentiles") = pct,
+          Rcpp::Named("mean") = Rcpp::wrap(summary.mean[names[q]]));
+    }
+    return result;
+  }
+
+  /**
+   * @brief The target spawning potential ratios as a std::vector.
+   */
+  std::vector<double> spr_target_values() {
+    std::vector<double> targets(this->spr_targets.size());
+    for (size_t i = 0; i < targets.size(); i++) {
+      targets[i] = this->spr_targets[i];
+    }
+    return targets;
+  }
+
   /**
    * @brief Method to calculate reference points for the model.
    */
@@ -827,6 +843,14 @@ class CatchAtAgeInterface : public FisheryModelInterfaceBase {
     std::set<uint32_t> fleet_ids;  // all fleets in the model
     typedef typename std::set<uint32_t>::iterator fleet_ids_iterator;
 
+    model->do_reference_points = this->do_reference_points.get();
+    model->spr_targets = this->spr_target_values();
+    model->use_atomic_kernels = this->use_atomic_kernels.get();
+    model->checkpoint_years =
+        static_cast<size_t>(std::max(0, this->checkpoint_years.get()));
+    model->static_dispatch = this->static_dispatch.get();
+    model->report_quantities = *this->report_quantities;
+
     // add to Information
     info->models_map[this->get_id()] = model;
 
@@ -138,6 +138,17 @@ class PopulationInterface : public PopulationInterfaceBase {
    * @brief The natural log of the natural mortality for each year.
    */
   ParameterVector log_M;
+  /**
+   * @brief How log_M varies: "constant", "age", "year", "block", or "full".
+   * log_M has one value, nages values, nyears values, nages values per
+   * block, or nyears * nages values, respectively.
+   */
+  SharedString M_structure = SharedString("full");
+  /**
+   * @brief The block of each year, numbered from zero, when M_structure is
+   * "block".
+   */
+  RealVector M_year_blocks;
   /**
    * @brief The natural log of the initial numbers at age.
    */
@@ -212,6 +223,8 @@ class PopulationInterface : public PopulationInterfaceBase {
         recruitment_id(other.recruitment_id),
         depletion_id(other.depletion_id),
         log_M(other.log_M),
+        M_structure(other.M_structure),
+        M_year_blocks(other.M_year_blocks),
         log_init_naa(other.log_init_naa),
         log_init_depletion(other.log_init_depletion),
         numbers_at_age(other.numbers_at_age),
@@ -449,6 +462,26 @@ class PopulationInterface : public PopulationInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters and derived quantities to the output tables.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("Population", this->id, "population", "log_M",
+                          this->log_M);
+    tables.add_parameters("Population", this->id, "population", "log_init_naa",
+                          this->log_init_naa);
+    tables.add_parameters("Population", this->id, "population",
+                          "log_init_depletion", this->log_init_depletion);
+    tables.add_derived_quantity("Population", this->id, "population", "SSB",
+                                this->derived_ssb);
+    tables.add_derived_quantity("Population", this->id, "population", "NAA",
+                                this->derived_naa);
+    tables.add_derived_quantity("Population", this->id, "population",
+                                "Biomass", this->derived_biomass);
+    tables.add_derived_quantity("Population", this->id, "population",
+                                "Recruitment", this->derived_recruitment);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -485,6 +518,28 @@ class PopulationInterface : public PopulationInterfaceBase {
     population->recruitment_id = this->recruitment_id.get();
     population->depletion_id = this->depletion_id.get();
     population->maturity_id = this->maturity_id.get();
+    if (!fims::AgeYearLayout::Parse(this->M_structure.get(),
+                                    population->M_layout.structure)) {
+      population->M_layout.readable = false;
+      FIMS_ERROR_LOG("Unknown M_structure \"" + this->M_structure.get() +
+                     "\" for population " + fims::to_string(this->id) +
+                     ", expected \"constant\", \"age\", \"year\", "
+                     "\"block\", or \"full\".");
+    }
+    population->M_layout.year_block.resize(this->M_year_blocks.size());
+    for (size_t i = 0; i < this->M_year_blocks.size(); i++) {
+      if (this->M_year_blocks[i] < 0) {
+        population->M_layout.readable = false;
+        population->M_layout.year_block[i] = 0;
+        FIMS_ERROR_LOG("M_year_blocks of population " +
+                       fims::to_string(this->id) + " has the negative block " +
+                       fims::to_string(this->M_year_blocks[i]) + " in year " +
+                       fims::to_string(i) + ".");
+      } else {
+        population->M_layout.year_block[i] =
+            static_cast<size_t>(this->M_year_blocks[i]);
+      }
+    }
     population->log_M.resize(this->log_M.size());
     population->log_init_naa.resize(this->log_init_naa.size());
     population->log_init_depletion.resize(this->log_init_depletion.size());
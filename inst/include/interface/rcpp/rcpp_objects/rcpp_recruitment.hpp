@@ -306,6 +306,18 @@ class BevertonHoltRecruitmentInterface : public RecruitmentInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters to the estimates table.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("recruitment", this->id, "Beverton--Holt",
+                          "logit_steep", this->logit_steep);
+    tables.add_parameters("recruitment", this->id, "Beverton--Holt",
+                          "log_rzero", this->log_rzero);
+    tables.add_parameters("recruitment", this->id, "Beverton--Holt", "log_devs",
+                          this->log_devs);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -213,6 +213,16 @@ class LogisticSelectivityInterface : public SelectivityInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters to the estimates table.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("selectivity", this->id, "Logistic",
+                          "inflection_point", this->inflection_point);
+    tables.add_parameters("selectivity", this->id, "Logistic", "slope",
+                          this->slope);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -464,6 +474,20 @@ class DoubleLogisticSelectivityInterface : public SelectivityInterfaceBase {
     return ss.str();
   }
 
+  /**
+   * @brief Adds the parameters to the estimates table.
+   */
+  virtual void add_to_tables(OutputTables &tables) {
+    tables.add_parameters("selectivity", this->id, "DoubleLogistic",
+                          "inflection_point_asc", this->inflection_point_asc);
+    tables.add_parameters("selectivity", this->id, "DoubleLogistic",
+                          "slope_asc", this->slope_asc);
+    tables.add_parameters("selectivity", this->id, "DoubleLogistic",
+                          "inflection_point_desc", this->inflection_point_desc);
+    tables.add_parameters("selectivity", this->id, "DoubleLogistic",
+                          "slope_desc", this->slope_desc);
+  }
+
 #ifdef TMB_MODEL
 
   template <typename Type>
@@ -2,6 +2,7 @@
 #define FIMS_MODELS_FISHERIES_MODELS_HPP
 
 #include "functors/catch_at_age.hpp"
+#include "functors/projection.hpp"
 #include "functors/surplus_production.hpp"
 
 #endif
@@ -1,10 +1,17 @@
 #ifndef FIMS_MODELS_CATCH_AT_AGE_HPP
 #define FIMS_MODELS_CATCH_AT_AGE_HPP
 
-#include <set>
+#include <algorithm>
+#include <functional>
 #include <regex>
+#include <set>
+#include <type_traits>
 
+#include "../../common/fims_checkpoint.hpp"
+#include "../../common/fims_kernels.hpp"
 #include "fishery_model_base.hpp"
+#include "hybrid_f.hpp"
+#include "reference_points.hpp"
 
 namespace fims_popdy {
 
@@ -73,6 +80,140 @@ class CatchAtAge : public FisheryModelBase<Type> {
   typedef
       typename std::map<std::string, fims::Vector<Type>>::iterator dq_iterator;
 
+  /**
+   * @brief If true, equilibrium reference points are calculated for each
+   * population in Report() and added to the ADREPORT output.
+   */
+  bool do_reference_points = false;
+
+  /**
+   * @brief The target spawning potential ratios used for the SPR-based
+   * reference points, e.g., 0.4 for F40%.
+   */
+  std::vector<double> spr_targets = {0.3, 0.35, 0.4};
+
+  /**
+   * @brief If true, Baranov catch, the survival step, and the normalization
+   * of expected compositions use the vector kernels in fims_kernels.hpp,
+   * which TMB records as one atomic operation each. If false, every scalar
+   * operation is recorded. Both give the same values.
+   */
+  bool use_atomic_kernels = true;
+
+  /**
+   * @brief The number of years in each checkpointed block of the population
+   * recursion. With TMB, each block is recorded on its own tape and added to
+   * the model tape as one operation, which bounds the memory needed for the
+   * Hessian of long time series at the cost of evaluating the blocks again in
+   * the derivative sweeps. Zero, the default, records the years directly.
+   */
+  size_t checkpoint_years = 0;
+
+  /**
+   * @brief The number of Newton steps used to solve the F of fleets with
+   * hybrid F from their observed landings, see HybridF.
+   */
+  size_t hybrid_F_iterations = 4;
+
+  /**
+   * @brief The years in which a fleet with hybrid F has no observed landings,
+   * by fleet id. SolveHybridF() records them, possibly on a pool thread, and
+   * LogEvaluateMessages() logs them once the evaluation has finished.
+   */
+  std::map<uint32_t, std::vector<size_t>> missing_landings_years;
+
+  /**
+   * @brief If true, ResolveModules() resolves the modules of each population
+   * to their concrete types, see ModuleTable, and the selectivity and
+   * maturity at age are evaluated once per evaluation without virtual calls.
+   * If false, every value is computed through the module base classes. Both
+   * give the same values.
+   */
+  bool static_dispatch = true;
+
+  /**
+   * @brief The names of the derived quantities to ADREPORT, e.g.,
+   * "spawning_biomass" or "index_expected". If empty, every derived quantity
+   * in Report() is reported.
+   */
+  std::set<std::string> report_quantities;
+
+  /**
+   * @brief If true, Evaluate() skips the derived quantities that SetDemand()
+   * found are neither used by a likelihood nor reported. The double model
+   * computes everything by default because it also fills the REPORT output
+   * and the output of the R interface.
+   */
+  bool skip_unused = !std::is_same<Type, double>::value;
+
+  /**
+   * @brief The contributions of each population to the fleet derived
+   * quantities, indexed by population id and then fleet id. Only used when
+   * the model has more than one population.
+   */
+  std::map<uint32_t,
+           std::map<uint32_t, std::map<std::string, fims::Vector<Type>>>>
+      population_fleet_derived_quantities;
+
+ private:
+  /**
+   * @brief True while the populations write to
+   * population_fleet_derived_quantities instead of fleet_derived_quantities.
+   */
+  bool population_tasks = false;
+  /**
+   * @brief True if the derived quantities are from an evaluation whose
+   * parameters Model::Evaluate() recorded, so the next incremental evaluation
+   * can start from them.
+   */
+  bool tracked = false;
+  /**
+   * @brief True from SetChangedParameters() until the end of the evaluation
+   * that follows it.
+   */
+  bool tracking = false;
+  /**
+   * @brief True during an evaluation that reuses the previous derived
+   * quantities.
+   */
+  bool partial = false;
+  /**
+   * @brief The first year that has to be recomputed for each population,
+   * indexed by population id. A value past nyears means none.
+   */
+  std::map<uint32_t, size_t> first_changed_year;
+  /**
+   * @brief The populations whose index contributions have to be recomputed
+   * in every year because a catchability changed.
+   */
+  std::set<uint32_t> index_changed;
+
+  /**
+   * @brief Which of the optional derived quantities of a population or a
+   * fleet are computed.
+   */
+  struct Demand {
+    bool unfished = true;        /**< unfished numbers, biomass, and SSB */
+    bool biomass = true;         /**< total biomass */
+    bool total_landings = true;  /**< landings summed over fleets */
+    bool landings = true;        /**< landings in numbers and expected */
+    bool landings_weight = true; /**< landings weight at age and by year */
+    bool index = true;           /**< index in numbers and expected */
+    bool index_weight = true;    /**< index weight at age and by year */
+    bool age_comp = true;        /**< expected age composition */
+    bool length_comp = true;     /**< expected length composition */
+    bool landings_length = true; /**< landings numbers at length */
+    bool index_length = true;    /**< index numbers at length */
+  };
+  /**
+   * @brief The demand of each population, indexed by population id.
+   */
+  std::map<uint32_t, Demand> population_demand;
+  /**
+   * @brief The demand of each fleet, indexed by fleet id.
+   */
+  std::map<uint32_t, Demand> fleet_demand;
+
  public:
   std::vector<Type> ages; /*!< vector of the ages for referencing*/
   /**
@@ -92,11 +233,49 @@ class CatchAtAge : public FisheryModelBase<Type> {
    */
   virtual ~CatchAtAge() {}
 
+  /**
+   * @brief Adds the derived quantities the model holds for each fleet and
+   * population to a memory report, by fleet or population id.
+   */
+  virtual void ReportMemory(fims::MemoryReport &report,
+                            const std::string &module) const {
+    fims_model_object::FIMSObject<Type>::ReportMemory(report, module);
+    typename std::map<uint32_t,
+                      std::map<std::string, fims::Vector<Type>>>::const_iterator
+        it;
+    for (it = this->fleet_derived_quantities.begin();
+         it != this->fleet_derived_quantities.end(); ++it) {
+      report.AddVectors("derived_quantity", "Fleet", (*it).first,
+                        (*it).second);
+    }
+    for (it = this->population_derived_quantities.begin();
+         it != this->population_derived_quantities.end(); ++it) {
+      report.AddVectors("derived_quantity", "Population", (*it).first,
+                        (*it).second);
+    }
+    typename std::map<
+        uint32_t, std::map<uint32_t, std::map<std::string, fims::Vector<Type>>>>::
+        const_iterator pit;
+    for (pit = this->population_fleet_derived_quantities.begin();
+         pit != this->population_fleet_derived_quantities.end(); ++pit) {
+      for (it = (*pit).second.begin(); it != (*pit).second.end(); ++it) {
+        typename std::map<std::string, fims::Vector<Type>>::const_iterator dq;
+        for (dq = (*it).second.begin(); dq != (*it).second.end(); ++dq) {
+          report.AddVector("derived_quantity", "Population", (*pit).first,
+                           "fleet " + fims::to_string((*it).first) + " " +
+                               (*dq).first,
+                           (*dq).second);
+        }
+      }
+    }
+  }
+
   /**
    * This function is called once at the beginning of the model run. It
    * initializes the derived quantities for the populations and fleets.
    */
   virtual void Initialize() {
+    this->tracked = false;
     // The following are initialized in the rcpp interface: ages, log_init_naa,
     //   numbers_at_age, log_Fmort, log_q
     for (size_t p = 0; p < this->populations.size(); p++) {
@@ -150,6 +329,10 @@ class CatchAtAge : public FisheryModelBase<Type> {
           this->populations[p]->nages);
       this->populations[p]->M.resize(this->populations[p]->nyears *
                                      this->populations[p]->nages);
+      this->populations[p]->M_layout.Resize(this->populations[p]->nyears,
+                                            this->populations[p]->nages);
+      this->populations[p]->M_distinct.resize(
+          this->populations[p]->M_layout.Size());
     }
 
     for (fleet_iterator fit = this->fleets.begin(); fit != this->fleets.end();
@@ -467,16 +650,39 @@ class CatchAtAge : public FisheryModelBase<Type> {
    * fleet to a given value.
    */
   virtual void Prepare() {
+    // A full reset zeroes the derived quantities in the model arena in one
+    // pass; the loops below reset only those stored elsewhere
+    bool bulk = !this->partial && this->arena != nullptr;
+    if (bulk) {
+      this->ResetArena();
+    }
+    // the entries are made here, serially, so SolveHybridF() only appends to
+    // the entry of its own fleet
+    for (fleet_iterator fit = this->fleets.begin(); fit != this->fleets.end();
+         ++fit) {
+      if ((*fit).second->hybrid_F) {
+        this->missing_landings_years[(*fit).first];
+      }
+    }
     for (size_t p = 0; p < this->populations.size(); p++) {
-      auto derived_quantities =
+      std::map<std::string, fims::Vector<Type>> &derived_quantities =
           this->population_derived_quantities[this->populations[p]->GetId()];
 
-      // Reset the derived quantities for the population
+      // Reset the derived quantities for the population, or only the years
+      // that are recomputed
       typename fims_popdy::Population<Type>::derived_quantities_iterator it;
       for (it = derived_quantities.begin(); it != derived_quantities.end();
            it++) {
         fims::Vector<Type> &dq = (*it).second;
-        this->ResetVector(dq);
+        if (this->partial) {
+          this->ResetYears(
+              dq,
+              CatchAtAge<Type>::RowLength((*it).first,
+                                          this->populations[p]->nages),
+              this->first_changed_year.at(this->populations[p]->GetId()));
+        } else if (!(bulk && this->InArena(dq))) {
+          this->ResetVector(dq);
+        }
       }
     }
 
@@ -492,17 +698,38 @@ class CatchAtAge : public FisheryModelBase<Type> {
       }
 
       // Transformation Section
-      for (size_t age = 0; age < population->nages; age++) {
-        for (size_t year = 0; year < population->nyears; year++) {
-          size_t i_age_year = age * population->nyears + year;
-          population->M[i_age_year] =
-              fims_math::exp(population->log_M[i_age_year]);
-          // TODO: is this still needed now that derived quantities are filled
-          // with ResetVector? mortality_F is a fims::Vector and therefore needs
-          // to be filled within a loop
-          // derived_quantities["mortality_F"][i_age_year] = 0.0;
-          derived_quantities["weight_at_age"][age] =
-              population->growth->evaluate(population->ages[age]);
+      // the modules compute their natural-scale parameters once here, so
+      // the per-year and per-age calculations read cached values
+      if (population->recruitment != nullptr) {
+        population->recruitment->TransformParameters();
+      }
+      if (population->maturity != nullptr) {
+        population->maturity->TransformParameters();
+      }
+      if (population->growth != nullptr) {
+        population->growth->TransformParameters();
+      }
+      // exp() is taken once per distinct value of log_M, e.g., once for a
+      // constant M, and the results are copied to each year and age
+      population->TransformM();
+
+      // weight at age is looked up once here, by year when it varies by year
+      population->growth->Prepare(population->ages, population->nyears);
+      fims::Vector<Type> &weight_at_age = derived_quantities["weight_at_age"];
+      size_t nweight_years =
+          population->growth->IsTimeVarying() ? population->nyears : 1;
+      if (weight_at_age.size() != nweight_years * population->nages) {
+        weight_at_age.resize(nweight_years * population->nages);
+      }
+      if (population->modules.resolved) {
+        population->modules.WeightAtAge(nweight_years, population->nages,
+                                        weight_at_age);
+      } else {
+        for (size_t year = 0; year < nweight_years; year++) {
+          for (size_t age = 0; age < population->nages; age++) {
+            weight_at_age[year * population->nages + age] =
+                population->growth->evaluate(year, age);
+          }
         }
       }
     }
@@ -512,20 +739,36 @@ class CatchAtAge : public FisheryModelBase<Type> {
       std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*fit).second;
       std::map<std::string, fims::Vector<Type>> &derived_quantities =
           this->fleet_derived_quantities[fleet->GetId()];
+      // With one population the population adds to the fleet derived
+      // quantities directly, so the years it does not recompute are kept
+      bool keep = this->partial && this->populations.size() == 1;
       typename fims_popdy::Population<Type>::derived_quantities_iterator it;
       for (it = derived_quantities.begin(); it != derived_quantities.end();
            it++) {
         fims::Vector<Type> &dq = (*it).second;
-        this->ResetVector(dq);
+        if (keep && CatchAtAge<Type>::IsFleetContribution((*it).first)) {
+          this->ResetFleetContribution(this->populations[0], (*it).first, dq,
+                                       fleet->nages);
+        } else if (!(bulk && this->InArena(dq))) {
+          this->ResetVector(dq);
+        }
       }
 
       // Transformation Section
+      if (fleet->selectivity != nullptr) {
+        fleet->selectivity->TransformParameters();
+      }
       for (size_t i = 0; i < fleet->log_q.size(); i++) {
         fleet->q[i] = fims_math::exp(fleet->log_q[i]);
       }
 
-      for (size_t year = 0; year < fleet->nyears; year++) {
-        fleet->Fmort[year] = fims_math::exp(fleet->log_Fmort[year]);
+      // The F of a fleet with hybrid F is solved in each year that is
+      // evaluated, and an incremental evaluation keeps the F it solved in
+      // the years before the first change
+      if (!fleet->hybrid_F) {
+        for (size_t year = 0; year < fleet->nyears; year++) {
+          fleet->Fmort[year] = fims_math::exp(fleet->log_Fmort[year]);
+        }
       }
 
       // TODO: does this age_length_to_conversion need to be a dq and parameter
@@ -538,191 +781,837 @@ class CatchAtAge : public FisheryModelBase<Type> {
                                       [i_length_age] =
             fleet->age_to_length_conversion[i_length_age];
       }
+      if (fleet->nlengths > 0) {
+        fleet->UpdateLengthKey();
+      }
+    }
+
+    // the selectivity and maturity at age, once the fleets are transformed
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      if (this->populations[p]->modules.resolved) {
+        this->populations[p]->modules.Update(this->populations[p]->ages);
+      }
     }
   }
-  /**
-   * This function is used to add a population id to the set of population ids.
-   */
-  void AddPopulation(uint32_t id) { this->population_ids.insert(id); }
 
   /**
-   * @brief Get the population ids of the model.
+   * @brief Resolves the modules of each population for static dispatch, or
+   * clears the tables if static_dispatch is false.
    */
-  std::set<uint32_t> &GetPopulationIds() { return this->population_ids; }
-
+  virtual void ResolveModules() {
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      if (this->static_dispatch) {
+        this->populations[p]->modules.Resolve(*this->populations[p]);
+      } else {
+        this->populations[p]->modules.resolved = false;
+      }
+    }
+  }
   /**
-   * This function is used to get the populations of the model. It returns a
-   * vector of shared pointers to the populations.
-   * @return std::vector<std::shared_ptr<fims_popdy::Population<Type>>>&
+   * @brief The names of the fleet derived quantities that populations add
+   * to.
    */
-  std::vector<std::shared_ptr<fims_popdy::Population<Type>>> &GetPopulations() {
-    return this->populations;
+  static const std::vector<std::string> &FleetContributionNames() {
+    static const std::vector<std::string> names = {
+        "landings_numbers_at_age", "landings_weight_at_age",
+        "landings_numbers",        "landings_weight",
+        "index_numbers_at_age",    "index_weight_at_age",
+        "index_numbers",           "index_weight"};
+    return names;
   }
 
   /**
-   * This method is used to calculate the initial numbers at age for a
-   * population. It takes a population object and an age as input and
-   * calculates the initial numbers at age for that population.
-   * @param population
-   * @param i_age_year
-   * @param a
+   * @brief The fleet derived quantities that a population writes to, i.e.,
+   * the population's own copy while populations are evaluated as separate
+   * tasks and the shared fleet derived quantities otherwise.
+   *
+   * @param population The population.
+   * @param fleet_ The index of the fleet in population->fleets.
    */
-  void CalculateInitialNumbersAA(
+  std::map<std::string, fims::Vector<Type>> &FleetQuantities(
       std::shared_ptr<fims_popdy::Population<Type>> &population,
-      size_t i_age_year, size_t a) {
-    this->population_derived_quantities[population->GetId()]["numbers_at_age"]
-                                       [i_age_year] =
-        fims_math::exp(population->log_init_naa[a]);
+      size_t fleet_) {
+    uint32_t fleet_id = population->fleets[fleet_]->GetId();
+    if (this->population_tasks) {
+      return this->population_fleet_derived_quantities.at(population->GetId())
+          .at(fleet_id);
+    }
+    return this->fleet_derived_quantities[fleet_id];
   }
 
   /**
-   * * This method is used to calculate the numbers at age for a
-   * population. It takes a population object, the index of the age
-   * in the current year, the index of the age in the previous year,
-   * and the age as input and calculates the numbers at age for that
-   * population.
-   * @param population
-   * @param i_age_year
-   * @param i_agem1_yearm1
-   * @param age
+   * @brief Checks that no two populations share a recruitment module, which
+   * each population writes its expected recruitment to.
    */
-  void CalculateNumbersAA(
-      std::shared_ptr<fims_popdy::Population<Type>> &population,
-      size_t i_age_year, size_t i_agem1_yearm1, size_t age) {
-    // using Z from previous age/year
-
-    this->population_derived_quantities[population->GetId()]["numbers_at_age"]
-                                       [i_age_year] =
-        this->population_derived_quantities[population->GetId()]
-                                           ["numbers_at_age"][i_agem1_yearm1] *
-        (fims_math::exp(
-            -this->population_derived_quantities[population->GetId()]
-                                                ["mortality_Z"]
-                                                [i_agem1_yearm1]));
-
-    // Plus group calculation
-    if (age == (population->nages - 1)) {
-      this->population_derived_quantities[population->GetId()]["numbers_at_age"]
-                                         [i_age_year] =
-          this->population_derived_quantities[population->GetId()]
-                                             ["numbers_at_age"][i_age_year] +
-          this->population_derived_quantities[population->GetId()]
-                                             ["numbers_at_age"]
-                                             [i_agem1_yearm1 + 1] *
-              (fims_math::exp(
-                  -this->population_derived_quantities[population->GetId()]
-                                                      ["mortality_Z"]
-                                                      [i_agem1_yearm1 + 1]));
+  bool SeparateRecruitment() {
+    std::set<const void *> recruitment;
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      if (!recruitment.insert(this->populations[p]->recruitment.get())
+               .second) {
+        return false;
+      }
     }
+    return true;
   }
 
   /**
-   * This method is used to calculate the unfished numbers at age for a
-   * population. It takes a population object, the index of the age
-   * in the current year, the index of the age in the previous year,
-   * and the age as input and calculates the unfished numbers at age
-   * for that population.
-   * @param population
-   * @param i_age_year
-   * @param i_agem1_yearm1
-   * @param age
+   * @brief Sizes and zeroes each population's copy of the fleet derived
+   * quantities it adds to.
    */
-  void CalculateUnfishedNumbersAA(
-      std::shared_ptr<fims_popdy::Population<Type>> &population,
-      size_t i_age_year, size_t i_agem1_yearm1, size_t age) {
-    // using M from previous age/year
-    this->population_derived_quantities[population->GetId()]
-                                       ["unfished_numbers_at_age"][i_age_year] =
-        this->population_derived_quantities[population->GetId()]
-                                           ["unfished_numbers_at_age"]
-                                           [i_agem1_yearm1] *
-        (fims_math::exp(-population->M[i_agem1_yearm1]));
-
-    // Plus group calculation
-    if (age == (population->nages - 1)) {
-      this->population_derived_quantities[population->GetId()]
-                                         ["unfished_numbers_at_age"]
-                                         [i_age_year] =
-          this->population_derived_quantities[population->GetId()]
-                                             ["unfished_numbers_at_age"]
-                                             [i_age_year] +
-          this->population_derived_quantities[population->GetId()]
-                                             ["unfished_numbers_at_age"]
-                                             [i_agem1_yearm1 + 1] *
-              (fims_math::exp(-population->M[i_agem1_yearm1 + 1]));
+  void PrepareFleetContributions() {
+    const std::vector<std::string> &names =
+        CatchAtAge<Type>::FleetContributionNames();
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      std::shared_ptr<fims_popdy::Population<Type>> &population =
+          this->populations[p];
+      std::map<uint32_t, std::map<std::string, fims::Vector<Type>>>
+          &contributions =
+              this->population_fleet_derived_quantities[population->GetId()];
+      for (size_t fleet_ = 0; fleet_ < population->fleets.size(); fleet_++) {
+        uint32_t fleet_id = population->fleets[fleet_]->GetId();
+        std::map<std::string, fims::Vector<Type>> &fleet_dq =
+            this->fleet_derived_quantities[fleet_id];
+        std::map<std::string, fims::Vector<Type>> &contribution =
+            contributions[fleet_id];
+        for (size_t i = 0; i < names.size(); i++) {
+          fims::Vector<Type> &v = contribution[names[i]];
+          if (v.size() != fleet_dq[names[i]].size()) {
+            v.resize(fleet_dq[names[i]].size());
+            this->ResetVector(v);
+          } else if (this->partial) {
+            this->ResetFleetContribution(population, names[i], v,
+                                         population->fleets[fleet_]->nages);
+          } else {
+            this->ResetVector(v);
+          }
+        }
+      }
     }
   }
 
   /**
-   * * This method is used to calculate the mortality for a population. It takes
-   * a population object, the index of the age in the current year, the year,
-   * and the age as input and calculates the mortality for that population.
-   * @param population
-   * @param i_age_year
-   * @param year
-   * @param age
+   * @brief True if populations add to the fleet derived quantity.
+   *
+   * @param name The name of the derived quantity.
    */
-  void CalculateMortality(
-      std::shared_ptr<fims_popdy::Population<Type>> &population,
-      size_t i_age_year, size_t year, size_t age) {
-    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
-      // evaluate is a member function of the selectivity class
-      Type s = population->fleets[fleet_]->selectivity->evaluate(
-          population->ages[age]);
+  static bool IsFleetContribution(const std::string &name) {
+    const std::vector<std::string> &names =
+        CatchAtAge<Type>::FleetContributionNames();
+    return std::find(names.begin(), names.end(), name) != names.end();
+  }
 
-      this->population_derived_quantities[population->GetId()]["mortality_F"]
-                                         [i_age_year] +=
-          population->fleets[fleet_]->Fmort[year] * s;
+  /**
+   * @brief The number of elements per year of a population derived quantity.
+   *
+   * @param name The name of the derived quantity.
+   * @param nages The number of ages.
+   * @return Zero for quantities that do not change by year, and
+   * std::string::npos for quantities that are not known, which are always
+   * reset.
+   */
+  static size_t RowLength(const std::string &name, size_t nages) {
+    static const std::set<std::string> by_year = {
+        "total_landings_weight",     "total_landings_numbers",
+        "biomass",                   "spawning_biomass",
+        "unfished_biomass",          "unfished_spawning_biomass",
+        "expected_recruitment"};
+    static const std::set<std::string> by_year_and_age = {
+        "mortality_F",
+        "mortality_Z",
+        "numbers_at_age",
+        "unfished_numbers_at_age",
+        "proportion_mature_at_age",
+        "sum_selectivity",
+        "landings_numbers_at_age",
+        "landings_weight_at_age",
+        "index_numbers_at_age",
+        "index_weight_at_age"};
+    if (name == "weight_at_age") {
+      return 0;
+    }
+    if (by_year.count(name) > 0) {
+      return 1;
+    }
+    if (by_year_and_age.count(name) > 0) {
+      return nages;
+    }
+    if (CatchAtAge<Type>::IsFleetContribution(name)) {
+      return 1;
+    }
+    return std::string::npos;
+  }
 
-      this->population_derived_quantities[population->GetId()]
-                                         ["sum_selectivity"][i_age_year] += s;
+  /**
+   * @brief Sets the elements of the years from first_year on to zero.
+   *
+   * @param v The derived quantity, folded by year.
+   * @param row_length The number of elements per year, see RowLength().
+   * @param first_year The first year to reset.
+   */
+  void ResetYears(fims::Vector<Type> &v, size_t row_length,
+                  size_t first_year) {
+    if (row_length == 0) {
+      return;
     }
-    this->population_derived_quantities[population->GetId()]["mortality_Z"]
-                                       [i_age_year] =
-        population->M[i_age_year] +
-        this->population_derived_quantities[population->GetId()]["mortality_F"]
-                                           [i_age_year];
+    if (row_length == std::string::npos) {
+      this->ResetVector(v);
+      return;
+    }
+    size_t start = std::min(v.size(), first_year * row_length);
+    std::fill(v.begin() + start, v.end(), static_cast<Type>(0.0));
   }
 
   /**
-   * * This method is used to calculate the biomass for a population. It takes a
-   * population object, the index of the age in the current year, the year,
-   * and the age as input and calculates the biomass for that population.
-   * @param population
-   * @param i_age_year
-   * @param year
-   * @param age
+   * @brief Resets the years of a fleet derived quantity that a population
+   * recomputes, and every year of the index quantities if a catchability of
+   * the population changed.
+   *
+   * @param population The population.
+   * @param name The name of the derived quantity.
+   * @param v The derived quantity.
+   * @param nages The number of ages of the fleet.
    */
-  void CalculateBiomass(
+  void ResetFleetContribution(
       std::shared_ptr<fims_popdy::Population<Type>> &population,
-      size_t i_age_year, size_t year, size_t age) {
-    this->population_derived_quantities[population->GetId()]["biomass"][year] +=
-        this->population_derived_quantities[population->GetId()]
-                                           ["numbers_at_age"][i_age_year] *
-        this->population_derived_quantities[population->GetId()]
-                                           ["weight_at_age"][age];
+      const std::string &name, fims::Vector<Type> &v, size_t nages) {
+    if (name.compare(0, 6, "index_") == 0 &&
+        this->index_changed.count(population->GetId()) > 0) {
+      this->ResetVector(v);
+    } else {
+      this->ResetYears(v, CatchAtAge<Type>::RowLength(name, nages),
+                       this->first_changed_year.at(population->GetId()));
+    }
   }
 
   /**
-   * * This method is used to calculate the unfished biomass for a population.
-   * It takes a population object, the index of the age in the current year, the
-   * year, and the age as input and calculates the unfished biomass for that
-   * population.
-   * @param population
-   * @param i_age_year
-   * @param year
-   * @param age
+   * @brief Finds the index of a parameter in a vector of parameters.
+   *
+   * @param v The vector.
+   * @param p The parameter.
+   * @param i The index of p in v, if it is there.
+   * @return True if p is an element of v.
    */
-  void CalculateUnfishedBiomass(
-      std::shared_ptr<fims_popdy::Population<Type>> &population,
+  static bool Contains(fims::Vector<Type> &v, const Type *p, size_t &i) {
+    if (v.size() == 0) {
+      return false;
+    }
+    std::less<const Type *> less;
+    const Type *first = &v[0];
+    if (less(p, first) || !less(p, first + v.size())) {
+      return false;
+    }
+    i = static_cast<size_t>(p - first);
+    return true;
+  }
+
+  /**
+   * @brief Finds the first year of a population that depends on a
+   * parameter.
+   *
+   * @param population The population.
+   * @param p The parameter.
+   * @param year The first year, if p is a parameter of the population.
+   * @param index_only Set to true if p only affects the index, i.e., it is a
+   * catchability.
+   * @return False if p is not one of the year-indexed parameters of the
+   * population, its fleets, or its recruitment.
+   */
+  bool FirstYear(std::shared_ptr<fims_popdy::Population<Type>> &population,
+                 const Type *p, size_t &year, bool &index_only) {
+    size_t i = 0;
+    index_only = false;
+    if (CatchAtAge<Type>::Contains(population->log_M, p, i)) {
+      year = population->M_layout.FirstYear(i);
+      return true;
+    }
+    if (CatchAtAge<Type>::Contains(population->log_init_naa, p, i) ||
+        CatchAtAge<Type>::Contains(population->recruitment->log_rzero, p, i)) {
+      year = 0;
+      return true;
+    }
+    if (CatchAtAge<Type>::Contains(population->recruitment->log_recruit_devs,
+                                   p, i) ||
+        CatchAtAge<Type>::Contains(population->recruitment->log_r, p, i)) {
+      // constrained deviations are centered, so every year changes
+      year = population->recruitment->constrain_deviations ? 0 : i + 1;
+      return true;
+    }
+    for (size_t fleet_ = 0; fleet_ < population->fleets.size(); fleet_++) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> &fleet =
+          population->fleets[fleet_];
+      if (CatchAtAge<Type>::Contains(fleet->log_Fmort, p, i)) {
+        year = i;
+        return true;
+      }
+      if (CatchAtAge<Type>::Contains(fleet->log_q, p, i)) {
+        year = population->nyears + 1;
+        index_only = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Works out which years of each population the next evaluation
+   * recomputes. A parameter that is not one of the year-indexed parameters of
+   * a population, e.g., a selectivity parameter, changes every year of every
+   * population.
+   *
+   * @param changed The parameters that changed since the last evaluation.
+   */
+  virtual void SetChangedParameters(const std::vector<Type *> &changed) {
+    this->partial = this->tracked;
+    this->tracking = true;
+    this->index_changed.clear();
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      this->first_changed_year[this->populations[p]->GetId()] =
+          this->partial ? this->populations[p]->nyears + 1 : 0;
+    }
+    if (!this->partial) {
+      return;
+    }
+    // a derived quantity that is not folded by year is always recomputed
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      std::map<std::string, fims::Vector<Type>> &dq =
+          this->population_derived_quantities[this->populations[p]->GetId()];
+      for (dq_iterator it = dq.begin(); it != dq.end(); ++it) {
+        if (CatchAtAge<Type>::RowLength((*it).first,
+                                        this->populations[p]->nages) ==
+            std::string::npos) {
+          this->first_changed_year[this->populations[p]->GetId()] = 0;
+        }
+      }
+    }
+    for (size_t k = 0; k < changed.size(); k++) {
+      bool found = false;
+      for (size_t p = 0; p < this->populations.size(); p++) {
+        std::shared_ptr<fims_popdy::Population<Type>> &population =
+            this->populations[p];
+        size_t year = 0;
+        bool index_only = false;
+        if (this->FirstYear(population, changed[k], year, index_only)) {
+          found = true;
+          size_t &first = this->first_changed_year[population->GetId()];
+          first = std::min(first, year);
+          if (index_only) {
+            this->index_changed.insert(population->GetId());
+          }
+        }
+      }
+      if (!found) {
+        for (size_t p = 0; p < this->populations.size(); p++) {
+          this->first_changed_year[this->populations[p]->GetId()] = 0;
+        }
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief The derived quantities that the model reports with ADREPORT, i.e.,
+   * report_quantities or, if it is empty, every derived quantity in Report().
+   */
+  std::set<std::string> ReportedQuantities() {
+    if (!this->report_quantities.empty()) {
+      return this->report_quantities;
+    }
+    return {"numbers_at_age",
+            "biomass",
+            "spawning_biomass",
+            "log_recruit_devs",
+            "Fmort",
+            "q",
+            "landings_expected",
+            "index_expected",
+            "landings_numbers_at_age",
+            "landings_numbers_at_length",
+            "index_numbers_at_age",
+            "index_numbers_at_length",
+            "agecomp_expected",
+            "lengthcomp_expected",
+            "agecomp_proportion",
+            "lengthcomp_proportion"};
+  }
+
+  /**
+   * @brief True if a derived quantity is reported, see ReportedQuantities().
+   *
+   * @param name The name of the derived quantity.
+   */
+  bool IsReported(const std::string &name) {
+    return this->report_quantities.empty() ||
+           this->report_quantities.count(name) > 0;
+  }
+
+  /**
+   * @brief The derived quantities of a fleet that each derived quantity of
+   * the fleet is calculated from. Expected landings and index follow the
+   * units of the observations, and the expected age composition follows the
+   * landings if the fleet has landings data and the index otherwise.
+   *
+   * @param fleet The fleet.
+   */
+  static std::map<std::string, std::vector<std::string>> FleetDependencies(
+      const std::shared_ptr<fims_popdy::Fleet<Type>> &fleet) {
+    std::map<std::string, std::vector<std::string>> graph;
+    graph["log_landings_expected"] = {"landings_expected"};
+    graph["landings_expected"] = {fleet->observed_landings_units == "number"
+                                      ? "landings_numbers"
+                                      : "landings_weight"};
+    graph["landings_weight"] = {"landings_weight_at_age"};
+    graph["landings_weight_at_age"] = {"landings_numbers_at_age"};
+    graph["landings_numbers"] = {"landings_numbers_at_age"};
+    graph["landings_numbers_at_length"] = {"landings_numbers_at_age"};
+    graph["log_index_expected"] = {"index_expected"};
+    graph["index_expected"] = {fleet->observed_index_units == "number"
+                                   ? "index_numbers"
+                                   : "index_weight"};
+    graph["index_weight"] = {"index_weight_at_age"};
+    graph["index_weight_at_age"] = {"index_numbers_at_age"};
+    graph["index_numbers"] = {"index_numbers_at_age"};
+    graph["index_numbers_at_length"] = {"index_numbers_at_age"};
+    graph["agecomp_expected"] = {fleet->fleet_observed_landings_data_id_m ==
+                                         -999
+                                     ? "index_numbers_at_age"
+                                     : "landings_numbers_at_age"};
+    graph["agecomp_proportion"] = {"agecomp_expected"};
+    graph["lengthcomp_expected"] = {"agecomp_expected"};
+    graph["lengthcomp_proportion"] = {"lengthcomp_expected"};
+    return graph;
+  }
+
+  /**
+   * @brief The optional derived quantities of a population that each derived
+   * quantity of the population is calculated from. The totals over fleets
+   * depend on the fleet derived quantities and are handled by SetDemand().
+   */
+  static std::map<std::string, std::vector<std::string>>
+  PopulationDependencies() {
+    std::map<std::string, std::vector<std::string>> graph;
+    graph["unfished_biomass"] = {"unfished_numbers_at_age"};
+    graph["unfished_spawning_biomass"] = {"unfished_numbers_at_age"};
+    return graph;
+  }
+
+  /**
+   * @brief Adds everything the needed derived quantities are calculated from
+   * to the needed derived quantities.
+   *
+   * @param needed The names of the needed derived quantities.
+   * @param graph The dependencies, see FleetDependencies().
+   */
+  static void AddDependencies(
+      std::set<std::string> &needed,
+      const std::map<std::string, std::vector<std::string>> &graph) {
+    std::vector<std::string> pending(needed.begin(), needed.end());
+    while (!pending.empty()) {
+      std::string name = pending.back();
+      pending.pop_back();
+      typename std::map<std::string, std::vector<std::string>>::const_iterator
+          it = graph.find(name);
+      if (it == graph.end()) {
+        continue;
+      }
+      for (size_t i = 0; i < (*it).second.size(); i++) {
+        if (needed.insert((*it).second[i]).second) {
+          pending.push_back((*it).second[i]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Adds the names of the derived quantities that are in the used
+   * vectors to the needed derived quantities.
+   */
+  static void AddUsed(std::map<std::string, fims::Vector<Type>> &dq,
+                      const std::set<const fims::Vector<Type> *> &used,
+                      std::set<std::string> &needed) {
+    for (dq_iterator it = dq.begin(); it != dq.end(); ++it) {
+      if (used.count(&(*it).second) > 0) {
+        needed.insert((*it).first);
+      }
+    }
+  }
+
+  /**
+   * @brief Finds the optional derived quantities that are needed because a
+   * density component uses them, they are reported, or a needed quantity is
+   * calculated from them. The rest are skipped if skip_unused is true.
+   *
+   * @param used The vectors that density components are linked to.
+   */
+  virtual void SetDemand(const std::set<const fims::Vector<Type> *> &used) {
+    this->population_demand.clear();
+    this->fleet_demand.clear();
+    std::set<std::string> reported = this->ReportedQuantities();
+
+    std::map<uint32_t, std::set<std::string>> fleet_needed;
+    for (fleet_iterator fit = this->fleets.begin(); fit != this->fleets.end();
+         ++fit) {
+      uint32_t id = (*fit).second->GetId();
+      fleet_needed[id] = reported;
+      AddUsed(this->fleet_derived_quantities[id], used, fleet_needed[id]);
+    }
+
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      std::shared_ptr<fims_popdy::Population<Type>> &population =
+          this->populations[p];
+      std::set<std::string> needed = reported;
+      AddUsed(this->population_derived_quantities[population->GetId()], used,
+              needed);
+      AddDependencies(needed, PopulationDependencies());
+      Demand demand;
+      demand.unfished = needed.count("unfished_numbers_at_age") > 0;
+      demand.biomass = needed.count("biomass") > 0;
+      demand.total_landings = needed.count("total_landings_weight") > 0 ||
+                              needed.count("total_landings_numbers") > 0;
+      if (demand.total_landings) {
+        for (size_t f = 0; f < population->fleets.size(); f++) {
+          std::set<std::string> &fleet =
+              fleet_needed[population->fleets[f]->GetId()];
+          fleet.insert("landings_weight_at_age");
+          fleet.insert("landings_numbers");
+        }
+      }
+      this->population_demand[population->GetId()] = demand;
+    }
+
+    for (fleet_iterator fit = this->fleets.begin(); fit != this->fleets.end();
+         ++fit) {
+      std::set<std::string> &needed = fleet_needed[(*fit).second->GetId()];
+      AddDependencies(needed, FleetDependencies((*fit).second));
+      Demand demand;
+      demand.landings = needed.count("landings_numbers_at_age") > 0;
+      demand.landings_weight = needed.count("landings_weight_at_age") > 0;
+      demand.index = needed.count("index_numbers_at_age") > 0;
+      demand.index_weight = needed.count("index_weight_at_age") > 0;
+      demand.age_comp = needed.count("agecomp_expected") > 0;
+      demand.length_comp = needed.count("lengthcomp_expected") > 0;
+      demand.landings_length = needed.count("landings_numbers_at_length") > 0;
+      demand.index_length = needed.count("index_numbers_at_length") > 0;
+      this->fleet_demand[(*fit).second->GetId()] = demand;
+    }
+  }
+
+  /**
+   * @brief The optional derived quantities computed for a population.
+   *
+   * @param id The population id.
+   */
+  const Demand &PopulationDemand(uint32_t id) {
+    return this->FindDemand(this->population_demand, id);
+  }
+
+  /**
+   * @brief The optional derived quantities computed for a fleet.
+   *
+   * @param id The fleet id.
+   */
+  const Demand &FleetDemand(uint32_t id) {
+    return this->FindDemand(this->fleet_demand, id);
+  }
+
+  /**
+   * @brief The demand with an id, or everything if skip_unused is false or
+   * SetDemand() has not been called.
+   */
+  const Demand &FindDemand(const std::map<uint32_t, Demand> &demands,
+                           uint32_t id) {
+    static const Demand everything;
+    if (!this->skip_unused) {
+      return everything;
+    }
+    typename std::map<uint32_t, Demand>::const_iterator it = demands.find(id);
+    return it == demands.end() ? everything : (*it).second;
+  }
+
+  /**
+   * @brief Adds the populations' copies of the fleet derived quantities to
+   * the fleet derived quantities in population order. The first population
+   * of a fleet is copied, so a fleet with one population gets exactly the
+   * values it would get from a serial evaluation.
+   */
+  void AddFleetContributions() {
+    const std::vector<std::string> &names =
+        CatchAtAge<Type>::FleetContributionNames();
+    std::set<uint32_t> copied;
+    for (size_t p = 0; p < this->populations.size(); p++) {
+      std::shared_ptr<fims_popdy::Population<Type>> &population =
+          this->populations[p];
+      for (size_t fleet_ = 0; fleet_ < population->fleets.size(); fleet_++) {
+        uint32_t fleet_id = population->fleets[fleet_]->GetId();
+        bool first = copied.insert(fleet_id).second;
+        std::map<std::string, fims::Vector<Type>> &contribution =
+            this->population_fleet_derived_quantities[population->GetId()]
+                                                     [fleet_id];
+        std::map<std::string, fims::Vector<Type>> &fleet_dq =
+            this->fleet_derived_quantities[fleet_id];
+        for (size_t n = 0; n < names.size(); n++) {
+          fims::Vector<Type> &from = contribution[names[n]];
+          fims::Vector<Type> &to = fleet_dq[names[n]];
+          for (size_t i = 0; i < from.size(); i++) {
+            if (first) {
+              to[i] = from[i];
+            } else {
+              to[i] += from[i];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * This function is used to add a population id to the set of population ids.
+   */
+  void AddPopulation(uint32_t id) { this->population_ids.insert(id); }
+
+  /**
+   * @brief Get the population ids of the model.
+   */
+  std::set<uint32_t> &GetPopulationIds() { return this->population_ids; }
+
+  /**
+   * This function is used to get the populations of the model. It returns a
+   * vector of shared pointers to the populations.
+   * @return std::vector<std::shared_ptr<fims_popdy::Population<Type>>>&
+   */
+  std::vector<std::shared_ptr<fims_popdy::Population<Type>>> &GetPopulations() {
+    return this->populations;
+  }
+
+  /**
+   * This method is used to calculate the initial numbers at age for a
+   * population. It takes a population object and an age as input and
+   * calculates the initial numbers at age for that population.
+   * @param population
+   * @param i_age_year
+   * @param a
+   */
+  void CalculateInitialNumbersAA(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      size_t i_age_year, size_t a) {
+    this->population_derived_quantities[population->GetId()]["numbers_at_age"]
+                                       [i_age_year] =
+        fims_math::exp(population->log_init_naa[a]);
+  }
+
+  /**
+   * * This method is used to calculate the numbers at age for a
+   * population. It takes a population object, the index of the age
+   * in the current year, the index of the age in the previous year,
+   * and the age as input and calculates the numbers at age for that
+   * population.
+   * @param population
+   * @param i_age_year
+   * @param i_agem1_yearm1
+   * @param age
+   */
+  void CalculateNumbersAA(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      size_t i_age_year, size_t i_agem1_yearm1, size_t age) {
+    // using Z from previous age/year
+
+    this->population_derived_quantities[population->GetId()]["numbers_at_age"]
+                                       [i_age_year] =
+        this->population_derived_quantities[population->GetId()]
+                                           ["numbers_at_age"][i_agem1_yearm1] *
+        (fims_math::exp(
+            -this->population_derived_quantities[population->GetId()]
+                                                ["mortality_Z"]
+                                                [i_agem1_yearm1]));
+
+    // Plus group calculation
+    if (age == (population->nages - 1)) {
+      this->population_derived_quantities[population->GetId()]["numbers_at_age"]
+                                         [i_age_year] =
+          this->population_derived_quantities[population->GetId()]
+                                             ["numbers_at_age"][i_age_year] +
+          this->population_derived_quantities[population->GetId()]
+                                             ["numbers_at_age"]
+                                             [i_agem1_yearm1 + 1] *
+              (fims_math::exp(
+                  -this->population_derived_quantities[population->GetId()]
+                                                      ["mortality_Z"]
+                                                      [i_agem1_yearm1 + 1]));
+    }
+  }
+
+  /**
+   * This method is used to calculate the unfished numbers at age for a
+   * population. It takes a population object, the index of the age
+   * in the current year, the index of the age in the previous year,
+   * and the age as input and calculates the unfished numbers at age
+   * for that population.
+   * @param population
+   * @param i_age_year
+   * @param i_agem1_yearm1
+   * @param age
+   */
+  void CalculateUnfishedNumbersAA(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      size_t i_age_year, size_t i_agem1_yearm1, size_t age) {
+    // using M from previous age/year
+    this->population_derived_quantities[population->GetId()]
+                                       ["unfished_numbers_at_age"][i_age_year] =
+        this->population_derived_quantities[population->GetId()]
+                                           ["unfished_numbers_at_age"]
+                                           [i_agem1_yearm1] *
+        (fims_math::exp(-population->M[i_agem1_yearm1]));
+
+    // Plus group calculation
+    if (age == (population->nages - 1)) {
+      this->population_derived_quantities[population->GetId()]
+                                         ["unfished_numbers_at_age"]
+                                         [i_age_year] =
+          this->population_derived_quantities[population->GetId()]
+                                             ["unfished_numbers_at_age"]
+                                             [i_age_year] +
+          this->population_derived_quantities[population->GetId()]
+                                             ["unfished_numbers_at_age"]
+                                             [i_agem1_yearm1 + 1] *
+              (fims_math::exp(-population->M[i_agem1_yearm1 + 1]));
+    }
+  }
+
+  /**
+   * * This method is used to calculate the mortality for a population. It takes
+   * a population object, the index of the age in the current year, the year,
+   * and the age as input and calculates the mortality for that population.
+   * @param population
+   * @param i_age_year
+   * @param year
+   * @param age
+   */
+  void CalculateMortality(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      size_t i_age_year, size_t year, size_t age) {
+    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      Type s = this->SelectivityAtAge(population, fleet_, age);
+
+      this->population_derived_quantities[population->GetId()]["mortality_F"]
+                                         [i_age_year] +=
+          population->fleets[fleet_]->Fmort[year] * s;
+
+      this->population_derived_quantities[population->GetId()]
+                                         ["sum_selectivity"][i_age_year] += s;
+    }
+    this->population_derived_quantities[population->GetId()]["mortality_Z"]
+                                       [i_age_year] =
+        population->M[i_age_year] +
+        this->population_derived_quantities[population->GetId()]["mortality_F"]
+                                           [i_age_year];
+  }
+
+  /**
+   * @brief The weight at age in a year, from the weight_at_age derived
+   * quantity, which holds one row of ages, or one per year when the growth
+   * varies by year. Years past the last model year use the last year.
+   *
+   * @param population The population.
+   * @param year The year index.
+   * @param age The age index.
+   */
+  const Type &WeightAtAge(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t year,
+      size_t age) {
+    fims::Vector<Type> &weight_at_age =
+        this->population_derived_quantities[population->GetId()]
+                                           ["weight_at_age"];
+    size_t nweight_years = weight_at_age.size() / population->nages;
+    size_t y = year < nweight_years ? year : nweight_years - 1;
+    return weight_at_age[y * population->nages + age];
+  }
+
+  /**
+   * @brief The selectivity of a fleet at an age, from the module table when
+   * the modules are resolved and from the selectivity module otherwise.
+   *
+   * @param population The population.
+   * @param fleet_ The index of the fleet in population->fleets.
+   * @param age The age index.
+   */
+  const Type SelectivityAtAge(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t fleet_,
+      size_t age) {
+    if (population->modules.resolved) {
+      return population->modules.selectivity_at_age[fleet_][age];
+    }
+    return population->fleets[fleet_]->selectivity->evaluate(
+        population->ages[age]);
+  }
+
+  /**
+   * @brief The maturity at an age, from the module table when the modules are
+   * resolved and from the maturity module otherwise.
+   *
+   * @param population The population.
+   * @param age The age index.
+   */
+  const Type MaturityAtAge(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t age) {
+    if (population->modules.resolved) {
+      return population->modules.maturity_at_age[age];
+    }
+    return population->maturity->evaluate(population->ages[age]);
+  }
+
+  /**
+   * @brief The expected recruitment of a population, see
+   * RecruitmentBase::evaluate_mean().
+   *
+   * @param population The population.
+   * @param spawners A measure of spawning output.
+   * @param phi_0 Number of spawners per recruit of an unfished population.
+   */
+  const Type RecruitmentMean(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      const Type &spawners, const Type &phi_0) {
+    if (population->modules.resolved) {
+      return population->modules.RecruitmentMean(spawners, phi_0);
+    }
+    return population->recruitment->evaluate_mean(spawners, phi_0);
+  }
+
+  /**
+   * * This method is used to calculate the biomass for a population. It takes a
+   * population object, the index of the age in the current year, the year,
+   * and the age as input and calculates the biomass for that population.
+   * @param population
+   * @param i_age_year
+   * @param year
+   * @param age
+   */
+  void CalculateBiomass(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      size_t i_age_year, size_t year, size_t age) {
+    this->population_derived_quantities[population->GetId()]["biomass"][year] +=
+        this->population_derived_quantities[population->GetId()]
+                                           ["numbers_at_age"][i_age_year] *
+        this->WeightAtAge(population, year, age);
+  }
+
+  /**
+   * * This method is used to calculate the unfished biomass for a population.
+   * It takes a population object, the index of the age in the current year, the
+   * year, and the age as input and calculates the unfished biomass for that
+   * population.
+   * @param population
+   * @param i_age_year
+   * @param year
+   * @param age
+   */
+  void CalculateUnfishedBiomass(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
       size_t i_age_year, size_t year, size_t age) {
     this->population_derived_quantities[population->GetId()]["unfished_biomass"]
                                        [year] +=
         this->population_derived_quantities[population->GetId()]
                                            ["unfished_numbers_at_age"]
                                            [i_age_year] *
-        this->population_derived_quantities[population->GetId()]
-                                           ["weight_at_age"][age];
+        this->WeightAtAge(population, year, age);
   }
 
   /**
@@ -746,8 +1635,7 @@ class CatchAtAge : public FisheryModelBase<Type> {
         this->population_derived_quantities[population->GetId()]
                                            ["proportion_mature_at_age"]
                                            [i_age_year] *
-        this->population_derived_quantities[population->GetId()]
-                                           ["weight_at_age"][age];
+        this->WeightAtAge(population, year, age);
   }
 
   /**
@@ -772,8 +1660,7 @@ class CatchAtAge : public FisheryModelBase<Type> {
         this->population_derived_quantities[population->GetId()]
                                            ["proportion_mature_at_age"]
                                            [i_age_year] *
-        this->population_derived_quantities[population->GetId()]
-                                           ["weight_at_age"][age];
+        this->WeightAtAge(population, year, age);
   }
 
   /**
@@ -788,14 +1675,14 @@ class CatchAtAge : public FisheryModelBase<Type> {
         numbers_spr[0] * population->proportion_female[0] *
         this->population_derived_quantities[population->GetId()]
                                            ["proportion_mature_at_age"][0] *
-        population->growth->evaluate(population->ages[0]);
+        this->WeightAtAge(population, 0, 0);
     for (size_t a = 1; a < (population->nages - 1); a++) {
       numbers_spr[a] = numbers_spr[a - 1] * fims_math::exp(-population->M[a]);
       phi_0 +=
           numbers_spr[a] * population->proportion_female[a] *
           this->population_derived_quantities[population->GetId()]
                                              ["proportion_mature_at_age"][a] *
-          population->growth->evaluate(population->ages[a]);
+          this->WeightAtAge(population, 0, a);
     }
 
     numbers_spr[population->nages - 1] =
@@ -808,7 +1695,7 @@ class CatchAtAge : public FisheryModelBase<Type> {
         this->population_derived_quantities[population->GetId()]
                                            ["proportion_mature_at_age"]
                                            [population->nages - 1] *
-        population->growth->evaluate(population->ages[population->nages - 1]);
+        this->WeightAtAge(population, 0, population->nages - 1);
 
     return phi_0;
   }
@@ -825,7 +1712,8 @@ class CatchAtAge : public FisheryModelBase<Type> {
     if (i_dev == population->nyears) {
       this->population_derived_quantities[population->GetId()]["numbers_at_age"]
                                          [i_age_year] =
-          population->recruitment->evaluate_mean(
+          this->RecruitmentMean(
+              population,
               this->population_derived_quantities[population->GetId()]
                                                  ["spawning_biomass"][year - 1],
               phi0);
@@ -836,7 +1724,8 @@ class CatchAtAge : public FisheryModelBase<Type> {
       // changed? AMH: there are now two virtual functions: evaluate_mean and
       // evaluate_process (see below)
       population->recruitment->log_expected_recruitment[year - 1] =
-          fims_math::log(population->recruitment->evaluate_mean(
+          fims_math::log(this->RecruitmentMean(
+              population,
               this->population_derived_quantities[population->GetId()]
                                                  ["spawning_biomass"][year - 1],
               phi0));
@@ -866,7 +1755,7 @@ class CatchAtAge : public FisheryModelBase<Type> {
     this->population_derived_quantities[population->GetId()]
                                        ["proportion_mature_at_age"]
                                        [i_age_year] =
-        population->maturity->evaluate(population->ages[age]);
+        this->MaturityAtAge(population, age);
   }
 
   /**
@@ -881,28 +1770,36 @@ class CatchAtAge : public FisheryModelBase<Type> {
   void CalculateLandings(
       std::shared_ptr<fims_popdy::Population<Type>> &population, size_t year,
       size_t age) {
+    bool total = this->PopulationDemand(population->GetId()).total_landings;
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      const Demand &demand =
+          this->FleetDemand(population->fleets[fleet_]->GetId());
+      if (!demand.landings) {
+        continue;
+      }
       size_t i_age_year = year * population->nages + age;
+      std::map<std::string, fims::Vector<Type>> &fleet_dq =
+          this->FleetQuantities(population, fleet_);
 
-      this->population_derived_quantities[population->GetId()]
-                                         ["total_landings_weight"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["landings_weight_at_age"][i_age_year];
+      if (total) {
+        this->population_derived_quantities[population->GetId()]
+                                           ["total_landings_weight"][year] +=
+            fleet_dq["landings_weight_at_age"][i_age_year];
+      }
 
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["landings_weight"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["landings_weight_at_age"][i_age_year];
+      if (demand.landings_weight) {
+        fleet_dq["landings_weight"][year] +=
+            fleet_dq["landings_weight_at_age"][i_age_year];
+      }
 
-      this->population_derived_quantities[population->GetId()]
-                                         ["total_landings_numbers"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["landings_numbers_at_age"][i_age_year];
+      if (total) {
+        this->population_derived_quantities[population->GetId()]
+                                           ["total_landings_numbers"][year] +=
+            fleet_dq["landings_numbers_at_age"][i_age_year];
+      }
 
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["landings_numbers"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["landings_numbers_at_age"][i_age_year];
+      fleet_dq["landings_numbers"][year] +=
+          fleet_dq["landings_numbers_at_age"][i_age_year];
     }
   }
 
@@ -920,13 +1817,15 @@ class CatchAtAge : public FisheryModelBase<Type> {
       size_t age) {
     int i_age_year = year * population->nages + age;
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["landings_weight_at_age"][i_age_year] =
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["landings_numbers_at_age"]
-                                        [i_age_year] *
-          this->population_derived_quantities[population->GetId()]
-                                             ["weight_at_age"][age];
+      if (!this->FleetDemand(population->fleets[fleet_]->GetId())
+               .landings_weight) {
+        continue;
+      }
+      std::map<std::string, fims::Vector<Type>> &fleet_dq =
+          this->FleetQuantities(population, fleet_);
+      fleet_dq["landings_weight_at_age"][i_age_year] =
+          fleet_dq["landings_numbers_at_age"][i_age_year] *
+          this->WeightAtAge(population, year, age);
     }
   }
 
@@ -942,12 +1841,14 @@ class CatchAtAge : public FisheryModelBase<Type> {
       std::shared_ptr<fims_popdy::Population<Type>> &population,
       size_t i_age_year, size_t year, size_t age) {
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      if (!this->FleetDemand(population->fleets[fleet_]->GetId()).landings) {
+        continue;
+      }
       // Baranov Catch Equation
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["landings_numbers_at_age"][i_age_year] +=
+      this->FleetQuantities(population, fleet_)["landings_numbers_at_age"]
+                                               [i_age_year] +=
           (population->fleets[fleet_]->Fmort[year] *
-           population->fleets[fleet_]->selectivity->evaluate(
-               population->ages[age])) /
+           this->SelectivityAtAge(population, fleet_, age)) /
           this->population_derived_quantities[population->GetId()]
                                              ["mortality_Z"][i_age_year] *
           this->population_derived_quantities[population->GetId()]
@@ -970,15 +1871,111 @@ class CatchAtAge : public FisheryModelBase<Type> {
   void CalculateIndex(std::shared_ptr<fims_popdy::Population<Type>> &population,
                       size_t i_age_year, size_t year, size_t age) {
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["index_weight"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["index_weight_at_age"][i_age_year];
+      const Demand &demand =
+          this->FleetDemand(population->fleets[fleet_]->GetId());
+      if (!demand.index) {
+        continue;
+      }
+      std::map<std::string, fims::Vector<Type>> &fleet_dq =
+          this->FleetQuantities(population, fleet_);
+      if (demand.index_weight) {
+        fleet_dq["index_weight"][year] +=
+            fleet_dq["index_weight_at_age"][i_age_year];
+      }
 
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["index_numbers"][year] +=
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["index_numbers_at_age"][i_age_year];
+      fleet_dq["index_numbers"][year] +=
+          fleet_dq["index_numbers_at_age"][i_age_year];
+    }
+  }
+
+  /**
+   * @brief Calculates the numbers at age at the start of the next year,
+   * except for recruits, with the survival kernel.
+   *
+   * @param population The population.
+   * @param year The year the mortality is applied in.
+   * @return The numbers at ages 1 to nages - 1 in year + 1.
+   */
+  std::vector<Type> CalculateSurvivors(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t year) {
+    size_t nages = population->nages;
+    std::map<std::string, fims::Vector<Type>> &dq =
+        this->population_derived_quantities[population->GetId()];
+    fims::Vector<Type> &numbers_at_age = dq["numbers_at_age"];
+    fims::Vector<Type> &mortality_Z = dq["mortality_Z"];
+    std::vector<Type> tx(2 * nages);
+    for (size_t a = 0; a < nages; a++) {
+      tx[a] = numbers_at_age[year * nages + a];
+      tx[nages + a] = mortality_Z[year * nages + a];
+    }
+    return fims_math::survival_step(tx);
+  }
+
+  /**
+   * @brief Calculates the landings numbers at age of every fleet in a year
+   * with the Baranov catch kernel. Gives the same values as calling
+   * CalculateLandingsNumbersAA() for each age.
+   *
+   * @param population The population.
+   * @param year The year.
+   */
+  void CalculateLandingsNumbers(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t year) {
+    size_t nages = population->nages;
+    std::map<std::string, fims::Vector<Type>> &dq =
+        this->population_derived_quantities[population->GetId()];
+    fims::Vector<Type> &numbers_at_age = dq["numbers_at_age"];
+    fims::Vector<Type> &mortality_Z = dq["mortality_Z"];
+    std::vector<Type> tx(3 * nages);
+    for (size_t a = 0; a < nages; a++) {
+      tx[nages + a] = mortality_Z[year * nages + a];
+      tx[2 * nages + a] = numbers_at_age[year * nages + a];
+    }
+    fims::Vector<Type> evaluated(nages);
+    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> &fleet =
+          population->fleets[fleet_];
+      if (!this->FleetDemand(fleet->GetId()).landings) {
+        continue;
+      }
+      const fims::Vector<Type> *selectivity_at_age = &evaluated;
+      if (population->modules.resolved) {
+        selectivity_at_age = &population->modules.selectivity_at_age[fleet_];
+      } else {
+        fleet->selectivity->evaluate_all(population->ages, evaluated);
+      }
+      const fims::Vector<Type> &selectivity = *selectivity_at_age;
+      for (size_t a = 0; a < nages; a++) {
+        tx[a] = fleet->Fmort[year] * selectivity[a];
+      }
+      std::vector<Type> landings = fims_math::baranov_catch(tx);
+      fims::Vector<Type> &landings_numbers_at_age =
+          this->FleetQuantities(population, fleet_)["landings_numbers_at_age"];
+      for (size_t a = 0; a < nages; a++) {
+        landings_numbers_at_age[year * nages + a] += landings[a];
+      }
+    }
+  }
+
+  /**
+   * @brief Divides one year of an expected composition by its sum with the
+   * normalization kernel.
+   *
+   * @param expected The expected composition, folded by year.
+   * @param proportion The output proportions, folded by year.
+   * @param start The index of the first bin of the year.
+   * @param nbins The number of bins in a year.
+   */
+  void NormalizeComposition(fims::Vector<Type> &expected,
+                            fims::Vector<Type> &proportion, size_t start,
+                            size_t nbins) {
+    std::vector<Type> tx(nbins);
+    for (size_t i = 0; i < nbins; i++) {
+      tx[i] = expected[start + i];
+    }
+    std::vector<Type> ty = fims_math::normalize(tx);
+    for (size_t i = 0; i < nbins; i++) {
+      proportion[start + i] = ty[i];
     }
   }
 
@@ -994,11 +1991,13 @@ class CatchAtAge : public FisheryModelBase<Type> {
       std::shared_ptr<fims_popdy::Population<Type>> &population,
       size_t i_age_year, size_t year, size_t age) {
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["index_numbers_at_age"][i_age_year] +=
+      if (!this->FleetDemand(population->fleets[fleet_]->GetId()).index) {
+        continue;
+      }
+      this->FleetQuantities(population, fleet_)["index_numbers_at_age"]
+                                               [i_age_year] +=
           (population->fleets[fleet_]->q.get_force_scalar(year) *
-           population->fleets[fleet_]->selectivity->evaluate(
-               population->ages[age])) *
+           this->SelectivityAtAge(population, fleet_, age)) *
           this->population_derived_quantities[population->GetId()]
                                              ["numbers_at_age"][i_age_year];
     }
@@ -1016,12 +2015,15 @@ class CatchAtAge : public FisheryModelBase<Type> {
       size_t age) {
     int i_age_year = year * population->nages + age;
     for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
-      this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                    ["index_weight_at_age"][i_age_year] =
-          this->fleet_derived_quantities[population->fleets[fleet_]->GetId()]
-                                        ["index_numbers_at_age"][i_age_year] *
-          this->population_derived_quantities[population->GetId()]
-                                             ["weight_at_age"][age];
+      if (!this->FleetDemand(population->fleets[fleet_]->GetId())
+               .index_weight) {
+        continue;
+      }
+      std::map<std::string, fims::Vector<Type>> &fleet_dq =
+          this->FleetQuantities(population, fleet_);
+      fleet_dq["index_weight_at_age"][i_age_year] =
+          fleet_dq["index_numbers_at_age"][i_age_year] *
+          this->WeightAtAge(population, year, age);
     }
   }
 
@@ -1120,9 +2122,19 @@ class CatchAtAge : public FisheryModelBase<Type> {
     fleet_iterator fit;
     for (fit = this->fleets.begin(); fit != this->fleets.end(); ++fit) {
       std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*fit).second;
+      if (!this->FleetDemand(fleet->GetId()).age_comp) {
+        continue;
+      }
       for (size_t y = 0; y < fleet->nyears; y++) {
         Type sum = static_cast<Type>(0.0);
         Type sum_obs = static_cast<Type>(0.0);
+        fims::Span<const double> observed;
+        double na_value = 0.0;
+        if (fleet->fleet_observed_agecomp_data_id_m != -999) {
+          observed = fims_popdy::Fleet<Type>::ObservedYear(
+              *fleet->observed_agecomp_data, y, fleet->nages);
+          na_value = fims::value_of(fleet->observed_agecomp_data->na_value);
+        }
         // robust_add is a small value to add to expected composition
         // proportions at age to stabilize likelihood calculations
         // when the expected proportions are close to zero.
@@ -1164,19 +2176,29 @@ class CatchAtAge : public FisheryModelBase<Type> {
           // allow for composition bins that do not match the population
           // bins.
           if (fleet->fleet_observed_agecomp_data_id_m != -999) {
-            if (fleet->observed_agecomp_data->at(i_age_year) !=
-                fleet->observed_agecomp_data->na_value) {
-              sum_obs += fleet->observed_agecomp_data->at(i_age_year);
+            if (observed[a] != na_value) {
+              sum_obs += static_cast<Type>(observed[a]);
             }
           }
         }
+        if (this->use_atomic_kernels) {
+          this->NormalizeComposition(
+              this->fleet_derived_quantities[fleet->GetId()]
+                                            ["agecomp_expected"],
+              this->fleet_derived_quantities[fleet->GetId()]
+                                            ["agecomp_proportion"],
+              y * fleet->nages, fleet->nages);
+        }
         for (size_t a = 0; a < fleet->nages; a++) {
           size_t i_age_year = y * fleet->nages + a;
-          this->fleet_derived_quantities[fleet->GetId()]["agecomp_proportion"]
-                                        [i_age_year] =
-              this->fleet_derived_quantities[fleet->GetId()]["agecomp_expected"]
-                                            [i_age_year] /
-              sum;
+          if (!this->use_atomic_kernels) {
+            this->fleet_derived_quantities[fleet->GetId()]
+                                          ["agecomp_proportion"][i_age_year] =
+                this->fleet_derived_quantities[fleet->GetId()]
+                                              ["agecomp_expected"]
+                                              [i_age_year] /
+                sum;
+          }
           // robust_add + robust_sum * this->agecomp_expected[i_age_year] / sum;
 
           if (fleet->fleet_observed_agecomp_data_id_m != -999) {
@@ -1199,11 +2221,44 @@ class CatchAtAge : public FisheryModelBase<Type> {
     fleet_iterator fit;
     for (fit = this->fleets.begin(); fit != this->fleets.end(); ++fit) {
       std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*fit).second;
+      const Demand &demand = this->FleetDemand(fleet->GetId());
+
+      if (fleet->nlengths > 0 &&
+          (demand.length_comp || demand.landings_length ||
+           demand.index_length)) {
+        std::map<std::string, fims::Vector<Type>> &fleet_dq =
+            this->fleet_derived_quantities[fleet->GetId()];
+        // numbers at length by year are numbers at age by year times the
+        // age-length key, of which only the band of nonzero length bins of
+        // each age is stored
+        const fims::BandedMatrix<Type> &key = fleet->length_key;
+        if (demand.length_comp) {
+          key.MultiplyAdd(fleet_dq["agecomp_expected"].data(),
+                          fleet_dq["lengthcomp_expected"].data(),
+                          fleet->nyears);
+        }
+        if (demand.landings_length) {
+          key.MultiplyAdd(fleet_dq["landings_numbers_at_age"].data(),
+                          fleet_dq["landings_numbers_at_length"].data(),
+                          fleet->nyears);
+        }
+        if (demand.index_length) {
+          key.MultiplyAdd(fleet_dq["index_numbers_at_age"].data(),
+                          fleet_dq["index_numbers_at_length"].data(),
+                          fleet->nyears);
+        }
 
-      if (fleet->nlengths > 0) {
         for (size_t y = 0; y < fleet->nyears; y++) {
           Type sum = static_cast<Type>(0.0);
           Type sum_obs = static_cast<Type>(0.0);
+          fims::Span<const double> observed;
+          double na_value = 0.0;
+          if (fleet->fleet_observed_lengthcomp_data_id_m != -999) {
+            observed = fims_popdy::Fleet<Type>::ObservedYear(
+                *fleet->observed_lengthcomp_data, y, fleet->nlengths);
+            na_value =
+                fims::value_of(fleet->observed_lengthcomp_data->na_value);
+          }
           // robust_add is a small value to add to expected composition
           // proportions at age to stabilize likelihood calculations
           // when the expected proportions are close to zero.
@@ -1213,61 +2268,39 @@ class CatchAtAge : public FisheryModelBase<Type> {
           // robust_sum = static_cast<Type>(1.0);
           for (size_t l = 0; l < fleet->nlengths; l++) {
             size_t i_length_year = y * fleet->nlengths + l;
-            for (size_t a = 0; a < fleet->nages; a++) {
-              size_t i_age_year = y * fleet->nages + a;
-              size_t i_length_age = a * fleet->nlengths + l;
-              this->fleet_derived_quantities[fleet->GetId()]
-                                            ["lengthcomp_expected"]
-                                            [i_length_year] +=
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["agecomp_expected"]
-                                                [i_age_year] *
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["age_to_length_conversion"]
-                                                [i_length_age];
-
-              this->fleet_derived_quantities[fleet->GetId()]
-                                            ["landings_numbers_at_length"]
-                                            [i_length_year] +=
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["landings_numbers_at_age"]
-                                                [i_age_year] *
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["age_to_length_conversion"]
-                                                [i_length_age];
-
-              this->fleet_derived_quantities[fleet->GetId()]
-                                            ["index_numbers_at_length"]
-                                            [i_length_year] +=
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["index_numbers_at_age"]
-                                                [i_age_year] *
-                  this->fleet_derived_quantities[fleet->GetId()]
-                                                ["age_to_length_conversion"]
-                                                [i_length_age];
-            }
-
             sum += this->fleet_derived_quantities[fleet->GetId()]
                                                  ["lengthcomp_expected"]
                                                  [i_length_year];
             // robust_sum -= robust_add;
 
             if (fleet->fleet_observed_lengthcomp_data_id_m != -999) {
-              if (fleet->observed_lengthcomp_data->at(i_length_year) !=
-                  fleet->observed_lengthcomp_data->na_value) {
-                sum_obs += fleet->observed_lengthcomp_data->at(i_length_year);
+              if (observed[l] != na_value) {
+                sum_obs += static_cast<Type>(observed[l]);
               }
             }
           }
+          if (!demand.length_comp) {
+            continue;
+          }
+          if (this->use_atomic_kernels) {
+            this->NormalizeComposition(
+                this->fleet_derived_quantities[fleet->GetId()]
+                                              ["lengthcomp_expected"],
+                this->fleet_derived_quantities[fleet->GetId()]
+                                              ["lengthcomp_proportion"],
+                y * fleet->nlengths, fleet->nlengths);
+          }
           for (size_t l = 0; l < fleet->nlengths; l++) {
             size_t i_length_year = y * fleet->nlengths + l;
-            this->fleet_derived_quantities[fleet->GetId()]
-                                          ["lengthcomp_proportion"]
-                                          [i_length_year] =
-                this->fleet_derived_quantities[fleet->GetId()]
-                                              ["lengthcomp_expected"]
-                                              [i_length_year] /
-                sum;
+            if (!this->use_atomic_kernels) {
+              this->fleet_derived_quantities[fleet->GetId()]
+                                            ["lengthcomp_proportion"]
+                                            [i_length_year] =
+                  this->fleet_derived_quantities[fleet->GetId()]
+                                                ["lengthcomp_expected"]
+                                                [i_length_year] /
+                  sum;
+            }
             // robust_add + robust_sum *
             // this->lengthcomp_expected[i_length_year] / sum;
             if (fleet->fleet_observed_lengthcomp_data_id_m != -999) {
@@ -1292,6 +2325,9 @@ class CatchAtAge : public FisheryModelBase<Type> {
     fleet_iterator fit;
     for (fit = this->fleets.begin(); fit != this->fleets.end(); ++fit) {
       std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*fit).second;
+      if (!this->FleetDemand(fleet->GetId()).index) {
+        continue;
+      }
 
       for (size_t i = 0;
            i < this->fleet_derived_quantities[fleet->GetId()]["index_numbers"]
@@ -1320,6 +2356,9 @@ class CatchAtAge : public FisheryModelBase<Type> {
     fleet_iterator fit;
     for (fit = this->fleets.begin(); fit != this->fleets.end(); ++fit) {
       std::shared_ptr<fims_popdy::Fleet<Type>> &fleet = (*fit).second;
+      if (!this->FleetDemand(fleet->GetId()).landings) {
+        continue;
+      }
 
       for (size_t i = 0; i < fleet->landings_weight.size(); i++) {
         if (fleet->observed_landings_units == "number") {
@@ -1341,158 +2380,495 @@ class CatchAtAge : public FisheryModelBase<Type> {
     }
   }
   /**
-   * * This method is used to evaluate the population dynamics model.
+   * @brief Adds the contributions of a population to the index of each of
+   * its fleets in one year.
+   *
+   * @param population The population.
+   * @param year The year.
    */
-  virtual void Evaluate() {
-    /*
-               Sets derived vectors to zero
-               Performs parameters transformations
-               Sets recruitment deviations to mean 0.
-     */
-    Prepare();
-    /*
-     start at year=0, age=0;
-     here year 0 is the estimated initial population structure and age 0 are
-     recruits loops start at zero with if statements inside to specify unique
-     code for initial structure and recruitment 0 loops. Could also have started
-     loops at 1 with initial structure and recruitment setup outside the loops.
+  void CalculateIndexYear(
+      std::shared_ptr<fims_popdy::Population<Type>> &population, size_t year) {
+    for (size_t a = 0; a < population->nages; a++) {
+      size_t i_age_year = year * population->nages + a;
+      CalculateIndexNumbersAA(population, i_age_year, year, a);
+      CalculateIndexWeightAA(population, year, a);
+      CalculateIndex(population, i_age_year, year, a);
+    }
+  }
 
-     year loop is extended to <= nyears because SSB is calculated as the start
-     of the year value and by extending one extra year we get estimates of the
-     population structure at the end of the final year. An alternative approach
-     would be to keep initial numbers at age in it's own vector and each year to
-     include the population structure at the end of the year. This is likely a
-     null point given that we are planning to modify to an event/stanza based
-     structure in later milestones which will eliminate this confusion by
-     explicitly referencing the exact date (or period of averaging) at which any
-     calculation or output is being made.
-     */
-    for (size_t p = 0; p < this->populations.size(); p++) {
-      std::shared_ptr<fims_popdy::Population<Type>> &population =
-          this->populations[p];
+  /**
+   * @brief Evaluates the dynamics of one population and its contributions to
+   * the landings and indices of its fleets.
+   *
+   * @details While populations are evaluated as separate tasks, a population
+   * only writes to its own derived quantities and to its own copy of the fleet
+   * derived quantities. Every map entry it looks up is created by Initialize()
+   * and PrepareFleetContributions(), so no task inserts into a shared map.
+   *
+   * @param population The population.
+   */
+  void EvaluatePopulation(
+      std::shared_ptr<fims_popdy::Population<Type>> &population) {
+    bool kernels = this->use_atomic_kernels && population->nages > 1;
+    // an incremental evaluation keeps the years before the first change
+    size_t first =
+        this->partial ? this->first_changed_year.at(population->GetId()) : 0;
+    if (this->partial &&
+        this->index_changed.count(population->GetId()) > 0) {
+      for (size_t y = 0; y < std::min(first, population->nyears); y++) {
+        this->CalculateIndexYear(population, y);
+      }
+    }
+    size_t nblock = this->checkpoint_years > 0 ? this->checkpoint_years
+                                               : population->nyears + 1;
+    for (size_t start = first; start <= population->nyears; start += nblock) {
+      size_t end = std::min(start + nblock, population->nyears + 1);
+      if (this->checkpoint_years > 0) {
+        fims::checkpoint<Type>(
+            [&]() { this->EvaluateYears(population, start, end, kernels); },
+            this->CheckpointVectors(population));
+      } else {
+        this->EvaluateYears(population, start, end, kernels);
+      }
+    }
+  }
+
+  /**
+   * @brief The vectors that the years of a population write to, i.e., the
+   * population derived quantities, the fleet derived quantities the
+   * population adds to, and the expected recruitment.
+   *
+   * @param population The population.
+   */
+  std::vector<fims::Vector<Type> *> CheckpointVectors(
+      std::shared_ptr<fims_popdy::Population<Type>> &population) {
+    std::vector<fims::Vector<Type> *> tracked;
+    std::map<std::string, fims::Vector<Type>> &dq =
+        this->population_derived_quantities[population->GetId()];
+    for (dq_iterator it = dq.begin(); it != dq.end(); ++it) {
+      tracked.push_back(&(*it).second);
+    }
+    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      std::map<std::string, fims::Vector<Type>> &fleet_dq =
+          this->FleetQuantities(population, fleet_);
+      for (dq_iterator it = fleet_dq.begin(); it != fleet_dq.end(); ++it) {
+        tracked.push_back(&(*it).second);
+      }
+    }
+    tracked.push_back(&population->recruitment->log_expected_recruitment);
+    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      if (population->fleets[fleet_]->hybrid_F) {
+        tracked.push_back(&population->fleets[fleet_]->Fmort);
+      }
+    }
+    return tracked;
+  }
 
-      // CAAPopulationProxy<Type>& population = this->populations_proxies[p];
+  /**
+   * @brief True if a fleet of the population has hybrid F.
+   */
+  bool HasHybridF(std::shared_ptr<fims_popdy::Population<Type>> &population) {
+    for (size_t fleet_ = 0; fleet_ < population->nfleets; fleet_++) {
+      if (population->fleets[fleet_]->hybrid_F) {
+        return true;
+      }
+    }
+    return false;
+  }
 
-      for (size_t y = 0; y <= population->nyears; y++) {
-        for (size_t a = 0; a < population->nages; a++) {
-          /*
-           index naming defines the dimensional folding structure
-           i.e. i_age_year is referencing folding over years and ages.
-           */
-          size_t i_age_year = y * population->nages + a;
+  /**
+   * @brief Solves the F in one year of the fleets of a population that have
+   * hybrid F, so their expected landings match the observed landings. The
+   * numbers at age of the year must be known. A year with no landings has no
+   * F. Information::CheckHybridF() ensures no landings are missing.
+   *
+   * @param population The population.
+   * @param year The year.
+   */
+  void SolveHybridF(std::shared_ptr<fims_popdy::Population<Type>> &population,
+                    size_t year) {
+    size_t nages = population->nages;
+    size_t nfleets = population->nfleets;
+    fims::Vector<Type> &numbers_at_age =
+        this->population_derived_quantities[population->GetId()]
+                                           ["numbers_at_age"];
+    HybridF<Type> solver;
+    solver.newton_iterations = this->hybrid_F_iterations;
+    solver.Resize(nages, nfleets);
+    for (size_t a = 0; a < nages; a++) {
+      solver.M[a] = population->M[year * nages + a];
+      solver.numbers[a] = numbers_at_age[year * nages + a];
+      solver.weight[a] = this->WeightAtAge(population, year, a);
+    }
+    for (size_t fleet_ = 0; fleet_ < nfleets; fleet_++) {
+      std::shared_ptr<fims_popdy::Fleet<Type>> &fleet =
+          population->fleets[fleet_];
+      for (size_t a = 0; a < nages; a++) {
+        solver.selectivity[fleet_][a] =
+            this->SelectivityAtAge(population, fleet_, a);
+      }
+      solver.F[fleet_] = fleet->Fmort[year];
+      solver.solve[fleet_] = false;
+      if (!fleet->hybrid_F) {
+        continue;
+      }
+      Type observed = fleet->observed_landings_data->at(year);
+      if (fims::value_of(observed) ==
+          fims::value_of(fleet->observed_landings_data->na_value)) {
+        // missing landings are rejected when the model is created or the
+        // data are updated, so they were written directly; the year is
+        // logged as an error and given no F
+        typename std::map<uint32_t, std::vector<size_t>>::iterator missing =
+            this->missing_landings_years.find(fleet->GetId());
+        if (missing != this->missing_landings_years.end()) {
+          (*missing).second.push_back(year);
+        }
+        solver.F[fleet_] = static_cast<Type>(0.0);
+        continue;
+      }
+      if (fims::value_of(observed) <= 0.0) {
+        solver.F[fleet_] = static_cast<Type>(0.0);
+        continue;
+      }
+      solver.solve[fleet_] = true;
+      solver.landings[fleet_] = observed;
+      solver.in_weight[fleet_] = fleet->observed_landings_units != "number";
+    }
+    solver.Solve();
+    for (size_t fleet_ = 0; fleet_ < nfleets; fleet_++) {
+      population->fleets[fleet_]->Fmort[year] = solver.F[fleet_];
+    }
+  }
+
+  /**
+   * @brief Evaluates the years [start, end) of a population.
+   *
+   * @param population The population.
+   * @param start The first year.
+   * @param end One past the last year, at most nyears + 1.
+   * @param kernels If true, the vector kernels are used.
+   */
+  void EvaluateYears(std::shared_ptr<fims_popdy::Population<Type>> &population,
+                     size_t start, size_t end, bool kernels) {
+    const Demand &demand = this->PopulationDemand(population->GetId());
+    // with hybrid F, mortality is known once the numbers at age of the year are
+    bool hybrid = this->HasHybridF(population);
+    for (size_t y = start; y < end; y++) {
+      // numbers at age after the mortality of the previous year
+      std::vector<Type> survivors;
+      if (kernels && y > 0) {
+        survivors = this->CalculateSurvivors(population, y - 1);
+      }
+      for (size_t a = 0; a < population->nages; a++) {
+        /*
+         index naming defines the dimensional folding structure
+         i.e. i_age_year is referencing folding over years and ages.
+         */
+        size_t i_age_year = y * population->nages + a;
+        /*
+         Mortality rates are not estimated in the final year which is
+         used to show expected population structure at the end of the model
+         period. This is because biomass in year i represents biomass at the
+         start of the year. Should we add complexity to track more values such
+         as start, mid, and end biomass in all years where, start biomass=end
+         biomass of the previous year? Referenced above, this is probably not
+         worth exploring as later milestone changes will eliminate this
+         confusion.
+         */
+        if (y < population->nyears && !hybrid) {
           /*
-           Mortality rates are not estimated in the final year which is
-           used to show expected population structure at the end of the model
-           period. This is because biomass in year i represents biomass at the
-           start of the year. Should we add complexity to track more values such
-           as start, mid, and end biomass in all years where, start biomass=end
-           biomass of the previous year? Referenced above, this is probably not
-           worth exploring as later milestone changes will eliminate this
-           confusion.
-           */
-          if (y < population->nyears) {
-            /*
-             First thing we need is total mortality aggregated across all fleets
-             to inform the subsequent catch and change in numbers at age
-             calculations. This is only calculated for years < nyears as these
-             are the model estimated years with data. The year loop extends to
-             y=nyears so that population numbers at age and SSB can be
-             calculated at the end of the last year of the model
-             */
-            CalculateMortality(population, i_age_year, y, a);
-          }
-          CalculateMaturityAA(population, i_age_year, a);
-          /* if statements needed because some quantities are only needed
-          for the first year and/or age, so these steps are included here.
+           First thing we need is total mortality aggregated across all fleets
+           to inform the subsequent catch and change in numbers at age
+           calculations. This is only calculated for years < nyears as these
+           are the model estimated years with data. The year loop extends to
+           y=nyears so that population numbers at age and SSB can be
+           calculated at the end of the last year of the model
            */
-          if (y == 0) {
-            // Initial numbers at age is a user input or estimated parameter
-            // vector.
-            CalculateInitialNumbersAA(population, i_age_year, a);
-
+          CalculateMortality(population, i_age_year, y, a);
+        }
+        CalculateMaturityAA(population, i_age_year, a);
+        /* if statements needed because some quantities are only needed
+        for the first year and/or age, so these steps are included here.
+         */
+        if (y == 0) {
+          // Initial numbers at age is a user input or estimated parameter
+          // vector.
+          CalculateInitialNumbersAA(population, i_age_year, a);
+
+          if (demand.unfished) {
             if (a == 0) {
               this->population_derived_quantities[population->GetId()]
                                                  ["unfished_numbers_at_age"]
                                                  [i_age_year] =
-                  fims_math::exp(population->recruitment->log_rzero[0]);
+                  population->recruitment->rzero;
             } else {
               CalculateUnfishedNumbersAA(population, i_age_year, a - 1, a);
             }
+          }
 
-            /*
-             Fished and unfished biomass vectors are summing biomass at
-             age across ages.
-             */
+          /*
+           Fished and unfished biomass vectors are summing biomass at
+           age across ages.
+           */
 
+          if (demand.biomass) {
             CalculateBiomass(population, i_age_year, y, a);
+          }
 
+          if (demand.unfished) {
             CalculateUnfishedBiomass(population, i_age_year, y, a);
+          }
 
-            /*
-             Fished and unfished spawning biomass vectors are summing biomass at
-             age across ages to allow calculation of recruitment in the next
-             year.
-             */
+          /*
+           Fished and unfished spawning biomass vectors are summing biomass at
+           age across ages to allow calculation of recruitment in the next
+           year.
+           */
 
-            CalculateSpawningBiomass(population, i_age_year, y, a);
+          CalculateSpawningBiomass(population, i_age_year, y, a);
 
+          if (demand.unfished) {
             CalculateUnfishedSpawningBiomass(population, i_age_year, y, a);
+          }
 
-            /*
-             Expected recruitment in year 0 is numbers at age 0 in year 0.
-             */
+          /*
+           Expected recruitment in year 0 is numbers at age 0 in year 0.
+           */
 
-            this->population_derived_quantities[population->GetId()]
-                                               ["expected_recruitment"]
-                                               [i_age_year] =
-                this->population_derived_quantities[population->GetId()]
-                                                   ["numbers_at_age"]
-                                                   [i_age_year];
-          } else {
-            if (a == 0) {
-              // Set the nrecruits for age a=0 year y (use pointers instead of
-              // functional returns) assuming fecundity = 1 and 50:50 sex ratio
-              CalculateRecruitment(population, i_age_year, y, y);
+          this->population_derived_quantities[population->GetId()]
+                                             ["expected_recruitment"]
+                                             [i_age_year] =
+              this->population_derived_quantities[population->GetId()]
+                                                 ["numbers_at_age"]
+                                                 [i_age_year];
+        } else {
+          if (a == 0) {
+            // Set the nrecruits for age a=0 year y (use pointers instead of
+            // functional returns) assuming fecundity = 1 and 50:50 sex ratio
+            CalculateRecruitment(population, i_age_year, y, y);
+            if (demand.unfished) {
               this->population_derived_quantities[population->GetId()]
                                                  ["unfished_numbers_at_age"]
                                                  [i_age_year] =
-                  fims_math::exp(population->recruitment->log_rzero[0]);
+                  population->recruitment->rzero;
+            }
+          } else {
+            size_t i_agem1_yearm1 = (y - 1) * population->nages + (a - 1);
+            if (kernels) {
+              this->population_derived_quantities[population->GetId()]
+                                                 ["numbers_at_age"]
+                                                 [i_age_year] =
+                  survivors[a - 1];
             } else {
-              size_t i_agem1_yearm1 = (y - 1) * population->nages + (a - 1);
               CalculateNumbersAA(population, i_age_year, i_agem1_yearm1, a);
-              CalculateUnfishedNumbersAA(population, i_age_year, i_agem1_yearm1,
-                                         a);
             }
+            if (demand.unfished) {
+              CalculateUnfishedNumbersAA(population, i_age_year,
+                                         i_agem1_yearm1, a);
+            }
+          }
+          if (demand.biomass) {
             CalculateBiomass(population, i_age_year, y, a);
-            CalculateSpawningBiomass(population, i_age_year, y, a);
+          }
+          CalculateSpawningBiomass(population, i_age_year, y, a);
 
+          if (demand.unfished) {
             CalculateUnfishedBiomass(population, i_age_year, y, a);
             CalculateUnfishedSpawningBiomass(population, i_age_year, y, a);
           }
+        }
+      }
 
-          /*
-          Here composition, total catch, and index values are calculated for all
-          years with reference data. They are not calculated for y=nyears as
-          there is this is just to get final population structure at the end of
-          the terminal year.
-           */
-          if (y < population->nyears) {
+      /*
+      Here composition, total catch, and index values are calculated for all
+      years with reference data. They are not calculated for y=nyears as
+      there is this is just to get final population structure at the end of
+      the terminal year. They only depend on mortality and numbers at age, so
+      they are calculated after all ages of the year are known.
+       */
+      if (y < population->nyears) {
+        if (hybrid) {
+          this->SolveHybridF(population, y);
+          for (size_t a = 0; a < population->nages; a++) {
+            CalculateMortality(population, y * population->nages + a, y, a);
+          }
+        }
+        if (kernels) {
+          CalculateLandingsNumbers(population, y);
+        }
+        for (size_t a = 0; a < population->nages; a++) {
+          size_t i_age_year = y * population->nages + a;
+          if (!kernels) {
             CalculateLandingsNumbersAA(population, i_age_year, y, a);
-            CalculateLandingsWeightAA(population, y, a);
-            CalculateLandings(population, y, a);
-
-            CalculateIndexNumbersAA(population, i_age_year, y, a);
-            CalculateIndexWeightAA(population, y, a);
-            CalculateIndex(population, i_age_year, y, a);
           }
+          CalculateLandingsWeightAA(population, y, a);
+          CalculateLandings(population, y, a);
+
+          CalculateIndexNumbersAA(population, i_age_year, y, a);
+          CalculateIndexWeightAA(population, y, a);
+          CalculateIndex(population, i_age_year, y, a);
         }
       }
     }
+  }
+
+  /**
+   * * This method is used to evaluate the population dynamics model.
+   */
+  virtual void Evaluate() {
+    /*
+               Sets derived vectors to zero
+               Performs parameters transformations
+               Sets recruitment deviations to mean 0.
+     */
+    Prepare();
+    /*
+     start at year=0, age=0;
+     here year 0 is the estimated initial population structure and age 0 are
+     recruits loops start at zero with if statements inside to specify unique
+     code for initial structure and recruitment 0 loops. Could also have started
+     loops at 1 with initial structure and recruitment setup outside the loops.
+
+     year loop is extended to <= nyears because SSB is calculated as the start
+     of the year value and by extending one extra year we get estimates of the
+     population structure at the end of the final year. An alternative approach
+     would be to keep initial numbers at age in it's own vector and each year to
+     include the population structure at the end of the year. This is likely a
+     null point given that we are planning to modify to an event/stanza based
+     structure in later milestones which will eliminate this confusion by
+     explicitly referencing the exact date (or period of averaging) at which any
+     calculation or output is being made.
+     */
+    // Populations only interact through the fleets they share. With more
+    // than one population, each one writes its fleet contributions to its own
+    // copy and the copies are added in population order afterwards, so the
+    // result is the same whether or not the populations run on the thread
+    // pool. Only the double model uses the pool because the AD tape cannot be
+    // recorded from several threads.
+    bool tasks = this->populations.size() > 1;
+    if (tasks) {
+      this->PrepareFleetContributions();
+    }
+    this->population_tasks = tasks;
+    if (tasks && this->thread_pool != nullptr &&
+        std::is_same<Type, double>::value && this->SeparateRecruitment()) {
+      this->thread_pool->ParallelFor(this->populations.size(),
+                                     [this](size_t p) {
+                                       this->EvaluatePopulation(
+                                           this->populations[p]);
+                                     });
+    } else {
+      for (size_t p = 0; p < this->populations.size(); p++) {
+        this->EvaluatePopulation(this->populations[p]);
+      }
+    }
+    this->population_tasks = false;
+    if (tasks) {
+      this->AddFleetContributions();
+    }
     evaluate_age_comp();
     evaluate_length_comp();
     evaluate_index();
     evaluate_landings();
     // ComputeProportions();
+    this->tracked = this->tracking;
+    this->tracking = false;
+    this->partial = false;
+  }
+
+  /**
+   * @brief Sets up the equilibrium model of a population for the terminal
+   * year.
+   *
+   * @param population The population.
+   * @param allocation The share of F for each fleet, in the order of
+   * population->fleets. If empty, the share of the terminal-year F is used.
+   */
+  EquilibriumModel<Type> GetEquilibriumModel(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      const std::vector<Type> &allocation = std::vector<Type>()) {
+    EquilibriumModel<Type> eq;
+    size_t nages = population->nages;
+    size_t year = population->nyears - 1;
+    eq.M.resize(nages);
+    eq.weight.resize(nages);
+    eq.fecundity.resize(nages);
+    eq.selectivity.resize(nages);
+    // transformed here, serially, so the solves and projections that run
+    // concurrently on the equilibrium model never write to the module
+    population->recruitment->TransformParameters();
+    eq.recruitment = population->recruitment;
+
+    std::vector<Type> share(population->fleets.size());
+    Type total = static_cast<Type>(0.0);
+    for (size_t f = 0; f < population->fleets.size(); f++) {
+      if (allocation.size() == population->fleets.size()) {
+        share[f] = allocation[f];
+      } else if (population->fleets[f]->hybrid_F) {
+        // the F of a fleet with hybrid F is solved, not a parameter
+        share[f] = population->fleets[f]->Fmort[year];
+      } else {
+        share[f] = fims_math::exp(population->fleets[f]->log_Fmort[year]);
+      }
+      total += share[f];
+    }
+
+    fims::Vector<Type> maturity(nages);
+    population->maturity->evaluate_all(population->ages, maturity);
+    for (size_t a = 0; a < nages; a++) {
+      eq.M[a] =
+          fims_math::exp(population->log_M[population->M_layout.Index(year, a)]);
+      eq.weight[a] = this->WeightAtAge(population, year, a);
+      eq.fecundity[a] =
+          population->proportion_female[a] * maturity[a] * eq.weight[a];
+      eq.selectivity[a] = static_cast<Type>(0.0);
+    }
+    fims::Vector<Type> selectivity(nages);
+    for (size_t f = 0; f < population->fleets.size(); f++) {
+      population->fleets[f]->selectivity->evaluate_all(population->ages,
+                                                       selectivity);
+      for (size_t a = 0; a < nages; a++) {
+        eq.selectivity[a] += (share[f] / total) * selectivity[a];
+      }
+    }
+    return eq;
+  }
+
+  /**
+   * @brief Calculates the equilibrium reference points of a population.
+   *
+   * @param population The population.
+   * @param allocation The share of F for each fleet, see
+   * GetEquilibriumModel().
+   */
+  ReferencePoints<Type> CalculateReferencePoints(
+      std::shared_ptr<fims_popdy::Population<Type>> &population,
+      const std::vector<Type> &allocation = std::vector<Type>()) {
+    return this->GetEquilibriumModel(population, allocation)
+        .Calculate(this->spr_targets);
+  }
+
+  /**
+   * @brief Logs an error for each fleet with hybrid F that had years without
+   * observed landings in the last evaluation.
+   */
+  virtual void LogEvaluateMessages() {
+    typename std::map<uint32_t, std::vector<size_t>>::iterator it;
+    for (it = this->missing_landings_years.begin();
+         it != this->missing_landings_years.end(); ++it) {
+      std::vector<size_t> &years = (*it).second;
+      if (years.empty()) {
+        continue;
+      }
+      std::string list;
+      for (size_t i = 0; i < years.size(); i++) {
+        list += (i == 0 ? "" : ", ") + fims::to_string(years[i]);
+      }
+      FIMS_ERROR_LOG("Fleet " + fims::to_string((*it).first) +
+                     " has hybrid F but its landings are missing in years " +
+                     list + "; F was set to zero in those years.");
+      years.clear();
+    }
   }
 
   /**
@@ -1619,7 +2995,8 @@ class CatchAtAge : public FisheryModelBase<Type> {
 
     /*ADREPORT using ADREPORTvector defined in
      * inst/include/interface/interface.hpp:
-     * function collapses the nested vector into a single vector
+     * function collapses the nested vector into a single vector. Only the
+     * derived quantities in report_quantities are reported, if it is set.
      */
     vector<Type> NAA = ADREPORTvector(naa);
     vector<Type> Biomass = ADREPORTvector(biomass);
@@ -1638,22 +3015,92 @@ class CatchAtAge : public FisheryModelBase<Type> {
     vector<Type> AgeCompositionProportion = ADREPORTvector(agecomp_prop);
     vector<Type> LengthCompositionProportion = ADREPORTvector(lengthcomp_prop);
 
-    ADREPORT_F(NAA, this->of);
-    ADREPORT_F(Biomass, this->of);
-    ADREPORT_F(SSB, this->of);
-    ADREPORT_F(LogRecDev, this->of);
-    ADREPORT_F(FMort, this->of);
-    ADREPORT_F(Q, this->of);
-    ADREPORT_F(LandingsExpected, this->of);
-    ADREPORT_F(IndexExpected, this->of);
-    ADREPORT_F(LandingsNumberAtAge, this->of);
-    ADREPORT_F(LandingsNumberAtLength, this->of);
-    ADREPORT_F(IndexNumberAtAge, this->of);
-    ADREPORT_F(IndexNumberAtLength, this->of);
-    ADREPORT_F(AgeCompositionExpected, this->of);
-    ADREPORT_F(LengthCompositionExpected, this->of);
-    ADREPORT_F(AgeCompositionProportion, this->of);
-    ADREPORT_F(LengthCompositionProportion, this->of);
+    if (this->IsReported("numbers_at_age")) {
+      ADREPORT_F(NAA, this->of);
+    }
+    if (this->IsReported("biomass")) {
+      ADREPORT_F(Biomass, this->of);
+    }
+    if (this->IsReported("spawning_biomass")) {
+      ADREPORT_F(SSB, this->of);
+    }
+    if (this->IsReported("log_recruit_devs")) {
+      ADREPORT_F(LogRecDev, this->of);
+    }
+    if (this->IsReported("Fmort")) {
+      ADREPORT_F(FMort, this->of);
+    }
+    if (this->IsReported("q")) {
+      ADREPORT_F(Q, this->of);
+    }
+    if (this->IsReported("landings_expected")) {
+      ADREPORT_F(LandingsExpected, this->of);
+    }
+    if (this->IsReported("index_expected")) {
+      ADREPORT_F(IndexExpected, this->of);
+    }
+    if (this->IsReported("landings_numbers_at_age")) {
+      ADREPORT_F(LandingsNumberAtAge, this->of);
+    }
+    if (this->IsReported("landings_numbers_at_length")) {
+      ADREPORT_F(LandingsNumberAtLength, this->of);
+    }
+    if (this->IsReported("index_numbers_at_age")) {
+      ADREPORT_F(IndexNumberAtAge, this->of);
+    }
+    if (this->IsReported("index_numbers_at_length")) {
+      ADREPORT_F(IndexNumberAtLength, this->of);
+    }
+    if (this->IsReported("agecomp_expected")) {
+      ADREPORT_F(AgeCompositionExpected, this->of);
+    }
+    if (this->IsReported("lengthcomp_expected")) {
+      ADREPORT_F(LengthCompositionExpected, this->of);
+    }
+    if (this->IsReported("agecomp_proportion")) {
+      ADREPORT_F(AgeCompositionProportion, this->of);
+    }
+    if (this->IsReported("lengthcomp_proportion")) {
+      ADREPORT_F(LengthCompositionProportion, this->of);
+    }
+
+    if (this->do_reference_points) {
+      size_t n_targets = this->spr_targets.size();
+      vector<Type> FMSY(n_pops);
+      vector<Type> MSY(n_pops);
+      vector<Type> SSBMSY(n_pops);
+      vector<Type> BMSY(n_pops);
+      vector<Type> SSB0(n_pops);
+      vector<Type> B0(n_pops);
+      vector<Type> FSPR(n_pops * n_targets);
+      for (size_t p = 0; p < this->populations.size(); p++) {
+        ReferencePoints<Type> rp =
+            this->CalculateReferencePoints(this->populations[p]);
+        FMSY(p) = rp.F_msy;
+        MSY(p) = rp.msy;
+        SSBMSY(p) = rp.ssb_msy;
+        BMSY(p) = rp.b_msy;
+        SSB0(p) = rp.ssb0;
+        B0(p) = rp.b0;
+        for (size_t i = 0; i < n_targets; i++) {
+          FSPR(p * n_targets + i) = rp.F_spr[i];
+        }
+      }
+      FIMS_REPORT_F(FMSY, this->of);
+      FIMS_REPORT_F(MSY, this->of);
+      FIMS_REPORT_F(SSBMSY, this->of);
+      FIMS_REPORT_F(BMSY, this->of);
+      FIMS_REPORT_F(SSB0, this->of);
+      FIMS_REPORT_F(B0, this->of);
+      FIMS_REPORT_F(FSPR, this->of);
+      ADREPORT_F(FMSY, this->of);
+      ADREPORT_F(MSY, this->of);
+      ADREPORT_F(SSBMSY, this->of);
+      ADREPORT_F(BMSY, this->of);
+      ADREPORT_F(SSB0, this->of);
+      ADREPORT_F(B0, this->of);
+      ADREPORT_F(FSPR, this->of);
+    }
 
 #endif
   }
@@ -1,10 +1,13 @@
 #ifndef FIMS_MODELS_FISHERY_MODEL_BASE_HPP
 #define FIMS_MODELS_FISHERY_MODEL_BASE_HPP
 
+#include <set>
+
 #include "../../common/model_object.hpp"
 #include "../../common/fims_math.hpp"
 #include "../../common/fims_vector.hpp"
 #include "../../population_dynamics/population/population.hpp"
+#include "../../utilities/fims_thread_pool.hpp"
 
 /**
  * @brief The population dynamics of FIMS.
@@ -54,6 +57,12 @@ class FisheryModelBase : public fims_model_object::FIMSObject<Type> {
 #ifdef TMB_MODEL
   ::objective_function<Type> *of;
 #endif
+  /**
+   * @brief Thread pool for evaluating populations as separate tasks, or
+   * nullptr to evaluate them one after another. Set by Model::Evaluate().
+   *
+   */
+  fims::ThreadPool *thread_pool = nullptr;
   /**
    * @brief Construct a new Fishery Model Base object.
    *
@@ -117,6 +126,55 @@ class FisheryModelBase : public fims_model_object::FIMSObject<Type> {
    */
   virtual void Prepare() {}
 
+  /**
+   * @brief Tells the model which parameters changed since its last evaluation
+   * so that the next evaluation can reuse the derived quantities that do not
+   * depend on them. Called by Model::Evaluate() before each incremental
+   * evaluation of the double model with the changed parameters. The default
+   * evaluates everything.
+   */
+  virtual void SetChangedParameters(const std::vector<Type *> &) {}
+
+  /**
+   * @brief Tells the model which of its derived quantities the likelihood
+   * uses, so it can skip the ones that are neither used nor reported. Called
+   * by Information::CreateModel() with the vectors that density components
+   * are linked to. The default evaluates everything.
+   */
+  virtual void SetDemand(const std::set<const fims::Vector<Type> *> &) {}
+
+  /**
+   * @brief Resolves the modules of each population to their concrete types
+   * so the model can evaluate them without virtual calls. Called by
+   * Information::CreateModel(). The default keeps the virtual calls.
+   */
+  virtual void ResolveModules() {}
+
+  /**
+   * @brief Holds the vectors created by Initialize(), i.e., the derived
+   * quantities, set by Information::CreateModel(). Null if the model was
+   * initialized outside of Information.
+   */
+  std::shared_ptr<fims::Arena<Type>> arena;
+
+  /**
+   * @brief True if a vector takes its storage from the model arena, so
+   * ResetArena() resets it.
+   */
+  bool InArena(const fims::Vector<Type> &v) const {
+    return this->arena != nullptr &&
+           v.get_allocator().GetArena() == this->arena.get();
+  }
+
+  /**
+   * @brief Sets every vector in the model arena to a value in one pass.
+   */
+  void ResetArena(Type value = 0.0) {
+    if (this->arena != nullptr) {
+      this->arena->Fill(value);
+    }
+  }
+
   /**
    * @brief Reset a vector from start to end with a value.
    *
@@ -134,6 +192,13 @@ class FisheryModelBase : public fims_model_object::FIMSObject<Type> {
    */
   virtual void Evaluate() {}
 
+  /**
+   * @brief Logs what the model found during its evaluation. Called by
+   * Model::Evaluate() once the evaluation tasks have finished, since the
+   * tasks do not write to the log. The default logs nothing.
+   */
+  virtual void LogEvaluateMessages() {}
+
   /**
    * @brief Report the model results via TMB.
    *
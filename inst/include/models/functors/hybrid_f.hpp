@@ -0,0 +1,230 @@
+/**
+ * @file hybrid_f.hpp
+ * @brief Solves the fishing mortality of fleets from their observed landings,
+ * the hybrid F method.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_MODELS_HYBRID_F_HPP
+#define FIMS_MODELS_HYBRID_F_HPP
+
+#include <vector>
+
+#include "../../common/fims_math.hpp"
+#include "../../common/fims_vector.hpp"
+
+namespace fims_popdy {
+
+/**
+ * @brief Fishing mortality of the fleets of one population in one year that
+ * matches their observed landings.
+ *
+ * @details A fleet with hybrid F has no log_Fmort parameters; its F in each
+ * year is found from the numbers at age at the start of the year so the
+ * Baranov landings equal the observed landings. The start is Pope's
+ * approximation, landings over the vulnerable biomass at mid-year, and it is
+ * followed by a fixed number of Newton steps in log F. Each step solves for
+ * all fleets together, since the fleets share the total mortality, so the
+ * steps converge quadratically however much the fleets overlap. The steps
+ * have no branches on Type, so the same code records on the AD tape and the
+ * derivatives of F with respect to the parameters follow the solution.
+ *
+ * Because the expected landings of a solved fleet equal its observed
+ * landings, its landings likelihood is constant in the model parameters. The
+ * term is kept, so the data and fits of the model do not depend on how F is
+ * found, but the standard deviation of the landings must then be fixed.
+ */
+template <typename Type>
+class HybridF {
+ public:
+  fims::Vector<Type> M;       /**< natural mortality at age */
+  fims::Vector<Type> numbers; /**< numbers at age at the start of the year */
+  fims::Vector<Type> weight;  /**< weight at age */
+  std::vector<fims::Vector<Type>>
+      selectivity;            /**< selectivity at age of each fleet */
+  std::vector<Type> landings; /**< observed landings of each solved fleet */
+  std::vector<bool> in_weight; /**< true if the landings of a fleet are in
+                                  weight, false if in numbers */
+  std::vector<bool> solve; /**< true for the fleets whose F is solved */
+  std::vector<Type> F;     /**< F of each fleet: the F of fleets that are
+                              not solved, and the solution for the others */
+  size_t newton_iterations = 4;   /**< number of Newton steps */
+  double max_exploitation = 0.95; /**< upper limit of the exploitation rate
+                                     of Pope's approximation */
+
+  /**
+   * @brief Sets the number of ages and fleets.
+   */
+  void Resize(size_t nages, size_t nfleets) {
+    this->M.resize(nages);
+    this->numbers.resize(nages);
+    this->weight.resize(nages);
+    this->selectivity.resize(nfleets);
+    for (size_t f = 0; f < nfleets; f++) {
+      this->selectivity[f].resize(nages);
+    }
+    this->landings.resize(nfleets);
+    this->in_weight.resize(nfleets);
+    this->solve.resize(nfleets);
+    this->F.resize(nfleets);
+  }
+
+  /**
+   * @brief Solves F for the fleets marked in solve.
+   */
+  void Solve() {
+    size_t nages = this->M.size();
+    std::vector<size_t> solved;
+    for (size_t f = 0; f < this->F.size(); f++) {
+      if (this->solve[f]) {
+        this->F[f] = this->PopeF(f);
+        solved.push_back(f);
+      }
+    }
+    size_t n = solved.size();
+    fims::Vector<Type> Z(nages);
+    std::vector<Type> g(n);
+    std::vector<Type> J(n * n);
+    for (size_t i = 0; i < this->newton_iterations; i++) {
+      for (size_t a = 0; a < nages; a++) {
+        Z[a] = this->M[a];
+        for (size_t f = 0; f < this->F.size(); f++) {
+          Z[a] += this->F[f] * this->selectivity[f][a];
+        }
+      }
+      for (size_t k = 0; k < n; k++) {
+        this->LogLandings(solved, k, Z, g[k], &J[k * n]);
+        g[k] -= fims_math::log(this->landings[solved[k]]);
+      }
+      HybridF<Type>::SolveLinear(n, J, g);
+      for (size_t k = 0; k < n; k++) {
+        size_t f = solved[k];
+        this->F[f] =
+            fims_math::exp(fims_math::log(this->F[f]) - this->LimitStep(g[k]));
+      }
+    }
+  }
+
+  /**
+   * @brief The expected landings of a fleet and their derivative with respect
+   * to its F, holding the F of the other fleets.
+   *
+   * @param f The fleet.
+   * @param Z The total mortality at age.
+   * @param C Output landings, in the units of the observed landings.
+   * @param dC Output derivative of C with respect to the F of the fleet.
+   */
+  void Landings(size_t f, const fims::Vector<Type> &Z, Type &C,
+                Type &dC) const {
+    C = static_cast<Type>(0.0);
+    dC = static_cast<Type>(0.0);
+    for (size_t a = 0; a < this->M.size(); a++) {
+      Type s = this->selectivity[f][a];
+      Type yield = this->in_weight[f] ? this->weight[a] : static_cast<Type>(1.0);
+      Type survival = fims_math::exp(-Z[a]);
+      Type dead = static_cast<Type>(1.0) - survival;
+      C += yield * this->F[f] * s * this->numbers[a] * dead / Z[a];
+      dC += yield * s * this->numbers[a] *
+            (dead / Z[a] +
+             this->F[f] * s * (survival / Z[a] - dead / (Z[a] * Z[a])));
+    }
+  }
+
+ private:
+  /**
+   * @brief The log of the expected landings of a solved fleet and its
+   * derivatives with respect to the log F of each solved fleet.
+   *
+   * @param solved The solved fleets.
+   * @param k The position of the fleet in solved.
+   * @param Z The total mortality at age.
+   * @param log_C Output log landings.
+   * @param dlog_C Output derivatives, one per solved fleet.
+   */
+  void LogLandings(const std::vector<size_t> &solved, size_t k,
+                   const fims::Vector<Type> &Z, Type &log_C,
+                   Type *dlog_C) const {
+    size_t f = solved[k];
+    size_t n = solved.size();
+    Type C = static_cast<Type>(0.0);
+    Type direct = static_cast<Type>(0.0);
+    for (size_t j = 0; j < n; j++) {
+      dlog_C[j] = static_cast<Type>(0.0);
+    }
+    for (size_t a = 0; a < this->M.size(); a++) {
+      Type yield = this->in_weight[f] ? this->weight[a] : static_cast<Type>(1.0);
+      Type available = yield * this->selectivity[f][a] * this->numbers[a];
+      Type survival = fims_math::exp(-Z[a]);
+      Type dead = static_cast<Type>(1.0) - survival;
+      // d/dZ of the fraction dead over Z
+      Type dh = survival / Z[a] - dead / (Z[a] * Z[a]);
+      C += available * this->F[f] * dead / Z[a];
+      direct += available * dead / Z[a];
+      for (size_t j = 0; j < n; j++) {
+        dlog_C[j] +=
+            available * this->F[f] * dh * this->selectivity[solved[j]][a];
+      }
+    }
+    dlog_C[k] += direct;
+    for (size_t j = 0; j < n; j++) {
+      dlog_C[j] *= this->F[solved[j]] / C;
+    }
+    log_C = fims_math::log(C);
+  }
+
+  /**
+   * @brief Solves J x = b in place of b by Gaussian elimination without
+   * pivoting, which needs no branches on Type. The Jacobian of the log
+   * landings has a dominant diagonal, since the F of a fleet changes its own
+   * landings more than those of the others.
+   */
+  static void SolveLinear(size_t n, std::vector<Type> &J, std::vector<Type> &b) {
+    for (size_t k = 0; k < n; k++) {
+      for (size_t i = k + 1; i < n; i++) {
+        Type factor = J[i * n + k] / J[k * n + k];
+        for (size_t j = k; j < n; j++) {
+          J[i * n + j] -= factor * J[k * n + j];
+        }
+        b[i] -= factor * b[k];
+      }
+    }
+    for (size_t k = n; k-- > 0;) {
+      for (size_t j = k + 1; j < n; j++) {
+        b[k] -= J[k * n + j] * b[j];
+      }
+      b[k] /= J[k * n + k];
+    }
+  }
+
+  /**
+   * @brief Pope's approximation of the F of a fleet, with the exploitation
+   * rate limited to max_exploitation without branching.
+   */
+  Type PopeF(size_t f) const {
+    Type vulnerable = static_cast<Type>(0.0);
+    for (size_t a = 0; a < this->M.size(); a++) {
+      Type yield = this->in_weight[f] ? this->weight[a] : static_cast<Type>(1.0);
+      vulnerable += yield * this->selectivity[f][a] * this->numbers[a] *
+                    fims_math::exp(-static_cast<Type>(0.5) * this->M[a]);
+    }
+    Type u = fims_math::ad_min(this->landings[f] / vulnerable,
+                               static_cast<Type>(this->max_exploitation),
+                               static_cast<Type>(1e-12));
+    return -fims_math::log(static_cast<Type>(1.0) - u);
+  }
+
+  /**
+   * @brief Limits a Newton step in log F to [-1, 1] without branching.
+   */
+  Type LimitStep(const Type &step) const {
+    Type C = static_cast<Type>(1e-12);
+    return fims_math::ad_max(
+        fims_math::ad_min(step, static_cast<Type>(1.0), C),
+        static_cast<Type>(-1.0), C);
+  }
+};
+
+}  // namespace fims_popdy
+
+#endif /* FIMS_MODELS_HYBRID_F_HPP */
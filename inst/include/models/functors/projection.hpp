@@ -0,0 +1,291 @@
+/**
+ * @file projection.hpp
+ * @brief Stochastic forward projections of a catch-at-age population beyond
+ * the last model year.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_MODELS_PROJECTION_HPP
+#define FIMS_MODELS_PROJECTION_HPP
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../utilities/fims_thread_pool.hpp"
+#include "catch_at_age.hpp"
+#include "reference_points.hpp"
+
+namespace fims_popdy {
+
+/**
+ * @brief Settings for a projection scenario.
+ */
+struct ProjectionSettings {
+  size_t nyears = 10; /**< number of projection years */
+  bool catch_based =
+      false; /**< if true, values are landings in weight instead of F */
+  std::vector<double>
+      values; /**< F or landings for each year, recycled if shorter */
+  size_t nreplicates = 1000; /**< number of stochastic replicates */
+  uint64_t seed = 1;         /**< seed for the random number generators */
+  size_t nthreads = 0;       /**< number of threads, zero uses all */
+  double sigma_r = 0.0; /**< if positive, recruitment deviations are drawn
+                           from a normal distribution with this standard
+                           deviation, otherwise the estimated deviations are
+                           resampled */
+  std::vector<double> probs = {0.05, 0.5,
+                               0.95}; /**< probabilities for the percentiles */
+};
+
+/**
+ * @brief Percentile summaries of a projection.
+ */
+struct ProjectionSummary {
+  std::vector<double> probs; /**< probabilities for the percentiles */
+  size_t nyears = 0;         /**< number of projection years */
+  std::map<std::string, std::vector<double>>
+      percentiles; /**< percentiles by quantity, folded as year * nprobs +
+                      prob */
+  std::map<std::string, std::vector<double>>
+      mean; /**< mean by quantity and year */
+};
+
+/**
+ * @brief Stochastic projection of one population using the double version of
+ * the model.
+ *
+ * @details Starts from numbers at age at the end of the last model year and
+ * steps forward with terminal-year natural mortality, weight, maturity, and
+ * selectivity, with F split among fleets as in the terminal year. Recruitment
+ * is the stock-recruit mean times a deviation that is either resampled from
+ * the estimated deviations or drawn from a normal distribution. Each
+ * replicate has its own random number stream seeded from the scenario seed
+ * and the replicate number, so the results do not depend on the number of
+ * threads.
+ */
+class Projection {
+ public:
+  EquilibriumModel<double> eq; /**< per-age inputs and stock-recruit module */
+  std::vector<double> initial_numbers; /**< numbers at age to start from */
+  std::vector<double> recruit_devs;    /**< estimated log deviations */
+  double phi0 = 0.0; /**< unfished spawning biomass per recruit */
+
+  /**
+   * @brief The names of the projected quantities.
+   */
+  static std::vector<std::string> Quantities() {
+    return {"ssb", "biomass", "recruitment", "landings_weight", "F"};
+  }
+
+  /**
+   * @brief Runs all replicates and summarizes them.
+   *
+   * @param settings The projection scenario.
+   */
+  ProjectionSummary Run(const ProjectionSettings &settings) const {
+    std::vector<std::string> names = Projection::Quantities();
+    size_t nyears = settings.nyears;
+    size_t nrep = settings.nreplicates;
+
+    // replicate-major storage; each replicate writes only its own rows
+    std::vector<std::vector<double>> trajectories(
+        names.size(), std::vector<double>(nrep * nyears));
+    fims::ThreadPool pool(settings.nthreads);
+    pool.ParallelFor(nrep, [&](size_t r) {
+      this->Replicate(r, settings, trajectories);
+    });
+
+    ProjectionSummary summary;
+    summary.probs = settings.probs;
+    summary.nyears = nyears;
+    std::vector<double> column(nrep);
+    for (size_t q = 0; q < names.size(); q++) {
+      std::vector<double> &pct = summary.percentiles[names[q]];
+      std::vector<double> &mean = summary.mean[names[q]];
+      pct.resize(nyears * settings.probs.size());
+      mean.resize(nyears);
+      for (size_t t = 0; t < nyears; t++) {
+        double sum = 0.0;
+        for (size_t r = 0; r < nrep; r++) {
+          column[r] = trajectories[q][r * nyears + t];
+          sum += column[r];
+        }
+        mean[t] = nrep > 0 ? sum / static_cast<double>(nrep) : 0.0;
+        std::sort(column.begin(), column.end());
+        for (size_t k = 0; k < settings.probs.size(); k++) {
+          pct[t * settings.probs.size() + k] =
+              Projection::Percentile(column, settings.probs[k]);
+        }
+      }
+    }
+    return summary;
+  }
+
+  /**
+   * @brief Runs one replicate.
+   *
+   * @param r The replicate number.
+   * @param settings The projection scenario.
+   * @param out Storage for each quantity, folded as r * nyears + year.
+   */
+  void Replicate(size_t r, const ProjectionSettings &settings,
+                 std::vector<std::vector<double>> &out) const {
+    size_t nages = this->initial_numbers.size();
+    size_t nyears = settings.nyears;
+    std::seed_seq seq{static_cast<uint64_t>(settings.seed),
+                      static_cast<uint64_t>(r)};
+    std::mt19937_64 rng(seq);
+
+    std::vector<double> N = this->initial_numbers;
+    std::vector<double> next(nages);
+    std::vector<double> Z(nages);
+    N[0] *= std::exp(this->DrawDeviation(rng, settings));
+
+    for (size_t t = 0; t < nyears; t++) {
+      double ssb = 0.0;
+      double biomass = 0.0;
+      for (size_t a = 0; a < nages; a++) {
+        ssb += this->eq.fecundity[a] * N[a];
+        biomass += this->eq.weight[a] * N[a];
+      }
+
+      double value = settings.values.empty()
+                         ? 0.0
+                         : settings.values[t % settings.values.size()];
+      double F = settings.catch_based ? this->SolveF(N, value) : value;
+      double landings = this->LandingsWeight(N, F);
+
+      size_t i = r * nyears + t;
+      out[0][i] = ssb;
+      out[1][i] = biomass;
+      out[2][i] = N[0];
+      out[3][i] = landings;
+      out[4][i] = F;
+
+      for (size_t a = 0; a < nages; a++) {
+        Z[a] = this->eq.M[a] + F * this->eq.selectivity[a];
+      }
+      next[0] = this->eq.recruitment->evaluate_mean(ssb, this->phi0) *
+                std::exp(this->DrawDeviation(rng, settings));
+      for (size_t a = 1; a < nages; a++) {
+        next[a] = N[a - 1] * std::exp(-Z[a - 1]);
+      }
+      // plus group
+      next[nages - 1] += N[nages - 1] * std::exp(-Z[nages - 1]);
+      N.swap(next);
+    }
+  }
+
+  /**
+   * @brief Landings in weight from Baranov's catch equation.
+   */
+  double LandingsWeight(const std::vector<double> &N, double F) const {
+    double landings = 0.0;
+    for (size_t a = 0; a < N.size(); a++) {
+      double Fa = F * this->eq.selectivity[a];
+      double Z = this->eq.M[a] + Fa;
+      landings += this->eq.weight[a] * N[a] * (Fa / Z) * (1.0 - std::exp(-Z));
+    }
+    return landings;
+  }
+
+  /**
+   * @brief Finds the F that gives target landings by bisection. Landings
+   * increase with F, so the target is capped at the landings for F = 10.
+   */
+  double SolveF(const std::vector<double> &N, double target) const {
+    double lo = 0.0;
+    double hi = 10.0;
+    if (target <= 0.0) {
+      return 0.0;
+    }
+    if (this->LandingsWeight(N, hi) <= target) {
+      return hi;
+    }
+    for (size_t i = 0; i < 60; i++) {
+      double mid = 0.5 * (lo + hi);
+      if (this->LandingsWeight(N, mid) < target) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    return 0.5 * (lo + hi);
+  }
+
+  /**
+   * @brief Linear interpolation between order statistics, the default
+   * (type 7) quantile in R.
+   *
+   * @param sorted The values in increasing order.
+   * @param p The probability.
+   */
+  static double Percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+      return 0.0;
+    }
+    double h = (static_cast<double>(sorted.size()) - 1.0) * p;
+    size_t lo = static_cast<size_t>(std::floor(h));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (h - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+  }
+
+ private:
+  /**
+   * @brief Draws a log recruitment deviation.
+   */
+  double DrawDeviation(std::mt19937_64 &rng,
+                       const ProjectionSettings &settings) const {
+    if (settings.sigma_r > 0.0) {
+      std::normal_distribution<double> normal(0.0, settings.sigma_r);
+      return normal(rng);
+    }
+    if (this->recruit_devs.empty()) {
+      return 0.0;
+    }
+    std::uniform_int_distribution<size_t> pick(0,
+                                               this->recruit_devs.size() - 1);
+    return this->recruit_devs[pick(rng)];
+  }
+};
+
+/**
+ * @brief Sets up a projection of a population from the double version of a
+ * catch-at-age model that has been evaluated at the estimates.
+ *
+ * @param model The model.
+ * @param population The population.
+ */
+inline Projection MakeProjection(
+    CatchAtAge<double> &model,
+    std::shared_ptr<fims_popdy::Population<double>> &population) {
+  Projection projection;
+  projection.eq = model.GetEquilibriumModel(population);
+  projection.phi0 = projection.eq.Phi0();
+
+  size_t nages = population->nages;
+  size_t nyears = population->nyears;
+  fims::Vector<double> &naa =
+      model.population_derived_quantities[population->GetId()]
+                                         ["numbers_at_age"];
+  projection.initial_numbers.resize(nages);
+  for (size_t a = 0; a < nages; a++) {
+    projection.initial_numbers[a] = naa[nyears * nages + a];
+  }
+
+  // realized minus expected log recruitment for the years with deviations
+  for (size_t y = 1; y < nyears; y++) {
+    projection.recruit_devs.push_back(
+        std::log(naa[y * nages]) -
+        population->recruitment->log_expected_recruitment[y - 1]);
+  }
+  return projection;
+}
+
+}  // namespace fims_popdy
+
+#endif /* FIMS_MODELS_PROJECTION_HPP */
@@ -0,0 +1,255 @@
+/**
+ * @file reference_points.hpp
+ * @brief Equilibrium per-recruit and stock-recruit calculations used to find
+ * MSY- and SPR-based reference points.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_MODELS_REFERENCE_POINTS_HPP
+#define FIMS_MODELS_REFERENCE_POINTS_HPP
+
+#include <vector>
+
+#include "../../common/fims_math.hpp"
+#include "../../common/fims_vector.hpp"
+#include "../../population_dynamics/recruitment/recruitment.hpp"
+
+namespace fims_popdy {
+
+/**
+ * @brief Reference points for one population and one fleet allocation.
+ */
+template <typename Type>
+struct ReferencePoints {
+  Type F_msy = 0.0;   /**< fishing mortality that maximizes equilibrium yield */
+  Type msy = 0.0;     /**< maximum sustainable yield in weight */
+  Type ssb_msy = 0.0; /**< equilibrium spawning biomass at F_msy */
+  Type b_msy = 0.0;   /**< equilibrium total biomass at F_msy */
+  Type r_msy = 0.0;   /**< equilibrium recruitment at F_msy */
+  Type spr_msy = 0.0; /**< spawning potential ratio at F_msy */
+  Type r0 = 0.0;      /**< unfished recruitment */
+  Type ssb0 = 0.0;    /**< unfished spawning biomass */
+  Type b0 = 0.0;      /**< unfished total biomass */
+  Type phi0 = 0.0;    /**< unfished spawning biomass per recruit */
+  fims::Vector<Type> spr_targets; /**< target spawning potential ratios */
+  fims::Vector<Type> F_spr;       /**< F giving each target ratio */
+  fims::Vector<Type> ssb_spr;     /**< equilibrium spawning biomass at F_spr */
+  fims::Vector<Type> yield_spr;   /**< equilibrium yield at F_spr */
+};
+
+/**
+ * @brief Equilibrium age-structured model for a single population.
+ *
+ * @details Fishing mortality at age is F times the allocation-weighted sum of
+ * fleet selectivity, so F is the total fully-selected F when the allocations
+ * sum to one. Reference points are found by a fixed number of Newton steps in
+ * log F. The steps have no branches on Type, so the same code records on the
+ * AD tape and the uncertainty of the reference points is available from
+ * `sdreport()`. Derivatives inside the Newton steps use central differences.
+ */
+template <typename Type>
+class EquilibriumModel {
+ public:
+  fims::Vector<Type> M;           /**< natural mortality at age */
+  fims::Vector<Type> weight;      /**< weight at age */
+  fims::Vector<Type> fecundity;   /**< female spawning output at age */
+  fims::Vector<Type> selectivity; /**< combined selectivity at age */
+  std::shared_ptr<RecruitmentBase<Type>>
+      recruitment; /**< stock-recruit module of the population, with its
+                      parameters transformed before the model is solved so
+                      that concurrent solves only read the cached values */
+  size_t newton_iterations = 25; /**< number of Newton steps per solve */
+  double derivative_step = 1e-3; /**< step in log F for the derivatives */
+
+  /**
+   * @brief Equilibrium quantities per recruit at F.
+   *
+   * @param F The fully-selected fishing mortality.
+   * @param spr Output spawning biomass per recruit.
+   * @param ypr Output yield in weight per recruit.
+   * @param bpr Output total biomass per recruit.
+   */
+  void PerRecruit(const Type& F, Type& spr, Type& ypr, Type& bpr) const {
+    size_t nages = this->M.size();
+    Type n = static_cast<Type>(1.0);
+    spr = static_cast<Type>(0.0);
+    ypr = static_cast<Type>(0.0);
+    bpr = static_cast<Type>(0.0);
+    for (size_t a = 0; a < nages; a++) {
+      Type Fa = F * this->selectivity[a];
+      Type Z = this->M[a] + Fa;
+      Type survival = fims_math::exp(-Z);
+      if (a == nages - 1) {
+        // plus group
+        n = n / (static_cast<Type>(1.0) - survival);
+      }
+      spr += n * this->fecundity[a];
+      bpr += n * this->weight[a];
+      ypr += n * this->weight[a] * (Fa / Z) *
+             (static_cast<Type>(1.0) - survival);
+      n *= survival;
+    }
+  }
+
+  /**
+   * @brief Unfished spawning biomass per recruit.
+   */
+  Type Phi0() const {
+    Type spr, ypr, bpr;
+    this->PerRecruit(static_cast<Type>(0.0), spr, ypr, bpr);
+    return spr;
+  }
+
+  /**
+   * @brief Equilibrium recruitment for a spawning biomass per recruit.
+   *
+   * @details Solves R = f(R * spr) for the stock-recruit function f by Newton
+   * steps starting at R0. The recruitment is kept positive so that a crashed
+   * stock gives a small recruitment instead of a negative one.
+   *
+   * @param spr Spawning biomass per recruit at F.
+   * @param phi0 Unfished spawning biomass per recruit.
+   */
+  Type EquilibriumRecruitment(const Type& spr, const Type& phi0) const {
+    Type r0 = this->recruitment->rzero;
+    Type floor = r0 * static_cast<Type>(1e-10);
+    Type r = r0;
+    for (size_t i = 0; i < this->newton_iterations; i++) {
+      Type h = r * static_cast<Type>(1e-4);
+      Type g = this->recruitment->evaluate_mean(r * spr, phi0) - r;
+      Type g_plus =
+          this->recruitment->evaluate_mean((r + h) * spr, phi0) - (r + h);
+      Type g_minus =
+          this->recruitment->evaluate_mean((r - h) * spr, phi0) - (r - h);
+      Type dg = (g_plus - g_minus) / (static_cast<Type>(2.0) * h);
+      r = fims_math::ad_max(r - g / dg, floor, floor * floor);
+    }
+    return r;
+  }
+
+  /**
+   * @brief Equilibrium yield in weight at F.
+   */
+  Type Yield(const Type& F, const Type& phi0) const {
+    Type spr, ypr, bpr;
+    this->PerRecruit(F, spr, ypr, bpr);
+    return this->EquilibriumRecruitment(spr, phi0) * ypr;
+  }
+
+  /**
+   * @brief Finds F that maximizes equilibrium yield.
+   *
+   * @details Newton steps on the first derivative of yield with respect to
+   * log F. Dividing by the absolute curvature keeps each step uphill and the
+   * step is limited to one unit of log F.
+   */
+  Type SolveFMSY(const Type& phi0) const {
+    Type h = static_cast<Type>(this->derivative_step);
+    Type x = fims_math::log(this->MeanM());
+    for (size_t i = 0; i < this->newton_iterations; i++) {
+      Type y = this->Yield(fims_math::exp(x), phi0);
+      Type y_plus = this->Yield(fims_math::exp(x + h), phi0);
+      Type y_minus = this->Yield(fims_math::exp(x - h), phi0);
+      Type d1 = (y_plus - y_minus) / (static_cast<Type>(2.0) * h);
+      Type d2 = (y_plus - static_cast<Type>(2.0) * y + y_minus) / (h * h);
+      Type step = d1 / fims_math::ad_fabs(d2);
+      x += this->LimitStep(step);
+    }
+    return fims_math::exp(x);
+  }
+
+  /**
+   * @brief Finds F that gives a target spawning potential ratio.
+   *
+   * @param target The target ratio of spawning biomass per recruit at F to
+   * unfished spawning biomass per recruit, e.g., 0.4 for F40%.
+   * @param phi0 Unfished spawning biomass per recruit.
+   */
+  Type SolveFSPR(const Type& target, const Type& phi0) const {
+    Type h = static_cast<Type>(this->derivative_step);
+    Type log_target = fims_math::log(target);
+    Type x = fims_math::log(this->MeanM());
+    for (size_t i = 0; i < this->newton_iterations; i++) {
+      Type g = this->LogSPRRatio(fims_math::exp(x), phi0) - log_target;
+      Type g_plus = this->LogSPRRatio(fims_math::exp(x + h), phi0);
+      Type g_minus = this->LogSPRRatio(fims_math::exp(x - h), phi0);
+      Type dg = (g_plus - g_minus) / (static_cast<Type>(2.0) * h);
+      x -= this->LimitStep(g / dg);
+    }
+    return fims_math::exp(x);
+  }
+
+  /**
+   * @brief Calculates all reference points.
+   *
+   * @param spr_targets The target spawning potential ratios.
+   */
+  ReferencePoints<Type> Calculate(const std::vector<double>& spr_targets) const {
+    ReferencePoints<Type> rp;
+    Type spr, ypr, bpr;
+    rp.phi0 = this->Phi0();
+    rp.r0 = this->recruitment->rzero;
+    this->PerRecruit(static_cast<Type>(0.0), spr, ypr, bpr);
+    rp.ssb0 = rp.r0 * rp.phi0;
+    rp.b0 = rp.r0 * bpr;
+
+    rp.F_msy = this->SolveFMSY(rp.phi0);
+    this->PerRecruit(rp.F_msy, spr, ypr, bpr);
+    rp.r_msy = this->EquilibriumRecruitment(spr, rp.phi0);
+    rp.msy = rp.r_msy * ypr;
+    rp.ssb_msy = rp.r_msy * spr;
+    rp.b_msy = rp.r_msy * bpr;
+    rp.spr_msy = spr / rp.phi0;
+
+    size_t n_targets = spr_targets.size();
+    rp.spr_targets.resize(n_targets);
+    rp.F_spr.resize(n_targets);
+    rp.ssb_spr.resize(n_targets);
+    rp.yield_spr.resize(n_targets);
+    for (size_t i = 0; i < n_targets; i++) {
+      rp.spr_targets[i] = static_cast<Type>(spr_targets[i]);
+      rp.F_spr[i] = this->SolveFSPR(rp.spr_targets[i], rp.phi0);
+      this->PerRecruit(rp.F_spr[i], spr, ypr, bpr);
+      Type r = this->EquilibriumRecruitment(spr, rp.phi0);
+      rp.ssb_spr[i] = r * spr;
+      rp.yield_spr[i] = r * ypr;
+    }
+    return rp;
+  }
+
+ private:
+  /**
+   * @brief Log of the spawning potential ratio at F.
+   */
+  Type LogSPRRatio(const Type& F, const Type& phi0) const {
+    Type spr, ypr, bpr;
+    this->PerRecruit(F, spr, ypr, bpr);
+    return fims_math::log(spr / phi0);
+  }
+
+  /**
+   * @brief Mean natural mortality over ages, used as the starting F.
+   */
+  Type MeanM() const {
+    Type sum = static_cast<Type>(0.0);
+    for (size_t a = 0; a < this->M.size(); a++) {
+      sum += this->M[a];
+    }
+    return sum / static_cast<Type>(this->M.size());
+  }
+
+  /**
+   * @brief Limits a Newton step in log F to [-1, 1] without branching.
+   */
+  Type LimitStep(const Type& step) const {
+    Type C = static_cast<Type>(1e-12);
+    return fims_math::ad_max(
+        fims_math::ad_min(step, static_cast<Type>(1.0), C),
+        static_cast<Type>(-1.0), C);
+  }
+};
+
+}  // namespace fims_popdy
+
+#endif /* FIMS_MODELS_REFERENCE_POINTS_HPP */
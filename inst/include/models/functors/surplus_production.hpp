@@ -116,6 +116,11 @@ class SurplusProduction : public FisheryModelBase<Type> {
           this->populations[p];
       std::map<std::string, fims::Vector<Type>> &derived_quantities =
           this->population_derived_quantities[this->populations[p]->GetId()];
+
+      // Transformation Section
+      if (population->depletion != nullptr) {
+        population->depletion->TransformParameters();
+      }
     }
 
     for (fleet_iterator fit = this->fleets.begin(); fit != this->fleets.end();
@@ -192,7 +197,7 @@ class SurplusProduction : public FisheryModelBase<Type> {
                                        [i_year] =
         this->population_derived_quantities[population->GetId()]
                                            ["expected_depletion"][i_year] *
-        fims_math::exp(population->depletion->log_K[0]);
+        population->depletion->K;
   }
 
   virtual void Evaluate() {
@@ -11,6 +11,7 @@
 #ifndef POPULATION_DYNAMICS_DEPLETION_BASE_HPP
 #define POPULATION_DYNAMICS_DEPLETION_BASE_HPP
 
+#include "../../../common/fims_math.hpp"
 #include "../../../common/model_object.hpp"
 #include "../../../common/fims_vector.hpp"
 
@@ -34,6 +35,12 @@ struct DepletionBase : public fims_model_object::FIMSObject<Type> {
   fims::Vector<Type>
       log_expected_depletion; /**< Expectation of the depletion process. */
   fims::Vector<Type> log_K;   /**< Carrying capacity of the population. */
+  Type K = static_cast<Type>(0.0); /**< Carrying capacity, exp(log_K), set by
+                                      TransformParameters() */
+  bool transformed = false; /**< True while the cached natural-scale values
+                              match the parameters: set by
+                              TransformParameters() and cleared when
+                              Information writes new parameter values */
   /** @brief Constructor.
    */
   DepletionBase() {
@@ -43,6 +50,20 @@ struct DepletionBase : public fims_model_object::FIMSObject<Type> {
 
   virtual ~DepletionBase() {}
 
+  /**
+   * @brief Computes the natural-scale parameters from the estimated ones.
+   * Called once per evaluation by the model, so the per-year calculations
+   * read the cached values instead of transforming the parameters again.
+   * Code that writes the parameters directly, rather than through
+   * Information, must call it again before the cached values are read.
+   */
+  virtual void TransformParameters() {
+    if (this->log_K.size() > 0) {
+      this->K = fims_math::exp(this->log_K[0]);
+    }
+    this->transformed = true;
+  }
+
   /**
    * @brief Calculates the depletion.
    *
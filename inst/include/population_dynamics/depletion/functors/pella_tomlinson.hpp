@@ -23,11 +23,27 @@ struct PellaTomlinsonDepletion : public DepletionBase<Type> {
   fims::Vector<Type> log_r; /**< Intrinsic growth rate. */
   fims::Vector<Type> log_m; /**< Shape parameter that adjusts the curvature of
                                the growth function */
+  Type r = static_cast<Type>(0.0); /**< Intrinsic growth rate, exp(log_r) */
+  Type m = static_cast<Type>(0.0); /**< Shape parameter, exp(log_m) */
 
   PellaTomlinsonDepletion() : DepletionBase<Type>() {}
 
   virtual ~PellaTomlinsonDepletion() {}
 
+  /**
+   * @brief Transforms the growth rate, shape, and carrying capacity from the
+   * log scale.
+   */
+  virtual void TransformParameters() {
+    DepletionBase<Type>::TransformParameters();
+    if (this->log_r.size() > 0) {
+      this->r = fims_math::exp(this->log_r[0]);
+    }
+    if (this->log_m.size() > 0) {
+      this->m = fims_math::exp(this->log_m[0]);
+    }
+  }
+
   /**
    * @brief Method of the depletion class that implements the
    * Pella--Tomlinson production function for depletion, d at time, t.
@@ -40,13 +56,17 @@ struct PellaTomlinsonDepletion : public DepletionBase<Type> {
    */
   virtual const Type evaluate_mean(const Type& depletion_ym1,
                                    const Type& catch_ym1) {
-    Type r;
-    Type K;
-    Type m;
-
-    r = fims_math::exp(this->log_r[0]);
-    K = fims_math::exp(this->log_K[0]);
-    m = fims_math::exp(this->log_m[0]);
+    // the parameters are transformed once per evaluation by the model; a
+    // module used on its own transforms them on every call and leaves the
+    // cache alone, so it never reads stale values
+    Type r = this->r;
+    Type K = this->K;
+    Type m = this->m;
+    if (!this->transformed) {
+      r = fims_math::exp(this->log_r[0]);
+      K = fims_math::exp(this->log_K[0]);
+      m = fims_math::exp(this->log_m[0]);
+    }
 
     return depletion_ym1 +
            (r / (m - 1.0)) * depletion_ym1 *
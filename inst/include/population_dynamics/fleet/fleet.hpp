@@ -9,6 +9,9 @@
 #ifndef FIMS_POPULATION_DYNAMICS_FLEET_HPP
 #define FIMS_POPULATION_DYNAMICS_FLEET_HPP
 
+#include <set>
+
+#include "../../common/banded_matrix.hpp"
 #include "../../common/data_object.hpp"
 #include "../../common/fims_vector.hpp"
 #include "../../common/model_object.hpp"
@@ -26,7 +29,7 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
   static uint32_t id_g; /*!< reference id for fleet object*/
   size_t nyears;        /*!< the number of years in the model*/
   size_t nages;         /*!< the number of ages in the model*/
-  size_t nlengths;      /*!< the number of lengths in the model*/
+  size_t nlengths = 0;  /*!< the number of lengths in the model*/
 
   // selectivity
   int fleet_selectivity_id_m = -999; /*!< id of selectivity component*/
@@ -64,6 +67,9 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
       log_q; /*!< estimated parameter: catchability of the fleet */
 
   fims::Vector<Type> Fmort; /*!< transformed parameter: Fishing mortality*/
+  bool hybrid_F = false; /*!< if true, Fmort is solved each year from the
+                            observed landings instead of log_Fmort, see
+                            HybridF */
   fims::Vector<Type>
       q; /*!< transformed parameter: the catchability of the fleet */
 
@@ -94,6 +100,8 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
   // composition
   fims::Vector<Type> age_to_length_conversion; /*!<derived quantity age to
                                                   length conversion matrix*/
+  fims::BandedMatrix<Type>
+      length_key; /*!<nonzero band of age_to_length_conversion*/
   fims::Vector<Type>
       agecomp_expected; /*!<model expected composition numbers at age*/
   fims::Vector<Type>
@@ -123,6 +131,62 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
    */
   virtual ~Fleet() {}
 
+  /**
+   * @brief Adds the parameters and derived quantities of the fleet to a
+   * memory report.
+   */
+  virtual void ReportMemory(fims::MemoryReport &report,
+                            const std::string &module) const {
+    fims_model_object::FIMSObject<Type>::ReportMemory(report, module);
+    report.AddVector("parameter", module, this->id, "log_Fmort",
+                     this->log_Fmort);
+    report.AddVector("parameter", module, this->id, "log_q", this->log_q);
+    report.AddVector("parameter", module, this->id, "Fmort", this->Fmort);
+    report.AddVector("parameter", module, this->id, "q", this->q);
+    report.AddVector("derived_quantity", module, this->id, "landings_weight",
+                     this->landings_weight);
+    report.AddVector("derived_quantity", module, this->id, "landings_numbers",
+                     this->landings_numbers);
+    report.AddVector("derived_quantity", module, this->id, "landings_expected",
+                     this->landings_expected);
+    report.AddVector("derived_quantity", module, this->id, "log_landings_expected",
+                     this->log_landings_expected);
+    report.AddVector("derived_quantity", module, this->id, "landings_numbers_at_age",
+                     this->landings_numbers_at_age);
+    report.AddVector("derived_quantity", module, this->id, "landings_weight_at_age",
+                     this->landings_weight_at_age);
+    report.AddVector("derived_quantity", module, this->id, "landings_numbers_at_length",
+                     this->landings_numbers_at_length);
+    report.AddVector("derived_quantity", module, this->id, "index_weight",
+                     this->index_weight);
+    report.AddVector("derived_quantity", module, this->id, "index_numbers",
+                     this->index_numbers);
+    report.AddVector("derived_quantity", module, this->id, "index_expected",
+                     this->index_expected);
+    report.AddVector("derived_quantity", module, this->id, "log_index_expected",
+                     this->log_index_expected);
+    report.AddVector("derived_quantity", module, this->id, "index_numbers_at_age",
+                     this->index_numbers_at_age);
+    report.AddVector("derived_quantity", module, this->id, "index_weight_at_age",
+                     this->index_weight_at_age);
+    report.AddVector("derived_quantity", module, this->id, "index_numbers_at_length",
+                     this->index_numbers_at_length);
+    report.AddVector("derived_quantity", module, this->id, "age_to_length_conversion",
+                     this->age_to_length_conversion);
+    report.AddVector("derived_quantity", module, this->id, "agecomp_expected",
+                     this->agecomp_expected);
+    report.AddVector("derived_quantity", module, this->id, "lengthcomp_expected",
+                     this->lengthcomp_expected);
+    report.AddVector("derived_quantity", module, this->id, "agecomp_proportion",
+                     this->agecomp_proportion);
+    report.AddVector("derived_quantity", module, this->id, "lengthcomp_proportion",
+                     this->lengthcomp_proportion);
+    report.AddVector("derived_quantity", module, this->id, "length_key",
+                     this->length_key.values);
+    report.AddVectors("derived_quantity", module, this->id,
+                      this->derived_quantities);
+  }
+
   /**
    * @brief Initialize Fleet Class
    * @param nyears The number of years in the model.
@@ -235,6 +299,20 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
             0)); /**<model expected composition proportion numbers at length*/
   }
 
+  /**
+   * @brief The observed composition of one year, a contiguous row of the
+   * data. The size of the data is validated when the model is created, so the
+   * row is read without bounds checks.
+   *
+   * @param d The composition data, with nbins values per year.
+   * @param year The year.
+   * @param nbins The number of age or length bins.
+   */
+  static fims::Span<const double> ObservedYear(
+      const fims_data_object::DataObject<Type> &d, size_t year, size_t nbins) {
+    return fims_data_object::view<1>(d).span().subspan(year * nbins, nbins);
+  }
+
   /**
    * Evaluate the proportion of landings numbers at age.
    */
@@ -242,6 +320,13 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
     for (size_t y = 0; y < this->nyears; y++) {
       Type sum = static_cast<Type>(0.0);
       Type sum_obs = static_cast<Type>(0.0);
+      fims::Span<const double> observed;
+      double na_value = 0.0;
+      if (this->fleet_observed_agecomp_data_id_m != -999) {
+        observed = Fleet<Type>::ObservedYear(*this->observed_agecomp_data, y,
+                                             this->nages);
+        na_value = fims::value_of(this->observed_agecomp_data->na_value);
+      }
       // robust_add is a small value to add to expected composition
       // proportions at age to stabilize likelihood calculations
       // when the expected proportions are close to zero.
@@ -277,9 +362,8 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
         // allow for composition bins that do not match the population
         // bins.
         if (this->fleet_observed_agecomp_data_id_m != -999) {
-          if (this->observed_agecomp_data->at(i_age_year) !=
-              this->observed_agecomp_data->na_value) {
-            sum_obs += this->observed_agecomp_data->at(i_age_year);
+          if (observed[a] != na_value) {
+            sum_obs += static_cast<Type>(observed[a]);
           }
         }
       }
@@ -297,14 +381,63 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
     }
   }
 
+  /**
+   * @brief Finds the length bins each age can be in from the nonzero
+   * elements of age_to_length_conversion. Called when the model is created,
+   * after the conversion matrix is set.
+   *
+   * @param estimated Parameters that are kept in the band even if they start
+   * at zero.
+   */
+  void SetupLengthKey(
+      const std::set<const Type *> &estimated = std::set<const Type *>()) {
+    this->length_key = fims::BandedMatrix<Type>(
+        this->age_to_length_conversion, this->nages, this->nlengths,
+        estimated);
+  }
+
+  /**
+   * @brief Copies the current values of age_to_length_conversion to the
+   * banded length key, setting the band up first if needed. Does nothing
+   * until the conversion matrix has been filled in.
+   */
+  void UpdateLengthKey() {
+    if (this->age_to_length_conversion.size() !=
+        static_cast<size_t>(this->nages * this->nlengths)) {
+      return;
+    }
+    if (!this->length_key.HasShape(this->nages, this->nlengths)) {
+      this->SetupLengthKey();
+    } else {
+      this->length_key.Update(this->age_to_length_conversion);
+    }
+  }
+
   /**
    * Evaluate the proportion of landings numbers at length.
    */
   void evaluate_length_comp() {
     if (this->nlengths > 0) {
+      this->UpdateLengthKey();
+      this->length_key.MultiplyAdd(this->agecomp_expected.data(),
+                                   this->lengthcomp_expected.data(),
+                                   this->nyears);
+      this->length_key.MultiplyAdd(this->landings_numbers_at_age.data(),
+                                   this->landings_numbers_at_length.data(),
+                                   this->nyears);
+      this->length_key.MultiplyAdd(this->index_numbers_at_age.data(),
+                                   this->index_numbers_at_length.data(),
+                                   this->nyears);
       for (size_t y = 0; y < this->nyears; y++) {
         Type sum = static_cast<Type>(0.0);
         Type sum_obs = static_cast<Type>(0.0);
+        fims::Span<const double> observed;
+        double na_value = 0.0;
+        if (this->fleet_observed_lengthcomp_data_id_m != -999) {
+          observed = Fleet<Type>::ObservedYear(*this->observed_lengthcomp_data,
+                                               y, this->nlengths);
+          na_value = fims::value_of(this->observed_lengthcomp_data->na_value);
+        }
         // robust_add is a small value to add to expected composition
         // proportions at age to stabilize likelihood calculations
         // when the expected proportions are close to zero.
@@ -315,29 +448,12 @@ struct Fleet : public fims_model_object::FIMSObject<Type> {
         // Type robust_sum = static_cast<Type>(1.0);
         for (size_t l = 0; l < this->nlengths; l++) {
           size_t i_length_year = y * this->nlengths + l;
-          for (size_t a = 0; a < this->nages; a++) {
-            size_t i_age_year = y * this->nages + a;
-            size_t i_length_age = a * this->nlengths + l;
-            this->lengthcomp_expected[i_length_year] +=
-                this->agecomp_expected[i_age_year] *
-                this->age_to_length_conversion[i_length_age];
-
-            this->landings_numbers_at_length[i_length_year] +=
-                this->landings_numbers_at_age[i_age_year] *
-                this->age_to_length_conversion[i_length_age];
-
-            this->index_numbers_at_length[i_length_year] +=
-                this->index_numbers_at_age[i_age_year] *
-                this->age_to_length_conversion[i_length_age];
-          }
-
           sum += this->lengthcomp_expected[i_length_year];
           // robust_sum -= robust_add;
 
           if (this->fleet_observed_lengthcomp_data_id_m != -999) {
-            if (this->observed_lengthcomp_data->at(i_length_year) !=
-                this->observed_lengthcomp_data->na_value) {
-              sum_obs += this->observed_lengthcomp_data->at(i_length_year);
+            if (observed[l] != na_value) {
+              sum_obs += static_cast<Type>(observed[l]);
             }
           }
         }
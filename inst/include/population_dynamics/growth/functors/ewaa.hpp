@@ -11,6 +11,9 @@
 
 // #include "../../../interface/interface.hpp"
 #include <map>
+#include <vector>
+
+#include "../../../common/def.hpp"
 
 #include "growth_base.hpp"
 
@@ -30,6 +33,15 @@ struct EWAAgrowth : public GrowthBase<Type> {
           where age starts at zero > */
   typedef typename std::map<double, double>::iterator
       weight_iterator; /**< Iterator for ewaa map object > */
+  std::vector<double>
+      weight_at_year_age; /**< optional empirical weight at age by year,
+          indexed year * nages + age; when empty ewaa is used for all years */
+  std::vector<double> weight_at_age; /**< ewaa resolved by age index in
+          Prepare() */
+  size_t nages = 0;                   /**< number of ages set by Prepare() */
+  size_t nyears = 0;                  /**< number of years set by Prepare() */
+  std::vector<double> missing_ages; /**< ages without a weight, found by
+          Prepare() and logged by LogPrepareMessages() */
 
   EWAAgrowth() : GrowthBase<Type>() {}
 
@@ -48,6 +60,81 @@ struct EWAAgrowth : public GrowthBase<Type> {
     Type ret = (*it).second;  // itewaa[a];
     return ret;
   }
+
+  /**
+   * @brief Looks up the weight of each age in ewaa once, so evaluate(year,
+   * age) is an array read. Ages that are not in ewaa have a weight of zero;
+   * the first time, they are recorded for LogPrepareMessages().
+   *
+   * @param ages The ages of the population.
+   * @param nyears The number of years of the population.
+   */
+  virtual void Prepare(const fims::Vector<double>& ages, size_t nyears) {
+    GrowthBase<Type>::Prepare(ages, nyears);
+    bool first = this->nages != ages.size() || this->nyears != nyears;
+    this->nages = ages.size();
+    this->nyears = nyears;
+    this->weight_at_age.resize(this->nages);
+    for (size_t a = 0; a < this->nages; a++) {
+      weight_iterator it = this->ewaa.find(ages[a]);
+      if (it == this->ewaa.end()) {
+        if (first && this->weight_at_year_age.empty()) {
+          this->missing_ages.push_back(ages[a]);
+        }
+        this->weight_at_age[a] = 0.0;
+      } else {
+        this->weight_at_age[a] = (*it).second;
+      }
+    }
+  }
+
+  /**
+   * @brief Logs the ages without a weight, once.
+   */
+  virtual void LogPrepareMessages() {
+    for (size_t i = 0; i < this->missing_ages.size(); i++) {
+      FIMS_WARNING_LOG("EWAAgrowth " + fims::to_string(this->id) +
+                       " has no weight for age " +
+                       fims::to_string(this->missing_ages[i]) +
+                       ", using zero");
+    }
+    this->missing_ages.clear();
+  }
+
+  /**
+   * @brief True if weights by year and age, if given, cover each year and
+   * age of the population. Checked by Information::CreateModel(), since
+   * evaluate(year, age) does not check bounds.
+   * @param nyears The number of years of the population.
+   * @param nages The number of ages of the population.
+   */
+  virtual bool IsValid(size_t nyears, size_t nages) const {
+    return !this->IsTimeVarying() ||
+           this->weight_at_year_age.size() == nyears * nages;
+  }
+
+  /**
+   * @brief True if weights by year and age were given.
+   */
+  virtual bool IsTimeVarying() const {
+    return !this->weight_at_year_age.empty();
+  }
+
+  /**
+   * @brief Returns the weight at age (in kg) by year and age index. Years past
+   * the last model year, e.g., the extra year of spawning biomass, use the
+   * last year.
+   *
+   * @param year The year index.
+   * @param age The age index.
+   */
+  virtual const Type evaluate(size_t year, size_t age) {
+    if (this->IsTimeVarying()) {
+      size_t y = year < this->nyears ? year : this->nyears - 1;
+      return this->weight_at_year_age[y * this->nages + age];
+    }
+    return this->weight_at_age[age];
+  }
 };
 }  // namespace fims_popdy
 #endif /* POPULATION_DYNAMICS_GROWTH_EWAA_HPP */
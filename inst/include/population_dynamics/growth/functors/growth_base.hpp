@@ -11,6 +11,7 @@
 #ifndef POPULATION_DYNAMICS_GROWTH_BASE_HPP
 #define POPULATION_DYNAMICS_GROWTH_BASE_HPP
 
+#include "../../../common/fims_vector.hpp"
 #include "../../../common/model_object.hpp"
 
 namespace fims_popdy {
@@ -35,11 +36,66 @@ struct GrowthBase : public fims_model_object::FIMSObject<Type> {
 
   virtual ~GrowthBase() {}
 
+  /**
+   * @brief Computes natural-scale parameters once per evaluation, before the
+   * growth is evaluated by age. The current growth functors are
+   * parameterized on the natural scale, so there is nothing to transform by
+   * default.
+   */
+  virtual void TransformParameters() {}
+
   /**
    * @brief Calculates the  growth at the independent variable value.
    * @param a The age at which to return weight of the fish (in kg).
    */
   virtual const Type evaluate(const double& a) = 0;
+
+  /**
+   * @brief Sets up the growth for the ages and years of a population. Called
+   * once per evaluation before evaluate(year, age) is used.
+   * @param ages The ages of the population.
+   * @param nyears The number of years of the population.
+   */
+  virtual void Prepare(const fims::Vector<double>& ages,
+                       [[maybe_unused]] size_t nyears) {
+    this->ages_m = ages;
+  }
+
+  /**
+   * @brief Logs the problems found by Prepare(). Prepare() may run in a
+   * thread pool task, which must not write to the log, so the problems are
+   * kept until the tasks have finished.
+   */
+  virtual void LogPrepareMessages() {}
+
+  /**
+   * @brief True if the growth has the values it needs for a population, e.g.,
+   * a weight for each year and age when weights vary by year.
+   * @param nyears The number of years of the population.
+   * @param nages The number of ages of the population.
+   */
+  virtual bool IsValid([[maybe_unused]] size_t nyears,
+                       [[maybe_unused]] size_t nages) const {
+    return true;
+  }
+
+  /**
+   * @brief True if the weight at age differs between years.
+   */
+  virtual bool IsTimeVarying() const { return false; }
+
+  /**
+   * @brief Returns the weight of the fish (in kg) by year and age index,
+   * after Prepare().
+   * @param year The year index.
+   * @param age The age index.
+   */
+  virtual const Type evaluate([[maybe_unused]] size_t year, size_t age) {
+    return this->evaluate(this->ages_m[age]);
+  }
+
+ protected:
+  fims::Vector<double> ages_m; /**< ages set by Prepare() */
 };
 
 template <typename Type>
@@ -11,6 +11,7 @@
 #ifndef POPULATION_DYNAMICS_MATURITY_BASE_HPP
 #define POPULATION_DYNAMICS_MATURITY_BASE_HPP
 
+#include "../../../common/fims_vector.hpp"
 #include "../../../common/model_object.hpp"
 
 namespace fims_popdy {
@@ -35,6 +36,14 @@ struct MaturityBase : public fims_model_object::FIMSObject<Type> {
     this->id = MaturityBase::id_g++;
   }
 
+  /**
+   * @brief Computes natural-scale parameters once per evaluation, before the
+   * maturity is evaluated by age. The current maturity functors are
+   * parameterized on the natural scale, so there is nothing to transform by
+   * default.
+   */
+  virtual void TransformParameters() {}
+
   /**
    * @brief Calculates the maturity.
    * @param x The independent variable in the maturity function (e.g., logistic
@@ -48,6 +57,23 @@ struct MaturityBase : public fims_model_object::FIMSObject<Type> {
    * @param pos Position index, e.g., which year.
    */
   virtual const Type evaluate(const Type& x, size_t pos) = 0;
+
+  /**
+   * @brief Calculates the maturity at every element of x, e.g., at every age.
+   * The default calls evaluate() once per element; functors override it with
+   * the batched functions from fims_math.
+   * @param x The independent variable, e.g., the ages.
+   * @param out The maturity, resized to the length of x.
+   */
+  virtual void evaluate_all(const fims::Vector<double>& x,
+                            fims::Vector<Type>& out) {
+    if (out.size() != x.size()) {
+      out.resize(x.size());
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+      out[i] = this->evaluate(x[i]);
+    }
+  }
 };
 
 // default id of the singleton maturity class
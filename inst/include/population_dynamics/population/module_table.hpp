@@ -0,0 +1,211 @@
+/**
+ * @file module_table.hpp
+ * @brief Defines the ModuleTable class, which resolves the selectivity,
+ * maturity, growth, and recruitment modules of a population to their concrete
+ * types so they can be evaluated without virtual calls.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#ifndef FIMS_POPULATION_DYNAMICS_MODULE_TABLE_HPP
+#define FIMS_POPULATION_DYNAMICS_MODULE_TABLE_HPP
+
+#include <type_traits>
+#include <typeinfo>
+#include <variant>
+#include <vector>
+
+#include "../../common/fims_vector.hpp"
+#include "../growth/growth.hpp"
+#include "../maturity/maturity.hpp"
+#include "../recruitment/recruitment.hpp"
+#include "../selectivity/selectivity.hpp"
+
+namespace fims_popdy {
+
+/**
+ * @brief The modules of a population, each held as a std::variant over the
+ * functor types FIMS provides, with the base class as the last alternative
+ * for any other functor.
+ *
+ * @details Resolve() is called once when the model is created. Update() is
+ * called once per evaluation and visits each module one time: the functor is
+ * called through its concrete type, so the calls are not virtual and the
+ * compiler can inline and vectorize the loop over ages. The values at age are
+ * cached here and read by the population loops. A module whose type is not
+ * one of the alternatives, e.g., a subclass of a FIMS functor, is called
+ * through the base class as before.
+ */
+template <typename Type>
+struct ModuleTable {
+  /** @brief A selectivity module by its concrete type. */
+  typedef std::variant<LogisticSelectivity<Type> *,
+                       DoubleLogisticSelectivity<Type> *, SelectivityBase<Type> *>
+      SelectivityKernel;
+  /** @brief A maturity module by its concrete type. */
+  typedef std::variant<LogisticMaturity<Type> *, MaturityBase<Type> *>
+      MaturityKernel;
+  /** @brief A growth module by its concrete type. */
+  typedef std::variant<EWAAgrowth<Type> *, GrowthBase<Type> *> GrowthKernel;
+  /** @brief A recruitment module by its concrete type. */
+  typedef std::variant<SRBevertonHolt<Type> *, RecruitmentBase<Type> *>
+      RecruitmentKernel;
+
+  bool resolved = false; /**< true once Resolve() found every module */
+  std::vector<SelectivityKernel>
+      selectivity;            /**< selectivity of each fleet of the population */
+  MaturityKernel maturity;    /**< maturity of the population */
+  GrowthKernel growth;        /**< growth of the population */
+  RecruitmentKernel recruitment; /**< recruitment of the population */
+
+  std::vector<fims::Vector<Type>>
+      selectivity_at_age;            /**< selectivity by fleet and age */
+  fims::Vector<Type> maturity_at_age; /**< maturity by age */
+
+  /**
+   * @brief Resolves the modules of a population. The table stays unresolved,
+   * and the population is evaluated through the base classes, if a module is
+   * missing.
+   *
+   * @param population The population, with its fleets and modules set.
+   */
+  template <class Population>
+  void Resolve(Population &population) {
+    this->resolved = false;
+    this->selectivity.clear();
+    if (population.maturity == nullptr || population.growth == nullptr ||
+        population.recruitment == nullptr) {
+      return;
+    }
+    for (size_t f = 0; f < population.fleets.size(); f++) {
+      if (population.fleets[f]->selectivity == nullptr) {
+        return;
+      }
+      this->selectivity.push_back(
+          ModuleTable<Type>::Find<SelectivityKernel>(
+              population.fleets[f]->selectivity.get()));
+    }
+    this->maturity = ModuleTable<Type>::Find<MaturityKernel>(
+        population.maturity.get());
+    this->growth =
+        ModuleTable<Type>::Find<GrowthKernel>(population.growth.get());
+    this->recruitment = ModuleTable<Type>::Find<RecruitmentKernel>(
+        population.recruitment.get());
+    this->selectivity_at_age.resize(this->selectivity.size());
+    this->resolved = true;
+  }
+
+  /**
+   * @brief Evaluates the selectivity of every fleet and the maturity at every
+   * age, one dispatch per module.
+   *
+   * @param ages The ages of the population.
+   */
+  void Update(const fims::Vector<double> &ages) {
+    for (size_t f = 0; f < this->selectivity.size(); f++) {
+      fims::Vector<Type> &out = this->selectivity_at_age[f];
+      std::visit(
+          [&](auto *module) { ModuleTable<Type>::EvaluateAll(module, ages, out); },
+          this->selectivity[f]);
+    }
+    std::visit(
+        [&](auto *module) {
+          ModuleTable<Type>::EvaluateAll(module, ages, this->maturity_at_age);
+        },
+        this->maturity);
+  }
+
+  /**
+   * @brief Fills the weight at age for the first nyears years, one dispatch
+   * for all years and ages. The growth must be prepared for the ages.
+   *
+   * @param nyears The number of years to fill.
+   * @param nages The number of ages.
+   * @param out The weights, indexed year * nages + age.
+   */
+  void WeightAtAge(size_t nyears, size_t nages, fims::Vector<Type> &out) {
+    std::visit(
+        [&](auto *module) {
+          typedef typename std::remove_pointer<decltype(module)>::type Module;
+          for (size_t year = 0; year < nyears; year++) {
+            for (size_t age = 0; age < nages; age++) {
+              if constexpr (std::is_same<Module, GrowthBase<Type>>::value) {
+                out[year * nages + age] = module->evaluate(year, age);
+              } else {
+                out[year * nages + age] = module->Module::evaluate(year, age);
+              }
+            }
+          }
+        },
+        this->growth);
+  }
+
+  /**
+   * @brief The expected recruitment for a spawning output, see
+   * RecruitmentBase::evaluate_mean().
+   *
+   * @param spawners A measure of spawning output.
+   * @param phi_0 Number of spawners per recruit of an unfished population.
+   */
+  const Type RecruitmentMean(const Type &spawners, const Type &phi_0) {
+    return std::visit(
+        [&](auto *module) -> Type {
+          typedef typename std::remove_pointer<decltype(module)>::type Module;
+          if constexpr (std::is_same<Module, RecruitmentBase<Type>>::value) {
+            return module->evaluate_mean(spawners, phi_0);
+          } else {
+            return module->Module::evaluate_mean(spawners, phi_0);
+          }
+        },
+        this->recruitment);
+  }
+
+ private:
+  /**
+   * @brief The alternative of a kernel variant whose type is exactly the
+   * dynamic type of a module, or the base class alternative.
+   */
+  template <class Kernel, class Base>
+  static Kernel Find(Base *module) {
+    Kernel kernel = module;
+    ModuleTable<Type>::FindAlternative<Kernel, 0>(module, kernel);
+    return kernel;
+  }
+
+  /**
+   * @brief Checks the alternatives of a kernel variant from the I-th on.
+   */
+  template <class Kernel, size_t I, class Base>
+  static void FindAlternative(Base *module, Kernel &kernel) {
+    if constexpr (I < std::variant_size<Kernel>::value) {
+      typedef typename std::remove_pointer<
+          typename std::variant_alternative<I, Kernel>::type>::type Module;
+      if constexpr (!std::is_same<Module, Base>::value) {
+        if (typeid(*module) == typeid(Module)) {
+          kernel = static_cast<Module *>(module);
+          return;
+        }
+      }
+      ModuleTable<Type>::FindAlternative<Kernel, I + 1>(module, kernel);
+    }
+  }
+
+  /**
+   * @brief Evaluates a selectivity or maturity module at every age, through
+   * its concrete type unless it is the base class alternative.
+   */
+  template <class Module>
+  static void EvaluateAll(Module *module, const fims::Vector<double> &ages,
+                          fims::Vector<Type> &out) {
+    if constexpr (std::is_same<Module, SelectivityBase<Type>>::value ||
+                  std::is_same<Module, MaturityBase<Type>>::value) {
+      module->evaluate_all(ages, out);
+    } else {
+      module->Module::evaluate_all(ages, out);
+    }
+  }
+};
+
+}  // namespace fims_popdy
+
+#endif /* FIMS_POPULATION_DYNAMICS_MODULE_TABLE_HPP */
@@ -8,6 +8,7 @@
 #ifndef FIMS_POPULATION_DYNAMICS_POPULATION_HPP
 #define FIMS_POPULATION_DYNAMICS_POPULATION_HPP
 
+#include "../../common/age_year_layout.hpp"
 #include "../../common/model_object.hpp"
 #include "../fleet/fleet.hpp"
 #include "../growth/growth.hpp"
@@ -15,6 +16,7 @@
 #include "../depletion/depletion.hpp"
 #include "../../interface/interface.hpp"
 #include "../maturity/maturity.hpp"
+#include "module_table.hpp"
 
 namespace fims_popdy {
 /*TODO:
@@ -41,12 +43,17 @@ struct Population : public fims_model_object::FIMSObject<Type> {
   fims::Vector<Type>
       log_init_depletion; /*!< estimated parameter: natural log of depletion*/
   fims::Vector<Type>
-      log_M; /*!< estimated parameter: natural log of Natural Mortality*/
+      log_M; /*!< estimated parameter: natural log of Natural Mortality, one
+                value per distinct value of M_layout*/
+  fims::AgeYearLayout M_layout; /*!< how log_M varies by year and age */
   fims::Vector<Type> proportion_female = fims::Vector<Type>(
       1, static_cast<Type>(0.5)); /*!< proportion female by age */
 
   // Transformed values
   fims::Vector<Type> M; /*!< transformed parameter: natural mortality*/
+  fims::Vector<Type>
+      M_distinct; /*!< natural mortality at each value of log_M, broadcast
+                     into M */
 
   fims::Vector<double> ages;      /*!< vector of the ages for referencing*/
   fims::Vector<double> years;     /*!< vector of years for referencing*/
@@ -103,6 +110,8 @@ struct Population : public fims_model_object::FIMSObject<Type> {
   std::set<uint32_t> fleet_ids; /*!< id of fleet model object*/
   std::vector<std::shared_ptr<fims_popdy::Fleet<Type>>>
       fleets; /*!< shared pointer to fleet module */
+  ModuleTable<Type> modules; /*!< the modules by their concrete types, see
+                                CatchAtAge::ResolveModules() */
 
   // Define objective function object to be able to REPORT and ADREPORT
 
@@ -125,6 +134,58 @@ struct Population : public fims_model_object::FIMSObject<Type> {
 
   Population() { this->id = Population::id_g++; }
 
+  /**
+   * @brief Adds the parameters and derived quantities of the population to a
+   * memory report.
+   */
+  virtual void ReportMemory(fims::MemoryReport &report,
+                            const std::string &module) const {
+    fims_model_object::FIMSObject<Type>::ReportMemory(report, module);
+    report.AddVector("parameter", module, this->id, "log_init_naa",
+                     this->log_init_naa);
+    report.AddVector("parameter", module, this->id, "log_init_depletion",
+                     this->log_init_depletion);
+    report.AddVector("parameter", module, this->id, "log_M", this->log_M);
+    report.AddVector("parameter", module, this->id, "proportion_female",
+                     this->proportion_female);
+    report.AddVector("parameter", module, this->id, "M", this->M);
+    report.AddVector("parameter", module, this->id, "M_distinct",
+                     this->M_distinct);
+    report.AddVector("derived_quantity", module, this->id, "ages", this->ages);
+    report.AddVector("derived_quantity", module, this->id, "years",
+                     this->years);
+    report.AddVector("derived_quantity", module, this->id, "mortality_F",
+                     this->mortality_F);
+    report.AddVector("derived_quantity", module, this->id, "mortality_Z",
+                     this->mortality_Z);
+    report.AddVector("derived_quantity", module, this->id, "weight_at_age",
+                     this->weight_at_age);
+    report.AddVector("derived_quantity", module, this->id, "numbers_at_age",
+                     this->numbers_at_age);
+    report.AddVector("derived_quantity", module, this->id, "unfished_numbers_at_age",
+                     this->unfished_numbers_at_age);
+    report.AddVector("derived_quantity", module, this->id, "biomass",
+                     this->biomass);
+    report.AddVector("derived_quantity", module, this->id, "spawning_biomass",
+                     this->spawning_biomass);
+    report.AddVector("derived_quantity", module, this->id, "unfished_biomass",
+                     this->unfished_biomass);
+    report.AddVector("derived_quantity", module, this->id, "unfished_spawning_biomass",
+                     this->unfished_spawning_biomass);
+    report.AddVector("derived_quantity", module, this->id, "proportion_mature_at_age",
+                     this->proportion_mature_at_age);
+    report.AddVector("derived_quantity", module, this->id, "total_landings_weight",
+                     this->total_landings_weight);
+    report.AddVector("derived_quantity", module, this->id, "total_landings_numbers",
+                     this->total_landings_numbers);
+    report.AddVector("derived_quantity", module, this->id, "expected_recruitment",
+                     this->expected_recruitment);
+    report.AddVector("derived_quantity", module, this->id, "sum_selectivity",
+                     this->sum_selectivity);
+    report.AddVectors("derived_quantity", module, this->id,
+                      this->derived_quantities);
+  }
+
   /**
    * @brief Initialize values. Called once at the start of model run.
    *
@@ -156,7 +217,23 @@ struct Population : public fims_model_object::FIMSObject<Type> {
     M.resize(nyears * nages);
     ages.resize(nages);
     log_init_naa.resize(nages);
-    log_M.resize(nyears * nages);
+    M_layout.Resize(nyears, nages);
+    M_distinct.resize(M_layout.Size());
+    log_M.resize(M_layout.Size());
+  }
+
+  /**
+   * @brief Computes natural mortality from log_M, once per distinct value,
+   * and broadcasts it into M by year and age.
+   */
+  void TransformM() {
+    if (this->M_distinct.size() != this->log_M.size()) {
+      this->M_distinct.resize(this->log_M.size());
+    }
+    for (size_t i = 0; i < this->log_M.size(); i++) {
+      this->M_distinct[i] = fims_math::exp(this->log_M[i]);
+    }
+    this->M_layout.Broadcast(this->M_distinct, this->M);
   }
 
   /**
@@ -189,11 +266,15 @@ struct Population : public fims_model_object::FIMSObject<Type> {
               static_cast<Type>(0.5));
 
     // Transformation Section
+    if (this->recruitment != nullptr) {
+      this->recruitment->TransformParameters();
+    }
+    growth->Prepare(ages, this->nyears);
+    this->TransformM();
     for (size_t age = 0; age < this->nages; age++) {
-      this->weight_at_age[age] = growth->evaluate(ages[age]);
+      this->weight_at_age[age] = growth->evaluate(0, age);
       for (size_t year = 0; year < this->nyears; year++) {
         size_t i_age_year = age * this->nyears + year;
-        this->M[i_age_year] = fims_math::exp(this->log_M[i_age_year]);
         // mortality_F is a fims::Vector and therefore needs to be filled
         // within a loop
         this->mortality_F[i_age_year] = static_cast<Type>(0.0);
@@ -346,12 +427,12 @@ struct Population : public fims_model_object::FIMSObject<Type> {
     Type phi_0 = static_cast<Type>(0.0);
     phi_0 += numbers_spr[0] * this->proportion_female[0] *
              this->proportion_mature_at_age[0] *
-             this->growth->evaluate(ages[0]);
+             this->weight_at_age[0];
     for (size_t a = 1; a < (this->nages - 1); a++) {
       numbers_spr[a] = numbers_spr[a - 1] * fims_math::exp(-this->M[a]);
       phi_0 += numbers_spr[a] * this->proportion_female[a] *
                this->proportion_mature_at_age[a] *
-               this->growth->evaluate(ages[a]);
+               this->weight_at_age[a];
     }
 
     numbers_spr[this->nages - 1] =
@@ -360,7 +441,7 @@ struct Population : public fims_model_object::FIMSObject<Type> {
     phi_0 += numbers_spr[this->nages - 1] *
              this->proportion_female[this->nages - 1] *
              this->proportion_mature_at_age[this->nages - 1] *
-             this->growth->evaluate(ages[this->nages - 1]);
+             this->weight_at_age[this->nages - 1];
     return phi_0;
   }
 
@@ -586,8 +667,7 @@ struct Population : public fims_model_object::FIMSObject<Type> {
           CalculateInitialNumbersAA(i_age_year, a);
 
           if (a == 0) {
-            this->unfished_numbers_at_age[i_age_year] =
-                fims_math::exp(this->recruitment->log_rzero[0]);
+            this->unfished_numbers_at_age[i_age_year] = this->recruitment->rzero;
           } else {
             CalculateUnfishedNumbersAA(i_age_year, a - 1, a);
           }
@@ -622,8 +702,7 @@ struct Population : public fims_model_object::FIMSObject<Type> {
             // Set the nrecruits for age a=0 year y (use pointers instead of
             // functional returns) assuming fecundity = 1 and 50:50 sex ratio
             CalculateRecruitment(i_age_year, y, y);
-            this->unfished_numbers_at_age[i_age_year] =
-                fims_math::exp(this->recruitment->log_rzero[0]);
+            this->unfished_numbers_at_age[i_age_year] = this->recruitment->rzero;
 
           } else {
             size_t i_agem1_yearm1 = (y - 1) * nages + (a - 1);
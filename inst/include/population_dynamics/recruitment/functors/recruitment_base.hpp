@@ -38,6 +38,12 @@ struct RecruitmentBase : public fims_model_object::FIMSObject<Type> {
       log_r; /**< Natural log of recruitment used for random effects */
   fims::Vector<Type>
       log_expected_recruitment; /**< Expectation of the recruitment process */
+  Type rzero = static_cast<Type>(0.0); /**< Unexploited recruitment,
+                                  exp(log_rzero), set by TransformParameters() */
+  bool transformed = false; /**< True while the cached natural-scale values
+                              match the parameters: set by
+                              TransformParameters() and cleared when
+                              Information writes new parameter values */
 
   bool estimate_log_recruit_devs = true; /*!< A flag to indicate if recruitment
                                   deviations are estimated or not */
@@ -64,6 +70,20 @@ struct RecruitmentBase : public fims_model_object::FIMSObject<Type> {
               0.0);
   }
 
+  /**
+   * @brief Computes the natural-scale parameters from the estimated ones.
+   * Called once per evaluation by the model, so the per-year calculations
+   * read the cached values instead of transforming the parameters again.
+   * Code that writes the parameters directly, rather than through
+   * Information, must call it again before the cached values are read.
+   */
+  virtual void TransformParameters() {
+    if (this->log_rzero.size() > 0) {
+      this->rzero = fims_math::exp(this->log_rzero[0]);
+    }
+    this->transformed = true;
+  }
+
   /** @brief Calculates the expected recruitment for a given spawning input.
    *
    * @param spawners A measure for spawning output.
@@ -32,11 +32,26 @@ struct SRBevertonHolt : public RecruitmentBase<Type> {
                                   relative to unfished
                                   recruitment at 20 percent of unfished
                                   spawning biomass.*/
+  Type steep = static_cast<Type>(0.0); /**< Steepness on the natural scale,
+                                  set by TransformParameters() */
 
   SRBevertonHolt() : RecruitmentBase<Type>() {}
 
   virtual ~SRBevertonHolt() {}
 
+  /**
+   * @brief Transforms steepness from the logit scale, bounded between 0.2 and
+   * 1.0, and unfished recruitment from the log scale.
+   */
+  virtual void TransformParameters() {
+    RecruitmentBase<Type>::TransformParameters();
+    if (this->logit_steep.size() > 0) {
+      this->steep = fims_math::inv_logit(static_cast<Type>(0.2),
+                                         static_cast<Type>(1.0),
+                                         this->logit_steep[0]);
+    }
+  }
+
   /** @brief Beverton--Holt implementation of the stock--recruitment function.
    *
    * The Beverton--Holt stock--recruitment implementation:
@@ -48,14 +63,17 @@ struct SRBevertonHolt : public RecruitmentBase<Type> {
    */
   virtual const Type evaluate_mean(const Type& spawners, const Type& phi_0) {
     Type recruits;
-    Type steep;
-    Type steep_lo = static_cast<Type>(0.2);
-    Type steep_hi = static_cast<Type>(1.0);
-    Type rzero;
-
-    // Transform input parameters
-    steep = fims_math::inv_logit(steep_lo, steep_hi, this->logit_steep[0]);
-    rzero = fims_math::exp(this->log_rzero[0]);
+    // the parameters are transformed once per evaluation by the model; a
+    // module used on its own transforms them on every call and leaves the
+    // cache alone, so it never reads stale values
+    Type steep = this->steep;
+    Type rzero = this->rzero;
+    if (!this->transformed) {
+      steep = fims_math::inv_logit(static_cast<Type>(0.2),
+                                   static_cast<Type>(1.0),
+                                   this->logit_steep[0]);
+      rzero = fims_math::exp(this->log_rzero[0]);
+    }
 
     recruits = (static_cast<Type>(0.8) * rzero * steep * spawners) /
                (static_cast<Type>(0.2) * phi_0 * rzero *
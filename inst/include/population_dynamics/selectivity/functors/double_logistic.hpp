@@ -75,6 +75,23 @@ struct DoubleLogisticSelectivity : public SelectivityBase<Type> {
         inflection_point_desc.get_force_scalar(pos),
         slope_desc.get_force_scalar(pos), x);
   }
+
+  /**
+   * @brief Evaluates the double logistic function at every element of x with
+   * the batched fims_math::double_logistic().
+   *
+   * @param x The independent variable, e.g., the ages.
+   * @param out The selectivity, resized to the length of x.
+   */
+  virtual void evaluate_all(const fims::Vector<double> &x,
+                            fims::Vector<Type> &out) {
+    if (out.size() != x.size()) {
+      out.resize(x.size());
+    }
+    fims_math::double_logistic(inflection_point_asc[0], slope_asc[0],
+                               inflection_point_desc[0], slope_desc[0],
+                               x.data(), out.data(), x.size());
+  }
 };
 
 }  // namespace fims_popdy
@@ -59,6 +59,22 @@ struct LogisticSelectivity : public SelectivityBase<Type> {
     return fims_math::logistic<Type>(inflection_point.get_force_scalar(pos),
                                      slope.get_force_scalar(pos), x);
   }
+
+  /**
+   * @brief Evaluates the logistic function at every element of x with the
+   * batched fims_math::logistic().
+   *
+   * @param x The independent variable, e.g., the ages.
+   * @param out The selectivity, resized to the length of x.
+   */
+  virtual void evaluate_all(const fims::Vector<double>& x,
+                            fims::Vector<Type>& out) {
+    if (out.size() != x.size()) {
+      out.resize(x.size());
+    }
+    fims_math::logistic(inflection_point[0], slope[0], x.data(), out.data(),
+                        x.size());
+  }
 };
 
 }  // namespace fims_popdy
@@ -11,6 +11,7 @@
 #ifndef POPULATION_DYNAMICS_SELECTIVITY_BASE_HPP
 #define POPULATION_DYNAMICS_SELECTIVITY_BASE_HPP
 
+#include "../../../common/fims_vector.hpp"
 #include "../../../common/model_object.hpp"
 
 namespace fims_popdy {
@@ -38,6 +39,14 @@ struct SelectivityBase : public fims_model_object::FIMSObject<Type> {
 
   virtual ~SelectivityBase() {}
 
+  /**
+   * @brief Computes natural-scale parameters once per evaluation, before the
+   * selectivity is evaluated by age and year. The current selectivity functors are
+   * parameterized on the natural scale, so there is nothing to transform by
+   * default.
+   */
+  virtual void TransformParameters() {}
+
   /**
    * @brief Calculates the selectivity.
    * @param x The independent variable in the logistic function (e.g., age or
@@ -52,6 +61,23 @@ struct SelectivityBase : public fims_model_object::FIMSObject<Type> {
    * @param pos Position index, e.g., which year.
    */
   virtual const Type evaluate(const Type& x, size_t pos) = 0;
+
+  /**
+   * @brief Calculates the selectivity at every element of x, e.g., at every age.
+   * The default calls evaluate() once per element; functors override it with
+   * the batched functions from fims_math.
+   * @param x The independent variable, e.g., the ages.
+   * @param out The selectivity, resized to the length of x.
+   */
+  virtual void evaluate_all(const fims::Vector<double>& x,
+                            fims::Vector<Type>& out) {
+    if (out.size() != x.size()) {
+      out.resize(x.size());
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+      out[i] = this->evaluate(x[i]);
+    }
+  }
 };
 
 // default id of the singleton selectivity class
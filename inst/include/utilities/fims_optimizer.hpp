@@ -0,0 +1,493 @@
+#ifndef FIMS_OPTIMIZER_HPP
+#define FIMS_OPTIMIZER_HPP
+
+/**
+ * @file fims_optimizer.hpp
+ * @brief A bounded quasi-Newton minimizer with optional Newton refinement.
+ * @details The minimizer works on plain std::vector<double> so it can be
+ * driven from C++ without crossing the R boundary, e.g., for batch fits of
+ * the double version of a FIMS model.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace fims {
+
+/**
+ * @brief Settings for the optimizer. The defaults mirror the settings that
+ * `fit_fims()` passes to `nlminb()`.
+ */
+struct OptimizerControl {
+  size_t max_iterations = 10000;  /**< maximum number of iterations */
+  size_t max_evaluations = 10000; /**< maximum number of function evaluations */
+  size_t memory = 5; /**< number of correction pairs kept by L-BFGS */
+  double gradient_tolerance =
+      1e-8; /**< convergence when the largest projected gradient is smaller */
+  double relative_tolerance =
+      1e-10; /**< convergence when the relative change in the objective is
+                smaller */
+  size_t max_line_search = 40; /**< maximum number of step halvings */
+  size_t newton_steps = 0; /**< Newton steps taken after the quasi-Newton fit */
+  double finite_difference_step =
+      1e-5; /**< step for finite difference gradients and Hessians */
+};
+
+/**
+ * @brief The result of a fit. The members match the list returned by
+ * `nlminb()`.
+ */
+struct OptimizerResult {
+  std::vector<double> par;         /**< parameter values at the minimum */
+  double objective = 0.0;          /**< objective function value at par */
+  int convergence = 1;             /**< 0 if the optimizer converged */
+  size_t iterations = 0;           /**< number of iterations */
+  size_t function_evaluations = 0; /**< number of objective evaluations */
+  size_t gradient_evaluations = 0; /**< number of gradient evaluations */
+  double max_gradient = 0.0; /**< largest absolute projected gradient at par */
+  std::string message;       /**< description of the stopping condition */
+};
+
+/**
+ * @brief Bounded limited-memory BFGS minimizer.
+ *
+ * @details Bounds are handled by projection: variables at a bound whose
+ * gradient points out of the feasible region are held fixed for the
+ * iteration, the two-loop recursion is applied to the remaining variables,
+ * and a backtracking Armijo search is done along the projected path. After
+ * the quasi-Newton phase, `newton_steps` Newton steps using the Hessian can be
+ * taken to reduce the final gradient.
+ */
+class Optimizer {
+ public:
+  /**
+   * @brief Objective function.
+   */
+  typedef std::function<double(const std::vector<double> &)> objective_t;
+  /**
+   * @brief Gradient function that fills the second argument.
+   */
+  typedef std::function<void(const std::vector<double> &,
+                             std::vector<double> &)>
+      gradient_t;
+  /**
+   * @brief Hessian function that fills the second argument, stored by row.
+   */
+  typedef std::function<void(const std::vector<double> &,
+                             std::vector<double> &)>
+      hessian_t;
+
+  OptimizerControl control; /**< settings for the fit */
+
+  /**
+   * @brief Constructor.
+   *
+   * @param objective The objective function.
+   * @param gradient The gradient. If empty, central finite differences of the
+   * objective are used.
+   * @param hessian The Hessian used by the Newton steps. If empty, central
+   * finite differences of the gradient are used.
+   */
+  Optimizer(objective_t objective, gradient_t gradient = gradient_t(),
+            hessian_t hessian = hessian_t())
+      : objective(objective), gradient(gradient), hessian(hessian) {}
+
+  /**
+   * @brief Minimizes the objective function.
+   *
+   * @param start The starting values.
+   * @param lower The lower bounds. If empty, -Inf is used.
+   * @param upper The upper bounds. If empty, Inf is used.
+   * @return The fit, see OptimizerResult.
+   */
+  OptimizerResult Minimize(const std::vector<double> &start,
+                           std::vector<double> lower = std::vector<double>(),
+                           std::vector<double> upper = std::vector<double>()) {
+    const size_t n = start.size();
+    const double inf = std::numeric_limits<double>::infinity();
+    if (lower.size() != n) lower.assign(n, -inf);
+    if (upper.size() != n) upper.assign(n, inf);
+
+    OptimizerResult result;
+    this->n_function = 0;
+    this->n_gradient = 0;
+
+    std::vector<double> x = start;
+    this->Project(x, lower, upper);
+    std::vector<double> g(n);
+    double f = this->Evaluate(x);
+    this->Gradient(x, g);
+
+    std::deque<std::vector<double>> s_history;
+    std::deque<std::vector<double>> y_history;
+    std::deque<double> rho_history;
+
+    std::vector<double> pg(n), d(n), x_new(n), g_new(n);
+    result.convergence = 1;
+    result.message = "iteration limit reached";
+    size_t iter = 0;
+    for (; iter < this->control.max_iterations; iter++) {
+      double max_pg = this->ProjectedGradient(x, g, lower, upper, pg);
+      if (max_pg <= this->control.gradient_tolerance) {
+        result.convergence = 0;
+        result.message = "gradient tolerance reached";
+        break;
+      }
+      if (this->n_function >= this->control.max_evaluations) {
+        result.message = "function evaluation limit reached";
+        break;
+      }
+
+      // search direction from the two-loop recursion on the free variables
+      this->TwoLoop(pg, s_history, y_history, rho_history, d);
+      double slope = Dot(pg, d);
+      if (!(slope < 0.0)) {
+        s_history.clear();
+        y_history.clear();
+        rho_history.clear();
+        for (size_t i = 0; i < n; i++) d[i] = -pg[i];
+        slope = Dot(pg, d);
+      }
+
+      // the first step has no curvature information, so limit its length
+      double step = 1.0;
+      if (s_history.empty()) {
+        step = std::min(1.0, 1.0 / max_pg);
+      }
+
+      // backtracking along the projected path
+      bool accepted = false;
+      double f_new = f;
+      for (size_t k = 0; k < this->control.max_line_search; k++) {
+        for (size_t i = 0; i < n; i++) x_new[i] = x[i] + step * d[i];
+        this->Project(x_new, lower, upper);
+        double decrease = 0.0;
+        for (size_t i = 0; i < n; i++) decrease += g[i] * (x_new[i] - x[i]);
+        f_new = this->Evaluate(x_new);
+        if (std::isfinite(f_new) && f_new <= f + 1e-4 * decrease) {
+          accepted = true;
+          break;
+        }
+        step *= 0.5;
+      }
+
+      if (!accepted) {
+        if (!s_history.empty()) {
+          // retry from steepest descent before giving up
+          s_history.clear();
+          y_history.clear();
+          rho_history.clear();
+          continue;
+        }
+        result.convergence = 1;
+        result.message = "false convergence, line search failed";
+        break;
+      }
+
+      this->Gradient(x_new, g_new);
+      std::vector<double> s(n), y(n);
+      for (size_t i = 0; i < n; i++) {
+        s[i] = x_new[i] - x[i];
+        y[i] = g_new[i] - g[i];
+      }
+      double sy = Dot(s, y);
+      if (sy > std::numeric_limits<double>::epsilon() * Dot(y, y)) {
+        s_history.push_back(s);
+        y_history.push_back(y);
+        rho_history.push_back(1.0 / sy);
+        if (s_history.size() > this->control.memory) {
+          s_history.pop_front();
+          y_history.pop_front();
+          rho_history.pop_front();
+        }
+      }
+
+      double change = std::fabs(f - f_new);
+      double scale = std::max(std::fabs(f), std::fabs(f_new));
+      x.swap(x_new);
+      g.swap(g_new);
+      f = f_new;
+      if (change <= this->control.relative_tolerance * scale) {
+        result.convergence = 0;
+        result.message = "relative convergence";
+        iter++;
+        break;
+      }
+    }
+    result.iterations = iter;
+
+    if (this->control.newton_steps > 0) {
+      f = this->NewtonSteps(x, g, lower, upper, f);
+    }
+
+    result.par = x;
+    result.objective = f;
+    result.max_gradient = this->ProjectedGradient(x, g, lower, upper, pg);
+    result.function_evaluations = this->n_function;
+    result.gradient_evaluations = this->n_gradient;
+    return result;
+  }
+
+ private:
+  objective_t objective; /**< the objective function */
+  gradient_t gradient;   /**< the gradient, may be empty */
+  hessian_t hessian;     /**< the Hessian, may be empty */
+  size_t n_function = 0; /**< number of objective evaluations */
+  size_t n_gradient = 0; /**< number of gradient evaluations */
+
+  /**
+   * @brief Evaluates the objective and counts the call.
+   */
+  double Evaluate(const std::vector<double> &x) {
+    this->n_function++;
+    return this->objective(x);
+  }
+
+  /**
+   * @brief Evaluates the gradient, using central differences if no gradient
+   * was supplied.
+   */
+  void Gradient(const std::vector<double> &x, std::vector<double> &g) {
+    this->n_gradient++;
+    g.resize(x.size());
+    if (this->gradient) {
+      this->gradient(x, g);
+      return;
+    }
+    std::vector<double> xh = x;
+    for (size_t i = 0; i < x.size(); i++) {
+      double h = this->control.finite_difference_step *
+                 std::max(1.0, std::fabs(x[i]));
+      xh[i] = x[i] + h;
+      double f_plus = this->objective(xh);
+      xh[i] = x[i] - h;
+      double f_minus = this->objective(xh);
+      xh[i] = x[i];
+      g[i] = (f_plus - f_minus) / (2.0 * h);
+    }
+  }
+
+  /**
+   * @brief Evaluates the Hessian by row, using central differences of the
+   * gradient if no Hessian was supplied.
+   */
+  void Hessian(const std::vector<double> &x, std::vector<double> &h) {
+    const size_t n = x.size();
+    h.assign(n * n, 0.0);
+    if (this->hessian) {
+      this->hessian(x, h);
+      return;
+    }
+    std::vector<double> xh = x;
+    std::vector<double> g_plus(n), g_minus(n);
+    for (size_t i = 0; i < n; i++) {
+      double step = this->control.finite_difference_step *
+                    std::max(1.0, std::fabs(x[i]));
+      xh[i] = x[i] + step;
+      this->Gradient(xh, g_plus);
+      xh[i] = x[i] - step;
+      this->Gradient(xh, g_minus);
+      xh[i] = x[i];
+      for (size_t j = 0; j < n; j++) {
+        h[i * n + j] = (g_plus[j] - g_minus[j]) / (2.0 * step);
+      }
+    }
+    // symmetrize
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = i + 1; j < n; j++) {
+        double avg = 0.5 * (h[i * n + j] + h[j * n + i]);
+        h[i * n + j] = avg;
+        h[j * n + i] = avg;
+      }
+    }
+  }
+
+  /**
+   * @brief Takes Newton steps on the free variables, keeping a step only if
+   * it does not increase the objective.
+   *
+   * @return The objective function value at x.
+   */
+  double NewtonSteps(std::vector<double> &x, std::vector<double> &g,
+                     const std::vector<double> &lower,
+                     const std::vector<double> &upper, double f) {
+    const size_t n = x.size();
+    std::vector<double> h, pg(n), d(n), x_new(n), g_new(n);
+    for (size_t k = 0; k < this->control.newton_steps; k++) {
+      this->ProjectedGradient(x, g, lower, upper, pg);
+      this->Hessian(x, h);
+      // decouple the variables held at a bound
+      for (size_t i = 0; i < n; i++) {
+        if (pg[i] == 0.0 && g[i] != 0.0) {
+          for (size_t j = 0; j < n; j++) {
+            h[i * n + j] = 0.0;
+            h[j * n + i] = 0.0;
+          }
+          h[i * n + i] = 1.0;
+        }
+      }
+      if (!this->SolveCholesky(h, pg, d)) {
+        break;
+      }
+      double step = 1.0;
+      bool accepted = false;
+      double f_new = f;
+      for (size_t m = 0; m < this->control.max_line_search; m++) {
+        for (size_t i = 0; i < n; i++) x_new[i] = x[i] - step * d[i];
+        this->Project(x_new, lower, upper);
+        f_new = this->Evaluate(x_new);
+        if (std::isfinite(f_new) && f_new <= f) {
+          accepted = true;
+          break;
+        }
+        step *= 0.5;
+      }
+      if (!accepted) {
+        break;
+      }
+      this->Gradient(x_new, g_new);
+      x.swap(x_new);
+      g.swap(g_new);
+      f = f_new;
+    }
+    return f;
+  }
+
+  /**
+   * @brief Solves h * d = b with a Cholesky factorization, adding a ridge to
+   * the diagonal until h is positive definite.
+   *
+   * @return False if no factorization could be found.
+   */
+  bool SolveCholesky(const std::vector<double> &h, const std::vector<double> &b,
+                     std::vector<double> &d) {
+    const size_t n = b.size();
+    std::vector<double> l(n * n);
+    double ridge = 0.0;
+    for (size_t attempt = 0; attempt < 20; attempt++) {
+      bool positive_definite = true;
+      std::fill(l.begin(), l.end(), 0.0);
+      for (size_t j = 0; j < n && positive_definite; j++) {
+        double sum = h[j * n + j] + ridge;
+        for (size_t k = 0; k < j; k++) sum -= l[j * n + k] * l[j * n + k];
+        if (!(sum > 0.0)) {
+          positive_definite = false;
+          break;
+        }
+        l[j * n + j] = std::sqrt(sum);
+        for (size_t i = j + 1; i < n; i++) {
+          double s = h[i * n + j];
+          for (size_t k = 0; k < j; k++) s -= l[i * n + k] * l[j * n + k];
+          l[i * n + j] = s / l[j * n + j];
+        }
+      }
+      if (positive_definite) {
+        // forward then back substitution
+        std::vector<double> z(n);
+        for (size_t i = 0; i < n; i++) {
+          double s = b[i];
+          for (size_t k = 0; k < i; k++) s -= l[i * n + k] * z[k];
+          z[i] = s / l[i * n + i];
+        }
+        d.assign(n, 0.0);
+        for (size_t ii = n; ii > 0; ii--) {
+          size_t i = ii - 1;
+          double s = z[i];
+          for (size_t k = i + 1; k < n; k++) s -= l[k * n + i] * d[k];
+          d[i] = s / l[i * n + i];
+        }
+        return true;
+      }
+      ridge = (ridge == 0.0) ? 1e-8 : ridge * 10.0;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Two-loop recursion giving d = -H * g for the stored pairs.
+   */
+  void TwoLoop(const std::vector<double> &g,
+               const std::deque<std::vector<double>> &s_history,
+               const std::deque<std::vector<double>> &y_history,
+               const std::deque<double> &rho_history, std::vector<double> &d) {
+    const size_t m = s_history.size();
+    std::vector<double> q = g;
+    std::vector<double> alpha(m);
+    for (size_t jj = m; jj > 0; jj--) {
+      size_t j = jj - 1;
+      alpha[j] = rho_history[j] * Dot(s_history[j], q);
+      for (size_t i = 0; i < q.size(); i++) q[i] -= alpha[j] * y_history[j][i];
+    }
+    if (m > 0) {
+      double gamma =
+          Dot(s_history[m - 1], y_history[m - 1]) /
+          Dot(y_history[m - 1], y_history[m - 1]);
+      for (size_t i = 0; i < q.size(); i++) q[i] *= gamma;
+    }
+    for (size_t j = 0; j < m; j++) {
+      double beta = rho_history[j] * Dot(y_history[j], q);
+      for (size_t i = 0; i < q.size(); i++) {
+        q[i] += s_history[j][i] * (alpha[j] - beta);
+      }
+    }
+    d.resize(g.size());
+    for (size_t i = 0; i < g.size(); i++) {
+      // keep variables at an active bound fixed
+      d[i] = (g[i] == 0.0) ? 0.0 : -q[i];
+    }
+  }
+
+  /**
+   * @brief Zeroes the gradient of variables held at a bound.
+   *
+   * @return The largest absolute projected gradient.
+   */
+  double ProjectedGradient(const std::vector<double> &x,
+                           const std::vector<double> &g,
+                           const std::vector<double> &lower,
+                           const std::vector<double> &upper,
+                           std::vector<double> &pg) {
+    double max_pg = 0.0;
+    pg.resize(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+      pg[i] = g[i];
+      if ((x[i] <= lower[i] && g[i] > 0.0) ||
+          (x[i] >= upper[i] && g[i] < 0.0)) {
+        pg[i] = 0.0;
+      }
+      max_pg = std::max(max_pg, std::fabs(pg[i]));
+    }
+    return max_pg;
+  }
+
+  /**
+   * @brief Moves x inside the bounds.
+   */
+  void Project(std::vector<double> &x, const std::vector<double> &lower,
+               const std::vector<double> &upper) {
+    for (size_t i = 0; i < x.size(); i++) {
+      x[i] = std::min(std::max(x[i], lower[i]), upper[i]);
+    }
+  }
+
+  /**
+   * @brief Dot product.
+   */
+  static double Dot(const std::vector<double> &a,
+                    const std::vector<double> &b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+  }
+};
+
+}  // namespace fims
+
+#endif /* FIMS_OPTIMIZER_HPP */
@@ -0,0 +1,157 @@
+#ifndef FIMS_THREAD_POOL_HPP
+#define FIMS_THREAD_POOL_HPP
+
+/**
+ * @file fims_thread_pool.hpp
+ * @brief A fixed-size pool of worker threads.
+ * @details Used to run independent double-precision tasks, e.g., projection
+ * replicates, concurrently. Tasks must not touch R or the FIMS log.
+ * @copyright This file is part of the NOAA, National Marine Fisheries Service
+ * Fisheries Integrated Modeling System project. See LICENSE in the source
+ * folder for reuse information.
+ */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace fims {
+
+/**
+ * @brief A fixed-size pool of worker threads with a FIFO task queue.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Constructor.
+   *
+   * @param nthreads The number of workers. If zero, the number of hardware
+   * threads is used.
+   */
+  explicit ThreadPool(size_t nthreads = 0) {
+    if (nthreads == 0) {
+      nthreads = ThreadPool::DefaultThreads();
+    }
+    for (size_t i = 0; i < nthreads; i++) {
+      this->workers.emplace_back([this]() { this->WorkerLoop(); });
+    }
+  }
+
+  /**
+   * @brief Destructor. Finishes the queued tasks and joins the workers.
+   */
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->stopping = true;
+    }
+    this->condition.notify_all();
+    for (size_t i = 0; i < this->workers.size(); i++) {
+      this->workers[i].join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief The number of workers.
+   */
+  size_t Size() const { return this->workers.size(); }
+
+  /**
+   * @brief The number of hardware threads, or one if it is unknown.
+   */
+  static size_t DefaultThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  /**
+   * @brief Queues a task.
+   *
+   * @param task The task.
+   * @return A future that becomes ready when the task finishes. Exceptions
+   * thrown by the task are rethrown by std::future::get().
+   */
+  template <typename F>
+  auto Submit(F task) -> std::future<decltype(task())> {
+    typedef decltype(task()) result_type;
+    std::shared_ptr<std::packaged_task<result_type()>> packaged =
+        std::make_shared<std::packaged_task<result_type()>>(task);
+    std::future<result_type> result = packaged->get_future();
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->tasks.push([packaged]() { (*packaged)(); });
+    }
+    this->condition.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Calls body(i) for i in [0, n) on the workers and waits for all of
+   * them. Indices are handed out one at a time, so the assignment of indices
+   * to threads does not affect the results as long as each call only writes
+   * to storage owned by its index.
+   *
+   * @param n The number of indices.
+   * @param body The function to call.
+   */
+  void ParallelFor(size_t n, const std::function<void(size_t)> &body) {
+    std::shared_ptr<std::atomic<size_t>> next =
+        std::make_shared<std::atomic<size_t>>(0);
+    size_t ntasks = std::min(n, this->Size());
+    std::vector<std::future<void>> done;
+    for (size_t t = 0; t < ntasks; t++) {
+      done.push_back(this->Submit([next, n, &body]() {
+        for (size_t i = (*next)++; i < n; i = (*next)++) {
+          body(i);
+        }
+      }));
+    }
+    // wait for every task before rethrowing so none outlives body
+    for (size_t t = 0; t < done.size(); t++) {
+      done[t].wait();
+    }
+    for (size_t t = 0; t < done.size(); t++) {
+      done[t].get();
+    }
+  }
+
+ private:
+  std::vector<std::thread> workers;        /**< the worker threads */
+  std::queue<std::function<void()>> tasks; /**< queued tasks */
+  std::mutex mutex;                        /**< guards tasks and stopping */
+  std::condition_variable condition;       /**< signals new tasks */
+  bool stopping = false;                   /**< true once shutting down */
+
+  /**
+   * @brief Runs tasks until the pool is stopped and the queue is empty.
+   */
+  void WorkerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->condition.wait(lock, [this]() {
+          return this->stopping || !this->tasks.empty();
+        });
+        if (this->stopping && this->tasks.empty()) {
+          return;
+        }
+        task = std::move(this->tasks.front());
+        this->tasks.pop();
+      }
+      task();
+    }
+  }
+};
+
+}  // namespace fims
+
+#endif /* FIMS_THREAD_POOL_HPP */
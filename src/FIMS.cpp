@@ -1,5 +1,6 @@
 
 #include <cmath>
+#include <mutex>
 
 #include "../inst/include/interface/rcpp/rcpp_interface.hpp"
 #include "../inst/include/interface/interface.hpp"
@@ -20,6 +21,15 @@ Type objective_function<Type>::operator()() {
     PARAMETER_VECTOR(p);
     PARAMETER_VECTOR(re);
 
+#ifdef _OPENMP
+    // Information and Model are shared by all threads, so TMB's parallel
+    // regions are taped one at a time. The tapes are still evaluated in
+    // parallel, but each one repeats the population dynamics and only the
+    // likelihood terms are split between them, see Model::Evaluate().
+    static std::mutex tape_mutex;
+    std::lock_guard<std::mutex> tape_lock(tape_mutex);
+#endif
+
     // code below copied from ModularTMBExample/src/tmb_objective_function.cpp
 
     // get the singleton instance for Model Class
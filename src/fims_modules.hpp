@@ -54,6 +54,9 @@ RCPP_MODULE(fims) {
   Rcpp::function("finalize", &finalize_fims,
                  "Extracts the derived quantities from `Information` to the "
                  "Rcpp object and returns a JSON string as the output.");
+  Rcpp::function("get_output_tables", &get_output_tables,
+                 "Gets the estimates, derived quantities, and fits as "
+                 "column-oriented tables instead of JSON.");
   Rcpp::function("get_fixed", &get_fixed_parameters_vector,
                  "Gets the fixed parameters vector object.");
   Rcpp::function("get_random", &get_random_parameters_vector,
@@ -62,6 +65,35 @@ RCPP_MODULE(fims) {
                  "Gets the parameter names object.");
   Rcpp::function("get_random_names", &get_random_names,
                  "Gets the random effects names object.");
+  Rcpp::function("update_data", update_data,
+                 "Replaces the observed values of a data object on an "
+                 "existing model.");
+  Rcpp::function("update_fixed", update_fixed,
+                 "Replaces the starting values of the fixed effects on an "
+                 "existing model.");
+  Rcpp::function("update_random", update_random,
+                 "Replaces the starting values of the random effects on an "
+                 "existing model.");
+  Rcpp::function("get_structure_hash", get_structure_hash,
+                 "Gets a hash of the model structure.");
+  Rcpp::function("get_memory_report", get_memory_report,
+                 "Gets the bytes held by each module, derived quantity, and "
+                 "data object of each Information instance.");
+  Rcpp::function("optimize_fims", optimize_fims,
+                 Rcpp::List::create(Rcpp::_["par"], Rcpp::_["lower"],
+                                    Rcpp::_["upper"], Rcpp::_["control"],
+                                    Rcpp::_["gr"] = R_NilValue),
+                 "Minimizes the objective function of the double version of "
+                 "the model in C++.");
+  Rcpp::function("run_retrospective", run_retrospective,
+                 Rcpp::List::create(Rcpp::_["npeels"], Rcpp::_["control"],
+                                    Rcpp::_["gr"] = R_NilValue,
+                                    Rcpp::_["retape"] = R_NilValue),
+                 "Runs a retrospective analysis on the double version of the "
+                 "model.");
+  Rcpp::function("set_n_threads", set_n_threads,
+                 "Sets the number of threads used to evaluate the double "
+                 "version of the model.");
   Rcpp::function("clear", clear,
                  "Clears all pointers/references of a FIMS model");
   Rcpp::function("get_log", get_log,
@@ -245,6 +277,7 @@ RCPP_MODULE(fims) {
       .field("observed_landings_units",
              &FleetInterface::observed_landings_units)
       .field("observed_index_units", &FleetInterface::observed_index_units)
+      .field("hybrid_F", &FleetInterface::hybrid_F)
       .field("index_expected", &FleetInterface::derived_index_expected)
       .field("landings_expected", &FleetInterface::derived_landings_expected)
       .field("log_index_expected", &FleetInterface::log_index_expected)
@@ -302,6 +335,10 @@ RCPP_MODULE(fims) {
       .field("nlengths", &PopulationInterface::nlengths, "number of lengths")
       .field("log_M", &PopulationInterface::log_M,
              "natural log of the natural mortality of the population")
+      .field("M_structure", &PopulationInterface::M_structure,
+             "how log_M varies: constant, age, year, block, or full")
+      .field("M_year_blocks", &PopulationInterface::M_year_blocks,
+             "block of each year when M_structure is block")
       .field("log_init_naa", &PopulationInterface::log_init_naa,
              "natural log of the initial numbers at age")
       .field("log_init_depletion", &PopulationInterface::log_init_depletion,
@@ -370,6 +407,8 @@ RCPP_MODULE(fims) {
       .field("ages", &EWAAGrowthInterface::ages, "Ages for each age class.")
       .field("weights", &EWAAGrowthInterface::weights,
              "Weights for each age class.")
+      .field("weights_at_year", &EWAAGrowthInterface::weights_at_year,
+             "Weights for each year and age class, ordered by age within year.")
       .method("get_id", &EWAAGrowthInterface::get_id)
       .method("evaluate", &EWAAGrowthInterface::evaluate);
 
@@ -464,9 +503,24 @@ RCPP_MODULE(fims) {
   Rcpp::class_<CatchAtAgeInterface>("CatchAtAge")
       .constructor()
       .method("AddPopulation", &CatchAtAgeInterface::AddPopulation)
+      .method("SetReportQuantities", &CatchAtAgeInterface::SetReportQuantities,
+              "Names of the derived quantities to report with standard errors")
       .method("get_output", &CatchAtAgeInterface::to_json)
+      .field("do_reference_points", &CatchAtAgeInterface::do_reference_points,
+             "If true, reference points are reported with standard errors")
+      .field("spr_targets", &CatchAtAgeInterface::spr_targets,
+             "Target spawning potential ratios for SPR-based reference points")
+      .field("use_atomic_kernels", &CatchAtAgeInterface::use_atomic_kernels,
+             "If true, population projection kernels are atomic tape operations")
+      .field("checkpoint_years", &CatchAtAgeInterface::checkpoint_years,
+             "Years per checkpointed block of the population recursion")
+      .field("static_dispatch", &CatchAtAgeInterface::static_dispatch,
+             "If true, population modules are evaluated without virtual calls")
       .method("calculate_reference_points",
-              &CatchAtAgeInterface::calculate_reference_points);
+              &CatchAtAgeInterface::calculate_reference_points)
+      .method("calculate_reference_points_allocations",
+              &CatchAtAgeInterface::calculate_reference_points_allocations)
+      .method("project", &CatchAtAgeInterface::project);
 
   Rcpp::class_<SurplusProductionInterface>("SurplusProduction")
       .constructor()
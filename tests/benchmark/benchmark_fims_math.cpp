@@ -0,0 +1,173 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "common/fims_math.hpp"
+#include "population_dynamics/maturity/functors/logistic.hpp"
+#include "population_dynamics/selectivity/functors/double_logistic.hpp"
+#include "population_dynamics/selectivity/functors/logistic.hpp"
+
+namespace
+{
+  // Ages 1, 2, ..., n as the independent variable
+  fims::Vector<double> MakeAges(size_t n)
+  {
+    fims::Vector<double> ages(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      ages[i] = static_cast<double>(i + 1);
+    }
+    return ages;
+  }
+
+  // Scalar fims_math::logistic, one call per age
+  void BM_LogisticScalar(benchmark::State &state)
+  {
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    std::vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      for (size_t i = 0; i < ages.size(); i++)
+      {
+        out[i] = fims_math::logistic(6.0, 0.7, ages[i]);
+      }
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_LogisticScalar)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Batched fims_math::logistic over all ages
+  void BM_LogisticBatched(benchmark::State &state)
+  {
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    std::vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      fims_math::logistic(6.0, 0.7, ages.data(), out.data(), ages.size());
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_LogisticBatched)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Selectivity the way the population loops call it: one virtual call per age
+  void BM_SelectivityEvaluate(benchmark::State &state)
+  {
+    auto selectivity =
+        std::make_shared<fims_popdy::LogisticSelectivity<double>>();
+    selectivity->inflection_point.resize(1);
+    selectivity->inflection_point[0] = 6.0;
+    selectivity->slope.resize(1);
+    selectivity->slope[0] = 0.7;
+    std::shared_ptr<fims_popdy::SelectivityBase<double>> base = selectivity;
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    fims::Vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      for (size_t i = 0; i < ages.size(); i++)
+      {
+        out[i] = base->evaluate(ages[i]);
+      }
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_SelectivityEvaluate)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Selectivity with one virtual call for all ages
+  void BM_SelectivityEvaluateAll(benchmark::State &state)
+  {
+    auto selectivity =
+        std::make_shared<fims_popdy::LogisticSelectivity<double>>();
+    selectivity->inflection_point.resize(1);
+    selectivity->inflection_point[0] = 6.0;
+    selectivity->slope.resize(1);
+    selectivity->slope[0] = 0.7;
+    std::shared_ptr<fims_popdy::SelectivityBase<double>> base = selectivity;
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    fims::Vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      base->evaluate_all(ages, out);
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_SelectivityEvaluateAll)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Double logistic selectivity, one virtual call per age
+  void BM_DoubleLogisticEvaluate(benchmark::State &state)
+  {
+    auto selectivity =
+        std::make_shared<fims_popdy::DoubleLogisticSelectivity<double>>();
+    selectivity->inflection_point_asc = fims::Vector<double>(1, 4.0);
+    selectivity->slope_asc = fims::Vector<double>(1, 1.2);
+    selectivity->inflection_point_desc = fims::Vector<double>(1, 12.0);
+    selectivity->slope_desc = fims::Vector<double>(1, 0.5);
+    std::shared_ptr<fims_popdy::SelectivityBase<double>> base = selectivity;
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    fims::Vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      for (size_t i = 0; i < ages.size(); i++)
+      {
+        out[i] = base->evaluate(ages[i]);
+      }
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_DoubleLogisticEvaluate)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Double logistic selectivity with one virtual call for all ages
+  void BM_DoubleLogisticEvaluateAll(benchmark::State &state)
+  {
+    auto selectivity =
+        std::make_shared<fims_popdy::DoubleLogisticSelectivity<double>>();
+    selectivity->inflection_point_asc = fims::Vector<double>(1, 4.0);
+    selectivity->slope_asc = fims::Vector<double>(1, 1.2);
+    selectivity->inflection_point_desc = fims::Vector<double>(1, 12.0);
+    selectivity->slope_desc = fims::Vector<double>(1, 0.5);
+    std::shared_ptr<fims_popdy::SelectivityBase<double>> base = selectivity;
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    fims::Vector<double> out(ages.size());
+    for (auto _ : state)
+    {
+      base->evaluate_all(ages, out);
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_DoubleLogisticEvaluateAll)->Arg(20)->Arg(100)->Arg(1000);
+
+  // Maturity, one virtual call per age and all ages at once
+  void BM_MaturityEvaluateAll(benchmark::State &state)
+  {
+    auto maturity = std::make_shared<fims_popdy::LogisticMaturity<double>>();
+    maturity->inflection_point = fims::Vector<double>(1, 5.0);
+    maturity->slope = fims::Vector<double>(1, 0.9);
+    std::shared_ptr<fims_popdy::MaturityBase<double>> base = maturity;
+    fims::Vector<double> ages = MakeAges(state.range(0));
+    fims::Vector<double> out(ages.size());
+    bool batched = state.range(1) != 0;
+    for (auto _ : state)
+    {
+      if (batched)
+      {
+        base->evaluate_all(ages, out);
+      }
+      else
+      {
+        for (size_t i = 0; i < ages.size(); i++)
+        {
+          out[i] = base->evaluate(ages[i]);
+        }
+      }
+      benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * ages.size());
+  }
+  BENCHMARK(BM_MaturityEvaluateAll)->ArgsProduct({{20, 100, 1000}, {0, 1}});
+}
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "common/model.hpp"
+
+namespace
+{
+  // A catch-at-age model with one population, nfleets fleets, and the FIMS
+  // selectivity, maturity, growth, and recruitment functors
+  std::shared_ptr<fims_popdy::CatchAtAge<double>> MakeModel(size_t nyears,
+                                                            size_t nages,
+                                                            size_t nfleets)
+  {
+    auto model = std::make_shared<fims_popdy::CatchAtAge<double>>();
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double>>> fleets;
+    for (size_t f = 0; f < nfleets; f++)
+    {
+      auto fleet = std::make_shared<fims_popdy::Fleet<double>>();
+      fleet->nyears = nyears;
+      fleet->nages = nages;
+      fleet->nlengths = 0;
+      fleet->log_q = fims::Vector<double>(1, std::log(0.5));
+      fleet->log_Fmort = fims::Vector<double>(nyears, std::log(0.2));
+      auto selectivity =
+          std::make_shared<fims_popdy::LogisticSelectivity<double>>();
+      selectivity->inflection_point = fims::Vector<double>(1, 3.0 + f);
+      selectivity->slope = fims::Vector<double>(1, 1.0);
+      fleet->selectivity = selectivity;
+      fleets.push_back(fleet);
+      model->fleets[fleet->GetId()] = fleet;
+    }
+
+    auto population = std::make_shared<fims_popdy::Population<double>>();
+    population->nyears = nyears;
+    population->nages = nages;
+    population->nfleets = nfleets;
+    population->fleets = fleets;
+    population->ages.resize(nages);
+    population->log_init_naa.resize(nages);
+    population->log_M = fims::Vector<double>(nyears * nages, std::log(0.2));
+    auto growth = std::make_shared<fims_popdy::EWAAgrowth<double>>();
+    for (size_t a = 0; a < nages; a++)
+    {
+      population->ages[a] = a + 1;
+      population->log_init_naa[a] = std::log(1000.0) - 0.3 * a;
+      growth->ewaa[a + 1] = 0.1 * (a + 1);
+    }
+    population->growth = growth;
+
+    auto maturity = std::make_shared<fims_popdy::LogisticMaturity<double>>();
+    maturity->inflection_point = fims::Vector<double>(1, 3.0);
+    maturity->slope = fims::Vector<double>(1, 1.5);
+    population->maturity = maturity;
+
+    auto recruitment = std::make_shared<fims_popdy::SRBevertonHolt<double>>();
+    auto log_devs = std::make_shared<fims_popdy::LogDevs<double>>();
+    recruitment->process = log_devs;
+    recruitment->process->recruitment = recruitment;
+    recruitment->logit_steep =
+        fims::Vector<double>(1, fims_math::logit(0.2, 1.0, 0.75));
+    recruitment->log_rzero = fims::Vector<double>(1, std::log(1000.0));
+    recruitment->log_recruit_devs = fims::Vector<double>(nyears - 1, 0.0);
+    recruitment->log_expected_recruitment.resize(nyears + 1);
+    population->recruitment = recruitment;
+
+    model->populations.push_back(population);
+    model->Initialize();
+    return model;
+  }
+
+  // Full evaluations with the modules called through the base classes (0) or
+  // resolved to their concrete types (1)
+  void BM_CatchAtAgeEvaluate(benchmark::State &state)
+  {
+    std::shared_ptr<fims_popdy::CatchAtAge<double>> model =
+        MakeModel(state.range(0), 20, 4);
+    model->static_dispatch = state.range(1) != 0;
+    model->ResolveModules();
+    for (auto _ : state)
+    {
+      model->Evaluate();
+      benchmark::ClobberMemory();
+    }
+  }
+  BENCHMARK(BM_CatchAtAgeEvaluate)->ArgsProduct({{30, 100}, {0, 1}});
+}
@@ -39,6 +39,28 @@ namespace
   
   }
 
+  // Batched evaluation matches evaluate(x) at every age, including through
+  // the default loop of the base class
+  TEST(LogisticSelectivity_Evaluate, EvaluateAllMatchesEvaluate) {
+    fims_popdy::LogisticSelectivity<double> fishery_selectivity;
+    fishery_selectivity.inflection_point.resize(1);
+    fishery_selectivity.slope.resize(1);
+    fishery_selectivity.inflection_point[0] = 4.5;
+    fishery_selectivity.slope[0] = 1.1;
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0, 3.0, 5.0, 8.0, 12.0});
+
+    fims::Vector<double> batched;
+    fishery_selectivity.evaluate_all(ages, batched);
+    fims::Vector<double> looped;
+    fishery_selectivity.fims_popdy::SelectivityBase<double>::evaluate_all(ages, looped);
+
+    ASSERT_EQ(batched.size(), ages.size());
+    for (size_t i = 0; i < ages.size(); i++) {
+      EXPECT_NEAR(batched[i], fishery_selectivity.evaluate(ages[i]), 1e-15);
+      EXPECT_NEAR(looped[i], batched[i], 1e-15);
+    }
+  }
+
   // Edge handling 
   // No edge cases.
 
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "common/age_year_layout.hpp"
+#include "common/information.hpp"
+
+namespace
+{
+  // Test that each structure has the expected number of distinct values
+  TEST(AgeYearLayout, SizeOfEachStructure)
+  {
+    fims::AgeYearLayout layout;
+    layout.year_block = {0, 0, 1, 1, 1};
+    layout.Resize(5, 3);
+    layout.structure = fims::AgeYearConstant;
+    EXPECT_EQ(layout.Size(), 1u);
+    layout.structure = fims::AgeYearAge;
+    EXPECT_EQ(layout.Size(), 3u);
+    layout.structure = fims::AgeYearYear;
+    EXPECT_EQ(layout.Size(), 5u);
+    layout.structure = fims::AgeYearBlock;
+    EXPECT_EQ(layout.nblocks, 2u);
+    EXPECT_EQ(layout.Size(), 6u);
+    layout.structure = fims::AgeYearFull;
+    EXPECT_EQ(layout.Size(), 15u);
+  }
+
+  // Test that Broadcast() copies each distinct value to the years and ages
+  // it applies to
+  TEST(AgeYearLayout, BroadcastFillsFullMatrix)
+  {
+    fims::AgeYearLayout layout;
+    layout.structure = fims::AgeYearBlock;
+    layout.year_block = {0, 0, 1};
+    layout.Resize(3, 2);
+    ASSERT_TRUE(layout.IsValid());
+    std::vector<double> distinct = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> full(6);
+    layout.Broadcast(distinct, full);
+    std::vector<double> expected = {1.0, 2.0, 1.0, 2.0, 3.0, 4.0};
+    EXPECT_EQ(full, expected);
+
+    layout.structure = fims::AgeYearAge;
+    layout.Broadcast(distinct, full);
+    expected = {1.0, 2.0, 1.0, 2.0, 1.0, 2.0};
+    EXPECT_EQ(full, expected);
+
+    layout.structure = fims::AgeYearYear;
+    layout.Broadcast(distinct, full);
+    expected = {1.0, 1.0, 2.0, 2.0, 3.0, 3.0};
+    EXPECT_EQ(full, expected);
+  }
+
+  // Test that FirstYear() finds the first year a distinct value is used in
+  TEST(AgeYearLayout, FirstYearOfDistinctValue)
+  {
+    fims::AgeYearLayout layout;
+    layout.year_block = {0, 0, 1, 1};
+    layout.Resize(4, 3);
+    layout.structure = fims::AgeYearConstant;
+    EXPECT_EQ(layout.FirstYear(0), 0u);
+    layout.structure = fims::AgeYearAge;
+    EXPECT_EQ(layout.FirstYear(2), 0u);
+    layout.structure = fims::AgeYearYear;
+    EXPECT_EQ(layout.FirstYear(2), 2u);
+    layout.structure = fims::AgeYearBlock;
+    EXPECT_EQ(layout.FirstYear(4), 2u);
+    layout.structure = fims::AgeYearFull;
+    EXPECT_EQ(layout.FirstYear(7), 2u);
+  }
+
+  // Test that the structures are read from their names and that blocks must
+  // cover each year
+  TEST(AgeYearLayout, ParseAndValidate)
+  {
+    fims::AgeYearStructure structure = fims::AgeYearFull;
+    EXPECT_TRUE(fims::AgeYearLayout::Parse("constant", structure));
+    EXPECT_EQ(structure, fims::AgeYearConstant);
+    EXPECT_TRUE(fims::AgeYearLayout::Parse("block", structure));
+    EXPECT_EQ(structure, fims::AgeYearBlock);
+    EXPECT_FALSE(fims::AgeYearLayout::Parse("by_age", structure));
+    EXPECT_EQ(structure, fims::AgeYearBlock);
+
+    fims::AgeYearLayout layout;
+    layout.structure = fims::AgeYearBlock;
+    layout.year_block = {0, 1};
+    layout.Resize(3, 2);
+    EXPECT_FALSE(layout.IsValid());
+    layout.structure = fims::AgeYearYear;
+    EXPECT_TRUE(layout.IsValid());
+    layout.readable = false;
+    EXPECT_FALSE(layout.IsValid());
+  }
+
+  // Test that a natural mortality layout that could not be read invalidates
+  // the model
+  TEST(AgeYearLayout, UnreadableLayoutInvalidatesModel)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    std::shared_ptr<fims_popdy::Population<double> > population =
+      std::make_shared<fims_popdy::Population<double> >();
+    population->nyears = 3;
+    population->nages = 2;
+    population->M_layout.structure = fims::AgeYearConstant;
+    population->log_M.resize(1);
+
+    bool valid_model = true;
+    info->SetNaturalMortality(valid_model, population);
+    EXPECT_TRUE(valid_model);
+
+    population->M_layout.readable = false;
+    info->SetNaturalMortality(valid_model, population);
+    EXPECT_FALSE(valid_model);
+
+    info->Clear();
+  }
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include "common/banded_matrix.hpp"
+
+namespace
+{
+  // An age-length key with 4 ages and 6 length bins where each age spans two
+  // or three bins
+  fims::Vector<double> MakeKey()
+  {
+    fims::Vector<double> key(4 * 6, 0.0);
+    key[0 * 6 + 0] = 0.7;
+    key[0 * 6 + 1] = 0.3;
+    key[1 * 6 + 1] = 0.2;
+    key[1 * 6 + 2] = 0.6;
+    key[1 * 6 + 3] = 0.2;
+    key[2 * 6 + 3] = 0.5;
+    key[2 * 6 + 4] = 0.5;
+    key[3 * 6 + 4] = 0.4;
+    key[3 * 6 + 5] = 0.6;
+    return key;
+  }
+
+  // Test that only the band of nonzero bins of each age is stored
+  TEST(BandedMatrix, StoresNonzeroBand)
+  {
+    fims::Vector<double> key = MakeKey();
+    fims::BandedMatrix<double> banded(key, 4, 6);
+    EXPECT_EQ(banded.values.size(), 9);
+    EXPECT_EQ(banded.band[1].first, 1);
+    EXPECT_EQ(banded.band[1].second, 4);
+    EXPECT_DOUBLE_EQ(banded.Density(), 9.0 / 24.0);
+    EXPECT_TRUE(banded.HasShape(4, 6));
+  }
+
+  // Test that an estimated element stays in the band even though it starts
+  // at zero, so a later value is picked up by Update()
+  TEST(BandedMatrix, KeepsEstimatedZeros)
+  {
+    fims::Vector<double> key = MakeKey();
+    std::set<const double *> estimated;
+    estimated.insert(&key[0 * 6 + 3]);
+    fims::BandedMatrix<double> banded(key, 4, 6, estimated);
+    EXPECT_EQ(banded.band[0].second, 4);
+    EXPECT_EQ(banded.values.size(), 11);
+
+    key[0 * 6 + 3] = 0.1;
+    banded.Update(key);
+    EXPECT_DOUBLE_EQ(banded.values[banded.offset[0] + 3], 0.1);
+  }
+
+  // Test that the banded product matches the dense triple loop
+  TEST(BandedMatrix, MultiplyAddMatchesDense)
+  {
+    fims::Vector<double> key = MakeKey();
+    fims::BandedMatrix<double> banded(key, 4, 6);
+    size_t nyears = 5;
+    std::vector<double> numbers(nyears * 4);
+    for (size_t i = 0; i < numbers.size(); i++)
+    {
+      numbers[i] = 100.0 + 10.0 * std::cos(static_cast<double>(i));
+    }
+
+    std::vector<double> expected(nyears * 6, 0.0);
+    for (size_t y = 0; y < nyears; y++)
+    {
+      for (size_t l = 0; l < 6; l++)
+      {
+        for (size_t a = 0; a < 4; a++)
+        {
+          expected[y * 6 + l] += numbers[y * 4 + a] * key[a * 6 + l];
+        }
+      }
+    }
+
+    std::vector<double> at_length(nyears * 6, 0.0);
+    banded.MultiplyAdd(numbers.data(), at_length.data(), nyears);
+    for (size_t i = 0; i < at_length.size(); i++)
+    {
+      EXPECT_NEAR(at_length[i], expected[i], 1e-12);
+    }
+  }
+}
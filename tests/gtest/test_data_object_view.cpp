@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "common/data_object.hpp"
+
+namespace
+{
+  // Makes a data object with the values 0, 1, 2, ... in row-major order
+  fims_data_object::DataObject<double> MakeData(size_t imax, size_t jmax)
+  {
+    fims_data_object::DataObject<double> d(imax, jmax);
+    std::vector<double> values(imax * jmax);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      values[i] = static_cast<double>(i);
+    }
+    d.data.SetBuffer(std::make_shared<fims::SharedData>(values));
+    return d;
+  }
+
+  // Test that a 2d view reads the same values as the data object and that
+  // its rows are contiguous
+  TEST(DataObjectView, RowsAreContiguous)
+  {
+    fims_data_object::DataObject<double> d = MakeData(4, 3);
+    fims_data_object::DataView<double, 2> v = fims_data_object::view<2>(d);
+    EXPECT_EQ(v.extent(0), 4u);
+    EXPECT_EQ(v.extent(1), 3u);
+    EXPECT_EQ(v.size(), 12u);
+    for (size_t i = 0; i < 4; i++)
+    {
+      fims::Span<const double> row = v.row(i);
+      ASSERT_EQ(row.size(), 3u);
+      for (size_t j = 0; j < 3; j++)
+      {
+        EXPECT_EQ(v(i, j), d.at(i, j));
+        EXPECT_EQ(row[j], d(i, j));
+        EXPECT_EQ(&row[j], &v.span()[i * 3 + j]);
+      }
+    }
+  }
+
+  // Test that a view with fewer dimensions than the data folds the leading
+  // dimensions, and one with more puts the data in the last ones
+  TEST(DataObjectView, FoldsDimensions)
+  {
+    fims_data_object::DataObject<double> d = MakeData(4, 3);
+    fims_data_object::DataView<double, 1> flat = fims_data_object::view<1>(d);
+    EXPECT_EQ(flat.extent(0), 12u);
+    EXPECT_EQ(flat(7), 7.0);
+
+    fims_data_object::DataView<double, 3> cube = fims_data_object::view<3>(d);
+    EXPECT_EQ(cube.extent(0), 1u);
+    EXPECT_EQ(cube.extent(1), 4u);
+    EXPECT_EQ(cube.extent(2), 3u);
+    EXPECT_EQ(cube(0, 2, 1), 7.0);
+  }
+
+  // Test that checked access throws out of bounds while at() is always
+  // checked
+  TEST(DataObjectView, CheckedAccessThrows)
+  {
+    fims_data_object::DataObject<double> d = MakeData(4, 3);
+    fims_data_object::DataView<double, 2, fims_data_object::CheckedAccess> v =
+      fims_data_object::view<2, fims_data_object::CheckedAccess>(d);
+    EXPECT_EQ(v(3, 2), 11.0);
+    EXPECT_THROW(v(4, 0), std::overflow_error);
+    EXPECT_THROW(v(0, 3), std::overflow_error);
+    EXPECT_THROW(v.row(4), std::overflow_error);
+    EXPECT_THROW(d.at(4, 0), std::overflow_error);
+  }
+
+  // Test that a data object is valid only if its size matches its dimensions
+  TEST(DataObjectView, ValidatesSize)
+  {
+    fims_data_object::DataObject<double> d = MakeData(4, 3);
+    EXPECT_TRUE(d.IsValid());
+    d.data.resize(11);
+    EXPECT_FALSE(d.IsValid());
+  }
+}
@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+#include "common/fims_kernels.hpp"
+
+namespace
+{
+  // Central finite difference of output i with respect to input j
+  template <class Kernel>
+  double FiniteDifference(Kernel kernel, std::vector<double> x, size_t i,
+                          size_t j)
+  {
+    double h = 1e-6;
+    double xj = x[j];
+    x[j] = xj + h;
+    double up = kernel(x)[i];
+    x[j] = xj - h;
+    double down = kernel(x)[i];
+    return (up - down) / (2.0 * h);
+  }
+
+  // Test that the Baranov catch kernel matches the scalar catch equation
+  TEST(FimsKernels, BaranovCatchMatchesScalar)
+  {
+    std::vector<double> F = {0.1, 0.2, 0.4};
+    std::vector<double> Z = {0.3, 0.5, 0.9};
+    std::vector<double> N = {1000.0, 600.0, 250.0};
+    std::vector<double> tx;
+    tx.insert(tx.end(), F.begin(), F.end());
+    tx.insert(tx.end(), Z.begin(), Z.end());
+    tx.insert(tx.end(), N.begin(), N.end());
+
+    std::vector<double> catch_at_age = fims_math::baranov_catch(tx);
+    ASSERT_EQ(catch_at_age.size(), 3);
+    for (size_t a = 0; a < 3; a++)
+    {
+      EXPECT_DOUBLE_EQ(catch_at_age[a],
+                       F[a] / Z[a] * N[a] * (1.0 - std::exp(-Z[a])));
+    }
+  }
+
+  // Test that the survival step ages the numbers and keeps a plus group
+  TEST(FimsKernels, SurvivalStepMatchesScalar)
+  {
+    std::vector<double> tx = {1000.0, 600.0, 250.0, 0.3, 0.5, 0.9};
+    std::vector<double> next = fims_math::survival_step(tx);
+    ASSERT_EQ(next.size(), 2);
+    EXPECT_DOUBLE_EQ(next[0], 1000.0 * std::exp(-0.3));
+    EXPECT_DOUBLE_EQ(next[1],
+                     600.0 * std::exp(-0.5) + 250.0 * std::exp(-0.9));
+  }
+
+  // Test that a normalized composition sums to one
+  TEST(FimsKernels, NormalizeSumsToOne)
+  {
+    std::vector<double> tx = {2.0, 5.0, 3.0};
+    std::vector<double> ty = fims_math::normalize(tx);
+    EXPECT_DOUBLE_EQ(ty[0], 0.2);
+    EXPECT_DOUBLE_EQ(ty[1], 0.5);
+    EXPECT_DOUBLE_EQ(ty[2], 0.3);
+  }
+
+  // Test that the hand-coded reverse sweeps match finite differences
+  TEST(FimsKernels, ReverseMatchesFiniteDifferences)
+  {
+    std::vector<double> baranov_x = {0.1, 0.2, 0.4, 0.3, 0.5,
+                                     0.9, 10.0, 6.0, 2.5};
+    std::vector<double> survival_x = {10.0, 6.0, 2.5, 0.3, 0.5, 0.9};
+    std::vector<double> normalize_x = {2.0, 5.0, 3.0};
+
+    // one reverse sweep per output with a unit weight on that output
+    for (size_t i = 0; i < 3; i++)
+    {
+      std::vector<double> py(3, 0.0);
+      py[i] = 1.0;
+      std::vector<double> px(baranov_x.size());
+      fims_math::baranov_catch_reverse<double>(baranov_x, py, px);
+      for (size_t j = 0; j < baranov_x.size(); j++)
+      {
+        EXPECT_NEAR(px[j],
+                    FiniteDifference(fims_math::baranov_catch<double>,
+                                     baranov_x, i, j),
+                    1e-6);
+      }
+    }
+
+    for (size_t i = 0; i < 2; i++)
+    {
+      std::vector<double> py(2, 0.0);
+      py[i] = 1.0;
+      std::vector<double> px(survival_x.size());
+      fims_math::survival_step_reverse<double>(survival_x, py, px);
+      for (size_t j = 0; j < survival_x.size(); j++)
+      {
+        EXPECT_NEAR(px[j],
+                    FiniteDifference(fims_math::survival_step<double>,
+                                     survival_x, i, j),
+                    1e-6);
+      }
+    }
+
+    std::vector<double> ty = fims_math::normalize(normalize_x);
+    for (size_t i = 0; i < 3; i++)
+    {
+      std::vector<double> py(3, 0.0);
+      py[i] = 1.0;
+      std::vector<double> px(normalize_x.size());
+      fims_math::normalize_reverse<double>(normalize_x, ty, py, px);
+      for (size_t j = 0; j < normalize_x.size(); j++)
+      {
+        EXPECT_NEAR(px[j],
+                    FiniteDifference(fims_math::normalize<double>,
+                                     normalize_x, i, j),
+                    1e-6);
+      }
+    }
+  }
+
+  // Test that the nonzero columns of each row are found, including a row of
+  // zeros
+  TEST(FimsKernels, NonzeroColumnsFindsBand)
+  {
+    std::vector<double> b = {0.0, 0.5, 0.5, 0.0,
+                             0.0, 0.0, 0.0, 0.0,
+                             0.2, 0.0, 0.3, 0.5};
+    std::vector<std::pair<size_t, size_t> > band =
+      fims_math::nonzero_columns(b.data(), 3, 4);
+    EXPECT_EQ(band[0].first, 1);
+    EXPECT_EQ(band[0].second, 3);
+    EXPECT_EQ(band[1].first, band[1].second);
+    EXPECT_EQ(band[2].first, 0);
+    EXPECT_EQ(band[2].second, 4);
+  }
+
+  // Test that the tiled product with a banded right matrix matches the plain
+  // triple loop, with tiles that do not divide the dimensions
+  TEST(FimsKernels, TiledProductMatchesTripleLoop)
+  {
+    size_t nrows = 7;
+    size_t ninner = 9;
+    size_t ncols = 11;
+    std::vector<double> a(nrows * ninner);
+    std::vector<double> b(ninner * ncols, 0.0);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      a[i] = std::sin(static_cast<double>(i)) + 1.5;
+    }
+    for (size_t k = 0; k < ninner; k++)
+    {
+      for (size_t j = k; j < std::min(k + 3, ncols); j++)
+      {
+        b[k * ncols + j] = 0.1 * static_cast<double>(j - k + 1);
+      }
+    }
+
+    std::vector<double> expected(nrows * ncols, 1.0);
+    for (size_t i = 0; i < nrows; i++)
+    {
+      for (size_t j = 0; j < ncols; j++)
+      {
+        for (size_t k = 0; k < ninner; k++)
+        {
+          expected[i * ncols + j] += a[i * ninner + k] * b[k * ncols + j];
+        }
+      }
+    }
+
+    std::vector<std::pair<size_t, size_t> > band =
+      fims_math::nonzero_columns(b.data(), ninner, ncols);
+    for (size_t tile = 1; tile <= 12; tile += 4)
+    {
+      std::vector<double> c(nrows * ncols, 1.0);
+      fims_math::add_product(a.data(), b.data(), c.data(), nrows, ninner, ncols,
+                             band, tile);
+      for (size_t i = 0; i < c.size(); i++)
+      {
+        EXPECT_NEAR(c[i], expected[i], 1e-12);
+      }
+    }
+  }
+}
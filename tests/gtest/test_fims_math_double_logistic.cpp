@@ -25,4 +25,19 @@ namespace
     }
   }
 
-}
\ No newline at end of file
+  // Test that the batched double logistic matches the scalar function
+  TEST(DoubleLogistic, BatchedMatchesScalar)
+  {
+    std::vector<double> x = {1.0, 3.0, 5.0, 8.0, 10.0, 15.0};
+    std::vector<double> out(x.size());
+    fims_math::double_logistic(4.0, 1.2, 9.0, 0.6, x.data(), out.data(),
+                               x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      EXPECT_NEAR(out[i],
+                  fims_math::double_logistic(4.0, 1.2, 9.0, 0.6, x[i]),
+                  1e-15);
+    }
+  }
+
+}
@@ -36,4 +36,18 @@ namespace
         // need to round the output value before using it as expected true value
         EXPECT_EQ(fims_math::exp(3), 20);
     }
+
+    // Test that the batched exp matches the scalar exp, also in place
+    TEST(Exp, BatchedMatchesScalar)
+    {
+        std::vector<double> x = {-2.5, 0.0, 1.0, 3.0, 10.0};
+        std::vector<double> out(x.size());
+        fims_math::exp(x.data(), out.data(), x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            EXPECT_EQ(out[i], std::exp(x[i]));
+        }
+        fims_math::exp(x.data(), x.data(), x.size());
+        EXPECT_EQ(x, out);
+    }
 }
@@ -37,4 +37,15 @@ namespace
     EXPECT_TRUE(std::isnan(fims_math::log(-2.5)));
   }
 
+    // Test that the batched log matches the scalar log
+    TEST(Log, BatchedMatchesScalar)
+    {
+        std::vector<double> x = {0.1, 1.0, 2.5, 100.0};
+        std::vector<double> out(x.size());
+        fims_math::log(x.data(), out.data(), x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            EXPECT_EQ(out[i], std::log(x[i]));
+        }
+    }
 }
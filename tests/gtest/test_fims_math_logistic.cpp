@@ -23,4 +23,21 @@ namespace
     }
   }
 
-}
\ No newline at end of file
+  // Test that the batched logistic matches the scalar logistic for double and
+  // for a type that uses the generic loop
+  TEST(Logistic, BatchedMatchesScalar)
+  {
+    std::vector<double> x = {0.5, 1.0, 2.0, 3.5, 7.0, 12.0, 20.0};
+    std::vector<double> out(x.size());
+    fims_math::logistic(4.0, 0.8, x.data(), out.data(), x.size());
+    std::vector<long double> out_ld(x.size());
+    fims_math::logistic<long double>(4.0L, 0.8L, x.data(), out_ld.data(),
+                                     x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      EXPECT_NEAR(out[i], fims_math::logistic(4.0, 0.8, x[i]), 1e-15);
+      EXPECT_NEAR(static_cast<double>(out_ld[i]), out[i], 1e-15);
+    }
+  }
+
+}
@@ -68,4 +68,18 @@ namespace
 
   }
 
-}
\ No newline at end of file
+  // Test that the batched inverse logit matches the scalar function
+  TEST(InvLogit, BatchedMatchesScalar)
+  {
+    std::vector<double> logit_x = {-3.0, -0.5, 0.0, 0.7, 4.0};
+    std::vector<double> out(logit_x.size());
+    fims_math::inv_logit(-1.0, 2.0, logit_x.data(), out.data(),
+                         logit_x.size());
+    for (size_t i = 0; i < logit_x.size(); ++i)
+    {
+      EXPECT_NEAR(out[i], fims_math::inv_logit(-1.0, 2.0, logit_x[i]),
+                  1e-15);
+    }
+  }
+
+}
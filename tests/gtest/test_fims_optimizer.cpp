@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "utilities/fims_optimizer.hpp"
+
+namespace
+{
+  // Rosenbrock function with its analytical gradient
+  double Rosenbrock(const std::vector<double>& x)
+  {
+    return 100.0 * std::pow(x[1] - x[0] * x[0], 2) + std::pow(1.0 - x[0], 2);
+  }
+
+  void RosenbrockGradient(const std::vector<double>& x, std::vector<double>& g)
+  {
+    g[0] = -400.0 * x[0] * (x[1] - x[0] * x[0]) - 2.0 * (1.0 - x[0]);
+    g[1] = 200.0 * (x[1] - x[0] * x[0]);
+  }
+
+  TEST(Optimizer, MinimizesRosenbrockWithGradient)
+  {
+    fims::Optimizer optimizer(Rosenbrock, RosenbrockGradient);
+    std::vector<double> start = {-1.2, 1.0};
+    fims::OptimizerResult result = optimizer.Minimize(start);
+
+    EXPECT_EQ(result.convergence, 0);
+    EXPECT_NEAR(result.par[0], 1.0, 1e-4);
+    EXPECT_NEAR(result.par[1], 1.0, 1e-4);
+    EXPECT_NEAR(result.objective, 0.0, 1e-8);
+    EXPECT_GT(result.iterations, 0);
+    EXPECT_GE(result.function_evaluations, result.iterations);
+  }
+
+  TEST(Optimizer, MinimizesWithFiniteDifferences)
+  {
+    fims::Optimizer optimizer(Rosenbrock);
+    std::vector<double> start = {-1.2, 1.0};
+    fims::OptimizerResult result = optimizer.Minimize(start);
+
+    EXPECT_EQ(result.convergence, 0);
+    EXPECT_NEAR(result.par[0], 1.0, 1e-3);
+    EXPECT_NEAR(result.par[1], 1.0, 1e-3);
+  }
+
+  TEST(Optimizer, RespectsBounds)
+  {
+    // the unconstrained minimum is at (1, 1), outside the upper bound of x[0]
+    fims::Optimizer optimizer(Rosenbrock, RosenbrockGradient);
+    std::vector<double> start = {0.0, 0.0};
+    std::vector<double> lower = {-2.0, -2.0};
+    std::vector<double> upper = {0.5, 2.0};
+    fims::OptimizerResult result = optimizer.Minimize(start, lower, upper);
+
+    EXPECT_EQ(result.convergence, 0);
+    EXPECT_NEAR(result.par[0], 0.5, 1e-6);
+    EXPECT_NEAR(result.par[1], 0.25, 1e-4);
+    EXPECT_LE(result.max_gradient, 1e-3);
+  }
+
+  TEST(Optimizer, NewtonStepsReduceGradient)
+  {
+    fims::Optimizer optimizer(Rosenbrock, RosenbrockGradient);
+    optimizer.control.relative_tolerance = 1e-4;
+    std::vector<double> start = {-1.2, 1.0};
+    fims::OptimizerResult loose = optimizer.Minimize(start);
+
+    optimizer.control.newton_steps = 5;
+    fims::OptimizerResult refined = optimizer.Minimize(start);
+
+    EXPECT_LE(refined.objective, loose.objective);
+    EXPECT_LT(refined.max_gradient, loose.max_gradient);
+    EXPECT_NEAR(refined.par[0], 1.0, 1e-6);
+    EXPECT_NEAR(refined.par[1], 1.0, 1e-6);
+  }
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "common/fims_allocator.hpp"
+#include "common/fims_vector.hpp"
+
+namespace
+{
+  // Test that moving a vector takes over its storage instead of copying it
+  TEST(FimsVector, MoveKeepsStorage)
+  {
+    fims::Vector<double> x(std::vector<double>{1.0, 2.0, 3.0});
+    const double *storage = x.data();
+
+    fims::Vector<double> y(std::move(x));
+    EXPECT_EQ(y.data(), storage);
+    EXPECT_EQ(y.size(), 3u);
+
+    fims::Vector<double> z;
+    z = std::move(y);
+    EXPECT_EQ(z.data(), storage);
+    EXPECT_DOUBLE_EQ(z[2], 3.0);
+  }
+
+  // Test that a vector with std::allocator moves its storage to and from
+  // std::vector, and that the default allocator copies the elements
+  TEST(FimsVector, MoveToStdVector)
+  {
+    typedef fims::Vector<double, std::allocator<double> > heap_vector;
+    std::vector<double> u(std::vector<double>{1.0, 2.0, 3.0});
+    const double *storage = u.data();
+    heap_vector h(std::move(u));
+    EXPECT_EQ(h.data(), storage);
+    std::vector<double> v = std::move(h);
+    EXPECT_EQ(v.data(), storage);
+
+    fims::Vector<double> x(v);
+    storage = x.data();
+    std::vector<double> w = std::move(x);
+    EXPECT_NE(w.data(), storage);
+    EXPECT_EQ(w, v);
+  }
+
+  // Test that copies are independent of the original
+  TEST(FimsVector, CopyIsIndependent)
+  {
+    fims::Vector<double> x(3, 1.5);
+    fims::Vector<double> y(x);
+    y[0] = 2.0;
+    EXPECT_DOUBLE_EQ(x[0], 1.5);
+    EXPECT_DOUBLE_EQ(y[0], 2.0);
+
+    std::vector<double> v = x;
+    EXPECT_EQ(v.size(), 3u);
+    EXPECT_NE(v.data(), x.data());
+  }
+
+  // Test that spans view the elements of a vector without copying them
+  TEST(FimsVector, SpanViewsElements)
+  {
+    fims::Vector<double> x(std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    fims::Span<double> row = x.span(3, 3);
+    EXPECT_EQ(row.size(), 3u);
+    EXPECT_EQ(row.data(), x.data() + 3);
+    row[0] = 10.0;
+    EXPECT_DOUBLE_EQ(x[3], 10.0);
+
+    const fims::Vector<double> &cx = x;
+    fims::Span<const double> all = cx.span();
+    double sum = 0.0;
+    for (double value : all)
+    {
+      sum += value;
+    }
+    EXPECT_DOUBLE_EQ(sum, 1.0 + 2.0 + 3.0 + 10.0 + 5.0 + 6.0);
+
+    fims::Span<const double> tail = row.subspan(1, 2);
+    EXPECT_DOUBLE_EQ(tail[1], 6.0);
+  }
+
+  // Test that a vector with the aligned allocator starts on the alignment
+  TEST(FimsVector, AlignedAllocator)
+  {
+    typedef fims::Vector<double, fims::AlignedAllocator<double, 64> > aligned;
+    aligned x(100, 2.0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(x.data()) % 64, 0u);
+    EXPECT_DOUBLE_EQ(x[99], 2.0);
+
+    aligned y = x;
+    EXPECT_TRUE(y == x);
+    std::vector<double> v = y;
+    EXPECT_EQ(v.size(), 100u);
+  }
+
+  // Test that vectors constructed in an arena scope are laid out one after
+  // another in the arena, and other vectors and copies use the heap
+  TEST(FimsVector, ArenaScope)
+  {
+    std::shared_ptr<fims::Arena<double> > arena =
+      std::make_shared<fims::Arena<double> >();
+    fims::Vector<double> outside(4, 1.0);
+    {
+      fims::ArenaScope<double> scope(arena);
+      fims::Vector<double> a(3, 1.0);
+      fims::Vector<double> b(5, 2.0);
+      EXPECT_EQ(a.get_allocator().GetArena(), arena.get());
+      EXPECT_EQ(b.data(), a.data() + 3);
+      EXPECT_EQ(arena->Size(), 8u);
+
+      arena->Fill(0.0);
+      EXPECT_DOUBLE_EQ(a[2], 0.0);
+      EXPECT_DOUBLE_EQ(b[4], 0.0);
+      outside = std::move(b);
+    }
+    EXPECT_EQ(outside.get_allocator().GetArena(), arena.get());
+    fims::Vector<double> copy(outside);
+    EXPECT_EQ(copy.get_allocator().GetArena(), nullptr);
+
+    // the arena lives as long as a vector in it
+    fims::Arena<double> *storage = arena.get();
+    arena.reset();
+    outside[0] = 3.0;
+    EXPECT_EQ(outside.get_allocator().GetArena(), storage);
+    EXPECT_DOUBLE_EQ(outside[0], 3.0);
+  }
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "population_dynamics/growth/functors/ewaa.hpp"
+#include "common/information.hpp"
 
 namespace
 {
@@ -51,4 +52,92 @@ namespace
     // this is zero because we are running it in a different test case than above
     EXPECT_EQ(ewaa2.GetId(), 0);
   }
+
+  // Test that Prepare() looks the weights up by age index and that ages
+  // missing from the map have a weight of zero
+  TEST(GrowthEvaluate, PrepareResolvesAgeIndex)
+  {
+    fims_popdy::EWAAgrowth<double> ewaa3;
+    ewaa3.ewaa =
+        std::map<double, double>{std::pair<double, double>(1.0, 0.5),
+                                 std::pair<double, double>(2.0, 1.5),
+                                 std::pair<double, double>(3.0, 2.5)};
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0, 3.0, 4.0});
+    ewaa3.Prepare(ages, 5);
+
+    EXPECT_FALSE(ewaa3.IsTimeVarying());
+    EXPECT_EQ(ewaa3.evaluate(0, 0), 0.5);
+    EXPECT_EQ(ewaa3.evaluate(4, 2), 2.5);
+    EXPECT_EQ(ewaa3.evaluate(2, 3), 0.0);
+  }
+
+  // Test that Prepare() records the ages without a weight instead of
+  // logging them, and that they are logged and cleared once
+  TEST(GrowthEvaluate, PrepareRecordsMissingAges)
+  {
+    fims_popdy::EWAAgrowth<double> ewaa5;
+    ewaa5.ewaa =
+        std::map<double, double>{std::pair<double, double>(1.0, 0.5)};
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0, 3.0});
+    ewaa5.Prepare(ages, 2);
+
+    ASSERT_EQ(ewaa5.missing_ages.size(), 2);
+    EXPECT_EQ(ewaa5.missing_ages[0], 2.0);
+    EXPECT_EQ(ewaa5.missing_ages[1], 3.0);
+
+    ewaa5.LogPrepareMessages();
+    EXPECT_TRUE(ewaa5.missing_ages.empty());
+    ewaa5.Prepare(ages, 2);
+    EXPECT_TRUE(ewaa5.missing_ages.empty());
+  }
+
+  // Test that weights by year are used when they are given, and that years
+  // past the last year use the last year
+  TEST(GrowthEvaluate, TimeVaryingWeights)
+  {
+    fims_popdy::EWAAgrowth<double> ewaa4;
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0});
+    ewaa4.weight_at_year_age = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+    ewaa4.Prepare(ages, 3);
+
+    EXPECT_TRUE(ewaa4.IsTimeVarying());
+    EXPECT_EQ(ewaa4.evaluate(0, 1), 0.2);
+    EXPECT_EQ(ewaa4.evaluate(1, 0), 0.3);
+    EXPECT_EQ(ewaa4.evaluate(2, 1), 0.6);
+    EXPECT_EQ(ewaa4.evaluate(3, 1), 0.6);
+  }
+
+  // Test that weights by year and age are valid only if there is one for
+  // each year and age, and that an invalid growth invalidates the model
+  TEST(GrowthEvaluate, WrongSizeWeightsInvalidateModel)
+  {
+    std::shared_ptr<fims_popdy::EWAAgrowth<double> > ewaa6 =
+        std::make_shared<fims_popdy::EWAAgrowth<double> >();
+    ewaa6->weight_at_year_age = {0.1, 0.2, 0.3, 0.4, 0.5};
+    EXPECT_FALSE(ewaa6->IsValid(3, 2));
+    EXPECT_TRUE(ewaa6->IsValid(5, 1));
+    fims_popdy::EWAAgrowth<double> ewaa7;
+    EXPECT_TRUE(ewaa7.IsValid(3, 2));
+
+    std::shared_ptr<fims_info::Information<double> > info =
+        fims_info::Information<double>::GetInstance();
+    info->Clear();
+    std::shared_ptr<fims_popdy::Population<double> > population =
+        std::make_shared<fims_popdy::Population<double> >();
+    population->nyears = 3;
+    population->nages = 2;
+    population->growth_id = ewaa6->GetId();
+    info->growth_models[ewaa6->GetId()] = ewaa6;
+
+    bool valid_model = true;
+    info->SetGrowth(valid_model, population);
+    EXPECT_FALSE(valid_model);
+
+    ewaa6->weight_at_year_age.push_back(0.6);
+    valid_model = true;
+    info->SetGrowth(valid_model, population);
+    EXPECT_TRUE(valid_model);
+
+    info->Clear();
+  }
 }
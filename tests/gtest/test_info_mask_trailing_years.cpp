@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "common/information.hpp"
+
+namespace
+{
+  // Test that only the trailing years of year-indexed data are masked
+  TEST(MaskTrailingYears, MasksYearIndexedData)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    info->SetNyears(4);
+
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(4);
+    std::shared_ptr<fims_data_object::DataObject<double> > agecomp =
+      std::make_shared<fims_data_object::DataObject<double> >(4, 3);
+    std::shared_ptr<fims_data_object::DataObject<double> > other =
+      std::make_shared<fims_data_object::DataObject<double> >(2);
+    for (size_t i = 0; i < index->data.size(); i++) index->data[i] = 1.0;
+    for (size_t i = 0; i < agecomp->data.size(); i++) agecomp->data[i] = 1.0;
+    for (size_t i = 0; i < other->data.size(); i++) other->data[i] = 1.0;
+    info->data_objects[1] = index;
+    info->data_objects[2] = agecomp;
+    info->data_objects[3] = other;
+
+    EXPECT_EQ(info->MaskTrailingYears(0), 0);
+    EXPECT_EQ(info->MaskTrailingYears(2), 2 + 2 * 3);
+
+    EXPECT_EQ(index->data[1], 1.0);
+    EXPECT_EQ(index->data[2], index->na_value);
+    EXPECT_EQ(index->data[3], index->na_value);
+    EXPECT_EQ(agecomp->at(1, 2), 1.0);
+    EXPECT_EQ(agecomp->at(2, 0), agecomp->na_value);
+    EXPECT_EQ(agecomp->at(3, 2), agecomp->na_value);
+    EXPECT_EQ(other->data[1], 1.0);
+
+    info->Clear();
+  }
+
+  // Test that the landings of a fleet with hybrid F are not masked, and that
+  // masking marks the data as changed
+  TEST(MaskTrailingYears, KeepsHybridFLandings)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    info->SetNyears(4);
+
+    std::shared_ptr<fims_data_object::DataObject<double> > landings =
+      std::make_shared<fims_data_object::DataObject<double> >(4);
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(4);
+    for (size_t i = 0; i < 4; i++) landings->data[i] = 1.0;
+    for (size_t i = 0; i < 4; i++) index->data[i] = 1.0;
+    info->data_objects[1] = landings;
+    info->data_objects[2] = index;
+    std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+      std::make_shared<fims_popdy::Fleet<double> >();
+    fleet->hybrid_F = true;
+    fleet->observed_landings_data = landings;
+    info->fleets[fleet->GetId()] = fleet;
+
+    size_t revision = info->data_revision;
+    EXPECT_EQ(info->MaskTrailingYears(2), 2);
+    EXPECT_EQ(landings->data[3], 1.0);
+    EXPECT_EQ(index->data[3], index->na_value);
+    EXPECT_GT(info->data_revision, revision);
+
+    info->Clear();
+  }
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include "common/information.hpp"
+
+namespace
+{
+  // Test that data values are swapped in place without changing the structure
+  TEST(UpdateDataObject, UpdatesValuesInPlace)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(3);
+    index->id = 1;
+    index->data[0] = 1.0;
+    index->data[1] = 2.0;
+    index->data[2] = 3.0;
+    info->data_objects[1] = index;
+
+    uint64_t hash = info->GetStructureHash();
+
+    std::vector<double> values = {4.0, 5.0, 6.0};
+    EXPECT_TRUE(info->UpdateDataObject(1, values));
+    EXPECT_EQ(info->data_objects[1].get(), index.get());
+    EXPECT_EQ(index->data[0], 4.0);
+    EXPECT_EQ(index->data[1], 5.0);
+    EXPECT_EQ(index->data[2], 6.0);
+    EXPECT_EQ(info->GetStructureHash(), hash);
+
+    // Wrong size and unknown id are rejected and leave the data untouched
+    std::vector<double> short_values = {7.0};
+    EXPECT_FALSE(info->UpdateDataObject(1, short_values));
+    EXPECT_FALSE(info->UpdateDataObject(2, values));
+    EXPECT_EQ(index->data[0], 4.0);
+
+    // A different data size is a different structure
+    std::shared_ptr<fims_data_object::DataObject<double> > landings =
+      std::make_shared<fims_data_object::DataObject<double> >(2);
+    landings->id = 2;
+    info->data_objects[2] = landings;
+    EXPECT_NE(info->GetStructureHash(), hash);
+
+    info->Clear();
+  }
+
+  // Test that parameter values are swapped through the stored pointers
+  TEST(UpdateParameters, UpdatesFixedAndRandomEffects)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+
+    double p1 = 0.0;
+    double p2 = 0.0;
+    double re1 = 0.0;
+    info->RegisterParameter(p1);
+    info->RegisterParameter(p2);
+    info->RegisterRandomEffect(re1);
+
+    std::vector<double> fixed = {1.5, -2.5};
+    std::vector<double> random = {0.25};
+    EXPECT_TRUE(info->UpdateFixedEffectsParameters(fixed));
+    EXPECT_TRUE(info->UpdateRandomEffectsParameters(random));
+    EXPECT_EQ(p1, 1.5);
+    EXPECT_EQ(p2, -2.5);
+    EXPECT_EQ(re1, 0.25);
+
+    EXPECT_FALSE(info->UpdateFixedEffectsParameters(random));
+    EXPECT_EQ(p1, 1.5);
+
+    info->Clear();
+  }
+
+  // Test that writing parameters marks the cached natural-scale values of
+  // the recruitment modules as out of date
+  TEST(UpdateParameters, ClearsTransformedRecruitment)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+
+    std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+      std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+    recruitment->logit_steep =
+      fims::Vector<double>(1, fims_math::logit(0.2, 1.0, 0.75));
+    recruitment->log_rzero = fims::Vector<double>(1, std::log(1000.0));
+    info->recruitment_models[recruitment->GetId()] = recruitment;
+    info->RegisterParameter(recruitment->log_rzero[0]);
+
+    recruitment->TransformParameters();
+    EXPECT_TRUE(recruitment->transformed);
+    std::vector<double> fixed = {std::log(2000.0)};
+    EXPECT_TRUE(info->UpdateFixedEffectsParameters(fixed));
+    EXPECT_FALSE(recruitment->transformed);
+    // 0.8 R0 h S / (0.2 R0 phi0 (1 - h) + S (h - 0.2)) with R0 = 2000
+    EXPECT_NEAR(recruitment->evaluate_mean(30.0, 0.1), 1358.4906, 0.0001);
+
+    info->Clear();
+  }
+}
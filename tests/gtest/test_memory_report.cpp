@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include "common/information.hpp"
+
+namespace
+{
+  // Finds the bytes of the first record with a name, or -1
+  double Bytes(const fims::MemoryReport &report, const std::string &name)
+  {
+    for (size_t i = 0; i < report.records.size(); i++)
+    {
+      if (report.records[i].name == name)
+      {
+        return static_cast<double>(report.records[i].bytes);
+      }
+    }
+    return -1.0;
+  }
+
+  // Test that vectors in an arena are counted once, against the arena
+  TEST(MemoryReport, AttributesArenaStorage)
+  {
+    std::shared_ptr<fims::Arena<double> > arena =
+      std::make_shared<fims::Arena<double> >(100);
+    fims::ArenaAllocator<double> in_arena(arena);
+    fims::ArenaAllocator<double> on_heap(nullptr);
+    fims::Vector<double> a(in_arena);
+    a.resize(30);
+    fims::Vector<double> b(in_arena);
+    b.resize(20);
+    fims::Vector<double> heap(on_heap);
+    heap.resize(10);
+
+    fims::MemoryReport report;
+    report.AddVector("derived_quantity", "Test", 1, "a", a);
+    report.AddVector("derived_quantity", "Test", 1, "b", b);
+    report.AddVector("derived_quantity", "Test", 1, "heap", heap);
+    report.AddArena("Test", 1, arena);
+
+    EXPECT_EQ(Bytes(report, "a"), 30.0 * sizeof(double));
+    EXPECT_EQ(Bytes(report, "b"), 20.0 * sizeof(double));
+    EXPECT_EQ(Bytes(report, "unattributed"), 50.0 * sizeof(double));
+    EXPECT_EQ(report.Total(), 110 * sizeof(double));
+    EXPECT_EQ(report.Total("arena"), 50 * sizeof(double));
+  }
+
+  // Test that a data buffer held by two data objects is counted once
+  TEST(MemoryReport, CountsSharedDataOnce)
+  {
+    std::shared_ptr<fims::SharedData> buffer =
+      std::make_shared<fims::SharedData>(std::vector<double>(8, 1.0));
+    fims_data_object::DataObject<double> d1(8);
+    fims_data_object::DataObject<double> d2(8);
+    d1.data.SetBuffer(buffer);
+    d2.data.SetBuffer(buffer);
+
+    fims::MemoryReport report;
+    report.AddBuffer("data", "DataObject", 1, "data", d1.data.GetBuffer());
+    report.AddBuffer("data", "DataObject", 2, "data", d2.data.GetBuffer());
+    ASSERT_EQ(report.records.size(), 2u);
+    EXPECT_FALSE(report.records[0].shared);
+    EXPECT_TRUE(report.records[1].shared);
+    EXPECT_EQ(report.Total("data"), 8 * sizeof(double));
+  }
+
+  // Test that the Information instance reports each module by id and each
+  // derived quantity by name
+  TEST(MemoryReport, ReportsModulesByIdAndName)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+
+    std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+      std::make_shared<fims_popdy::Fleet<double> >();
+    fleet->nlengths = 0;
+    fleet->log_Fmort.resize(12);
+    fleet->derived_quantities["landings_expected"] =
+      fims::Vector<double>(5, 0.0);
+    info->fleets[fleet->GetId()] = fleet;
+
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(6);
+    index->id = 3;
+    info->data_objects[3] = index;
+
+    fims::MemoryReport report;
+    report.type = "double";
+    info->ReportMemory(report);
+
+    bool found_parameter = false;
+    bool found_derived = false;
+    bool found_data = false;
+    for (size_t i = 0; i < report.records.size(); i++)
+    {
+      const fims::MemoryRecord &r = report.records[i];
+      EXPECT_EQ(r.type, "double");
+      if (r.module == "Fleet" && r.id == fleet->GetId())
+      {
+        if (r.name == "log_Fmort")
+        {
+          found_parameter = true;
+          EXPECT_EQ(r.category, "parameter");
+          EXPECT_GE(r.bytes, 12 * sizeof(double));
+        }
+        if (r.name == "landings_expected" && r.category == "derived_quantity" &&
+            r.bytes == 5 * sizeof(double))
+        {
+          found_derived = true;
+        }
+      }
+      if (r.module == "DataObject" && r.id == 3)
+      {
+        found_data = true;
+        EXPECT_EQ(r.bytes, 6 * sizeof(double));
+      }
+    }
+    EXPECT_TRUE(found_parameter);
+    EXPECT_TRUE(found_derived);
+    EXPECT_TRUE(found_data);
+    EXPECT_GT(report.Total(), 0u);
+
+    info->Clear();
+  }
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "common/model.hpp"
+
+namespace
+{
+  // A density component that returns fixed observation-level values
+  template <typename Type>
+  struct FixedLPDF : public fims_distributions::DensityComponentBase<Type>
+  {
+    std::vector<Type> values;
+
+    virtual const Type evaluate()
+    {
+      this->lpdf_vec.resize(values.size());
+      Type lpdf = 0.0;
+      for (size_t i = 0; i < values.size(); i++)
+      {
+        this->lpdf_vec[i] = values[i];
+        lpdf += values[i];
+      }
+      return lpdf;
+    }
+  };
+
+  // Test that one region is the plain serial sum
+  TEST(RegionSum, OneRegionIsSerialSum)
+  {
+    std::vector<double> terms = {0.1, 1e10, -1e10, 0.3, 1.0 / 3.0};
+    double serial = 0.0;
+    for (size_t j = 0; j < terms.size(); j++) serial += terms[j];
+    EXPECT_EQ(fims_model::Model<double>::RegionSum(terms, 0, 1), serial);
+  }
+
+  // The sum of the region sums, in region order, with the regions spread
+  // over n_threads threads
+  double ThreadedRegionSum(const std::vector<double> &terms, size_t n_regions,
+                           size_t n_threads)
+  {
+    std::vector<double> sums(n_regions);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+      threads.emplace_back([&, t]() {
+        for (size_t r = t; r < n_regions; r += n_threads)
+        {
+          sums[r] = fims_model::Model<double>::RegionSum(terms, r, n_regions);
+        }
+      });
+    }
+    for (size_t t = 0; t < n_threads; t++) threads[t].join();
+    double total = 0.0;
+    for (size_t r = 0; r < n_regions; r++) total += sums[r];
+    return total;
+  }
+
+  // Test that region sums computed on fewer threads than regions and added
+  // in region order match the plain serial sum to rounding, and do not
+  // depend on the number of threads
+  TEST(RegionSum, ThreadedMatchesSerial)
+  {
+    std::vector<double> terms(1000);
+    double serial = 0.0;
+    double magnitude = 0.0;
+    for (size_t j = 0; j < terms.size(); j++)
+    {
+      terms[j] = std::sin(static_cast<double>(j)) * std::pow(10.0, j % 7);
+      serial += terms[j];
+      magnitude += std::fabs(terms[j]);
+    }
+    size_t n_regions = 7;
+
+    double parallel = ThreadedRegionSum(terms, n_regions, 3);
+    EXPECT_NEAR(parallel, serial, 1e-12 * magnitude);
+    EXPECT_EQ(ThreadedRegionSum(terms, n_regions, 2), parallel);
+    EXPECT_EQ(ThreadedRegionSum(terms, n_regions, 1), parallel);
+  }
+
+  // Test that splitting a data likelihood into row blocks keeps the
+  // objective function value
+  TEST(RegionSum, EvaluateSplitsDataIntoBlocks)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    std::shared_ptr<fims_model::Model<double> > model =
+      fims_model::Model<double>::GetInstance();
+
+    fims::Vector<double> expected(10, 0.0);
+    info->variable_map[7] = &expected;
+    std::shared_ptr<FixedLPDF<double> > data =
+      std::make_shared<FixedLPDF<double> >();
+    data->input_type = "data";
+    data->key.resize(1);
+    data->key[0] = 7;
+    for (size_t i = 0; i < 10; i++) data->values.push_back(-0.25 * (i + 1));
+    info->density_components[data->id] = data;
+
+    model->n_regions = 1;
+    EXPECT_DOUBLE_EQ(model->Evaluate(), 13.75);
+
+    model->n_regions = 3;
+    model->region_block_size = 2;
+    EXPECT_DOUBLE_EQ(model->Evaluate(), 13.75);
+
+    model->n_regions = 1;
+    model->region_block_size = 256;
+    info->Clear();
+  }
+}
@@ -0,0 +1,360 @@
+#include "gtest/gtest.h"
+#include "common/model.hpp"
+
+namespace
+{
+  // Test that the solver recovers the F of two fleets from the landings they
+  // give, one fleet in weight and one in numbers
+  TEST(HybridF, RecoversFFromLandings)
+  {
+    size_t nages = 8;
+    fims_popdy::HybridF<double> solver;
+    solver.Resize(nages, 2);
+    std::vector<double> truth = {0.35, 0.12};
+    for (size_t a = 0; a < nages; a++)
+    {
+      solver.M[a] = 0.2;
+      solver.numbers[a] = 1000.0 * std::exp(-0.4 * a);
+      solver.weight[a] = 0.1 * (a + 1);
+      solver.selectivity[0][a] = 1.0 / (1.0 + std::exp(-(a - 3.0)));
+      solver.selectivity[1][a] = 1.0 / (1.0 + std::exp(-(a - 1.5)));
+    }
+    solver.in_weight = {true, false};
+    solver.F = truth;
+    fims::Vector<double> Z(nages);
+    for (size_t a = 0; a < nages; a++)
+    {
+      Z[a] = solver.M[a] + truth[0] * solver.selectivity[0][a] +
+             truth[1] * solver.selectivity[1][a];
+    }
+    for (size_t f = 0; f < 2; f++)
+    {
+      double dC;
+      solver.Landings(f, Z, solver.landings[f], dC);
+    }
+
+    solver.F = {0.0, 0.0};
+    solver.solve = {true, true};
+    solver.newton_iterations = 4;
+    solver.Solve();
+    EXPECT_NEAR(solver.F[0], truth[0], 1e-8);
+    EXPECT_NEAR(solver.F[1], truth[1], 1e-8);
+  }
+
+  // Test that a fleet that is not solved keeps its F
+  TEST(HybridF, FixedFleetKeepsF)
+  {
+    size_t nages = 4;
+    fims_popdy::HybridF<double> solver;
+    solver.Resize(nages, 2);
+    for (size_t a = 0; a < nages; a++)
+    {
+      solver.M[a] = 0.3;
+      solver.numbers[a] = 100.0;
+      solver.weight[a] = 1.0;
+      solver.selectivity[0][a] = 1.0;
+      solver.selectivity[1][a] = 0.5;
+    }
+    solver.in_weight = {true, true};
+    solver.solve = {false, true};
+    solver.F = {0.25, 0.0};
+    solver.landings[1] = 20.0;
+    solver.Solve();
+    EXPECT_EQ(solver.F[0], 0.25);
+    EXPECT_GT(solver.F[1], 0.0);
+  }
+
+  // A catch-at-age model with one population and two fleets
+  std::shared_ptr<fims_popdy::CatchAtAge<double> > MakeModel(
+    size_t nyears, size_t nages,
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > &fleets)
+  {
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      std::make_shared<fims_popdy::CatchAtAge<double> >();
+    for (size_t f = 0; f < 2; f++)
+    {
+      std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+        std::make_shared<fims_popdy::Fleet<double> >();
+      fleet->nyears = nyears;
+      fleet->nages = nages;
+      fleet->nlengths = 0;
+      fleet->log_q = fims::Vector<double>(1, std::log(0.5));
+      fleet->log_Fmort.resize(nyears);
+      for (size_t y = 0; y < nyears; y++)
+      {
+        fleet->log_Fmort[y] = std::log(0.1 + 0.03 * y + 0.1 * f);
+      }
+      std::shared_ptr<fims_popdy::LogisticSelectivity<double> > selectivity =
+        std::make_shared<fims_popdy::LogisticSelectivity<double> >();
+      selectivity->inflection_point = fims::Vector<double>(1, 2.0 + f);
+      selectivity->slope = fims::Vector<double>(1, 1.0);
+      fleet->selectivity = selectivity;
+      fleets.push_back(fleet);
+      model->fleets[fleet->GetId()] = fleet;
+    }
+
+    std::shared_ptr<fims_popdy::Population<double> > population =
+      std::make_shared<fims_popdy::Population<double> >();
+    population->nyears = nyears;
+    population->nages = nages;
+    population->nfleets = fleets.size();
+    population->fleets = fleets;
+    population->ages.resize(nages);
+    population->log_init_naa.resize(nages);
+    population->log_M = fims::Vector<double>(nyears * nages, std::log(0.2));
+    std::shared_ptr<fims_popdy::EWAAgrowth<double> > growth =
+      std::make_shared<fims_popdy::EWAAgrowth<double> >();
+    for (size_t a = 0; a < nages; a++)
+    {
+      population->ages[a] = a + 1;
+      population->log_init_naa[a] = std::log(1000.0) - 0.3 * a;
+      growth->ewaa[a + 1] = 0.1 * (a + 1);
+    }
+    population->growth = growth;
+
+    std::shared_ptr<fims_popdy::LogisticMaturity<double> > maturity =
+      std::make_shared<fims_popdy::LogisticMaturity<double> >();
+    maturity->inflection_point = fims::Vector<double>(1, 3.0);
+    maturity->slope = fims::Vector<double>(1, 1.5);
+    population->maturity = maturity;
+
+    std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+      std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+    std::shared_ptr<fims_popdy::LogDevs<double> > log_devs =
+      std::make_shared<fims_popdy::LogDevs<double> >();
+    recruitment->process = log_devs;
+    recruitment->process->recruitment = recruitment;
+    recruitment->logit_steep =
+      fims::Vector<double>(1, fims_math::logit(0.2, 1.0, 0.75));
+    recruitment->log_rzero = fims::Vector<double>(1, std::log(1000.0));
+    recruitment->log_recruit_devs = fims::Vector<double>(nyears - 1, 0.0);
+    recruitment->log_expected_recruitment.resize(nyears + 1);
+    population->recruitment = recruitment;
+
+    model->populations.push_back(population);
+    model->Initialize();
+    return model;
+  }
+
+  // Gives the fleets hybrid F, with the landings of the current evaluation
+  // as their observed landings, and returns the F that gave them
+  std::vector<std::vector<double> > UseHybridF(
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > &model,
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > &fleets,
+    size_t nyears)
+  {
+    std::vector<std::vector<double> > truth(fleets.size());
+    for (size_t f = 0; f < fleets.size(); f++)
+    {
+      std::shared_ptr<fims_data_object::DataObject<double> > landings =
+        std::make_shared<fims_data_object::DataObject<double> >(nyears);
+      fims::Vector<double> &landings_weight =
+        model->fleet_derived_quantities[fleets[f]->GetId()]["landings_weight"];
+      for (size_t y = 0; y < nyears; y++)
+      {
+        landings->set(y, landings_weight[y]);
+        truth[f].push_back(fleets[f]->Fmort[y]);
+        fleets[f]->log_Fmort[y] = std::log(0.5);
+      }
+      fleets[f]->observed_landings_data = landings;
+      fleets[f]->hybrid_F = true;
+    }
+    return truth;
+  }
+
+  // Test that F solved from the landings of a model recovers the F that gave
+  // them, and that log_Fmort is not used
+  TEST(HybridF, CatchAtAgeMatchesObservedLandings)
+  {
+    size_t nyears = 10;
+    size_t nages = 8;
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      MakeModel(nyears, nages, fleets);
+    model->Evaluate();
+    std::vector<std::vector<double> > truth =
+      UseHybridF(model, fleets, nyears);
+
+    model->Evaluate();
+    for (size_t f = 0; f < 2; f++)
+    {
+      fims::Vector<double> &landings_weight =
+        model->fleet_derived_quantities[fleets[f]->GetId()]["landings_weight"];
+      for (size_t y = 0; y < nyears; y++)
+      {
+        EXPECT_NEAR(fleets[f]->Fmort[y], truth[f][y], 1e-6 * truth[f][y]);
+        EXPECT_NEAR(landings_weight[y],
+                    fleets[f]->observed_landings_data->at(y),
+                    1e-6 * landings_weight[y]);
+      }
+    }
+  }
+
+  // Test that an incremental evaluation keeps the F solved in the years
+  // before the change, so it matches a full evaluation
+  TEST(HybridF, IncrementalMatchesFull)
+  {
+    size_t nyears = 10;
+    size_t nages = 8;
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      MakeModel(nyears, nages, fleets);
+    model->Evaluate();
+    UseHybridF(model, fleets, nyears);
+
+    model->SetChangedParameters(std::vector<double *>());
+    model->Evaluate();
+    double *change =
+      &model->populations[0]->recruitment->log_recruit_devs[5];
+    *change += 0.2;
+    model->SetChangedParameters(std::vector<double *>(1, change));
+    model->Evaluate();
+    std::vector<fims::Vector<double> > Fmort;
+    std::vector<fims::Vector<double> > landings_weight;
+    for (size_t f = 0; f < 2; f++)
+    {
+      Fmort.push_back(fleets[f]->Fmort);
+      landings_weight.push_back(
+        model->fleet_derived_quantities[fleets[f]->GetId()]
+                                       ["landings_weight"]);
+    }
+
+    // without SetChangedParameters() every year is solved again
+    model->Evaluate();
+    for (size_t f = 0; f < 2; f++)
+    {
+      for (size_t y = 0; y < nyears; y++)
+      {
+        EXPECT_DOUBLE_EQ(Fmort[f][y], fleets[f]->Fmort[y]);
+        EXPECT_DOUBLE_EQ(landings_weight[f][y],
+                         model->fleet_derived_quantities[fleets[f]->GetId()]
+                                                        ["landings_weight"][y]);
+      }
+    }
+  }
+
+  // Test that an incremental evaluation after the landings change, or after
+  // last_parameters is cleared, solves F from the new landings although no
+  // parameter changed, and that landings with a missing year are rejected
+  TEST(HybridF, UpdatedLandingsAreSolvedAgain)
+  {
+    size_t nyears = 10;
+    size_t nages = 8;
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      MakeModel(nyears, nages, fleets);
+    model->Evaluate();
+    UseHybridF(model, fleets, nyears);
+
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    info->models_map[model->GetId()] = model;
+    for (size_t f = 0; f < 2; f++)
+    {
+      info->fleets[fleets[f]->GetId()] = fleets[f];
+      info->data_objects[fleets[f]->observed_landings_data->id] =
+        fleets[f]->observed_landings_data;
+    }
+    info->RegisterParameter(
+      model->populations[0]->recruitment->log_rzero[0]);
+    std::shared_ptr<fims_model::Model<double> > fims_model =
+      fims_model::Model<double>::GetInstance();
+    fims_model->incremental = true;
+    fims_model->Evaluate();
+    fims_model->Evaluate();
+
+    uint32_t id = fleets[0]->observed_landings_data->id;
+    std::vector<double> landings(nyears);
+    for (size_t y = 0; y < nyears; y++)
+    {
+      landings[y] = 0.8 * fleets[0]->observed_landings_data->at(y);
+    }
+    ASSERT_TRUE(info->UpdateDataObject(id, landings));
+    fims_model->Evaluate();
+    fims::Vector<double> &landings_weight =
+      model->fleet_derived_quantities[fleets[0]->GetId()]["landings_weight"];
+    for (size_t y = 0; y < nyears; y++)
+    {
+      EXPECT_NEAR(landings_weight[y], landings[y], 1e-6 * landings[y]);
+    }
+
+    std::vector<double> missing = landings;
+    missing[3] = fleets[0]->observed_landings_data->na_value;
+    EXPECT_FALSE(info->UpdateDataObject(id, missing));
+    EXPECT_EQ(fleets[0]->observed_landings_data->at(3), landings[3]);
+
+    // values written without UpdateDataObject() are used once
+    // last_parameters is cleared
+    fleets[0]->observed_landings_data->set(3, 0.5 * landings[3]);
+    fims_model->last_parameters.clear();
+    fims_model->Evaluate();
+    EXPECT_NEAR(landings_weight[3], 0.5 * landings[3], 1e-6 * landings[3]);
+
+    fims_model->incremental = false;
+    info->Clear();
+  }
+
+  // Test that a year with missing landings written directly to the data is
+  // recorded for the error log rather than taken as zero landings, and that
+  // both give no F
+  TEST(HybridF, MissingLandingsAreRecorded)
+  {
+    size_t nyears = 10;
+    size_t nages = 8;
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      MakeModel(nyears, nages, fleets);
+    model->Evaluate();
+    UseHybridF(model, fleets, nyears);
+    fleets[0]->observed_landings_data->set(
+      3, fleets[0]->observed_landings_data->na_value);
+    fleets[0]->observed_landings_data->set(5, 0.0);
+
+    model->Prepare();
+    model->Evaluate();
+    EXPECT_EQ(fleets[0]->Fmort[3], 0.0);
+    EXPECT_EQ(fleets[0]->Fmort[5], 0.0);
+    ASSERT_EQ(model->missing_landings_years[fleets[0]->GetId()].size(), 1);
+    EXPECT_EQ(model->missing_landings_years[fleets[0]->GetId()][0], 3);
+    EXPECT_TRUE(model->missing_landings_years[fleets[1]->GetId()].empty());
+
+    model->LogEvaluateMessages();
+    EXPECT_TRUE(model->missing_landings_years[fleets[0]->GetId()].empty());
+  }
+
+  // Test that a model is invalid if a fleet with hybrid F has a year with
+  // missing landings
+  TEST(HybridF, MissingLandingsInvalidateModel)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+      std::make_shared<fims_popdy::Fleet<double> >();
+    fleet->nyears = 3;
+    fleet->hybrid_F = true;
+    fleet->observed_landings_data =
+      std::make_shared<fims_data_object::DataObject<double> >(3);
+    for (size_t y = 0; y < 3; y++)
+    {
+      fleet->observed_landings_data->set(y, 10.0);
+    }
+    std::shared_ptr<fims_popdy::Population<double> > population =
+      std::make_shared<fims_popdy::Population<double> >();
+    population->fleet_ids.insert(fleet->GetId());
+    info->fleets[fleet->GetId()] = fleet;
+    info->populations[population->GetId()] = population;
+
+    bool valid_model = true;
+    info->CheckHybridF(valid_model);
+    EXPECT_TRUE(valid_model);
+
+    fleet->observed_landings_data->set(
+      1, fleet->observed_landings_data->na_value);
+    info->CheckHybridF(valid_model);
+    EXPECT_FALSE(valid_model);
+
+    info->Clear();
+  }
+}
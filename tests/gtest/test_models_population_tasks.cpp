@@ -0,0 +1,462 @@
+#include "gtest/gtest.h"
+#include "common/model.hpp"
+
+namespace
+{
+  // Expects two vectors to be equal bit for bit
+  void ExpectSame(const fims::Vector<double> &x, const fims::Vector<double> &y)
+  {
+    ASSERT_EQ(x.size(), y.size());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      EXPECT_EQ(x[i], y[i]);
+    }
+  }
+
+  // Two populations fished by the same two fleets
+  class PopulationTasksTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      model = std::make_shared<fims_popdy::CatchAtAge<double> >();
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+          std::make_shared<fims_popdy::Fleet<double> >();
+        fleet->nyears = nyears;
+        fleet->nages = nages;
+        fleet->nlengths = 0;
+        fleet->log_q.resize(1);
+        fleet->log_q[0] = std::log(0.5 + 0.1 * f);
+        fleet->log_Fmort.resize(nyears);
+        for (size_t y = 0; y < nyears; y++)
+        {
+          fleet->log_Fmort[y] = std::log(0.1 + 0.02 * y + 0.05 * f);
+        }
+        std::shared_ptr<fims_popdy::LogisticSelectivity<double> > selectivity =
+          std::make_shared<fims_popdy::LogisticSelectivity<double> >();
+        selectivity->inflection_point.resize(1);
+        selectivity->inflection_point[0] = 3.0 + f;
+        selectivity->slope.resize(1);
+        selectivity->slope[0] = 1.0;
+        fleet->selectivity = selectivity;
+        fleets.push_back(fleet);
+        model->fleets[fleet->GetId()] = fleet;
+      }
+      for (size_t p = 0; p < 3; p++)
+      {
+        model->populations.push_back(MakePopulation(p));
+      }
+      model->Initialize();
+    }
+
+    std::shared_ptr<fims_popdy::Population<double> > MakePopulation(size_t p)
+    {
+      std::shared_ptr<fims_popdy::Population<double> > population =
+        std::make_shared<fims_popdy::Population<double> >();
+      population->nyears = nyears;
+      population->nages = nages;
+      population->nfleets = nfleets;
+      population->fleets = fleets;
+      population->ages.resize(nages);
+      population->log_init_naa.resize(nages);
+      population->log_M.resize(nyears * nages);
+      std::shared_ptr<fims_popdy::EWAAgrowth<double> > growth =
+        std::make_shared<fims_popdy::EWAAgrowth<double> >();
+      for (size_t a = 0; a < nages; a++)
+      {
+        population->ages[a] = a + 1;
+        population->log_init_naa[a] = std::log(1000.0 * (p + 1)) - 0.3 * a;
+        growth->ewaa[a + 1] = 0.1 * (a + 1) * (1.0 + 0.1 * p);
+      }
+      for (size_t i = 0; i < nyears * nages; i++)
+      {
+        population->log_M[i] = std::log(0.2 + 0.05 * p);
+      }
+      population->growth = growth;
+
+      std::shared_ptr<fims_popdy::LogisticMaturity<double> > maturity =
+        std::make_shared<fims_popdy::LogisticMaturity<double> >();
+      maturity->inflection_point.resize(1);
+      maturity->inflection_point[0] = 3.0;
+      maturity->slope.resize(1);
+      maturity->slope[0] = 1.5;
+      population->maturity = maturity;
+
+      std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+        std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+      std::shared_ptr<fims_popdy::LogDevs<double> > log_devs =
+        std::make_shared<fims_popdy::LogDevs<double> >();
+      recruitment->process = log_devs;
+      recruitment->process->recruitment = recruitment;
+      recruitment->logit_steep.resize(1);
+      recruitment->logit_steep[0] = fims_math::logit(0.2, 1.0, 0.75);
+      recruitment->log_rzero.resize(1);
+      recruitment->log_rzero[0] = std::log(1000.0 * (p + 1));
+      recruitment->log_recruit_devs.resize(nyears - 1);
+      for (size_t y = 0; y < nyears - 1; y++)
+      {
+        recruitment->log_recruit_devs[y] = 0.1 * std::sin(y + p);
+      }
+      recruitment->log_expected_recruitment.resize(nyears + 1);
+      population->recruitment = recruitment;
+      return population;
+    }
+
+    size_t nyears = 8;
+    size_t nages = 6;
+    size_t nfleets = 2;
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model;
+  };
+
+  // Test that evaluating the populations on a thread pool gives exactly the
+  // same derived quantities as evaluating them one after another
+  TEST_F(PopulationTasksTest, ThreadPoolMatchesSerial)
+  {
+    model->thread_pool = nullptr;
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    fims::ThreadPool pool(3);
+    model->thread_pool = &pool;
+    for (size_t k = 0; k < 5; k++)
+    {
+      model->Evaluate();
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        uint32_t id = fleets[f]->GetId();
+        ExpectSame(model->fleet_derived_quantities[id]["landings_weight"],
+                   fleet_dq[id]["landings_weight"]);
+        ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                   fleet_dq[id]["index_numbers"]);
+        ExpectSame(model->fleet_derived_quantities[id]["agecomp_proportion"],
+                   fleet_dq[id]["agecomp_proportion"]);
+      }
+      for (size_t p = 0; p < model->populations.size(); p++)
+      {
+        uint32_t id = model->populations[p]->GetId();
+        ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                   population_dq[id]["numbers_at_age"]);
+        ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                   population_dq[id]["spawning_biomass"]);
+      }
+    }
+  }
+
+  // Test that the vector kernels give the same derived quantities as the
+  // scalar age loops
+  TEST_F(PopulationTasksTest, KernelsMatchScalar)
+  {
+    model->use_atomic_kernels = false;
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    model->use_atomic_kernels = true;
+    model->Evaluate();
+    for (size_t f = 0; f < nfleets; f++)
+    {
+      uint32_t id = fleets[f]->GetId();
+      ExpectSame(model->fleet_derived_quantities[id]["landings_numbers_at_age"],
+                 fleet_dq[id]["landings_numbers_at_age"]);
+      ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                 fleet_dq[id]["index_numbers"]);
+      ExpectSame(model->fleet_derived_quantities[id]["agecomp_proportion"],
+                 fleet_dq[id]["agecomp_proportion"]);
+    }
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      uint32_t id = model->populations[p]->GetId();
+      ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                 population_dq[id]["numbers_at_age"]);
+    }
+  }
+
+  // Test that the modules resolved to their concrete types give the same
+  // derived quantities as the virtual calls
+  TEST_F(PopulationTasksTest, StaticDispatchMatchesVirtual)
+  {
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    model->ResolveModules();
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      fims_popdy::ModuleTable<double> &modules = model->populations[p]->modules;
+      EXPECT_TRUE(modules.resolved);
+      EXPECT_EQ(modules.selectivity.size(), nfleets);
+      EXPECT_EQ(modules.selectivity[0].index(), 0u);
+      EXPECT_EQ(modules.maturity.index(), 0u);
+      EXPECT_EQ(modules.growth.index(), 0u);
+      EXPECT_EQ(modules.recruitment.index(), 0u);
+    }
+    model->Evaluate();
+    for (size_t f = 0; f < nfleets; f++)
+    {
+      uint32_t id = fleets[f]->GetId();
+      ExpectSame(model->fleet_derived_quantities[id]["landings_numbers_at_age"],
+                 fleet_dq[id]["landings_numbers_at_age"]);
+      ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                 fleet_dq[id]["index_numbers"]);
+    }
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      uint32_t id = model->populations[p]->GetId();
+      ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                 population_dq[id]["numbers_at_age"]);
+      ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                 population_dq[id]["spawning_biomass"]);
+      ExpectSame(
+        model->population_derived_quantities[id]["proportion_mature_at_age"],
+        population_dq[id]["proportion_mature_at_age"]);
+    }
+
+    model->static_dispatch = false;
+    model->ResolveModules();
+    EXPECT_FALSE(model->populations[0]->modules.resolved);
+  }
+
+  // Test that a constant natural mortality stored as one value gives the same
+  // derived quantities as the same value stored for each year and age
+  TEST_F(PopulationTasksTest, ConstantMMatchesFull)
+  {
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      std::shared_ptr<fims_popdy::Population<double> > &population =
+        model->populations[p];
+      population->M_layout.structure = fims::AgeYearConstant;
+      population->M_layout.Resize(nyears, nages);
+      population->log_M.resize(population->M_layout.Size());
+    }
+    model->Evaluate();
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      uint32_t id = model->populations[p]->GetId();
+      EXPECT_EQ(model->populations[p]->log_M.size(), 1u);
+      EXPECT_EQ(model->populations[p]->M.size(), nyears * nages);
+      ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                 population_dq[id]["numbers_at_age"]);
+      ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                 population_dq[id]["spawning_biomass"]);
+    }
+  }
+
+  // Test that derived quantities laid out in the model arena and reset in one
+  // pass give the same values as those reset one vector at a time
+  TEST_F(PopulationTasksTest, ArenaResetMatchesVectorReset)
+  {
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    model->arena = std::make_shared<fims::Arena<double> >();
+    {
+      fims::ArenaScope<double> scope(model->arena);
+      model->Initialize();
+    }
+    uint32_t population_id = model->populations[0]->GetId();
+    EXPECT_TRUE(model->InArena(
+      model->population_derived_quantities[population_id]["numbers_at_age"]));
+    EXPECT_GT(model->arena->Size(), 0u);
+
+    for (size_t k = 0; k < 2; k++)
+    {
+      model->Evaluate();
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        uint32_t id = fleets[f]->GetId();
+        ExpectSame(model->fleet_derived_quantities[id]["landings_weight"],
+                   fleet_dq[id]["landings_weight"]);
+        ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                   fleet_dq[id]["index_numbers"]);
+      }
+      for (size_t p = 0; p < model->populations.size(); p++)
+      {
+        uint32_t id = model->populations[p]->GetId();
+        ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                   population_dq[id]["numbers_at_age"]);
+        ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                   population_dq[id]["spawning_biomass"]);
+      }
+    }
+  }
+
+  // Test that evaluating the years in checkpoint blocks, including a block
+  // size that does not divide the number of years, gives the same derived
+  // quantities as evaluating them in one pass
+  TEST_F(PopulationTasksTest, CheckpointBlocksMatchOnePass)
+  {
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    for (size_t block = 1; block <= nyears + 2; block += 2)
+    {
+      model->checkpoint_years = block;
+      model->Evaluate();
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        uint32_t id = fleets[f]->GetId();
+        ExpectSame(model->fleet_derived_quantities[id]["landings_weight"],
+                   fleet_dq[id]["landings_weight"]);
+        ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                   fleet_dq[id]["index_numbers"]);
+      }
+      for (size_t p = 0; p < model->populations.size(); p++)
+      {
+        uint32_t id = model->populations[p]->GetId();
+        ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                   population_dq[id]["numbers_at_age"]);
+        ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                   population_dq[id]["spawning_biomass"]);
+      }
+    }
+  }
+
+  // Test that an incremental evaluation after a change to one parameter
+  // gives the same derived quantities as a full evaluation, for parameters
+  // that change the later years, only the index, or every year
+  TEST_F(PopulationTasksTest, IncrementalMatchesFull)
+  {
+    std::vector<double *> changes = {
+      &fleets[0]->log_Fmort[5],
+      &fleets[1]->log_q[0],
+      &model->populations[1]->recruitment->log_recruit_devs[3],
+      &model->populations[2]->log_M[4 * nages + 2],
+      &model->populations[0]->log_init_naa[1]};
+
+    for (size_t k = 0; k < changes.size(); k++)
+    {
+      model->SetChangedParameters(std::vector<double *>());
+      model->Evaluate();
+
+      *changes[k] += 0.1;
+      model->SetChangedParameters(std::vector<double *>(1, changes[k]));
+      model->Evaluate();
+      std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+        fleet_dq = model->fleet_derived_quantities;
+      std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+        population_dq = model->population_derived_quantities;
+
+      // without SetChangedParameters() everything is recomputed
+      model->Evaluate();
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        uint32_t id = fleets[f]->GetId();
+        ExpectSame(model->fleet_derived_quantities[id]["landings_weight"],
+                   fleet_dq[id]["landings_weight"]);
+        ExpectSame(model->fleet_derived_quantities[id]["index_numbers"],
+                   fleet_dq[id]["index_numbers"]);
+        ExpectSame(model->fleet_derived_quantities[id]["agecomp_proportion"],
+                   fleet_dq[id]["agecomp_proportion"]);
+      }
+      for (size_t p = 0; p < model->populations.size(); p++)
+      {
+        uint32_t id = model->populations[p]->GetId();
+        ExpectSame(model->population_derived_quantities[id]["numbers_at_age"],
+                   population_dq[id]["numbers_at_age"]);
+        ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                   population_dq[id]["spawning_biomass"]);
+        ExpectSame(model->population_derived_quantities[id]["mortality_Z"],
+                   population_dq[id]["mortality_Z"]);
+      }
+    }
+  }
+
+  // Test that skipping the derived quantities that are neither used nor
+  // reported leaves the used ones unchanged and the skipped ones at zero
+  TEST_F(PopulationTasksTest, DemandSkipsUnusedQuantities)
+  {
+    model->Evaluate();
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > > fleet_dq =
+      model->fleet_derived_quantities;
+    std::map<uint32_t, std::map<std::string, fims::Vector<double> > >
+      population_dq = model->population_derived_quantities;
+
+    uint32_t fishery = fleets[0]->GetId();
+    uint32_t survey = fleets[1]->GetId();
+    std::set<const fims::Vector<double> *> used;
+    used.insert(
+      &model->fleet_derived_quantities[fishery]["log_landings_expected"]);
+    used.insert(&model->fleet_derived_quantities[survey]["log_index_expected"]);
+    model->report_quantities.insert("spawning_biomass");
+    model->skip_unused = true;
+    model->SetDemand(used);
+    model->Evaluate();
+
+    ExpectSame(model->fleet_derived_quantities[fishery]["log_landings_expected"],
+               fleet_dq[fishery]["log_landings_expected"]);
+    ExpectSame(model->fleet_derived_quantities[survey]["log_index_expected"],
+               fleet_dq[survey]["log_index_expected"]);
+    for (size_t y = 0; y < nyears; y++)
+    {
+      EXPECT_EQ(model->fleet_derived_quantities[fishery]["index_numbers"][y],
+                0.0);
+      EXPECT_EQ(model->fleet_derived_quantities[survey]["landings_weight"][y],
+                0.0);
+    }
+    for (size_t p = 0; p < model->populations.size(); p++)
+    {
+      uint32_t id = model->populations[p]->GetId();
+      ExpectSame(model->population_derived_quantities[id]["spawning_biomass"],
+                 population_dq[id]["spawning_biomass"]);
+      for (size_t y = 0; y <= nyears; y++)
+      {
+        EXPECT_EQ(model->population_derived_quantities[id]["biomass"][y], 0.0);
+        EXPECT_EQ(
+          model->population_derived_quantities[id]["unfished_spawning_biomass"]
+                                              [y],
+          0.0);
+      }
+    }
+
+    // computing everything again restores the skipped quantities
+    model->skip_unused = false;
+    model->Evaluate();
+    ExpectSame(model->fleet_derived_quantities[survey]["landings_weight"],
+               fleet_dq[survey]["landings_weight"]);
+  }
+
+  // Test that the fleet landings are the sum of the populations' landings
+  TEST_F(PopulationTasksTest, FleetLandingsSumOverPopulations)
+  {
+    model->Evaluate();
+    for (size_t y = 0; y < nyears; y++)
+    {
+      double by_fleet = 0.0;
+      for (size_t f = 0; f < nfleets; f++)
+      {
+        by_fleet +=
+          model->fleet_derived_quantities[fleets[f]->GetId()]
+                                         ["landings_weight"][y];
+      }
+      double by_population = 0.0;
+      for (size_t p = 0; p < model->populations.size(); p++)
+      {
+        by_population +=
+          model->population_derived_quantities[model->populations[p]->GetId()]
+                                              ["total_landings_weight"][y];
+      }
+      EXPECT_GT(by_fleet, 0.0);
+      EXPECT_NEAR(by_fleet, by_population, 1e-10 * by_population);
+    }
+  }
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "common/information.hpp"
+#include "population_dynamics/recruitment/functors/sr_beverton_holt.hpp"
+
+namespace
+{
+  class ProjectionTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+        std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+      recruitment->logit_steep.resize(1);
+      recruitment->logit_steep[0] = fims_math::logit(0.2, 1.0, 0.75);
+      recruitment->log_rzero.resize(1);
+      recruitment->log_rzero[0] = std::log(1000.0);
+      recruitment->TransformParameters();
+
+      fims_popdy::EquilibriumModel<double> &eq = projection.eq;
+      eq.recruitment = recruitment;
+      eq.M.resize(nages);
+      eq.weight.resize(nages);
+      eq.fecundity.resize(nages);
+      eq.selectivity.resize(nages);
+      projection.initial_numbers.resize(nages);
+      for (size_t a = 0; a < nages; a++)
+      {
+        double age = static_cast<double>(a + 1);
+        eq.M[a] = 0.2;
+        eq.weight[a] = 0.0005 * std::pow(50.0 * (1.0 - std::exp(-0.3 * age)), 3);
+        eq.fecundity[a] = 0.5 * eq.weight[a] / (1.0 + std::exp(-2.0 * (age - 3.0)));
+        eq.selectivity[a] = 1.0 / (1.0 + std::exp(-1.5 * (age - 4.0)));
+        projection.initial_numbers[a] = 1000.0 * std::exp(-0.4 * a);
+      }
+      projection.phi0 = eq.Phi0();
+      projection.recruit_devs = {-0.5, -0.2, 0.0, 0.1, 0.4, 0.6};
+    }
+
+    size_t nages = 10;
+    fims_popdy::Projection projection;
+  };
+
+  TEST_F(ProjectionTest, DeterministicProjectionMatchesDynamics)
+  {
+    fims_popdy::ProjectionSettings settings;
+    settings.nyears = 3;
+    settings.values = {0.2};
+    settings.nreplicates = 5;
+    settings.nthreads = 2;
+    projection.recruit_devs.clear();
+    fims_popdy::ProjectionSummary summary = projection.Run(settings);
+
+    // step the first year by hand
+    std::vector<double> N = projection.initial_numbers;
+    double ssb = 0.0;
+    for (size_t a = 0; a < nages; a++)
+    {
+      ssb += projection.eq.fecundity[a] * N[a];
+    }
+    double recruits = projection.eq.recruitment->evaluate_mean(ssb, projection.phi0);
+    std::vector<double> ssb_pct = summary.percentiles["ssb"];
+    std::vector<double> rec_pct = summary.percentiles["recruitment"];
+    size_t nprobs = settings.probs.size();
+    EXPECT_NEAR(ssb_pct[0], ssb, 1e-8);
+    EXPECT_NEAR(rec_pct[1 * nprobs], recruits, 1e-8);
+    // without deviations every percentile is the same
+    EXPECT_NEAR(rec_pct[1 * nprobs], rec_pct[1 * nprobs + nprobs - 1], 1e-8);
+    EXPECT_NEAR(summary.percentiles["F"][2 * nprobs], 0.2, 1e-12);
+    EXPECT_NEAR(summary.percentiles["landings_weight"][0],
+      projection.LandingsWeight(N, 0.2), 1e-8);
+  }
+
+  TEST_F(ProjectionTest, ResultsDoNotDependOnThreads)
+  {
+    fims_popdy::ProjectionSettings settings;
+    settings.nyears = 8;
+    settings.values = {0.1, 0.3};
+    settings.nreplicates = 200;
+    settings.seed = 42;
+
+    settings.nthreads = 1;
+    fims_popdy::ProjectionSummary serial = projection.Run(settings);
+    settings.nthreads = 4;
+    fims_popdy::ProjectionSummary parallel = projection.Run(settings);
+
+    std::vector<std::string> names = fims_popdy::Projection::Quantities();
+    for (size_t q = 0; q < names.size(); q++)
+    {
+      EXPECT_EQ(serial.percentiles[names[q]], parallel.percentiles[names[q]]);
+      EXPECT_EQ(serial.mean[names[q]], parallel.mean[names[q]]);
+    }
+    // resampled deviations spread the recruitment percentiles
+    EXPECT_LT(serial.percentiles["recruitment"][0],
+      serial.percentiles["recruitment"][2]);
+  }
+
+  TEST_F(ProjectionTest, CatchScenarioMatchesTarget)
+  {
+    fims_popdy::ProjectionSettings settings;
+    settings.nyears = 5;
+    settings.catch_based = true;
+    settings.values = {150.0};
+    settings.nreplicates = 50;
+    settings.sigma_r = 0.5;
+    fims_popdy::ProjectionSummary summary = projection.Run(settings);
+
+    std::vector<double> &landings = summary.percentiles["landings_weight"];
+    for (size_t i = 0; i < landings.size(); i++)
+    {
+      EXPECT_NEAR(landings[i], 150.0, 1e-6);
+    }
+  }
+
+  TEST(ThreadPool, ParallelForVisitsEachIndexOnce)
+  {
+    fims::ThreadPool pool(3);
+    std::vector<int> visits(1000, 0);
+    pool.ParallelFor(visits.size(), [&](size_t i) { visits[i] += 1; });
+    for (size_t i = 0; i < visits.size(); i++)
+    {
+      EXPECT_EQ(visits[i], 1);
+    }
+    std::future<int> answer = pool.Submit([]() { return 42; });
+    EXPECT_EQ(answer.get(), 42);
+  }
+}
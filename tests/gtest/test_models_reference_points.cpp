@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include "common/model.hpp"
+#include "models/functors/reference_points.hpp"
+#include "population_dynamics/recruitment/functors/sr_beverton_holt.hpp"
+
+namespace
+{
+  class ReferencePointsTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+        std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+      recruitment->logit_steep.resize(1);
+      recruitment->logit_steep[0] = fims_math::logit(0.2, 1.0, steep);
+      recruitment->log_rzero.resize(1);
+      recruitment->log_rzero[0] = std::log(r0);
+      recruitment->TransformParameters();
+      eq.recruitment = recruitment;
+
+      eq.M.resize(nages);
+      eq.weight.resize(nages);
+      eq.fecundity.resize(nages);
+      eq.selectivity.resize(nages);
+      for (size_t a = 0; a < nages; a++)
+      {
+        double age = static_cast<double>(a + 1);
+        eq.M[a] = 0.2;
+        eq.weight[a] = 0.0005 * std::pow(50.0 * (1.0 - std::exp(-0.3 * age)), 3);
+        eq.fecundity[a] = 0.5 * eq.weight[a] / (1.0 + std::exp(-2.0 * (age - 3.0)));
+        eq.selectivity[a] = 1.0 / (1.0 + std::exp(-1.5 * (age - 4.0)));
+      }
+    }
+
+    size_t nages = 12;
+    double steep = 0.75;
+    double r0 = 1000.0;
+    fims_popdy::EquilibriumModel<double> eq;
+  };
+
+  TEST_F(ReferencePointsTest, UnfishedQuantities)
+  {
+    std::vector<double> targets;
+    fims_popdy::ReferencePoints<double> rp = eq.Calculate(targets);
+
+    EXPECT_NEAR(rp.r0, r0, 1e-8);
+    EXPECT_NEAR(rp.ssb0, r0 * eq.Phi0(), 1e-8);
+    EXPECT_NEAR(eq.EquilibriumRecruitment(rp.phi0, rp.phi0), r0, 1e-6);
+  }
+
+  TEST_F(ReferencePointsTest, RecruitmentMatchesBevertonHolt)
+  {
+    // closed form equilibrium recruitment for the Beverton-Holt curve
+    double spr, ypr, bpr;
+    double phi0 = eq.Phi0();
+    eq.PerRecruit(0.3, spr, ypr, bpr);
+    double expected = r0 * (4.0 * steep * spr - (1.0 - steep) * phi0) /
+      ((5.0 * steep - 1.0) * spr);
+    EXPECT_NEAR(eq.EquilibriumRecruitment(spr, phi0), expected, 1e-6);
+  }
+
+  TEST_F(ReferencePointsTest, FmsyMaximizesYield)
+  {
+    std::vector<double> targets;
+    fims_popdy::ReferencePoints<double> rp = eq.Calculate(targets);
+    double phi0 = rp.phi0;
+
+    // fine grid search
+    double best_F = 0.0;
+    double best_yield = 0.0;
+    for (double F = 0.001; F < 2.0; F += 0.001)
+    {
+      double y = eq.Yield(F, phi0);
+      if (y > best_yield)
+      {
+        best_yield = y;
+        best_F = F;
+      }
+    }
+    EXPECT_NEAR(rp.F_msy, best_F, 1e-3);
+    EXPECT_GE(rp.msy, best_yield - 1e-6);
+    EXPECT_NEAR(rp.spr_msy, rp.ssb_msy / (rp.r_msy * phi0), 1e-10);
+  }
+
+  TEST_F(ReferencePointsTest, FsprMatchesTargets)
+  {
+    std::vector<double> targets = {0.3, 0.4};
+    fims_popdy::ReferencePoints<double> rp = eq.Calculate(targets);
+    ASSERT_EQ(rp.F_spr.size(), 2);
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+      double spr, ypr, bpr;
+      eq.PerRecruit(rp.F_spr[i], spr, ypr, bpr);
+      EXPECT_NEAR(spr / rp.phi0, targets[i], 1e-8);
+    }
+    // a lower target ratio needs more fishing
+    EXPECT_GT(rp.F_spr[0], rp.F_spr[1]);
+  }
+
+  // Test that CatchAtAge::CalculateReferencePoints() builds the equilibrium
+  // model of a population from its modules and the fleet allocation
+  TEST(CatchAtAgeReferencePoints, MatchesEquilibriumModel)
+  {
+    size_t nyears = 10;
+    size_t nages = 8;
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      std::make_shared<fims_popdy::CatchAtAge<double> >();
+    std::vector<std::shared_ptr<fims_popdy::Fleet<double> > > fleets;
+    for (size_t f = 0; f < 2; f++)
+    {
+      std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+        std::make_shared<fims_popdy::Fleet<double> >();
+      fleet->nyears = nyears;
+      fleet->nages = nages;
+      fleet->nlengths = 0;
+      fleet->log_q = fims::Vector<double>(1, std::log(0.5));
+      fleet->log_Fmort = fims::Vector<double>(nyears, std::log(0.1 + 0.2 * f));
+      std::shared_ptr<fims_popdy::LogisticSelectivity<double> > selectivity =
+        std::make_shared<fims_popdy::LogisticSelectivity<double> >();
+      selectivity->inflection_point = fims::Vector<double>(1, 2.0 + 2.0 * f);
+      selectivity->slope = fims::Vector<double>(1, 1.0);
+      fleet->selectivity = selectivity;
+      fleets.push_back(fleet);
+      model->fleets[fleet->GetId()] = fleet;
+    }
+
+    std::shared_ptr<fims_popdy::Population<double> > population =
+      std::make_shared<fims_popdy::Population<double> >();
+    population->nyears = nyears;
+    population->nages = nages;
+    population->nfleets = fleets.size();
+    population->fleets = fleets;
+    population->ages.resize(nages);
+    population->log_init_naa.resize(nages);
+    population->log_M = fims::Vector<double>(nyears * nages, std::log(0.2));
+    std::shared_ptr<fims_popdy::EWAAgrowth<double> > growth =
+      std::make_shared<fims_popdy::EWAAgrowth<double> >();
+    for (size_t a = 0; a < nages; a++)
+    {
+      population->ages[a] = a + 1;
+      population->log_init_naa[a] = std::log(1000.0) - 0.3 * a;
+      growth->ewaa[a + 1] = 0.1 * (a + 1);
+    }
+    population->growth = growth;
+    std::shared_ptr<fims_popdy::LogisticMaturity<double> > maturity =
+      std::make_shared<fims_popdy::LogisticMaturity<double> >();
+    maturity->inflection_point = fims::Vector<double>(1, 3.0);
+    maturity->slope = fims::Vector<double>(1, 1.5);
+    population->maturity = maturity;
+    std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+      std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+    std::shared_ptr<fims_popdy::LogDevs<double> > log_devs =
+      std::make_shared<fims_popdy::LogDevs<double> >();
+    recruitment->process = log_devs;
+    recruitment->process->recruitment = recruitment;
+    recruitment->logit_steep =
+      fims::Vector<double>(1, fims_math::logit(0.2, 1.0, 0.75));
+    recruitment->log_rzero = fims::Vector<double>(1, std::log(1000.0));
+    recruitment->log_recruit_devs = fims::Vector<double>(nyears - 1, 0.0);
+    recruitment->log_expected_recruitment.resize(nyears + 1);
+    population->recruitment = recruitment;
+    model->populations.push_back(population);
+    model->Initialize();
+    model->Evaluate();
+
+    // the same model built by hand, with F allocated 1:3 by the terminal F
+    fims_popdy::EquilibriumModel<double> eq;
+    eq.recruitment = recruitment;
+    eq.M.resize(nages);
+    eq.weight.resize(nages);
+    eq.fecundity.resize(nages);
+    eq.selectivity.resize(nages);
+    for (size_t a = 0; a < nages; a++)
+    {
+      eq.M[a] = 0.2;
+      eq.weight[a] = 0.1 * (a + 1);
+      eq.fecundity[a] = 0.5 * maturity->evaluate(a + 1.0) * eq.weight[a];
+      eq.selectivity[a] = 0.25 * fleets[0]->selectivity->evaluate(a + 1.0) +
+                          0.75 * fleets[1]->selectivity->evaluate(a + 1.0);
+    }
+
+    model->spr_targets = {0.4};
+    fims_popdy::ReferencePoints<double> rp =
+      model->CalculateReferencePoints(model->populations[0]);
+    fims_popdy::ReferencePoints<double> expected = eq.Calculate({0.4});
+    EXPECT_NEAR(rp.phi0, expected.phi0, 1e-10);
+    EXPECT_NEAR(rp.F_msy, expected.F_msy, 1e-8);
+    EXPECT_NEAR(rp.msy, expected.msy, 1e-8);
+    ASSERT_EQ(rp.F_spr.size(), 1u);
+    EXPECT_NEAR(rp.F_spr[0], expected.F_spr[0], 1e-8);
+
+    // an explicit allocation replaces the terminal-year F
+    fims_popdy::ReferencePoints<double> first_fleet =
+      model->CalculateReferencePoints(model->populations[0], {1.0, 0.0});
+    EXPECT_GT(std::fabs(first_fleet.F_msy - rp.F_msy), 1e-4);
+  }
+}
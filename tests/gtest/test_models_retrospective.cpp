@@ -0,0 +1,209 @@
+#include "gtest/gtest.h"
+#include "common/retrospective.hpp"
+
+namespace
+{
+  // A normal likelihood with unit standard deviation that skips missing
+  // observations; the likelihoods in distributions/ are only evaluated in
+  // TMB builds
+  template <typename Type>
+  struct UnitNormal : public fims_distributions::DensityComponentBase<Type>
+  {
+    virtual const Type evaluate()
+    {
+      size_t n = this->get_n_x();
+      this->lpdf_vec.resize(n);
+      Type lpdf = 0.0;
+      for (size_t i = 0; i < n; i++)
+      {
+        this->lpdf_vec[i] = 0.0;
+        if (this->get_observed(i) != this->observed_values->na_value)
+        {
+          Type residual = this->get_observed(i) - this->get_expected(i);
+          this->lpdf_vec[i] = -0.5 * residual * residual;
+        }
+        lpdf += this->lpdf_vec[i];
+      }
+      return lpdf;
+    }
+  };
+
+  // A catch-at-age model with one population and one fleet whose log index
+  // is fit with UnitNormal, registered in the double Information
+  // instance with log_rzero and log_q as the fixed effects
+  std::shared_ptr<fims_popdy::CatchAtAge<double> > MakeModel(
+    size_t nyears, size_t nages)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+    info->SetNyears(nyears);
+
+    std::shared_ptr<fims_popdy::CatchAtAge<double> > model =
+      std::make_shared<fims_popdy::CatchAtAge<double> >();
+    std::shared_ptr<fims_popdy::Fleet<double> > fleet =
+      std::make_shared<fims_popdy::Fleet<double> >();
+    fleet->nyears = nyears;
+    fleet->nages = nages;
+    fleet->nlengths = 0;
+    fleet->log_q = fims::Vector<double>(1, std::log(0.5));
+    fleet->log_Fmort.resize(nyears);
+    for (size_t y = 0; y < nyears; y++)
+    {
+      fleet->log_Fmort[y] = std::log(0.1 + 0.03 * y);
+    }
+    std::shared_ptr<fims_popdy::LogisticSelectivity<double> > selectivity =
+      std::make_shared<fims_popdy::LogisticSelectivity<double> >();
+    selectivity->inflection_point = fims::Vector<double>(1, 2.0);
+    selectivity->slope = fims::Vector<double>(1, 1.0);
+    fleet->selectivity = selectivity;
+    model->fleets[fleet->GetId()] = fleet;
+
+    std::shared_ptr<fims_popdy::Population<double> > population =
+      std::make_shared<fims_popdy::Population<double> >();
+    population->nyears = nyears;
+    population->nages = nages;
+    population->nfleets = 1;
+    population->fleets.push_back(fleet);
+    population->ages.resize(nages);
+    population->log_init_naa.resize(nages);
+    population->log_M = fims::Vector<double>(nyears * nages, std::log(0.2));
+    std::shared_ptr<fims_popdy::EWAAgrowth<double> > growth =
+      std::make_shared<fims_popdy::EWAAgrowth<double> >();
+    for (size_t a = 0; a < nages; a++)
+    {
+      population->ages[a] = a + 1;
+      population->log_init_naa[a] = std::log(1000.0) - 0.3 * a;
+      growth->ewaa[a + 1] = 0.1 * (a + 1);
+    }
+    population->growth = growth;
+
+    std::shared_ptr<fims_popdy::LogisticMaturity<double> > maturity =
+      std::make_shared<fims_popdy::LogisticMaturity<double> >();
+    maturity->inflection_point = fims::Vector<double>(1, 3.0);
+    maturity->slope = fims::Vector<double>(1, 1.5);
+    population->maturity = maturity;
+
+    std::shared_ptr<fims_popdy::SRBevertonHolt<double> > recruitment =
+      std::make_shared<fims_popdy::SRBevertonHolt<double> >();
+    std::shared_ptr<fims_popdy::LogDevs<double> > log_devs =
+      std::make_shared<fims_popdy::LogDevs<double> >();
+    recruitment->process = log_devs;
+    recruitment->process->recruitment = recruitment;
+    recruitment->logit_steep =
+      fims::Vector<double>(1, fims_math::logit(0.2, 1.0, 0.75));
+    recruitment->log_rzero = fims::Vector<double>(1, std::log(1000.0));
+    recruitment->log_recruit_devs = fims::Vector<double>(nyears - 1, 0.0);
+    recruitment->log_expected_recruitment.resize(nyears + 1);
+    population->recruitment = recruitment;
+
+    model->populations.push_back(population);
+    model->Initialize();
+    model->Evaluate();
+
+    // observations scattered around the expected log index
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(nyears);
+    fims::Vector<double> &log_index_expected =
+      model->fleet_derived_quantities[fleet->GetId()]["log_index_expected"];
+    for (size_t y = 0; y < nyears; y++)
+    {
+      index->set(y, log_index_expected[y] + 0.2 * std::sin(3.0 * y));
+    }
+    std::shared_ptr<UnitNormal<double> > likelihood =
+      std::make_shared<UnitNormal<double> >();
+    likelihood->input_type = "data";
+    likelihood->observed_values = index;
+    likelihood->key.resize(1);
+    likelihood->key[0] = 1;
+
+    info->models_map[model->GetId()] = model;
+    info->fleets[fleet->GetId()] = fleet;
+    info->data_objects[index->id] = index;
+    info->density_components[likelihood->id] = likelihood;
+    info->variable_map[1] = &log_index_expected;
+    info->RegisterParameter(recruitment->log_rzero[0]);
+    info->RegisterParameter(fleet->log_q[0]);
+    return model;
+  }
+
+  // A full evaluation of the double model at par with the last nyears_removed
+  // years masked, starting from the full data
+  double FreshObjective(const std::vector<double> &par, size_t nyears_removed)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    std::shared_ptr<fims_model::Model<double> > model =
+      fims_model::Model<double>::GetInstance();
+    fims_model::PeelData<double> data(info);
+    data.Mask(nyears_removed);
+    info->UpdateFixedEffectsParameters(par);
+    model->incremental = false;
+    double objective = model->Evaluate();
+    data.Mask(0);
+    return objective;
+  }
+
+  // Test that the first objective function value of each peel, which is
+  // evaluated incrementally after the previous peel, matches a full
+  // evaluation with the same data and parameters, as does the value at the
+  // estimates of each peel
+  TEST(Retrospective, PeelObjectiveMatchesFullEvaluation)
+  {
+    size_t nyears = 12;
+    MakeModel(nyears, 6);
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    std::shared_ptr<fims_model::Model<double> > model =
+      fims_model::Model<double>::GetInstance();
+    std::vector<double> start = {*info->fixed_effects_parameters[0],
+                                 *info->fixed_effects_parameters[1]};
+
+    // without iterations the objective is the first one of each peel
+    fims_model::Retrospective<double> first;
+    first.npeels = 3;
+    first.control.max_iterations = 0;
+    fims_model::RetrospectiveResult result = first.Run();
+    ASSERT_EQ(result.objective.size(), 4);
+    for (size_t k = 0; k < result.objective.size(); k++)
+    {
+      EXPECT_NEAR(result.objective[k], FreshObjective(start, k),
+                  1e-10 * std::fabs(result.objective[k]));
+    }
+    // the masked years are left out of the likelihood
+    EXPECT_NE(result.objective[0], result.objective[3]);
+
+    fims_model::Retrospective<double> fit;
+    fit.npeels = 3;
+    fit.control.max_iterations = 5;
+    result = fit.Run();
+    ASSERT_EQ(result.objective.size(), 4);
+    // the starting values are restored
+    EXPECT_EQ(*info->fixed_effects_parameters[0], start[0]);
+    for (size_t k = 0; k < result.objective.size(); k++)
+    {
+      EXPECT_NEAR(result.objective[k], FreshObjective(result.par[k], k),
+                  1e-10 * std::fabs(result.objective[k]));
+    }
+
+    model->incremental = false;
+    info->Clear();
+  }
+
+  // Test that a model with random effects is rejected
+  TEST(Retrospective, RejectsRandomEffects)
+  {
+    MakeModel(6, 4);
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    double re = 0.0;
+    info->RegisterRandomEffect(re);
+
+    fims_model::Retrospective<double> retro;
+    fims_model::RetrospectiveResult result = retro.Run();
+    EXPECT_TRUE(result.objective.empty());
+    EXPECT_TRUE(result.par.empty());
+
+    info->Clear();
+  }
+}
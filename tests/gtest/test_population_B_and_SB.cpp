@@ -31,6 +31,29 @@ namespace
         EXPECT_GT(dq["biomass"][year], 0);
     }
 
+    // Test that weights at age by year are used for the biomass of that year
+    TEST_F(CAAEvaluateTestFixture, CalculateBiomass_TimeVaryingWeight_works)
+    {
+        uint32_t pop_id = population->GetId();
+        auto growth = std::dynamic_pointer_cast<fims_popdy::EWAAgrowth<double>>(
+            population->growth);
+        growth->weight_at_year_age.resize(nyears * nages);
+        for (int i = 0; i < nyears * nages; i++)
+        {
+            growth->weight_at_year_age[i] = 1.0 + 0.01 * i;
+        }
+        catch_at_age_model->Prepare();
+
+        auto& dq = catch_at_age_model->population_derived_quantities[pop_id];
+        EXPECT_EQ(dq["weight_at_age"].size(), nyears * nages);
+
+        double biomass = dq["biomass"][year];
+        catch_at_age_model->CalculateBiomass(population, i_age_year, year, age);
+        EXPECT_DOUBLE_EQ(dq["biomass"][year] - biomass,
+                  dq["numbers_at_age"][i_age_year] *
+                      growth->weight_at_year_age[year * nages + age]);
+    }
+
     TEST_F(CAAEvaluateTestFixture, CalculateSpawningBiomass_ExtraYear_works)
     {
         uint32_t pop_id = population->GetId();
@@ -21,4 +21,22 @@ namespace
 
   }
 
+  // Test that evaluate_all gives the maturity at every age
+  TEST(LogisticMaturity, EvaluateAll)
+  {
+    fims_popdy::LogisticMaturity<double> maturity;
+    maturity.inflection_point.resize(1);
+    maturity.inflection_point[0] = 5.0;
+    maturity.slope.resize(1);
+    maturity.slope[0] = 0.9;
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0, 4.0, 6.0, 9.0});
+    fims::Vector<double> out;
+    maturity.evaluate_all(ages, out);
+    ASSERT_EQ(out.size(), ages.size());
+    for (size_t i = 0; i < ages.size(); ++i)
+    {
+      EXPECT_NEAR(out[i], maturity.evaluate(ages[i]), 1e-15);
+    }
+  }
+
 }
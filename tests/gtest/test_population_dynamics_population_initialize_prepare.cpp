@@ -106,5 +106,26 @@ namespace
         }
         
     }
+
+    // Test that Prepare() resets the derived quantities left over from an
+    // earlier evaluation, so they do not accumulate across evaluations
+    TEST_F(CAAPrepareTestFixture, Prepare_resets_previous_evaluation)
+    {
+        uint32_t pop_id = catch_at_age_model->populations[0]->GetId();
+        auto &dq = catch_at_age_model->population_derived_quantities[pop_id];
+        dq["biomass"][0] = 10.0;
+        dq["spawning_biomass"][0] = 5.0;
+        dq["numbers_at_age"][0] = 100.0;
+        dq["total_landings_weight"][0] = 1.0;
+
+        catch_at_age_model->Prepare();
+
+        EXPECT_EQ(dq["biomass"], fims::Vector<double>(nyears + 1, 0));
+        EXPECT_EQ(dq["spawning_biomass"], fims::Vector<double>(nyears + 1, 0));
+        EXPECT_EQ(dq["numbers_at_age"],
+            fims::Vector<double>((nyears + 1) * nages, 0)
+        );
+        EXPECT_EQ(dq["total_landings_weight"], fims::Vector<double>(nyears, 0));
+    }
 } // namespace
 
@@ -23,4 +23,26 @@ namespace
 
   }
 
-}
\ No newline at end of file
+  // Test that evaluate_all gives the selectivity at every age
+  TEST(DoubleLogisticSelectivity, EvaluateAll)
+  {
+    fims_popdy::DoubleLogisticSelectivity<double> fishery_selectivity;
+    fishery_selectivity.inflection_point_asc.resize(1);
+    fishery_selectivity.slope_asc.resize(1);
+    fishery_selectivity.inflection_point_desc.resize(1);
+    fishery_selectivity.slope_desc.resize(1);
+    fishery_selectivity.inflection_point_asc[0] = 3.0;
+    fishery_selectivity.slope_asc[0] = 1.5;
+    fishery_selectivity.inflection_point_desc[0] = 9.0;
+    fishery_selectivity.slope_desc[0] = 0.4;
+    fims::Vector<double> ages(std::vector<double>{1.0, 2.0, 4.0, 7.0, 11.0, 15.0});
+    fims::Vector<double> out;
+    fishery_selectivity.evaluate_all(ages, out);
+    ASSERT_EQ(out.size(), ages.size());
+    for (size_t i = 0; i < ages.size(); ++i)
+    {
+      EXPECT_NEAR(out[i], fishery_selectivity.evaluate(ages[i]), 1e-15);
+    }
+  }
+
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/information.hpp"
+
+namespace
+{
+  // Test that data objects viewing one buffer read the same values without
+  // copying them
+  TEST(SharedData, DataObjectsShareOneBuffer)
+  {
+    std::shared_ptr<fims::SharedData> buffer =
+      std::make_shared<fims::SharedData>(std::vector<double>{1.0, 2.0, 3.0});
+    fims_data_object::DataObject<double> a(3);
+    fims_data_object::DataObject<double> b(3);
+    a.data.SetBuffer(buffer);
+    b.data.SetBuffer(buffer);
+
+    EXPECT_EQ(a.data.GetBuffer().get(), b.data.GetBuffer().get());
+    EXPECT_EQ(a.at(1), 2.0);
+    EXPECT_EQ(b(2), 3.0);
+    EXPECT_FALSE(buffer->IsMapped());
+  }
+
+  // Test that a write to one data object copies the buffer first, so the
+  // other data objects keep the original values
+  TEST(SharedData, WritesCopyTheSharedBuffer)
+  {
+    std::shared_ptr<fims::SharedData> buffer =
+      std::make_shared<fims::SharedData>(std::vector<double>{1.0, 2.0, 3.0});
+    fims_data_object::DataObject<double> a(3);
+    fims_data_object::DataObject<double> b(3);
+    a.data.SetBuffer(buffer);
+    b.data.SetBuffer(buffer);
+
+    a.set(0, 10.0);
+    EXPECT_EQ(a.at(0), 10.0);
+    EXPECT_EQ(b.at(0), 1.0);
+    EXPECT_EQ(buffer->data()[0], 1.0);
+    EXPECT_NE(a.data.GetBuffer().get(), buffer.get());
+
+    // the copy is not shared, so later writes do not copy again
+    const fims::SharedData *copy = a.data.GetBuffer().get();
+    a.data[1] = 20.0;
+    EXPECT_EQ(a.data.GetBuffer().get(), copy);
+    EXPECT_EQ(a.at(1), 20.0);
+
+    EXPECT_THROW(a.set(3, 1.0), std::overflow_error);
+  }
+
+  // Test that updating a data object with a buffer swaps the pointer
+  TEST(SharedData, UpdateDataObjectSwapsBuffer)
+  {
+    std::shared_ptr<fims_info::Information<double> > info =
+      fims_info::Information<double>::GetInstance();
+    info->Clear();
+
+    std::shared_ptr<fims_data_object::DataObject<double> > index =
+      std::make_shared<fims_data_object::DataObject<double> >(2);
+    index->id = 1;
+    info->data_objects[1] = index;
+
+    std::shared_ptr<fims::SharedData> buffer =
+      std::make_shared<fims::SharedData>(std::vector<double>{4.0, 5.0});
+    EXPECT_TRUE(info->UpdateDataObject(1, buffer));
+    EXPECT_EQ(index->data.GetBuffer().get(), buffer.get());
+    EXPECT_EQ(index->at(1), 5.0);
+
+    std::shared_ptr<fims::SharedData> short_buffer =
+      std::make_shared<fims::SharedData>(std::vector<double>{6.0});
+    EXPECT_FALSE(info->UpdateDataObject(1, short_buffer));
+    EXPECT_EQ(index->data.GetBuffer().get(), buffer.get());
+
+    info->Clear();
+  }
+
+  // Test that a file of doubles is mapped and read back
+  TEST(SharedData, MapFileReadsDoubles)
+  {
+    std::string path = "shared_data_test.bin";
+    std::vector<double> values = {0.5, 1.5, 2.5, 3.5};
+    {
+      std::ofstream out(path.c_str(), std::ios::binary);
+      out.write(reinterpret_cast<const char *>(values.data()),
+                values.size() * sizeof(double));
+    }
+
+    std::shared_ptr<fims::SharedData> buffer =
+      fims::SharedData::MapFile(path);
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(buffer->size(), values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      EXPECT_EQ(buffer->data()[i], values[i]);
+    }
+
+    // a write to a mapped buffer goes to a copy
+    fims_data_object::DataObject<double> d(4);
+    d.data.SetBuffer(buffer);
+    d.set(3, 9.0);
+    EXPECT_EQ(d.at(3), 9.0);
+    EXPECT_EQ(buffer->data()[3], 3.5);
+
+    buffer.reset();
+    std::remove(path.c_str());
+    EXPECT_EQ(fims::SharedData::MapFile(path), nullptr);
+  }
+}
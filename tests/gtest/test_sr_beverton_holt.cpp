@@ -60,4 +60,27 @@ namespace
       EXPECT_EQ(recruit2.evaluate_process(0), 0);
   }
 
+  // Test that TransformParameters() caches steepness and unfished
+  // recruitment on the natural scale, and that a module that has not been
+  // transformed follows changes to its parameters
+  TEST(SrBevertonHoltEvaluate, TransformParametersCachesValues)
+  {
+      fims_popdy::SRBevertonHolt<double> recruit;
+      recruit.logit_steep.resize(1);
+      recruit.logit_steep[0] = fims_math::logit(0.2, 1.0, 0.75);
+      recruit.log_rzero.resize(1);
+      recruit.log_rzero[0] = std::log(1000.0);
+      EXPECT_NEAR(recruit.evaluate_mean(30.0, 0.1), 837.2093, 0.0001);
+      EXPECT_FALSE(recruit.transformed);
+
+      recruit.logit_steep[0] = fims_math::logit(0.2, 1.0, 0.99);
+      EXPECT_NEAR(recruit.evaluate_mean(30.0, 0.1), 994.1423, 0.0001);
+
+      recruit.TransformParameters();
+      EXPECT_TRUE(recruit.transformed);
+      EXPECT_NEAR(recruit.steep, 0.99, 1e-12);
+      EXPECT_NEAR(recruit.rzero, 1000.0, 1e-9);
+      EXPECT_NEAR(recruit.evaluate_mean(30.0, 0.1), 994.1423, 0.0001);
+  }
+
 }